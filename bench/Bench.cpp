@@ -0,0 +1,81 @@
+/*
+ * Bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace circuit {
+
+volatile float CBench::sink = 0.f;
+
+CBench::CBench(const SConfig& config)
+		: config(config)
+{
+}
+
+CBench::~CBench()
+{
+}
+
+bool CBench::IsSelected(const std::string& name) const
+{
+	return config.filter.empty() || (name.find(config.filter) != std::string::npos);
+}
+
+void CBench::Run(const std::string& name, const Func& setup, const Func& body)
+{
+	if (!IsSelected(name)) {
+		return;
+	}
+
+	using clock = std::chrono::steady_clock;
+	samples.clear();
+	samples.reserve(config.reps);
+	for (int i = -config.warmup; i < config.reps; ++i) {
+		if (setup) {
+			setup();
+		}
+		const clock::time_point t0 = clock::now();
+		body();
+		const clock::time_point t1 = clock::now();
+		if (i >= 0) {
+			samples.push_back(std::chrono::duration<float, std::micro>(t1 - t0).count());
+		}
+	}
+	if (samples.empty()) {
+		return;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	float mean = 0.f;
+	for (float s : samples) {
+		mean += s;
+	}
+	mean /= samples.size();
+	printf("%-28s %6i %11.1f %11.1f %11.1f %11.1f %11.1f %11.1f\n", name.c_str(), int(samples.size()),
+			samples.front(), Percentile(0.5f), Percentile(0.9f), Percentile(0.99f), samples.back(), mean);
+	fflush(stdout);
+}
+
+void CBench::PrintHeader()
+{
+	printf("%-28s %6s %11s %11s %11s %11s %11s %11s\n", "kernel (us)", "reps", "min", "p50", "p90", "p99", "max", "mean");
+}
+
+/*
+ * Nearest-rank percentile of sorted samples
+ */
+float CBench::Percentile(float p) const
+{
+	const int rank = std::max(int(p * samples.size() + 0.5f) - 1, 0);
+	return samples[std::min<int>(rank, samples.size() - 1)];
+}
+
+} // namespace circuit
@@ -0,0 +1,51 @@
+/*
+ * Bench.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Repetition runner: warm-up runs are discarded, every measured repetition is one sample.
+ * Setup is called before each repetition outside of timed region.
+ */
+class CBench {
+public:
+	struct SConfig {
+		int warmup;
+		int reps;
+		std::string filter;  // substring of kernel name, empty runs all
+	};
+	using Func = std::function<void ()>;
+
+	CBench(const SConfig& config);
+	virtual ~CBench();
+
+	bool IsSelected(const std::string& name) const;
+	void Run(const std::string& name, const Func& setup, const Func& body);
+	void Run(const std::string& name, const Func& body) { Run(name, nullptr, body); }
+
+	static void PrintHeader();
+	// Keeps results alive so compiler can't drop the kernel
+	static void Consume(float value) { sink = sink + value; }
+
+private:
+	float Percentile(float p) const;
+
+	SConfig config;
+	std::vector<float> samples;  // microseconds, sorted after run
+	static volatile float sink;
+};
+
+} // namespace circuit
+
+#endif // BENCH_BENCH_H_
@@ -0,0 +1,106 @@
+/*
+ * KMeansReference.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KMeansReference.h"
+
+#include "util/utils.h"
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace circuit {
+
+using namespace springai;
+
+CKMeansReference::CKMeansReference(const AIFloat3& initPos)
+{
+	means.push_back(initPos);
+}
+
+CKMeansReference::~CKMeansReference()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+/*
+ * 2d only, ignores y component.
+ * @see KAIK/AttackHandler::KMeansIteration for general reference
+ */
+void CKMeansReference::Iteration(const std::vector<AIFloat3>& unitPositions, int newK)
+{
+	assert(newK > 0 && !unitPositions.empty());
+	int numUnits = unitPositions.size();
+	// change the number of means according to newK
+	int oldK = means.size();
+	means.resize(newK);
+	// add new means at the positions farthest from already placed means
+	if (newK > oldK) {
+		std::vector<float> placedDistance(numUnits, std::numeric_limits<float>::max());
+		for (int i = 0; i < numUnits; i++) {
+			for (int m = 0; m < oldK; m++) {
+				placedDistance[i] = std::min(placedDistance[i], unitPositions[i].SqDistance2D(means[m]));
+			}
+		}
+		for (int m = oldK; m < newK; m++) {
+			int farthestIndex = std::max_element(placedDistance.begin(), placedDistance.end()) - placedDistance.begin();
+			means[m] = unitPositions[farthestIndex];
+			for (int i = 0; i < numUnits; i++) {
+				placedDistance[i] = std::min(placedDistance[i], unitPositions[i].SqDistance2D(means[m]));
+			}
+		}
+	}
+
+	// check all positions and assign them to means, complexity n*k for one iteration
+	std::vector<int> unitsClosestMeanID(numUnits, -1);
+	std::vector<float> unitsClosestDistance(numUnits);
+	std::vector<int> numUnitsAssignedToMean(newK, 0);
+
+	for (int i = 0; i < numUnits; i++) {
+		AIFloat3 unitPos = unitPositions[i];
+		float closestDistance = std::numeric_limits<float>::max();
+		int closestIndex = -1;
+
+		for (int m = 0; m < newK; m++) {
+			AIFloat3 mean = means[m];
+			float distance = unitPos.SqDistance2D(mean);
+
+			if (distance < closestDistance) {
+				closestDistance = distance;
+				closestIndex = m;
+			}
+		}
+
+		// position i is closest to the mean at closestIndex
+		unitsClosestMeanID[i] = closestIndex;
+		unitsClosestDistance[i] = closestDistance;
+		numUnitsAssignedToMean[closestIndex]++;
+	}
+
+	// change the means according to which positions are assigned to them
+	std::vector<AIFloat3> newMeans(newK, ZeroVector);
+
+	for (int i = 0; i < numUnits; i++) {
+		int meanIndex = unitsClosestMeanID[i];
+		newMeans[meanIndex] += unitPositions[i] / numUnitsAssignedToMean[meanIndex];
+	}
+
+	// if a mean has no positions assigned, move it to the worst placed position
+	for (int m = 0; m < newK; m++) {
+		if (numUnitsAssignedToMean[m] > 0) {
+			means[m] = newMeans[m];
+			continue;
+		}
+		int worstIndex = std::max_element(unitsClosestDistance.begin(), unitsClosestDistance.end()) - unitsClosestDistance.begin();
+		if (unitsClosestDistance[worstIndex] > 0.f) {
+			means[m] = unitPositions[worstIndex];
+			unitsClosestDistance[worstIndex] = 0.f;  // one mean per position
+		}
+	}
+}
+
+} // namespace circuit
@@ -0,0 +1,37 @@
+/*
+ * KMeansReference.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCH_KMEANSREFERENCE_H_
+#define BENCH_KMEANSREFERENCE_H_
+
+#include "AIFloat3.h"
+
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Plain Lloyd k-means as CKMeansCluster did before incremental version: full n*k assignment
+ * every iteration. New means are placed farthest-first, empty means at the worst placed point.
+ * Baseline of kmeans_* kernels and of CheckKMeans inertia.
+ */
+class CKMeansReference {
+public:
+	CKMeansReference(const springai::AIFloat3& initPos);
+	virtual ~CKMeansReference();
+
+	void Iteration(const std::vector<springai::AIFloat3>& unitPositions, int newK);
+	const std::vector<springai::AIFloat3>& GetMeans() const { return means; }
+	void SetMeans(const std::vector<springai::AIFloat3>& newMeans) { means = newMeans; }
+
+private:
+	std::vector<springai::AIFloat3> means;
+};
+
+} // namespace circuit
+
+#endif // BENCH_KMEANSREFERENCE_H_
@@ -0,0 +1,644 @@
+/*
+ * Kernels.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "Kernels.h"
+#include "Bench.h"
+#include "KMeansReference.h"
+#include "Scenario.h"
+#include "StandIn.h"
+
+#include "terrain/BlockingMap.h"
+#include "terrain/PathFinder.h"
+#include "terrain/TerrainData.h"
+#include "terrain/ThreatGrid.h"
+#include "resource/EnergyTree.h"
+#include "resource/MetalData.h"
+#include "util/math/EncloseCircle.h"
+#include "util/math/HierarchCluster.h"
+#include "util/math/KMeansCluster.h"
+#include "util/math/RagMatrix.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <cmath>
+#include <cstdio>
+
+namespace circuit {
+
+using namespace springai;
+using namespace NSMicroPather;
+
+#define PATH_QUERIES		64
+#define GOAL_TARGETS		16
+#define GOAL_RADIUS			6  // path nodes
+#define KMEANS_GROUPS		32
+#define KMEANS_MOVED		10  // percent of points moved between iterations
+#define KMEANS_ROUNDS		20  // warm iterations of CheckKMeans
+#define KMEANS_TOLERANCE	0.05f  // incremental inertia may exceed reference by 5%
+#define CLUSTER_DISTANCE	1000.f
+#define ENCLOSE_SETS		256
+#define SPOT_QUERIES		4096
+#define CRATER_RADIUS		24  // height map squares
+#define CRATER_DEPTH		80.f
+#define BUILD_QUERIES		256
+#define BUILD_RADIUS		600.f  // FindBuildSite
+#define BUILD_RADIUS_LOW	2000.f  // FindBuildSiteLow, > SQUARE_SIZE * 2 * 100
+#define ENERGY_OWNED		50  // percent of owned clusters
+#define ENERGY_CHANGES		1  // ownership and link changes per RebuildTree
+
+namespace {
+
+void MakeDistMatrix(const CMetalData::Metals& spots, CRagMatrix& matrix)
+{
+	for (unsigned i = 1; i < spots.size(); ++i) {
+		for (unsigned j = 0; j < i; ++j) {
+			matrix(i, j) = spots[i].position.distance2D(spots[j].position);
+		}
+	}
+}
+
+/*
+ * Sector centres of mobile type's areas, as CPathFinder marks them passable
+ */
+void GetPassable(const CTerrainData& terrainData, BenchMoveType type, std::vector<AIFloat3>& passable)
+{
+	const SAreaData& areaData = *terrainData.pAreaData.load();
+	const STerrainMapMobileType& mt = areaData.mobileType[static_cast<int>(type)];
+	passable.clear();
+	for (unsigned i = 0; i < mt.sector.size(); ++i) {
+		if (mt.sector[i].area != nullptr) {
+			passable.push_back(areaData.sector[i].position);
+		}
+	}
+}
+
+// Sum of squared 2D distances to the closest mean
+float GetInertia(const std::vector<AIFloat3>& points, const std::vector<AIFloat3>& means)
+{
+	float inertia = 0.f;
+	for (const AIFloat3& p : points) {
+		float minDist = std::numeric_limits<float>::max();
+		for (const AIFloat3& m : means) {
+			minDist = std::min(minDist, p.SqDistance2D(m));
+		}
+		inertia += minDist;
+	}
+	return inertia;
+}
+
+// Index of the closest mean, the first one on ties as plain Lloyd assignment
+int GetClosestMean(const AIFloat3& point, const std::vector<AIFloat3>& means)
+{
+	int closestIndex = -1;
+	float closestSqDist = std::numeric_limits<float>::max();
+	for (unsigned i = 0; i < means.size(); ++i) {
+		const float sqDist = point.SqDistance2D(means[i]);
+		if (sqDist < closestSqDist) {
+			closestSqDist = sqDist;
+			closestIndex = i;
+		}
+	}
+	return closestIndex;
+}
+
+// Random move of KMEANS_MOVED percent of points, as enemies move between CMilitaryManager::KMeansIteration
+void MovePoints(std::mt19937& rng, const std::vector<AIFloat3>& points,
+				std::vector<std::pair<int, AIFloat3>>& moved)
+{
+	moved.clear();
+	for (unsigned i = 0; i < points.size(); ++i) {
+		if (int(rng() % 100) < KMEANS_MOVED) {
+			AIFloat3 pos = points[i];
+			pos.x += int(rng() % 129) - 64;
+			pos.z += int(rng() % 129) - 64;
+			moved.push_back(std::make_pair(i, pos));
+		}
+	}
+}
+
+} // namespace
+
+void BenchPather(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	CTerrainData terrainData;
+	InitTerrainData(scenario, terrainData);
+	SThreatGrid grid;
+	InitThreatGrid(terrainData, grid);
+	for (const SScenario::SEnemy& e : scenario.enemies) {
+		AddEnemy(terrainData, grid, e);
+	}
+	std::vector<AIFloat3> passable;
+	GetPassable(terrainData, BenchMoveType::BOT, passable);
+	if (passable.size() < 2) {
+		return;
+	}
+
+	std::mt19937 rng(seed);
+	std::vector<std::pair<AIFloat3, AIFloat3>> queries;
+	while (queries.size() < PATH_QUERIES) {
+		const AIFloat3& start = passable[rng() % passable.size()];
+		const AIFloat3& end = passable[rng() % passable.size()];
+		if (start != end) {
+			queries.push_back(std::make_pair(start, end));
+		}
+	}
+
+	std::unique_ptr<CPathFinder> pathfinder(new CPathFinder(&terrainData));
+	SetPathMapData(*pathfinder, grid, static_cast<int>(BenchMoveType::BOT));
+	const int radius = GOAL_RADIUS * pathfinder->GetSquareSize();
+	const int pointRadius = pathfinder->GetSquareSize();  // MakePath fails on radius < 1 node
+	F3Vec path;
+
+	const std::pair<OpenListType, const char*> openLists[] = {
+		{OpenListType::BINARY_HEAP, "pather_solve/binary"},
+		{OpenListType::QUAD_HEAP, "pather_solve/quad"},
+		{OpenListType::RADIX_HEAP, "pather_solve/radix"},
+	};
+	for (auto& ol : openLists) {
+		bench.Run(ol.second, [&]() {
+			pathfinder->SetOpenListType(ol.first);
+			for (auto& q : queries) {
+				AIFloat3 start = q.first, end = q.second;
+				path.clear();
+				CBench::Consume(pathfinder->MakePath(path, start, end, pointRadius));
+			}
+		});
+	}
+	pathfinder->SetOpenListType(OpenListType::BINARY_HEAP);
+
+	bench.Run("pather_radius", [&]() {
+		for (auto& q : queries) {
+			AIFloat3 start = q.first, end = q.second;
+			path.clear();
+			CBench::Consume(pathfinder->MakePath(path, start, end, radius));
+		}
+	});
+
+	bench.Run("pather_cost", [&]() {
+		for (auto& q : queries) {
+			AIFloat3 end = q.second;
+			CBench::Consume(pathfinder->PathCost(q.first, end, radius));
+		}
+	});
+
+	// Goal discs around random passable targets
+	F3Vec targets;
+	for (int i = 0; i < GOAL_TARGETS; ++i) {
+		targets.push_back(passable[rng() % passable.size()]);
+	}
+	CPathFinder::CGoalSet goals;
+	bench.Run("pather_goal_set", [&]() {
+		pathfinder->MakeGoalSet(goals, targets, radius);
+		CBench::Consume(goals.IsEmpty());
+	});
+	bench.Run("pather_any_goal", [&]() {
+		for (auto& q : queries) {
+			AIFloat3 start = q.first;
+			path.clear();
+			CBench::Consume(pathfinder->FindBestPath(path, start, goals, false));
+		}
+	});
+}
+
+void BenchCluster(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	std::vector<AIFloat3> points;
+	for (const SScenario::SEnemy& e : scenario.enemies) {
+		points.push_back(e.pos);
+	}
+	if (!points.empty()) {
+		const int k = std::min<int>(KMEANS_GROUPS, points.size());
+		std::mt19937 rng(seed);
+		CKMeansCluster warm(points.front());
+		for (unsigned i = 0; i < points.size(); ++i) {
+			warm.SetPoint(i, points[i]);
+		}
+		warm.Iteration(k);
+
+		std::vector<std::pair<int, AIFloat3>> moved;
+		bench.Run("kmeans_warm", [&]() {
+			MovePoints(rng, points, moved);
+		}, [&]() {
+			for (auto& m : moved) {
+				warm.SetPoint(m.first, m.second);
+			}
+			warm.Iteration(k);
+			CBench::Consume(warm.GetMeans().front().x);
+		});
+
+		// Reference gets all positions every iteration, as CMilitaryManager did
+		CKMeansReference warmRef(points.front());
+		std::vector<AIFloat3> positions = points;
+		warmRef.Iteration(positions, k);
+		bench.Run("kmeans_warm/reference", [&]() {
+			MovePoints(rng, points, moved);
+		}, [&]() {
+			for (auto& m : moved) {
+				positions[m.first] = m.second;
+			}
+			warmRef.Iteration(positions, k);
+			CBench::Consume(warmRef.GetMeans().front().x);
+		});
+
+		bench.Run("kmeans_cold", [&]() {
+			CKMeansCluster cold(points.front());
+			for (unsigned i = 0; i < points.size(); ++i) {
+				cold.SetPoint(i, points[i]);
+			}
+			for (int i = 0; i < 10; ++i) {
+				cold.Iteration(k);
+			}
+			CBench::Consume(cold.GetMeans().front().x);
+		});
+		bench.Run("kmeans_cold/reference", [&]() {
+			CKMeansReference cold(points.front());
+			for (int i = 0; i < 10; ++i) {
+				cold.Iteration(points, k);
+			}
+			CBench::Consume(cold.GetMeans().front().x);
+		});
+	}
+
+	const CMetalData::Metals& spots = scenario.spots;
+	if (spots.size() > 1) {
+		CRagMatrix baseMatrix(spots.size());
+		MakeDistMatrix(spots, baseMatrix);
+		std::unique_ptr<CRagMatrix> matrix;
+		bench.Run("hierarch_cluster", [&]() {
+			matrix.reset(new CRagMatrix(baseMatrix));
+		}, [&]() {
+			CHierarchCluster clust;
+			CBench::Consume(clust.Clusterize(*matrix, CLUSTER_DISTANCE).size());
+		});
+
+		// Point sets of nearby spots, 3..30 points each
+		std::mt19937 rng(seed);
+		std::vector<std::vector<AIFloat3>> sets(ENCLOSE_SETS);
+		std::vector<std::pair<float, unsigned>> byDist(spots.size());
+		for (std::vector<AIFloat3>& set : sets) {
+			const AIFloat3& center = spots[rng() % spots.size()].position;
+			for (unsigned i = 0; i < spots.size(); ++i) {
+				byDist[i] = std::make_pair(center.SqDistance2D(spots[i].position), i);
+			}
+			const unsigned size = std::min<unsigned>(3 + rng() % 28, spots.size());
+			std::partial_sort(byDist.begin(), byDist.begin() + size, byDist.end());
+			for (unsigned i = 0; i < size; ++i) {
+				set.push_back(spots[byDist[i].second].position);
+			}
+		}
+		bench.Run("enclose_circle", [&]() {
+			CEncloseCircle enclose;
+			for (const std::vector<AIFloat3>& set : sets) {
+				enclose.MakeCircle(set);
+				CBench::Consume(enclose.GetRadius());
+			}
+		});
+	}
+}
+
+void BenchMetal(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	const CMetalData::Metals& spots = scenario.spots;
+	if (spots.size() < 2) {
+		return;
+	}
+
+	std::unique_ptr<CMetalData> metalData;
+	bench.Run("spot_tree_build", [&]() {
+		metalData.reset(new CMetalData());
+	}, [&]() {
+		InitMetalData(scenario, *metalData);
+	});
+
+	std::mt19937 rng(seed);
+	std::vector<AIFloat3> queries;
+	for (int i = 0; i < SPOT_QUERIES; ++i) {
+		queries.push_back(AIFloat3((rng() / 4294967296.0f) * scenario.GetWidth(), 0.f,
+								   (rng() / 4294967296.0f) * scenario.GetDepth()));
+	}
+	bench.Run("spot_tree_knn", [&]() {
+		for (const AIFloat3& pos : queries) {
+			CBench::Consume(metalData->FindNearestSpot(pos));
+		}
+	});
+
+	CRagMatrix baseMatrix(spots.size());
+	MakeDistMatrix(spots, baseMatrix);
+	std::shared_ptr<CRagMatrix> matrix;
+	bench.Run("metal_clusterize", [&]() {
+		metalData.reset(new CMetalData());
+		InitMetalData(scenario, *metalData);
+		matrix = std::make_shared<CRagMatrix>(baseMatrix);
+	}, [&]() {
+		metalData->Clusterize(CLUSTER_DISTANCE, matrix);
+		CBench::Consume(metalData->GetClusters().size());
+	});
+}
+
+void BenchTerrain(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	std::unique_ptr<CTerrainData> terrainData;
+	bench.Run("terrain_init", [&]() {
+		terrainData.reset(new CTerrainData());
+	}, [&]() {
+		InitTerrainData(scenario, *terrainData);
+		CBench::Consume(terrainData->pAreaData.load()->percentLand);
+	});
+	if (terrainData == nullptr) {
+		terrainData.reset(new CTerrainData());
+		InitTerrainData(scenario, *terrainData);
+	}
+
+	// Crater at random position, as CTerrainData::CheckHeightMap sees it after explosion
+	std::mt19937 rng(seed);
+	std::vector<float> heights;
+	bench.Run("terrain_update_areas", [&]() {
+		heights = scenario.heights;
+		const int cx = rng() % scenario.mapX;
+		const int cz = rng() % scenario.mapZ;
+		const int x1 = std::max(cx - CRATER_RADIUS, 0), x2 = std::min(cx + CRATER_RADIUS, scenario.mapX - 1);
+		const int z1 = std::max(cz - CRATER_RADIUS, 0), z2 = std::min(cz + CRATER_RADIUS, scenario.mapZ - 1);
+		for (int z = z1; z <= z2; ++z) {
+			for (int x = x1; x <= x2; ++x) {
+				const float dist = sqrtf(SQUARE(x - cx) + SQUARE(z - cz));
+				if (dist < CRATER_RADIUS) {
+					heights[z * scenario.mapX + x] -= CRATER_DEPTH * (1.f - dist / CRATER_RADIUS);
+				}
+			}
+		}
+		terrainData->SetNextMaps(std::move(heights), std::vector<float>(scenario.slopes));
+	}, [&]() {
+		terrainData->UpdateAreas();
+		CBench::Consume(terrainData->GetNextAreaData()->percentLand);
+	});
+}
+
+void BenchThreat(CBench& bench, const SScenario& scenario)
+{
+	CTerrainData terrainData;
+	InitTerrainData(scenario, terrainData);
+	std::vector<SScenario::SEnemy> enemies = scenario.enemies;
+
+	SThreatGrid grid;
+	bench.Run("threat_stamp", [&]() {
+		InitThreatGrid(terrainData, grid);
+	}, [&]() {
+		for (const SScenario::SEnemy& e : enemies) {
+			AddEnemy(terrainData, grid, e);
+		}
+		CBench::Consume(grid.surfThreat[grid.mapSize / 2]);
+	});
+
+	// CThreatMap::Update once per second: every enemy is re-stamped, mobile ones move to target
+	InitThreatGrid(terrainData, grid);
+	for (const SScenario::SEnemy& e : enemies) {
+		AddEnemy(terrainData, grid, e);
+	}
+	bench.Run("threat_update", [&]() {
+		for (SScenario::SEnemy& e : enemies) {
+			DelEnemy(terrainData, grid, e);
+		}
+		for (SScenario::SEnemy& e : enemies) {
+			const float speed = GetSpeed(e.kind);
+			const float dist = e.pos.distance2D(e.target);
+			if ((speed > 0.f) && (dist > speed)) {
+				e.pos += (e.target - e.pos) * (speed / dist);
+			}
+			AddEnemy(terrainData, grid, e);
+		}
+		grid.Decay();
+		CBench::Consume(grid.surfThreat[grid.mapSize / 2]);
+	});
+
+	bench.Run("threat_decay", [&]() {
+		grid.Decay();
+		CBench::Consume(grid.airThreat[grid.mapSize / 2]);
+	});
+}
+
+void BenchBuildSite(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	// Static enemies and occupied spots are the structures
+	std::vector<SScenario::SEnemy> structures;
+	for (const SScenario::SEnemy& e : scenario.enemies) {
+		if (GetSpeed(e.kind) <= 0.f) {
+			structures.push_back(e);
+		}
+	}
+	std::mt19937 rng(seed);
+	for (const CMetalData::SMetal& spot : scenario.spots) {
+		if (rng() % 2 == 0) {
+			structures.push_back({SScenario::SEnemy::Kind::MEX, 0, spot.position, ZeroVector});
+		}
+	}
+
+	SBlockingMap blockingMap;
+	InitBlockingMap(scenario, blockingMap);
+	bench.Run("build_site_mark", [&]() {
+		for (const SScenario::SEnemy& s : structures) {
+			MarkBlocker(blockingMap, s, true);
+		}
+		for (const SScenario::SEnemy& s : structures) {
+			MarkBlocker(blockingMap, s, false);
+		}
+		CBench::Consume(blockingMap.grid.front().blockerMask);
+	});
+	for (const SScenario::SEnemy& s : structures) {
+		MarkBlocker(blockingMap, s, true);
+	}
+
+	// Energy structures near spots and start boxes, as economy tasks request them
+	std::vector<AIFloat3> queries;
+	for (int i = 0; i < BUILD_QUERIES; ++i) {
+		if (!scenario.spots.empty() && (i % 2 == 0)) {
+			queries.push_back(scenario.spots[rng() % scenario.spots.size()].position);
+		} else if (!scenario.startBoxes.empty()) {
+			queries.push_back(scenario.startBoxes[rng() % scenario.startBoxes.size()].pos);
+		} else {
+			queries.push_back(AIFloat3(scenario.GetWidth() / 2, 0.f, scenario.GetDepth() / 2));
+		}
+	}
+	const int2 size = GetBuildSize(SScenario::SEnemy::Kind::ENERGY);
+	const int radius = int(BUILD_RADIUS / (SQUARE_SIZE * 2));
+	const int radiusLow = int(BUILD_RADIUS_LOW / (SQUARE_SIZE * 2));
+	SBlockingMap::GetSearchOffsetTable(radius);
+	SBlockingMap::GetSearchOffsetTableLow(radiusLow);
+	// Engine checks CanBeBuiltAtSafe and Map::IsPossibleToBuildAt accept every open site
+	SBlockingMap::SitePredicate predicate = [](const int2&, const int2&) {
+		return true;
+	};
+
+	bench.Run("build_site", [&]() {
+		for (const AIFloat3& pos : queries) {
+			const int2 cell(int(pos.x / (SQUARE_SIZE * 2)), int(pos.z / (SQUARE_SIZE * 2)));
+			CBench::Consume(blockingMap.FindOpenSite(cell, radius, size, predicate).x);
+		}
+	});
+	bench.Run("build_site_low", [&]() {
+		for (const AIFloat3& pos : queries) {
+			const int2 cell(int(pos.x / (SQUARE_SIZE * 2)), int(pos.z / (SQUARE_SIZE * 2)));
+			CBench::Consume(blockingMap.FindOpenSiteLow(cell, radiusLow, size, predicate).x);
+		}
+	});
+}
+
+void BenchEnergy(CBench& bench, const SScenario& scenario, unsigned seed)
+{
+	const CMetalData::Metals& spots = scenario.spots;
+	if (spots.size() < 2) {
+		return;
+	}
+
+	CMetalData metalData;
+	InitMetalData(scenario, metalData);
+	std::shared_ptr<CRagMatrix> matrix = std::make_shared<CRagMatrix>(spots.size());
+	MakeDistMatrix(spots, *matrix);
+	metalData.Clusterize(CLUSTER_DISTANCE, matrix);
+	const CMetalData::Graph& graph = metalData.GetGraph();
+	if ((graph.nodeNum() < 2) || (graph.edgeNum() < 1)) {
+		return;
+	}
+
+	// CEnergyGrid::CalcEdgeCost of valid link that is not built yet, changed links scale it
+	const CMetalData::WeightMap& weights = metalData.GetWeights();
+	const CMetalData::CenterMap& centers = metalData.GetCenters();
+	const AIFloat3 basePos = scenario.startBoxes.empty()
+			? AIFloat3(scenario.GetWidth() / 2, 0.f, scenario.GetDepth() / 2)
+			: scenario.startBoxes.front().pos;
+	const float invBaseWeight = 1.0f / (SQUARE(scenario.GetWidth()) + SQUARE(scenario.GetDepth()));
+	std::vector<float> baseCosts(graph.edgeNum()), linkCosts(graph.edgeNum());
+	for (CMetalData::Graph::EdgeIt edgeIt(graph); edgeIt != lemon::INVALID; ++edgeIt) {
+		baseCosts[graph.id(edgeIt)] = weights[edgeIt] * basePos.SqDistance2D(centers[edgeIt]) * invBaseWeight;
+	}
+	linkCosts = baseCosts;
+	CEnergyTree::CostFunc calcEdgeCost = [&graph, &linkCosts](const CMetalData::Graph::Edge edge) {
+		return linkCosts[graph.id(edge)];
+	};
+
+	std::mt19937 rng(seed);
+	std::vector<bool> owned(graph.nodeNum());
+	for (int i = 0; i < graph.nodeNum(); ++i) {
+		owned[i] = int(rng() % 100) < ENERGY_OWNED;
+	}
+
+	// CEnergyGrid::KruskalTree
+	std::unique_ptr<CEnergyTree> energyTree;
+	auto kruskalTree = [&]() {
+		for (CMetalData::Graph::EdgeIt edgeIt(graph); edgeIt != lemon::INVALID; ++edgeIt) {
+			energyTree->SetCost(edgeIt, calcEdgeCost(edgeIt));
+		}
+		energyTree->Kruskal();
+	};
+	bench.Run("energy_kruskal", [&]() {
+		energyTree.reset(new CEnergyTree(graph));
+		for (int i = 0; i < graph.nodeNum(); ++i) {
+			if (owned[i]) {
+				energyTree->EnableNode(i);
+			}
+		}
+	}, [&]() {
+		kruskalTree();
+		CBench::Consume(energyTree->GetSize());
+	});
+
+	// CEnergyGrid::RebuildTree: lost and captured clusters, changed links
+	std::vector<int> linkClusters, unlinkClusters;
+	std::set<int> dirtyLinks;
+	bench.Run("energy_rebuild_tree", [&]() {
+		linkClusters.clear();
+		unlinkClusters.clear();
+		dirtyLinks.clear();
+		for (int i = 0; i < ENERGY_CHANGES; ++i) {
+			const int index = rng() % graph.nodeNum();
+			if (std::find(linkClusters.begin(), linkClusters.end(), index) != linkClusters.end()
+				|| std::find(unlinkClusters.begin(), unlinkClusters.end(), index) != unlinkClusters.end())
+			{
+				continue;
+			}
+			(owned[index] ? unlinkClusters : linkClusters).push_back(index);
+			owned[index] = !owned[index];
+		}
+		for (int i = 0; i < ENERGY_CHANGES; ++i) {
+			const int edgeIdx = rng() % graph.edgeNum();
+			const float mod = 0.5f + (rng() % 151) / 100.f;  // link finished, invalid or valid again
+			linkCosts[edgeIdx] = baseCosts[edgeIdx] * mod;
+			dirtyLinks.insert(edgeIdx);
+		}
+	}, [&]() {
+		if (!energyTree->Rebuild(unlinkClusters, linkClusters, dirtyLinks, calcEdgeCost)) {
+			for (int index : unlinkClusters) {
+				energyTree->DisableNode(index);
+			}
+			for (int index : linkClusters) {
+				energyTree->EnableNode(index);
+			}
+			kruskalTree();
+		}
+		CBench::Consume(energyTree->GetSize());
+	});
+}
+
+bool CheckKMeans(const SScenario& scenario, unsigned seed)
+{
+	std::vector<AIFloat3> points;
+	for (const SScenario::SEnemy& e : scenario.enemies) {
+		points.push_back(e.pos);
+	}
+	if (points.empty()) {
+		return true;
+	}
+
+	const int k = std::min<int>(KMEANS_GROUPS, points.size());
+	std::mt19937 rng(seed);
+	CKMeansCluster incremental(points.front());
+	for (unsigned i = 0; i < points.size(); ++i) {
+		incremental.SetPoint(i, points[i]);
+	}
+	// Both continue from the same seeded means
+	incremental.Iteration(k);
+	CKMeansReference reference(points.front());
+	reference.SetMeans(incremental.GetMeans());
+
+	// Same positions and the same number of Lloyd steps for both,
+	// bounded assignment must match plain assignment to the means before the step
+	std::vector<std::pair<int, AIFloat3>> moved;
+	std::vector<AIFloat3> prevMeans;
+	float incInertia = 0.f, refInertia = 0.f, maxRatio = 0.f;
+	int mismatches = 0;
+	for (int round = 0; round < KMEANS_ROUNDS; ++round) {
+		MovePoints(rng, points, moved);
+		for (auto& m : moved) {
+			points[m.first] = m.second;
+			incremental.SetPoint(m.first, m.second);
+		}
+		prevMeans = incremental.GetMeans();
+		incremental.Iteration(k);
+		reference.Iteration(points, k);
+
+		for (unsigned i = 0; i < points.size(); ++i) {
+			if (incremental.GetMeanIndex(i) != GetClosestMean(points[i], prevMeans)) {
+				++mismatches;
+			}
+		}
+		incInertia = GetInertia(points, incremental.GetMeans());
+		refInertia = GetInertia(points, reference.GetMeans());
+		if (refInertia > 0.f) {
+			maxRatio = std::max(maxRatio, incInertia / refInertia);
+		}
+	}
+
+	const bool isValid = (mismatches == 0) && (maxRatio <= 1.f + KMEANS_TOLERANCE);
+	printf("kmeans after %i iterations: assignment mismatches %i, inertia incremental %.4g, reference %.4g, "
+			"max ratio %.3f (limit %.2f) %s\n", KMEANS_ROUNDS, mismatches, incInertia, refInertia, maxRatio,
+			1.f + KMEANS_TOLERANCE, isValid ? "OK" : "FAILED");
+	return isValid;
+}
+
+} // namespace circuit
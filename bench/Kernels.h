@@ -0,0 +1,36 @@
+/*
+ * Kernels.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCH_KERNELS_H_
+#define BENCH_KERNELS_H_
+
+namespace circuit {
+
+class CBench;
+struct SScenario;
+
+// CPathFinder over stand-in terrain and threat: every open list, radius search, cost, multi-goal search
+void BenchPather(CBench& bench, const SScenario& scenario, unsigned seed);
+// CKMeansCluster against CKMeansReference, CHierarchCluster, CEncloseCircle
+void BenchCluster(CBench& bench, const SScenario& scenario, unsigned seed);
+// CMetalData: nanoflann spot tree and clusterization
+void BenchMetal(CBench& bench, const SScenario& scenario, unsigned seed);
+// CTerrainData: areas from scratch and update after height map change
+void BenchTerrain(CBench& bench, const SScenario& scenario, unsigned seed);
+// CThreatMap: stamping of all enemies, per second update of moving enemies, decay
+void BenchThreat(CBench& bench, const SScenario& scenario);
+// SBlockingMap: structure marking, FindOpenSite and FindOpenSiteLow scans of FindBuildSite
+void BenchBuildSite(CBench& bench, const SScenario& scenario, unsigned seed);
+// CEnergyGrid::RebuildTree: full Kruskal and CEnergyTree::Rebuild
+void BenchEnergy(CBench& bench, const SScenario& scenario, unsigned seed);
+
+// Incremental CKMeansCluster assigns as plain Lloyd step and its inertia stays within tolerance of CKMeansReference
+bool CheckKMeans(const SScenario& scenario, unsigned seed);
+
+} // namespace circuit
+
+#endif // BENCH_KERNELS_H_
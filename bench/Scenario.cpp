@@ -0,0 +1,240 @@
+/*
+ * Scenario.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "Scenario.h"
+
+#include "json/json.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+
+namespace circuit {
+
+using namespace springai;
+
+#define MAP_UNIT		64  // squares per map size unit
+#define NOISE_OCTAVES	5
+
+namespace {
+
+// Raw generator output is portable, std distributions are not
+float Uniform(std::mt19937& rng, float lo, float hi)
+{
+	return lo + (hi - lo) * (rng() / 4294967296.0f);
+}
+
+class CValueNoise {
+public:
+	CValueNoise(std::mt19937& rng, int cells) : cells(cells) {
+		grid.resize((cells + 1) * (cells + 1));
+		for (float& v : grid) {
+			v = Uniform(rng, 0.f, 1.f);
+		}
+	}
+	float Sample(float u, float v) const {
+		const float x = u * cells;
+		const float z = v * cells;
+		const int x0 = std::min(int(x), cells - 1);
+		const int z0 = std::min(int(z), cells - 1);
+		float fx = x - x0;
+		float fz = z - z0;
+		fx = fx * fx * (3.f - 2.f * fx);
+		fz = fz * fz * (3.f - 2.f * fz);
+		const int row = cells + 1;
+		const float a = grid[z0 * row + x0];
+		const float b = grid[z0 * row + x0 + 1];
+		const float c = grid[(z0 + 1) * row + x0];
+		const float d = grid[(z0 + 1) * row + x0 + 1];
+		const float top = a + (b - a) * fx;
+		return top + (c + (d - c) * fx - top) * fz;
+	}
+private:
+	int cells;
+	std::vector<float> grid;
+};
+
+/*
+ * Same as util/map_gen.py gen_slopes: 1 - normal.y over SLOPE_SIZE squares
+ */
+void MakeSlopes(SScenario& scenario)
+{
+	const int smx = scenario.GetSlopeX();
+	const int smz = scenario.GetSlopeZ();
+	scenario.slopes.resize(smx * smz);
+	for (int sz = 0; sz < smz; ++sz) {
+		const int z = sz * SLOPE_SIZE;
+		const int z2 = std::min(z + SLOPE_SIZE, scenario.mapZ - 1);
+		for (int sx = 0; sx < smx; ++sx) {
+			const int x = sx * SLOPE_SIZE;
+			const int x2 = std::min(x + SLOPE_SIZE, scenario.mapX - 1);
+			const float h = scenario.GetHeight(x, z);
+			const float dx = (scenario.GetHeight(x2, z) - h) / (SLOPE_SIZE * SQUARE_SIZE);
+			const float dz = (scenario.GetHeight(x, z2) - h) / (SLOPE_SIZE * SQUARE_SIZE);
+			scenario.slopes[sz * smx + sx] = 1.f - 1.f / sqrtf(1.f + dx * dx + dz * dz);
+		}
+	}
+}
+
+bool ReadRaw(const std::string& path, std::vector<float>& data)
+{
+	std::ifstream rawFile(path, std::ios::binary);  // little-endian float32
+	return bool(rawFile.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float)));
+}
+
+const char* kindNames[] = {
+	"mex", "defence", "factory", "energy", "artillery", "raider", "assault", "skirmisher", "anti_air", "air"
+};
+static_assert(sizeof(kindNames) / sizeof(kindNames[0]) == static_cast<size_t>(SScenario::SEnemy::Kind::_SIZE_),
+		"kindNames must match SEnemy::Kind");
+
+} // namespace
+
+void SScenario::Generate(int units, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	mapX = mapZ = units * MAP_UNIT;
+
+	std::vector<CValueNoise> octaves;
+	for (int i = 0; i < NOISE_OCTAVES; ++i) {
+		octaves.emplace_back(rng, 4 << i);
+	}
+	heights.resize(mapX * mapZ);
+	for (int z = 0; z < mapZ; ++z) {
+		for (int x = 0; x < mapX; ++x) {
+			float h = 0.f, w = 1.f, norm = 0.f;
+			for (const CValueNoise& o : octaves) {
+				h += w * o.Sample(float(x) / mapX, float(z) / mapZ);
+				norm += w;
+				w *= 0.5f;
+			}
+			heights[z * mapX + x] = -50.f + 450.f * h / norm;
+		}
+	}
+
+	MakeSlopes(*this);
+
+	// Same density rule as CMetalManager::ParseMetalSpots, spots come in small groups
+	const int count = std::max(int((240.f - 80.f) / (SQUARE(24.f) - SQUARE(8.f)) * (SQUARE(units) - SQUARE(8.f)) + 80.f), 8);
+	spots.clear();
+	while (int(spots.size()) < count) {
+		const float cx = Uniform(rng, 0.05f, 0.95f) * GetWidth();
+		const float cz = Uniform(rng, 0.05f, 0.95f) * GetDepth();
+		const int group = 1 + rng() % 3;
+		for (int i = 0; (i < group) && (int(spots.size()) < count); ++i) {
+			AIFloat3 pos(cx + Uniform(rng, -96.f, 96.f), 0.f, cz + Uniform(rng, -96.f, 96.f));
+			pos.x = std::min(std::max(pos.x, 0.f), GetWidth() - 1.f);
+			pos.z = std::min(std::max(pos.z, 0.f), GetDepth() - 1.f);
+			pos.y = GetHeight(int(pos.x) / SQUARE_SIZE, int(pos.z) / SQUARE_SIZE);
+			spots.push_back({Uniform(rng, 1.5f, 3.f), pos});
+		}
+	}
+
+	// Two start boxes on the diagonal, as util/map_gen.py places them for 2 teams
+	startBoxes.clear();
+	for (int i = 0; i < 2; ++i) {
+		const float a = M_PI * i + M_PI * 0.25f;
+		const float cx = GetWidth() * (0.5f + 0.38f * cosf(a));
+		const float cz = GetDepth() * (0.5f + 0.38f * sinf(a));
+		const float hw = GetWidth() * 0.08f;
+		const float hh = GetDepth() * 0.08f;
+		startBoxes.push_back({cx - hw, cz - hh, cx + hw, cz + hh, AIFloat3(cx, 0.f, cz)});
+	}
+
+	// Enemy groups of 4..24 units of the same kind, mobile ones head to AI start
+	const int enemyCount = SQUARE(units) * 8;
+	enemies.clear();
+	while (int(enemies.size()) < enemyCount) {
+		const float cx = Uniform(rng, 0.f, 1.f) * GetWidth();
+		const float cz = Uniform(rng, 0.f, 1.f) * GetDepth();
+		const int group = 4 + rng() % 21;
+		const SEnemy::Kind kind = static_cast<SEnemy::Kind>(rng() % static_cast<unsigned>(SEnemy::Kind::_SIZE_));
+		const AIFloat3 target = (kind < SEnemy::Kind::RAIDER) ? ZeroVector : startBoxes.front().pos;
+		for (int i = 0; (i < group) && (int(enemies.size()) < enemyCount); ++i) {
+			AIFloat3 pos(cx + Uniform(rng, -160.f, 160.f), 0.f, cz + Uniform(rng, -160.f, 160.f));
+			pos.x = std::min(std::max(pos.x, 0.f), GetWidth() - 1.f);
+			pos.z = std::min(std::max(pos.z, 0.f), GetDepth() - 1.f);
+			pos.y = GetHeight(int(pos.x) / SQUARE_SIZE, int(pos.z) / SQUARE_SIZE);
+			enemies.push_back({kind, 0, pos, target});
+		}
+	}
+}
+
+bool SScenario::Load(const std::string& dir)
+{
+	std::ifstream jsonFile(dir + "/scenario.json");
+	if (!jsonFile) {
+		printf("Can't open %s/scenario.json\n", dir.c_str());
+		return false;
+	}
+	std::stringstream ss;
+	ss << jsonFile.rdbuf();
+	const std::string str = ss.str();
+
+	Json::Value json;
+	std::string errs;
+	Json::CharReader* reader = Json::CharReaderBuilder().newCharReader();
+	const bool ok = reader->parse(str.c_str(), str.c_str() + str.size(), &json, &errs);
+	delete reader;
+	if (!ok) {
+		printf("Malformed scenario.json: %s\n", errs.c_str());
+		return false;
+	}
+
+	const Json::Value& hm = json["heightMap"];
+	mapX = hm["width"].asInt();
+	mapZ = hm["height"].asInt();
+	heights.resize(mapX * mapZ);
+	if (!ReadRaw(dir + "/" + hm["file"].asString(), heights)) {
+		printf("Height map is shorter than %ix%i\n", mapX, mapZ);
+		return false;
+	}
+	const Json::Value& sm = json["slopeMap"];
+	if (sm.isNull()) {
+		MakeSlopes(*this);
+	} else {
+		slopes.resize(GetSlopeX() * GetSlopeZ());
+		if ((sm["width"].asInt() != GetSlopeX()) || (sm["height"].asInt() != GetSlopeZ())
+			|| !ReadRaw(dir + "/" + sm["file"].asString(), slopes))
+		{
+			printf("Slope map is not %ix%i\n", GetSlopeX(), GetSlopeZ());
+			return false;
+		}
+	}
+
+	spots.clear();
+	for (const Json::Value& s : json["metalSpots"]) {
+		spots.push_back({s["metal"].asFloat(), AIFloat3(s["x"].asFloat(), s["y"].asFloat(), s["z"].asFloat())});
+	}
+	startBoxes.clear();
+	for (const Json::Value& b : json["startBoxes"]) {
+		startBoxes.push_back({b["left"].asFloat(), b["top"].asFloat(), b["right"].asFloat(), b["bottom"].asFloat(),
+							  AIFloat3(b["x"].asFloat(), 0.f, b["z"].asFloat())});
+	}
+	enemies.clear();
+	for (const Json::Value& e : json["enemies"]) {
+		const std::string name = e["kind"].asString();
+		auto it = std::find_if(std::begin(kindNames), std::end(kindNames), [&name](const char* n) {
+			return name == n;
+		});
+		if (it == std::end(kindNames)) {
+			printf("Unknown enemy kind '%s'\n", name.c_str());
+			return false;
+		}
+		const Json::Value& target = e["target"];
+		enemies.push_back({static_cast<SEnemy::Kind>(std::distance(std::begin(kindNames), it)), e["frame"].asInt(),
+						   AIFloat3(e["x"].asFloat(), e["y"].asFloat(), e["z"].asFloat()),
+						   target.isNull() ? ZeroVector : AIFloat3(target["x"].asFloat(), 0.f, target["z"].asFloat())});
+	}
+	return true;
+}
+
+} // namespace circuit
@@ -0,0 +1,65 @@
+/*
+ * Scenario.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCH_SCENARIO_H_
+#define BENCH_SCENARIO_H_
+
+#include "resource/MetalData.h"
+#include "util/Defines.h"
+
+#include "AIFloat3.h"
+
+#include <string>
+#include <vector>
+
+namespace circuit {
+
+#define SLOPE_SIZE	2  // height map squares per slope map cell
+
+/*
+ * Benchmark input: height and slope maps, metal spots, start boxes and enemies.
+ * Either generated from seed or loaded from util/map_gen.py output.
+ */
+struct SScenario {
+	struct SEnemy {
+		enum class Kind: char {
+			MEX = 0, DEFENCE, FACTORY, ENERGY, ARTILLERY, RAIDER, ASSAULT, SKIRMISHER, ANTI_AIR, AIR, _SIZE_
+		};
+		Kind kind;
+		int frame;  // appearance
+		springai::AIFloat3 pos;
+		springai::AIFloat3 target;  // ZeroVector if static
+	};
+	struct SStartBox {
+		float left;
+		float top;
+		float right;
+		float bottom;
+		springai::AIFloat3 pos;  // centre
+	};
+
+	int mapX;  // height map size in squares
+	int mapZ;
+	std::vector<float> heights;  // Map::GetHeightMap layout
+	std::vector<float> slopes;  // Map::GetSlopeMap layout
+	CMetalData::Metals spots;
+	std::vector<SStartBox> startBoxes;  // AI is in the first one
+	std::vector<SEnemy> enemies;
+
+	void Generate(int units, unsigned seed);
+	bool Load(const std::string& dir);
+
+	float GetHeight(int x, int z) const { return heights[z * mapX + x]; }
+	int GetSlopeX() const { return mapX / SLOPE_SIZE; }
+	int GetSlopeZ() const { return mapZ / SLOPE_SIZE; }
+	float GetWidth() const { return mapX * SQUARE_SIZE; }
+	float GetDepth() const { return mapZ * SQUARE_SIZE; }
+};
+
+} // namespace circuit
+
+#endif // BENCH_SCENARIO_H_
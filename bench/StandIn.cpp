@@ -0,0 +1,267 @@
+/*
+ * StandIn.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "StandIn.h"
+
+#include "terrain/BlockingMap.h"
+#include "terrain/PathFinder.h"
+#include "terrain/TerrainData.h"
+#include "terrain/ThreatGrid.h"
+#include "resource/MetalData.h"
+#include "util/utils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace circuit {
+
+using namespace springai;
+
+#define DECLOAK_RADIUS	128.f
+#define ALLOWED_RANGE	2000.f  // @see CThreatMap::CThreatMap
+#define SLACK_MOD		(2.f / FRAMES_PER_SEC)
+
+namespace {
+
+// MoveDef::maxSlope = 1 - cos(slope * 1.5), minElevation = -depth, maxElevation = -minWaterDepth
+struct SMoveType {
+	float maxSlope;
+	float minElevation;
+	float maxElevation;
+	bool canHover;
+	bool canFloat;
+};
+const SMoveType moveTypes[] = {
+	{0.110f,    -22.f, 1e6f, false, false},  // TANK: 18 degrees
+	{0.412f,    -22.f, 1e6f, false, false},  // BOT: 36 degrees
+	{0.412f,  -5000.f, 1e6f, false, false},  // AMPH
+	{0.110f,      0.f, 1e6f, true,  false},  // HOVER
+	{1.000f,    -1e6f, -10.f, false, true},  // SHIP
+};
+static_assert(sizeof(moveTypes) / sizeof(moveTypes[0]) == static_cast<size_t>(BenchMoveType::_SIZE_),
+		"moveTypes must match BenchMoveType");
+
+// Per kind stand-in of CCircuitDef, ranges are in elmos
+struct SKindDef {
+	float airRange;
+	float landRange;
+	float waterRange;
+	float dps;
+	float health;
+	float speed;  // elmos per second, 0 for static
+	int footprint;  // squares
+	float shieldRadius;
+	float shieldPower;
+};
+const SKindDef kindDefs[] = {
+	{  0.f,    0.f,   0.f,  0.f,  700.f,   0.f, 3,   0.f,    0.f},  // MEX
+	{  0.f,  550.f, 550.f, 30.f, 1500.f,   0.f, 2,   0.f,    0.f},  // DEFENCE
+	{  0.f,    0.f,   0.f,  0.f, 4000.f,   0.f, 7,   0.f,    0.f},  // FACTORY
+	{  0.f,    0.f,   0.f,  0.f,  500.f,   0.f, 5,   0.f,    0.f},  // ENERGY
+	{  0.f, 1800.f,   0.f, 60.f, 1800.f,   0.f, 3,   0.f,    0.f},  // ARTILLERY
+	{  0.f,  240.f,   0.f, 15.f,  300.f,  96.f, 2,   0.f,    0.f},  // RAIDER
+	{  0.f,  330.f,   0.f, 35.f, 2000.f,  54.f, 3, 250.f, 1200.f},  // ASSAULT
+	{  0.f,  460.f,   0.f, 20.f,  600.f,  60.f, 2,   0.f,    0.f},  // SKIRMISHER
+	{700.f,    0.f,   0.f, 40.f,  700.f,  60.f, 2,   0.f,    0.f},  // ANTI_AIR
+	{  0.f,  200.f, 200.f, 25.f,  400.f, 240.f, 2,   0.f,    0.f},  // AIR
+};
+static_assert(sizeof(kindDefs) / sizeof(kindDefs[0]) == static_cast<size_t>(SScenario::SEnemy::Kind::_SIZE_),
+		"kindDefs must match SEnemy::Kind");
+
+// Threat ranges in cells, the same rules as CThreatMap::CThreatMap, GetCloakRange and GetShieldRange
+struct SKindThreat {
+	float threat;
+	int rangeAir;
+	int rangeLand;
+	int rangeWater;
+	int rangeCloak;
+	int rangeShield;
+	float shieldPower;
+};
+
+SKindThreat GetKindThreat(const SScenario::SEnemy& enemy, int squareSize)
+{
+	const SKindDef& def = kindDefs[static_cast<int>(enemy.kind)];
+	const bool isMobile = def.speed > 0.f;
+	const float slack = isMobile ?
+						std::min(SLACK_MOD * def.speed, 5.f) * DEFAULT_SLACK :
+						DEFAULT_SLACK * 3.f;
+	SKindThreat kt;
+	kt.threat = def.dps * sqrtf(def.health + def.shieldPower * 2.0f);
+	kt.rangeAir = (def.airRange > 0.f) ? int(def.airRange + slack) / squareSize : 0;
+	kt.rangeLand = ((def.landRange > 0.f) && (def.landRange <= ALLOWED_RANGE)) ? int(def.landRange + slack) / squareSize : 0;
+	kt.rangeWater = ((def.waterRange > 0.f) && (def.waterRange <= ALLOWED_RANGE)) ? int(def.waterRange + slack) / squareSize : 0;
+	const int size = def.footprint * (SQUARE_SIZE / 2);
+	const int distCloak = (DECLOAK_RADIUS + DEFAULT_SLACK) / squareSize + (isMobile ? (DEFAULT_SLACK * 2) / squareSize : 0);
+	kt.rangeCloak = (int)sqrtf(2 * SQUARE(size)) / squareSize + distCloak;
+	kt.rangeShield = (def.shieldRadius > 0.f) ? (int)def.shieldRadius / squareSize + 1 : 0;
+	kt.shieldPower = def.shieldPower;
+	return kt;
+}
+
+} // namespace
+
+void InitTerrainData(const SScenario& scenario, CTerrainData& terrainData)
+{
+	SAreaData& areaData = *terrainData.pAreaData.load();
+	areaData.mobileType.clear();
+	for (const SMoveType& mt : moveTypes) {
+		STerrainMapMobileType mobileType;
+		mobileType.maxSlope = mt.maxSlope;
+		mobileType.minElevation = mt.minElevation;
+		mobileType.maxElevation = mt.maxElevation;
+		mobileType.canHover = mt.canHover;
+		mobileType.canFloat = mt.canFloat;
+		mobileType.udCount = 1;
+		areaData.mobileType.push_back(mobileType);
+	}
+
+	// Land and floating structures
+	areaData.immobileType.clear();
+	STerrainMapImmobileType immobileType;
+	immobileType.minElevation = 0.f;
+	immobileType.maxElevation = 1e6f;
+	immobileType.udCount = 1;
+	areaData.immobileType.push_back(immobileType);
+	immobileType.minElevation = -1e6f;
+	immobileType.maxElevation = -15.f;
+	immobileType.canFloat = true;
+	areaData.immobileType.push_back(immobileType);
+
+	terrainData.waterIsHarmful = false;
+	terrainData.waterIsAVoid = false;
+	terrainData.InitAreas(scenario.mapX, scenario.mapZ, std::vector<float>(scenario.heights), scenario.slopes);
+}
+
+void InitMetalData(const SScenario& scenario, CMetalData& metalData)
+{
+	metalData.Init(scenario.spots);
+}
+
+void InitThreatGrid(const CTerrainData& terrainData, SThreatGrid& grid)
+{
+	grid.Init(terrainData.sectorXSize + 2, terrainData.sectorZSize + 2);  // +2 for pathfinder edges
+}
+
+float GetSpeed(SScenario::SEnemy::Kind kind)
+{
+	return kindDefs[static_cast<int>(kind)].speed;
+}
+
+void AddEnemy(const CTerrainData& terrainData, SThreatGrid& grid, const SScenario::SEnemy& enemy)
+{
+	const int squareSize = CTerrainData::convertStoP;
+	const SKindThreat kt = GetKindThreat(enemy, squareSize);
+	const int posx = (int)enemy.pos.x / squareSize + 1;
+	const int posz = (int)enemy.pos.z / squareSize + 1;
+	if (kt.rangeAir > 0) {
+		grid.AddAir(posx, posz, kt.threat, kt.rangeAir);
+	}
+	if ((kt.rangeLand > 0) || (kt.rangeWater > 0)) {
+		grid.AddAmph(posx, posz, kt.threat, kt.rangeLand, kt.rangeWater, terrainData.pAreaData.load()->sector);
+	}
+	grid.AddDecloaker(posx, posz, kt.rangeCloak);
+	if (kt.rangeShield > 0) {
+		grid.AddShield(posx, posz, kt.shieldPower, kt.rangeShield);
+	}
+}
+
+void DelEnemy(const CTerrainData& terrainData, SThreatGrid& grid, const SScenario::SEnemy& enemy)
+{
+	const int squareSize = CTerrainData::convertStoP;
+	const SKindThreat kt = GetKindThreat(enemy, squareSize);
+	const int posx = (int)enemy.pos.x / squareSize + 1;
+	const int posz = (int)enemy.pos.z / squareSize + 1;
+	if (kt.rangeAir > 0) {
+		grid.DelAir(posx, posz, kt.threat, kt.rangeAir);
+	}
+	if ((kt.rangeLand > 0) || (kt.rangeWater > 0)) {
+		grid.DelAmph(posx, posz, kt.threat, kt.rangeLand, kt.rangeWater, terrainData.pAreaData.load()->sector);
+	}
+	grid.DelDecloaker(posx, posz, kt.rangeCloak);
+	if (kt.rangeShield > 0) {
+		grid.DelShield(posx, posz, kt.shieldPower, kt.rangeShield);
+	}
+}
+
+void SetPathMapData(CPathFinder& pathfinder, SThreatGrid& grid, int mobileTypeId)
+{
+	float* costArray;
+	if (mobileTypeId < 0) {
+		costArray = grid.airThreat.data();
+	} else if (mobileTypeId == static_cast<int>(BenchMoveType::AMPH)) {
+		costArray = grid.amphThreat.data();
+	} else {
+		costArray = grid.surfThreat.data();
+	}
+	pathfinder.SetMapData(mobileTypeId, costArray);
+}
+
+/*
+ * No Map in bench: height of node's centre square from the stand-in height map
+ */
+float CPathFinder::GetElevation(const AIFloat3& pos) const
+{
+	const int mapWidth = CTerrainData::terrainWidth / SQUARE_SIZE;
+	const int mapHeight = CTerrainData::terrainHeight / SQUARE_SIZE;
+	const int x = utils::clamp(int(pos.x / SQUARE_SIZE), 0, mapWidth - 1);
+	const int z = utils::clamp(int(pos.z / SQUARE_SIZE), 0, mapHeight - 1);
+	return terrainData->GetHeightMap()[z * mapWidth + x];
+}
+
+void InitBlockingMap(const SScenario& scenario, SBlockingMap& blockingMap)
+{
+	blockingMap.columns = scenario.mapX / 2;  // build-step = 2 little green squares
+	blockingMap.rows = scenario.mapZ / 2;
+	SBlockingMap::SBlockCell cell = {};
+	blockingMap.grid.assign(blockingMap.columns * blockingMap.rows, cell);
+	blockingMap.InitBits();
+	blockingMap.columnsLow = scenario.mapX / (GRID_RATIO_LOW * 2);
+	blockingMap.rowsLow = scenario.mapZ / (GRID_RATIO_LOW * 2);
+	SBlockingMap::SBlockCellLow cellLow = {};
+	blockingMap.gridLow.assign(blockingMap.columnsLow * blockingMap.rowsLow, cellLow);
+}
+
+void MarkBlocker(SBlockingMap& blockingMap, const SScenario::SEnemy& enemy, bool block)
+{
+	if (GetSpeed(enemy.kind) > 0.f) {
+		return;
+	}
+
+	const int2 size = GetBuildSize(enemy.kind);
+	const int x1 = int(enemy.pos.x / (SQUARE_SIZE * 2)) - (size.x / 2), x2 = x1 + size.x;
+	const int z1 = int(enemy.pos.z / (SQUARE_SIZE * 2)) - (size.y / 2), z2 = z1 + size.y;
+
+	int2 m1(x1, z1);
+	int2 m2(x2, z2);
+	blockingMap.Bound(m1, m2);
+
+	const SBlockingMap::StructType structType = SBlockingMap::StructType::UNKNOWN;
+	const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
+
+	if (block) {
+		for (int z = m1.y; z < m2.y; z++) {
+			for (int x = m1.x; x < m2.x; x++) {
+				blockingMap.AddStruct(x, z, structType, notIgnore);
+			}
+		}
+	} else {
+		for (int z = m1.y; z < m2.y; z++) {
+			for (int x = m1.x; x < m2.x; x++) {
+				blockingMap.DelStruct(x, z, structType, notIgnore);
+			}
+		}
+	}
+}
+
+int2 GetBuildSize(SScenario::SEnemy::Kind kind)
+{
+	const int size = kindDefs[static_cast<int>(kind)].footprint;  // UnitDef::GetXSize() / 2
+	return int2(size, size);
+}
+
+} // namespace circuit
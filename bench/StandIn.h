@@ -0,0 +1,53 @@
+/*
+ * StandIn.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCH_STANDIN_H_
+#define BENCH_STANDIN_H_
+
+#include "Scenario.h"
+
+#include "System/type2.h"
+
+namespace circuit {
+
+class CTerrainData;
+class CMetalData;
+class CPathFinder;
+struct SThreatGrid;
+struct SBlockingMap;
+
+/*
+ * Stand-ins of the engine callback: production classes are filled from SScenario
+ * the same way their game Init fills them from unit defs and Map.
+ */
+
+// Mobile types of InitTerrainData, index is STerrainMapMobileType::Id
+enum class BenchMoveType: int {TANK = 0, BOT, AMPH, HOVER, SHIP, _SIZE_};
+
+// CTerrainData::Init: fixed set of move types instead of unit defs, then InitAreas
+void InitTerrainData(const SScenario& scenario, CTerrainData& terrainData);
+// CMetalManager::ParseMetalSpots
+void InitMetalData(const SScenario& scenario, CMetalData& metalData);
+// CThreatMap constructor: grid over terrain sectors
+void InitThreatGrid(const CTerrainData& terrainData, SThreatGrid& grid);
+// Elmos per second of enemy kind, 0 for static
+float GetSpeed(SScenario::SEnemy::Kind kind);
+// CThreatMap::AddEnemyUnit / DelEnemyUnit, ranges and threat come from enemy kind
+void AddEnemy(const CTerrainData& terrainData, SThreatGrid& grid, const SScenario::SEnemy& enemy);
+void DelEnemy(const CTerrainData& terrainData, SThreatGrid& grid, const SScenario::SEnemy& enemy);
+// CPathFinder::SetMapData of a unit, mobileTypeId < 0 is air
+void SetPathMapData(CPathFinder& pathfinder, SThreatGrid& grid, int mobileTypeId);
+// CTerrainManager constructor: empty blocking map of build-step cells
+void InitBlockingMap(const SScenario& scenario, SBlockingMap& blockingMap);
+// CTerrainManager::MarkBlocker default marker of static enemy, mobile enemies are skipped
+void MarkBlocker(SBlockingMap& blockingMap, const SScenario::SEnemy& enemy, bool block);
+// Build-step size of structure of enemy kind, facing south
+int2 GetBuildSize(SScenario::SEnemy::Kind kind);
+
+} // namespace circuit
+
+#endif // BENCH_STANDIN_H_
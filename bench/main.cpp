@@ -0,0 +1,78 @@
+/*
+ * main.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ * Micro-benchmarks of engine-independent kernels.
+ * Usage: CircuitBench [-n reps] [-w warmup] [-f filter] [-s map_units] [-r seed] [-i scenario_dir]
+ * scenario_dir is output of util/map_gen.py, without it input is generated from seed.
+ * Exit code is 1 if a correctness check fails.
+ */
+
+#include "Bench.h"
+#include "Kernels.h"
+#include "Scenario.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace circuit;
+
+int main(int argc, char** argv)
+{
+	CBench::SConfig config = {5, 50, ""};
+	int units = 16;
+	unsigned seed = 0;
+	std::string scenarioDir;
+
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+		if (value == nullptr) {
+			printf("Missing value of %s\n", arg);
+			return 1;
+		}
+		if (strcmp(arg, "-n") == 0) {
+			config.reps = std::max(atoi(value), 1);
+		} else if (strcmp(arg, "-w") == 0) {
+			config.warmup = std::max(atoi(value), 0);
+		} else if (strcmp(arg, "-f") == 0) {
+			config.filter = value;
+		} else if (strcmp(arg, "-s") == 0) {
+			units = std::max(atoi(value), 2);
+		} else if (strcmp(arg, "-r") == 0) {
+			seed = strtoul(value, nullptr, 10);
+		} else if (strcmp(arg, "-i") == 0) {
+			scenarioDir = value;
+		} else {
+			printf("Unknown option %s\n", arg);
+			return 1;
+		}
+		++i;
+	}
+
+	SScenario scenario;
+	if (scenarioDir.empty()) {
+		scenario.Generate(units, seed);
+	} else if (!scenario.Load(scenarioDir)) {
+		return 1;
+	}
+	printf("map %ix%i squares, %u spots, %u enemies, seed %u\n", scenario.mapX, scenario.mapZ,
+			unsigned(scenario.spots.size()), unsigned(scenario.enemies.size()), seed);
+
+	CBench bench(config);
+	CBench::PrintHeader();
+	BenchPather(bench, scenario, seed);
+	BenchCluster(bench, scenario, seed);
+	BenchMetal(bench, scenario, seed);
+	BenchTerrain(bench, scenario, seed);
+	BenchThreat(bench, scenario);
+	BenchBuildSite(bench, scenario, seed);
+	BenchEnergy(bench, scenario, seed);
+
+	return CheckKMeans(scenario, seed) ? 0 : 1;
+}
@@ -13,14 +13,17 @@
 #include "module/MilitaryManager.h"
 #include "resource/MetalManager.h"
 #include "terrain/TerrainManager.h"
+#include "terrain/LineOfFire.h"
 #include "terrain/ThreatMap.h"
 #include "terrain/PathFinder.h"
 #include "task/PlayerTask.h"
 #include "unit/CircuitUnit.h"
 #include "unit/EnemyUnit.h"
+#include "unit/EnemyStructures.h"
 #include "util/GameAttribute.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
+#include "json/json.h"
 #ifdef DEBUG_VIS
 #include "resource/EnergyGrid.h"
 #endif
@@ -54,6 +57,7 @@ namespace circuit {
 using namespace springai;
 
 #define ACTION_UPDATE_RATE	128
+#define ACTION_UPDATE_BUDGET	1000  // us
 #define RELEASE_CONFIG		100
 #define RELEASE_COMMANDER	101
 #define RELEASE_CORRUPTED	102
@@ -75,7 +79,7 @@ CCircuitAI::CCircuitAI(OOAICallback* callback)
 		, allyTeam(nullptr)
 		, uEnemyMark(0)
 		, kEnemyMark(0)
-		, actionIterator(0)
+		, actionStagger(ACTION_UPDATE_RATE, ACTION_UPDATE_RATE * 2, ACTION_UPDATE_BUDGET)
 		, isCheating(false)
 		, isAllyAware(true)
 		, isCommMerge(true)
@@ -561,6 +565,8 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 	pathfinder = allyTeam->GetPathfinder();
 
 	terrainManager->Init();
+	lineOfFire = std::make_shared<CLineOfFire>(this, &gameAttribute->GetTerrainData());
+	enemyStructures = std::make_shared<CEnemyStructures>(CTerrainData::terrainWidth, CTerrainData::terrainHeight);
 
 	if (setupManager->HasStartBoxes() && setupManager->CanChooseStartPos()) {
 		const CSetupManager::StartPosType spt = metalManager->HasMetalSpots() ?
@@ -583,6 +589,11 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 
 	uEnemyMark = skirmishAIId % FRAMES_PER_SEC;
 	kEnemyMark = (skirmishAIId + FRAMES_PER_SEC / 2) % FRAMES_PER_SEC;
+	scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CCircuitAI::UpdateRulesParams, this),
+							FRAMES_PER_SEC, (skirmishAIId + FRAMES_PER_SEC / 4) % FRAMES_PER_SEC);
+	if (setupManager->GetConfig()["debug"].get("stagger_stats", false).asBool()) {
+		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CCircuitAI::LogStaggerStats, this), FRAMES_PER_SEC * 60);
+	}
 
 	if (isCheating) {
 		Cheats* cheats = callback->GetCheats();
@@ -620,6 +631,9 @@ int CCircuitAI::Release(int reason)
 
 	if (reason == 1) {  // @see SReleaseEvent
 		gameAttribute->SetGameEnd(true);
+		// ally team shares pathfinder, first released AI reports
+		pathfinder->GetStats().Dump(this);
+		pathfinder->GetStats().Clear();
 	}
 	if (terrainManager != nullptr) {
 		terrainManager->DidUpdateAreaUsers();
@@ -634,6 +648,8 @@ int CCircuitAI::Release(int reason)
 	economyManager = nullptr;
 	factoryManager = nullptr;
 	builderManager = nullptr;
+	lineOfFire = nullptr;
+	enemyStructures = nullptr;
 	terrainManager = nullptr;
 	metalManager = nullptr;
 	pathfinder = nullptr;
@@ -714,6 +730,12 @@ int CCircuitAI::Update(int frame)
 
 int CCircuitAI::Message(int playerId, const char* message)
 {
+	const char cmdPathStats[] = "~pathstats\0";
+	if ((pathfinder != nullptr) && (strcmp(message, cmdPathStats) == 0)) {
+		pathfinder->GetStats().Dump(this);
+		return 0;  // signaling: OK
+	}
+
 #ifdef DEBUG_VIS
 	const char cmdPos[]    = "~стройсь\0";
 	const char cmdSelfD[]  = "~Згинь, нечистая сила!\0";
@@ -944,25 +966,19 @@ int CCircuitAI::EnemyEnterLOS(CEnemyUnit* enemy)
 	if (threatMap->EnemyEnterLOS(enemy)) {
 		militaryManager->AddEnemyCost(enemy);
 	}
+	enemyStructures->AddEnemy(enemy);
 
 	if (isKnownBefore) {
 		return 0;  // signaling: OK
 	}
 	// Force unit's reaction
-	auto friendlies = std::move(callback->GetFriendlyUnitsIn(enemy->GetPos(), 500.0f));
-	if (friendlies.empty()) {
-		return 0;  // signaling: OK
-	}
-	for (Unit* f : friendlies) {
-		if (f == nullptr) {
-			continue;
-		}
-		CCircuitUnit* unit = GetTeamUnit(f->GetUnitId());
+	ForEachFriendlyInRadius(enemy->GetPos(), 500.0f, [this](CAllyUnit* f) {
+		CCircuitUnit* unit = GetTeamUnit(f->GetId());
 		if ((unit != nullptr) && (unit->GetTask() != nullptr)) {
 			unit->ForceExecute();
 		}
-		delete f;
-	}
+		return false;
+	});
 
 	return 0;  // signaling: OK
 }
@@ -1002,6 +1018,7 @@ int CCircuitAI::EnemyDestroyed(CEnemyUnit* enemy)
 	if (threatMap->EnemyDestroyed(enemy)) {
 		militaryManager->DelEnemyCost(enemy);
 	}
+	enemyStructures->RemoveEnemy(enemy);
 
 	return 0;  // signaling: OK
 }
@@ -1048,7 +1065,7 @@ int CCircuitAI::Load(std::istream& is)
 	}
 	for (auto& kv : teamUnits) {
 		CCircuitUnit* unit = kv.second;
-		if (unit->GetUnit()->GetRulesParamFloat("disableAiControl", 0) > 0.f) {
+		if (unit->GetRulesParam(CCircuitUnit::RulesParam::DISABLE_AI_CONTROL, lastFrame) > 0.f) {
 			DisableControl(unit);
 		}
 	}
@@ -1166,6 +1183,18 @@ CAllyUnit* CCircuitAI::GetFriendlyUnit(Unit* u) const
 	return nullptr;
 }
 
+void CCircuitAI::ForEachFriendlyInRadius(const AIFloat3& pos, float radius, const CAllyTeam::FriendlyFunc& func)
+{
+	allyTeam->ForEachFriendlyInRadius(this, pos, radius, [this, &func](CAllyUnit* unit) {
+		CCircuitUnit* teamUnit = GetTeamUnit(unit->GetId());
+		if (teamUnit != nullptr) {
+			return func(teamUnit);
+		}
+		// NOTE: OOAICallback::GetFriendlyUnits may return yet unregistered units created in GamePreload
+		return (sAICallback->Unit_getTeam(skirmishAIId, unit->GetId()) != teamId) && func(unit);
+	});
+}
+
 std::pair<CEnemyUnit*, bool> CCircuitAI::RegisterEnemyUnit(ICoreUnit::Id unitId, bool isInLOS)
 {
 	CEnemyUnit* unit = GetEnemyUnit(unitId);
@@ -1317,29 +1346,49 @@ void CCircuitAI::EnableControl(const std::string data)
 	}
 }
 
-void CCircuitAI::ActionUpdate()
+void CCircuitAI::LogStaggerStats()
 {
-	if (actionIterator >= actionUnits.size()) {
-		actionIterator = 0;
+	auto logStagger = [this](const char* name, const CStagger& stagger) {
+		LOG("<Stagger> %i: %s | cycle: %u | worst: %u | overruns: %u | backlog: %u | avg: %.1f us", skirmishAIId, name,
+			stagger.GetLastCycle(), stagger.GetWorstCycle(), stagger.GetOverruns(), stagger.GetBacklog(), stagger.GetAvgCost());
+	};
+	logStagger("action", actionStagger);
+	logStagger("fight", militaryManager->GetFightStagger());
+	logStagger("build", builderManager->GetBuildStagger());
+	logStagger("factory", factoryManager->GetUpdateStagger());
+}
+
+void CCircuitAI::UpdateRulesParams()
+{
+	CCircuitUnit::SRulesStats stats = {0, 0};
+	for (auto& kv : teamUnits) {
+		CCircuitUnit* unit = kv.second;
+		const CCircuitUnit::SRulesStats us = unit->PopRulesStats();
+		stats.reads += us.reads;
+		stats.hits += us.hits;
+		unit->RefreshRulesParams(lastFrame);
 	}
+#ifdef DEBUG_LOG
+	if (lastFrame % (FRAMES_PER_SEC * 60) < FRAMES_PER_SEC) {
+		LOG("AI: %i | RulesParam per frame: %.1f engine reads | %.1f cached", skirmishAIId,
+			float(stats.reads) / FRAMES_PER_SEC, float(stats.hits) / FRAMES_PER_SEC);
+	}
+#endif
+}
 
+void CCircuitAI::ActionUpdate()
+{
 	// stagger the Update's
-	unsigned int n = (actionUnits.size() / ACTION_UPDATE_RATE) + 1;
-
-	while ((actionIterator < actionUnits.size()) && (n != 0)) {
-		CCircuitUnit* unit = actionUnits[actionIterator];
+	actionStagger.Update(actionUnits, [this](CCircuitUnit* unit) {
 		if (unit->IsDead()) {
-			actionUnits[actionIterator] = actionUnits.back();
-			actionUnits.pop_back();
 			DeleteTeamUnit(unit);
-		} else {
-			if (unit->GetTask()->GetType() != IUnitTask::Type::PLAYER) {
-				unit->Update(this);
-			}
-			++actionIterator;
-			n--;
+			return false;
 		}
-	}
+		if (unit->GetTask()->GetType() != IUnitTask::Type::PLAYER) {
+			unit->Update(this);
+		}
+		return true;
+	});
 }
 
 std::string CCircuitAI::InitOptions()
@@ -11,6 +11,7 @@
 #include "unit/AllyTeam.h"
 #include "unit/CircuitDef.h"
 #include "util/Defines.h"
+#include "util/Stagger.h"
 
 #include <memory>
 #include <unordered_map>
@@ -50,6 +51,8 @@ class CSetupManager;
 class CThreatMap;
 class CPathFinder;
 class CTerrainManager;
+class CLineOfFire;
+class CEnemyStructures;
 class CBuilderManager;
 class CFactoryManager;
 class CEconomyManager;
@@ -148,6 +151,8 @@ public:
 	CAllyUnit* GetFriendlyUnit(springai::Unit* u) const;
 	CAllyUnit* GetFriendlyUnit(ICoreUnit::Id unitId) const { return allyTeam->GetFriendlyUnit(unitId); }
 	const CAllyTeam::Units& GetFriendlyUnits() const { return allyTeam->GetFriendlyUnits(); }
+	// Own units are passed as CCircuitUnit
+	void ForEachFriendlyInRadius(const springai::AIFloat3& pos, float radius, const CAllyTeam::FriendlyFunc& func);
 
 	using EnemyUnits = std::map<ICoreUnit::Id, CEnemyUnit*>;
 private:
@@ -169,7 +174,9 @@ public:
 	void AddActionUnit(CCircuitUnit* unit) { actionUnits.push_back(unit); }
 
 private:
+	void UpdateRulesParams();
 	void ActionUpdate();
+	void LogStaggerStats();
 
 	Units teamUnits;  // owner
 	EnemyUnits enemyUnits;  // owner
@@ -178,7 +185,7 @@ private:
 	int kEnemyMark;
 
 	std::vector<CCircuitUnit*> actionUnits;
-	unsigned int actionIterator;
+	CStagger actionStagger;
 
 	std::set<CCircuitUnit*> garbage;
 // ---- Units ---- END
@@ -218,6 +225,7 @@ public:
 	std::shared_ptr<CScheduler>& GetScheduler() { return scheduler; }
 	int GetLastFrame()    const { return lastFrame; }
 	int GetSkirmishAIId() const { return skirmishAIId; }
+	const struct SSkirmishAICallback* GetSkirmishAICallback() const { return sAICallback; }
 	int GetTeamId()       const { return teamId; }
 	int GetAllyTeamId()   const { return allyTeamId; }
 	springai::OOAICallback* GetCallback()   const { return callback; }
@@ -234,6 +242,8 @@ public:
 	CThreatMap*       GetThreatMap()       const { return threatMap.get(); }
 	CPathFinder*      GetPathfinder()      const { return pathfinder.get(); }
 	CTerrainManager*  GetTerrainManager()  const { return terrainManager.get(); }
+	CLineOfFire*      GetLineOfFire()      const { return lineOfFire.get(); }
+	CEnemyStructures* GetEnemyStructures() const { return enemyStructures.get(); }
 	CBuilderManager*  GetBuilderManager()  const { return builderManager.get(); }
 	CFactoryManager*  GetFactoryManager()  const { return factoryManager.get(); }
 	CEconomyManager*  GetEconomyManager()  const { return economyManager.get(); }
@@ -276,6 +286,8 @@ private:
 	std::shared_ptr<CThreatMap> threatMap;
 	std::shared_ptr<CPathFinder> pathfinder;
 	std::shared_ptr<CTerrainManager> terrainManager;
+	std::shared_ptr<CLineOfFire> lineOfFire;
+	std::shared_ptr<CEnemyStructures> enemyStructures;
 	std::shared_ptr<CBuilderManager> builderManager;
 	std::shared_ptr<CFactoryManager> factoryManager;
 	std::shared_ptr<CEconomyManager> economyManager;
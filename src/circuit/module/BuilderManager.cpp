@@ -43,15 +43,21 @@
 #include "Command.h"
 #include "Log.h"
 
+#include <numeric>
+
 namespace circuit {
 
 using namespace springai;
 
+#define ASSIGN_CANDIDATES	4
+#define ASSIGN_BATCH_SIZE	16
+#define BUILD_UPDATE_BUDGET	1000  // us
+
 CBuilderManager::CBuilderManager(CCircuitAI* circuit)
 		: IUnitModule(circuit)
 		, buildTasksCount(0)
 		, buildPower(.0f)
-		, buildIterator(0)
+		, buildStagger(TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 2, BUILD_UPDATE_BUDGET)
 {
 	CScheduler* scheduler = circuit->GetScheduler().get();
 	scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CBuilderManager::Watchdog, this),
@@ -200,6 +206,10 @@ CBuilderManager::CBuilderManager(CCircuitAI* circuit)
 	ReadConfig();
 
 	buildTasks.resize(static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::_SIZE_));
+	taskGrids.resize(static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::_SIZE_));
+	for (CBuilderTaskGrid& grid : taskGrids) {
+		grid.Init(CTerrainData::terrainWidth, CTerrainData::terrainHeight);
+	}
 
 	for (auto mtId : workerMobileTypes) {
 		for (auto& area : terrainManager->GetMobileTypeById(mtId)->area) {
@@ -330,13 +340,13 @@ int CBuilderManager::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 
 void CBuilderManager::AddBuildPower(CCircuitUnit* unit)
 {
-	buildPower += unit->GetBuildSpeed();
+	buildPower += unit->GetBuildSpeed(circuit->GetLastFrame());
 	circuit->GetMilitaryManager()->AddResponse(unit);
 }
 
 void CBuilderManager::DelBuildPower(CCircuitUnit* unit)
 {
-	buildPower -= unit->GetBuildSpeed();
+	buildPower -= unit->GetBuildSpeed(circuit->GetLastFrame());
 	circuit->GetMilitaryManager()->DelResponse(unit);
 }
 
@@ -346,16 +356,40 @@ const std::set<IBuilderTask*>& CBuilderManager::GetTasks(IBuilderTask::BuildType
 	return buildTasks[static_cast<IBuilderTask::BT>(type)];
 }
 
+IBuilderTask* CBuilderManager::FindTaskNear(IBuilderTask::BuildType type, const AIFloat3& position, float radius,
+										   const CBuilderTaskGrid::TaskFunc& predicate)
+{
+	assert(type < IBuilderTask::BuildType::_SIZE_);
+	CBuilderTaskGrid& grid = taskGrids[static_cast<IBuilderTask::BT>(type)];
+	grid.Refresh(circuit->GetLastFrame());
+	return grid.FindNear(position, radius, predicate);
+}
+
+void CBuilderManager::FindNearestTasks(IBuilderTask::BuildType type, const AIFloat3& position, unsigned k,
+									   std::vector<IBuilderTask*>& outTasks)
+{
+	assert(type < IBuilderTask::BuildType::_SIZE_);
+	CBuilderTaskGrid& grid = taskGrids[static_cast<IBuilderTask::BT>(type)];
+	grid.Refresh(circuit->GetLastFrame());
+	grid.FindNearest(position, k, outTasks);
+}
+
 void CBuilderManager::ActivateTask(IBuilderTask* task)
 {
 	if ((task->GetType() == IUnitTask::Type::BUILDER) && (task->GetBuildType() < IBuilderTask::BuildType::_SIZE_)) {
-		buildTasks[static_cast<IBuilderTask::BT>(task->GetBuildType())].insert(task);
-		buildTasksCount++;
+		AddBuildTask(task, task->GetBuildType());
 	}
 	buildUpdates.push_back(task);
 	task->Activate();
 }
 
+void CBuilderManager::AddBuildTask(IBuilderTask* task, IBuilderTask::BuildType type)
+{
+	buildTasks[static_cast<IBuilderTask::BT>(type)].insert(task);
+	taskGrids[static_cast<IBuilderTask::BT>(type)].AddTask(task);
+	buildTasksCount++;
+}
+
 IBuilderTask* CBuilderManager::EnqueueTask(IBuilderTask::Priority priority,
 										   CCircuitDef* buildDef,
 										   const AIFloat3& position,
@@ -391,8 +425,7 @@ IBuilderTask* CBuilderManager::EnqueueFactory(IBuilderTask::Priority priority,
 	const float cost = isPlop ? 1.f : buildDef->GetCost();
 	IBuilderTask* task = new CBFactoryTask(this, priority, buildDef, position, cost, shake, isPlop, timeout);
 	if (isActive) {
-		buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::FACTORY)].insert(task);
-		buildTasksCount++;
+		AddBuildTask(task, IBuilderTask::BuildType::FACTORY);
 		buildUpdates.push_back(task);
 	} else {
 		task->Deactivate();
@@ -410,8 +443,7 @@ IBuilderTask* CBuilderManager::EnqueuePylon(IBuilderTask::Priority priority,
 {
 	IBuilderTask* task = new CBPylonTask(this, priority, buildDef, position, link, cost, timeout);
 	if (isActive) {
-		buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::PYLON)].insert(task);
-		buildTasksCount++;
+		AddBuildTask(task, IBuilderTask::BuildType::PYLON);
 		buildUpdates.push_back(task);
 	} else {
 		task->Deactivate();
@@ -428,8 +460,7 @@ IBuilderTask* CBuilderManager::EnqueueRepair(IBuilderTask::Priority priority,
 		return it->second;
 	}
 	CBRepairTask* task = new CBRepairTask(this, priority, target, timeout);
-	buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::REPAIR)].insert(task);
-	buildTasksCount++;
+	AddBuildTask(task, IBuilderTask::BuildType::REPAIR);
 	buildUpdates.push_back(task);
 	repairedUnits[target->GetId()] = task;
 	return task;
@@ -443,8 +474,7 @@ IBuilderTask* CBuilderManager::EnqueueReclaim(IBuilderTask::Priority priority,
 											  bool isMetal)
 {
 	IBuilderTask* task = new CBReclaimTask(this, priority, position, cost, timeout, radius, isMetal);
-	buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::RECLAIM)].insert(task);
-	buildTasksCount++;
+	AddBuildTask(task, IBuilderTask::BuildType::RECLAIM);
 	buildUpdates.push_back(task);
 	return task;
 }
@@ -458,8 +488,7 @@ IBuilderTask* CBuilderManager::EnqueueReclaim(IBuilderTask::Priority priority,
 		return it->second;
 	}
 	CBReclaimTask* task = new CBReclaimTask(this, priority, target, timeout);
-	buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::RECLAIM)].insert(task);
-	buildTasksCount++;
+	AddBuildTask(task, IBuilderTask::BuildType::RECLAIM);
 	buildUpdates.push_back(task);
 	reclaimedUnits[target] = task;
 	return task;
@@ -489,8 +518,7 @@ IBuilderTask* CBuilderManager::EnqueueTerraform(IBuilderTask::Priority priority,
 		task = new CBTerraformTask(this, priority, target, cost, timeout);
 	}
 	if (isActive) {
-		buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::TERRAFORM)].insert(task);
-		buildTasksCount++;
+		AddBuildTask(task, IBuilderTask::BuildType::TERRAFORM);
 		buildUpdates.push_back(task);
 	} else {
 		task->Deactivate();
@@ -572,8 +600,7 @@ IBuilderTask* CBuilderManager::AddTask(IBuilderTask::Priority priority,
 	}
 
 	if (isActive) {
-		buildTasks[static_cast<IBuilderTask::BT>(type)].insert(task);
-		buildTasksCount++;
+		AddBuildTask(task, type);
 		buildUpdates.push_back(task);
 	} else {
 		task->Deactivate();
@@ -599,6 +626,7 @@ void CBuilderManager::DequeueTask(IBuilderTask* task, bool done)
 				} break;
 			}
 			tasks.erase(it);
+			taskGrids[static_cast<IBuilderTask::BT>(task->GetBuildType())].RemoveTask(task);
 			buildTasksCount--;
 		}
 	}
@@ -929,17 +957,34 @@ IBuilderTask* CBuilderManager::MakeCommTask(CCircuitUnit* unit)
 
 IBuilderTask* CBuilderManager::MakeBuilderTask(CCircuitUnit* unit)
 {
+	AIFloat3 pos = unit->GetPos(circuit->GetLastFrame());
+	IBuilderTask* task = circuit->GetEconomyManager()->MakeEconomyTasks(pos, unit);
+
+	std::vector<SCandidate> candidates;
+	CollectBuilderTasks(unit, 1, candidates);
+	if (!candidates.empty()) {
+		task = candidates.front().task;
+	}
+
+	if (task == nullptr) {
+		if (unit->GetTask() != idleTask) {
+			return nullptr;  // current task is in danger or unreachable
+		}
+		task = CreateBuilderTask(pos, unit);
+	}
+
+	return task;
+}
+
+void CBuilderManager::CollectBuilderTasks(CCircuitUnit* unit, unsigned maxCount, std::vector<SCandidate>& outCandidates)
+{
+	outCandidates.clear();
 	CThreatMap* threatMap = circuit->GetThreatMap();
 	threatMap->SetThreatType(unit);
-	const IBuilderTask* task = nullptr;
 	const int frame = circuit->GetLastFrame();
-	AIFloat3 pos = unit->GetPos(frame);
+	const AIFloat3& pos = unit->GetPos(frame);
 
 	CEconomyManager* economyManager = circuit->GetEconomyManager();
-	task = economyManager->MakeEconomyTasks(pos, unit);
-//	if (task != nullptr) {
-//		return task;
-//	}
 	const bool isStalling = economyManager->IsMetalEmpty() &&
 							(economyManager->GetAvgMetalIncome() * 1.2f < economyManager->GetMetalPull()) &&
 							(metalPull > economyManager->GetPullMtoS() * circuit->GetFactoryManager()->GetMetalPull());
@@ -953,82 +998,226 @@ IBuilderTask* CBuilderManager::MakeBuilderTask(CCircuitUnit* unit)
 	const float maxSpeed = cdef->GetSpeed() / pathfinder->GetSquareSize() * THREAT_BASE;
 	const float maxThreat = threatMap->GetUnitThreat(unit);
 	const int buildDistance = std::max<int>(cdef->GetBuildDistance(), pathfinder->GetSquareSize());
-	float metric = std::numeric_limits<float>::max();
-	for (const std::set<IBuilderTask*>& tasks : buildTasks) {
-		for (const IBuilderTask* candidate : tasks) {
-			if (!candidate->CanAssignTo(unit) || (isNotReady &&
-												  (candidate->GetPriority() != IBuilderTask::Priority::NOW) &&
-												  (candidate->GetBuildDef() != nullptr) &&
-												  !economyManager->IsIgnoreStallingPull(candidate)))
-			{
-				continue;
+	auto getWeight = [](const IBuilderTask* candidate) {
+		const float weight = (static_cast<float>(candidate->GetPriority()) + 1.0f);
+		return 1.0f / SQUARE(weight);
+	};
+
+	// Cheap filters, metric by lower bound of path cost (straight distance in path squares)
+	std::vector<SCandidate> bounds;
+	auto gather = [&](IBuilderTask* candidate) {
+		if (!candidate->CanAssignTo(unit) || (isNotReady &&
+											  (candidate->GetPriority() != IBuilderTask::Priority::NOW) &&
+											  (candidate->GetBuildDef() != nullptr) &&
+											  !economyManager->IsIgnoreStallingPull(candidate)))
+		{
+			return false;
+		}
+
+		const AIFloat3& bp = candidate->GetPosition();
+		const AIFloat3& buildPos = utils::is_valid(bp) ? bp : pos;
+		if (candidate->GetPriority() < IBuilderTask::Priority::HIGH) {
+			CCircuitDef* buildDef = candidate->GetBuildDef();
+			const float buildThreat = (buildDef != nullptr) ? buildDef->GetPower() : 0.f;
+			if (threatMap->GetThreatAt(buildPos) > maxThreat + buildThreat) {
+				return false;
 			}
+		}
+		if (!terrainManager->CanBuildAt(unit, buildPos)) {  // ensure that path always exists
+			return false;
+		}
 
-			// Check time-distance to target
+		const float distCost = std::max((pos.distance2D(buildPos) - buildDistance) / pathfinder->GetSquareSize(), THREAT_BASE);
+		bounds.push_back(SCandidate {candidate, distCost * getWeight(candidate)});
+		return false;
+	};
+
+	// Path costs in order of lower bounds, until bound exceeds the worst kept candidate
+	auto refine = [&]() {
+		std::sort(bounds.begin(), bounds.end(), [](const SCandidate& a, const SCandidate& b) {
+			return a.metric < b.metric;
+		});
+		for (const SCandidate& bound : bounds) {
+			if ((outCandidates.size() >= maxCount) && (bound.metric >= outCandidates.back().metric)) {
+				break;
+			}
+			IBuilderTask* candidate = bound.task;
 			const AIFloat3& bp = candidate->GetPosition();
 			AIFloat3 buildPos = utils::is_valid(bp) ? bp : pos;
 
 			float distCost;
 			if (candidate->GetPriority() >= IBuilderTask::Priority::HIGH) {
 				// Disregard safety
-				if (!terrainManager->CanBuildAt(unit, buildPos)) {  // ensure that path always exists
-					continue;
-				}
-
 				distCost = pathfinder->PathCost(pos, buildPos, buildDistance);
-
 			} else {
-
-				CCircuitDef* buildDef = candidate->GetBuildDef();
-				const float buildThreat = (buildDef != nullptr) ? buildDef->GetPower() : 0.f;
-				if ((threatMap->GetThreatAt(buildPos) > maxThreat + buildThreat) ||
-					!terrainManager->CanBuildAt(unit, buildPos))  // ensure that path always exists
-				{
-					continue;
-				}
-
-				// FIXME: Lags on large maps
 				distCost = pathfinder->PathCostDirect(pos, buildPos, buildDistance);
 				if (distCost < 0.0f) {
 					continue;
 				}
 			}
-
 			distCost = std::max(distCost, THREAT_BASE);
 
-			float weight = (static_cast<float>(candidate->GetPriority()) + 1.0f);
-			weight = 1.0f / SQUARE(weight);
-			bool valid = false;
-
 			CCircuitUnit* target = candidate->GetTarget();
 			if (target != nullptr) {
-				if (distCost * weight < metric) {
-					// BA: float time_to_build = targetDef->GetBuildTime() / workerDef->GetBuildSpeed();
-					Unit* tu = target->GetUnit();
-					const float maxHealth = tu->GetMaxHealth();
-					const float health = tu->GetHealth() - maxHealth * 0.005f;
-					const float healthSpeed = maxHealth * candidate->GetBuildPower() / candidate->GetCost();
-					valid = (((maxHealth - health) * 0.6f) * maxSpeed > healthSpeed * distCost);
+				// BA: float time_to_build = targetDef->GetBuildTime() / workerDef->GetBuildSpeed();
+				Unit* tu = target->GetUnit();
+				const float maxHealth = tu->GetMaxHealth();
+				const float health = tu->GetHealth() - maxHealth * 0.005f;
+				const float healthSpeed = maxHealth * candidate->GetBuildPower() / candidate->GetCost();
+				if (((maxHealth - health) * 0.6f) * maxSpeed <= healthSpeed * distCost) {
+					continue;
 				}
-			} else {
-				valid = (distCost * weight < metric)/* && (distCost < MAX_TRAVEL_SEC * maxSpeed)*/;
 			}
 
-			if (valid) {
-				task = candidate;
-				metric = distCost * weight;
+			const SCandidate result {candidate, distCost * getWeight(candidate)};
+			auto it = std::upper_bound(outCandidates.begin(), outCandidates.end(), result,
+					[](const SCandidate& a, const SCandidate& b) { return a.metric < b.metric; });
+			outCandidates.insert(it, result);
+			if (outCandidates.size() > maxCount) {
+				outCandidates.pop_back();
+			}
+		}
+		bounds.clear();
+	};
+
+	/*
+	 * Horizon cuts only LOW/NORMAL tasks: far ones are considered when nothing suitable is near.
+	 * Far NOW/HIGH tasks always compete by priority-weighted metric.
+	 */
+	const float horizon = cdef->GetSpeed() * MAX_TRAVEL_SEC;
+	const float sqHorizon = SQUARE(horizon);
+	auto gatherFar = [&](bool isUrgent) {
+		for (const std::set<IBuilderTask*>& tasks : buildTasks) {
+			for (IBuilderTask* candidate : tasks) {
+				const AIFloat3& tp = candidate->GetTaskPos();
+				if (!utils::is_valid(tp) || (pos.SqDistance2D(tp) <= sqHorizon)) {
+					continue;  // near tasks
+				}
+				if ((candidate->GetPriority() >= IBuilderTask::Priority::HIGH) == isUrgent) {
+					gather(candidate);
+				}
 			}
 		}
+	};
+	for (CBuilderTaskGrid& grid : taskGrids) {
+		grid.Refresh(frame);
+		grid.ForEachInRadius(pos, horizon, gather);
 	}
+	gatherFar(true);
+	refine();
+	if (outCandidates.empty()) {
+		gatherFar(false);
+		refine();
+	}
+}
 
-	if (task == nullptr) {
-		if (unit->GetTask() != idleTask) {
-			return nullptr;  // current task is in danger or unreachable
+void CBuilderManager::AssignIdleBatch()
+{
+	std::set<CCircuitUnit*>& newIdlers = idleTask->GetNewUnits();
+	if (newIdlers.size() < 2) {
+		newIdlers.clear();  // nothing to balance, MakeTask handles single worker
+		return;
+	}
+
+	// Sparse cost matrix: few best candidates of each worker
+	const int frame = circuit->GetLastFrame();
+	std::vector<CCircuitUnit*> batchUnits;
+	std::vector<CCircuitUnit*> emptyUnits;  // examined, no candidates
+	std::vector<std::pair<int, int>> ranges;  // worker: [first, last) of bids
+	std::vector<std::pair<int, float>> bids;  // task index, metric
+	std::vector<IBuilderTask*> batchTasks;
+	std::unordered_map<IBuilderTask*, int> taskIndices;
+	std::vector<SCandidate> candidates;
+	float maxMetric = 0.f;
+	unsigned examined = 0;
+	auto iter = newIdlers.begin();
+	while ((iter != newIdlers.end()) && (examined < ASSIGN_BATCH_SIZE)) {
+		CCircuitUnit* unit = *iter;
+		iter = newIdlers.erase(iter);
+		if (unit->GetCircuitDef()->IsRoleComm() && (circuit->GetSetupManager()->GetHide(unit->GetCircuitDef()) != nullptr)) {
+			continue;  // commander may hide instead, @see MakeTask
+		}
+		++examined;
+		// NOTE: Throttled per nearest metal cluster, builders of other clusters need own call
+		circuit->GetEconomyManager()->MakeEconomyTasks(unit->GetPos(frame), unit);
+		CollectBuilderTasks(unit, ASSIGN_CANDIDATES, candidates);
+		if (candidates.empty()) {
+			emptyUnits.push_back(unit);
+			continue;
+		}
+		ranges.push_back(std::make_pair(bids.size(), bids.size() + candidates.size()));
+		batchUnits.push_back(unit);
+		for (const SCandidate& c : candidates) {
+			auto it = taskIndices.find(c.task);
+			if (it == taskIndices.end()) {
+				it = taskIndices.emplace(c.task, batchTasks.size()).first;
+				batchTasks.push_back(c.task);
+			}
+			bids.push_back(std::make_pair(it->second, c.metric));
+			maxMetric = std::max(maxMetric, c.metric);
 		}
-		task = CreateBuilderTask(pos, unit);
 	}
 
-	return const_cast<IBuilderTask*>(task);
+	/*
+	 * Auction algorithm (Bertsekas) for one-to-one min-cost assignment of LOW/NORMAL tasks.
+	 * NOW/HIGH tasks are not auctioned, any number of workers may assist them.
+	 * Option "no task" costs more than any candidate.
+	 */
+	const float noneValue = -(maxMetric * 2.f + 1.f);
+	const float eps = (maxMetric + 1.f) * 1e-3f / std::max<unsigned>(batchUnits.size(), 1);
+	std::vector<float> prices(batchTasks.size(), 0.f);
+	std::vector<int> owners(batchTasks.size(), -1);
+	std::vector<int> assigned(batchUnits.size(), -1);
+	std::vector<int> queue(batchUnits.size());
+	std::iota(queue.begin(), queue.end(), 0);
+	while (!queue.empty()) {
+		const int i = queue.back();
+		queue.pop_back();
+		int bestTask = -1;
+		float bestValue = noneValue;
+		float secondValue = noneValue;
+		for (int b = ranges[i].first; b < ranges[i].second; ++b) {
+			const float value = -bids[b].second - prices[bids[b].first];
+			if (value > bestValue) {
+				secondValue = bestValue;
+				bestValue = value;
+				bestTask = bids[b].first;
+			} else if (value > secondValue) {
+				secondValue = value;
+			}
+		}
+		if (bestTask < 0) {
+			continue;
+		}
+		assigned[i] = bestTask;
+		if (batchTasks[bestTask]->GetPriority() >= IBuilderTask::Priority::HIGH) {
+			continue;
+		}
+		prices[bestTask] += bestValue - secondValue + eps;
+		if (owners[bestTask] >= 0) {
+			assigned[owners[bestTask]] = -1;
+			queue.push_back(owners[bestTask]);
+		}
+		owners[bestTask] = i;
+	}
+
+	for (unsigned i = 0; i < batchUnits.size(); ++i) {
+		CCircuitUnit* unit = batchUnits[i];
+		// Outbid worker takes its best candidate, as MakeBuilderTask would
+		IBuilderTask* task = batchTasks[(assigned[i] < 0) ? bids[ranges[i].first].first : assigned[i]];
+		if (task->CanAssignTo(unit)) {
+			task->AssignTo(unit);  // removes unit from idleTask
+			task->Execute(unit);
+		}
+	}
+	// Candidates were already checked, skip the rest of MakeBuilderTask
+	for (CCircuitUnit* unit : emptyUnits) {
+		IBuilderTask* task = CreateBuilderTask(unit->GetPos(frame), unit);
+		if (task != nullptr) {
+			task->AssignTo(unit);
+			task->Execute(unit);
+		}
+	}
 }
 
 IBuilderTask* CBuilderManager::CreateBuilderTask(const AIFloat3& position, CCircuitUnit* unit)
@@ -1173,38 +1362,29 @@ void CBuilderManager::Watchdog()
 void CBuilderManager::UpdateIdle()
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
+	AssignIdleBatch();
 	idleTask->Update();
 }
 
 void CBuilderManager::UpdateBuild()
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	if (buildIterator >= buildUpdates.size()) {
-		buildIterator = 0;
-	}
-
 	int lastFrame = circuit->GetLastFrame();
 	// stagger the Update's
-	unsigned int n = (buildUpdates.size() / TEAM_SLOWUPDATE_RATE) + 1;
-
-	while ((buildIterator < buildUpdates.size()) && (n != 0)) {
-		IUnitTask* task = buildUpdates[buildIterator];
+	buildStagger.Update(buildUpdates, [this, lastFrame](IUnitTask* task) {
 		if (task->IsDead()) {
-			buildUpdates[buildIterator] = buildUpdates.back();
-			buildUpdates.pop_back();
 			delete task;
+			return false;
+		}
+		int frame = task->GetLastTouched();
+		int timeout = task->GetTimeout();
+		if ((frame != -1) && (timeout > 0) && (lastFrame - frame >= timeout)) {
+			AbortTask(task);
 		} else {
-			int frame = task->GetLastTouched();
-			int timeout = task->GetTimeout();
-			if ((frame != -1) && (timeout > 0) && (lastFrame - frame >= timeout)) {
-				AbortTask(task);
-			} else {
-				task->Update();
-			}
-			++buildIterator;
-			n--;
+			task->Update();
 		}
-	}
+		return true;
+	});
 }
 
 void CBuilderManager::UpdateAreaUsers()
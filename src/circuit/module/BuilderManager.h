@@ -10,8 +10,10 @@
 
 #include "module/UnitModule.h"
 #include "task/builder/BuilderTask.h"
+#include "task/builder/BuilderTaskGrid.h"
 #include "terrain/TerrainData.h"
 #include "unit/CircuitUnit.h"
+#include "util/Stagger.h"
 
 #include <map>
 #include <set>
@@ -48,8 +50,13 @@ public:
 	void AddBuildPower(CCircuitUnit* unit);
 	void DelBuildPower(CCircuitUnit* unit);
 	float GetBuildPower() const { return buildPower; }
+	const CStagger& GetBuildStagger() const { return buildStagger; }
 	bool CanEnqueueTask(const unsigned mod = 8) const { return buildTasksCount < workers.size() * mod; }
 	const std::set<IBuilderTask*>& GetTasks(IBuilderTask::BuildType type) const;
+	IBuilderTask* FindTaskNear(IBuilderTask::BuildType type, const springai::AIFloat3& position, float radius,
+							   const CBuilderTaskGrid::TaskFunc& predicate = nullptr);
+	void FindNearestTasks(IBuilderTask::BuildType type, const springai::AIFloat3& position, unsigned k,
+						  std::vector<IBuilderTask*>& outTasks);
 	void ActivateTask(IBuilderTask* task);
 
 	IBuilderTask* EnqueueTask(IBuilderTask::Priority priority,
@@ -119,6 +126,7 @@ private:
 						  bool isActive,
 						  int timeout);
 	void DequeueTask(IBuilderTask* task, bool done = false);
+	void AddBuildTask(IBuilderTask* task, IBuilderTask::BuildType type);
 
 public:
 	bool IsBuilderInArea(CCircuitDef* buildDef, const springai::AIFloat3& position);  // Check if build-area has proper builder
@@ -141,6 +149,14 @@ public:
 private:
 	IBuilderTask* MakeCommTask(CCircuitUnit* unit);
 	IBuilderTask* MakeBuilderTask(CCircuitUnit* unit);
+	struct SCandidate {
+		IBuilderTask* task;
+		float metric;  // weighted path cost
+	};
+	// Up to maxCount suitable tasks ordered by metric
+	void CollectBuilderTasks(CCircuitUnit* unit, unsigned maxCount, std::vector<SCandidate>& outCandidates);
+	// Workers that went idle since last UpdateIdle get distinct LOW/NORMAL tasks in one batch
+	void AssignIdleBatch();
 	IBuilderTask* CreateBuilderTask(const springai::AIFloat3& position, CCircuitUnit* unit);
 
 	void AddBuildList(CCircuitUnit* unit);
@@ -160,10 +176,11 @@ private:
 	std::map<ICoreUnit::Id, CBRepairTask*> repairedUnits;
 	std::map<CAllyUnit*, CBReclaimTask*> reclaimedUnits;
 	std::vector<std::set<IBuilderTask*>> buildTasks;  // UnitDef based tasks
+	std::vector<CBuilderTaskGrid> taskGrids;  // spatial index of buildTasks
 	unsigned int buildTasksCount;
 	float buildPower;
 	std::vector<IUnitTask*> buildUpdates;  // owner
-	unsigned int buildIterator;
+	CStagger buildStagger;
 
 	std::set<CCircuitUnit*> workers;
 
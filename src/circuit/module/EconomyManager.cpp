@@ -12,6 +12,7 @@
 #include "setup/SetupManager.h"
 #include "resource/MetalManager.h"
 #include "resource/EnergyGrid.h"
+#include "resource/FeatureRegistry.h"
 #include "terrain/TerrainManager.h"
 #include "CircuitAI.h"
 #include "util/math/LagrangeInterPol.h"
@@ -24,8 +25,6 @@
 #include "Map.h"
 #include "Resource.h"
 #include "Economy.h"
-#include "Feature.h"
-#include "FeatureDef.h"
 #include "Team.h"
 #include "Log.h"
 
@@ -492,6 +491,23 @@ void CEconomyManager::SetOpenSpot(int spotId, bool value)
 	}
 	openSpots[spotId] = value;
 	value ? --mexCount : ++mexCount;
+
+	const int cluster = circuit->GetMetalManager()->GetCluster(spotId);
+	if (value) {
+		if (--ownSpotCounts[cluster] == 0) {
+			ownClusterIndex.Erase(cluster);
+		}
+	} else if (ownSpotCounts[cluster]++ == 0) {
+		ownClusterIndex.Insert(cluster);
+	}
+}
+
+int CEconomyManager::FindNearestOwnCluster(const AIFloat3& pos, CMetalData::PointPredicate& predicate) const
+{
+	if (mexCount >= mexMax) {  // IsOpenSpot is false for every spot
+		return circuit->GetMetalManager()->FindNearestCluster(pos, predicate);
+	}
+	return ownClusterIndex.FindNearest(pos, predicate);
 }
 
 bool CEconomyManager::IsIgnorePull(const IBuilderTask* task) const
@@ -607,58 +623,32 @@ IBuilderTask* CEconomyManager::UpdateReclaimTasks(const AIFloat3& position, CCir
 		return nullptr;
 	}
 
-	std::vector<Feature*> features;
-	if (isNear) {
-		const float distance = unit->GetCircuitDef()->GetSpeed() * ((GetMetalPull() * 0.8f > GetAvgMetalIncome()) ? 300 : 30);
-		features = std::move(circuit->GetCallback()->GetFeaturesIn(position, distance));
-	} else {
-		features = std::move(circuit->GetCallback()->GetFeatures());
-	}
-	if (features.empty()) {
-		return nullptr;
-	}
+	CFeatureRegistry* featureRegistry = circuit->GetAllyTeam()->GetFeatureRegistry().get();
+	featureRegistry->Update();
+	const float distance = isNear
+			? unit->GetCircuitDef()->GetSpeed() * ((GetMetalPull() * 0.8f > GetAvgMetalIncome()) ? 300 : 30)
+			: std::numeric_limits<float>::max();
 
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
-	AIFloat3 pos;
-	float cost = .0f;
-	float minSqDist = std::numeric_limits<float>::max();
-	for (Feature* feature : features) {
-		AIFloat3 featPos = feature->GetPosition();
-		CTerrainManager::CorrectPosition(featPos);  // Impulsed flying feature
-		if (!terrainManager->CanBuildAtSafe(unit, featPos)) {
-			continue;
-		}
-		FeatureDef* featDef = feature->GetDef();
-		if (!featDef->IsReclaimable()) {
-			delete featDef;
-			continue;
-		}
-		float reclaimValue = featDef->GetContainedResource(metalRes)/* * feature->GetReclaimLeft()*/;
-		delete featDef;
-		if (reclaimValue < 1.0f) {
-			continue;
-		}
-		float sqDist = position.SqDistance2D(featPos);
-		if (sqDist < minSqDist) {
-			pos = featPos;
-			cost = reclaimValue;
-			minSqDist = sqDist;
-		}
+	auto isSafe = [terrainManager, unit](const CFeatureRegistry::SFeature& feature) {
+		return terrainManager->CanBuildAtSafe(unit, feature.position);
+	};
+	const CFeatureRegistry::SFeature* feature = featureRegistry->FindNearest(position, distance, 1.0f, isSafe);
+	if (feature == nullptr) {
+		return nullptr;
 	}
-	IBuilderTask* task = nullptr;
-	if (minSqDist < std::numeric_limits<float>::max()) {
-		for (IBuilderTask* t : builderManager->GetTasks(IBuilderTask::BuildType::RECLAIM)) {
-			if (utils::is_equal_pos(pos, t->GetTaskPos())) {
-				task = t;
-				break;
-			}
-		}
-		if (task == nullptr) {
-			task = builderManager->EnqueueReclaim(IBuilderTask::Priority::HIGH, pos, cost, FRAMES_PER_SEC * 300,
-												  8.0f/*unit->GetCircuitDef()->GetBuildDistance()*/);
-		}
+
+	const AIFloat3& pos = feature->position;
+	const float cost = feature->metal/* * feature->GetReclaimLeft()*/;
+
+	IBuilderTask* task = builderManager->FindTaskNear(IBuilderTask::BuildType::RECLAIM, pos, SQUARE_SIZE * 3,
+			[&pos](IBuilderTask* t) {
+				return utils::is_equal_pos(pos, t->GetTaskPos());
+			});
+	if (task == nullptr) {
+		task = builderManager->EnqueueReclaim(IBuilderTask::Priority::HIGH, pos, cost, FRAMES_PER_SEC * 300,
+											  8.0f/*unit->GetCircuitDef()->GetBuildDistance()*/);
 	}
-	utils::free_clear(features);
 
 	return task;
 }
@@ -1007,14 +997,12 @@ IBuilderTask* CEconomyManager::UpdatePylonTasks()
 	if (utils::is_valid(buildPos) && builderManager->IsBuilderInArea(buildDef, buildPos)) {
 		return builderManager->EnqueuePylon(IBuilderTask::Priority::HIGH, buildDef, buildPos, link, cost);
 	} else {
-		link->SetValid(false);
-		energyGrid->SetForceRebuild(true);
+		energyGrid->SetLinkValid(link, false);
 		// TODO: Optimize: when invalid link appears start watchdog gametask
 		//       that will traverse invalidLinks vector and enable link on timeout.
 		//       When invalidLinks is empty remove watchdog gametask.
 		circuit->GetScheduler()->RunTaskAfter(std::make_shared<CGameTask>([link](CEnergyGrid* energyGrid) {
-			link->SetValid(true);
-			energyGrid->SetForceRebuild(true);
+			energyGrid->SetLinkValid(link, true);
 		}, energyGrid), FRAMES_PER_SEC * 120);
 	}
 
@@ -1142,6 +1130,13 @@ void CEconomyManager::Init()
 	const size_t spSize = circuit->GetMetalManager()->GetSpots().size();
 	openSpots.resize(spSize, true);
 
+	ownSpotCounts.resize(clSize, 0);
+	std::vector<AIFloat3> positions;
+	for (const CMetalData::SCluster& cluster : circuit->GetMetalManager()->GetClusters()) {
+		positions.push_back(cluster.position);
+	}
+	ownClusterIndex.Init(positions, false);
+
 	const Json::Value& econ = circuit->GetSetupManager()->GetConfig()["economy"];
 	const float mm = econ.get("mex_max", 2.f).asFloat();
 	mexMax = (mm < 1.f) ? (mm * spSize) : std::numeric_limits<decltype(mexMax)>::max();
@@ -9,6 +9,7 @@
 #define SRC_CIRCUIT_MODULE_ECONOMYMANAGER_H_
 
 #include "module/Module.h"
+#include "resource/SpotIndex.h"
 
 #include "AIFloat3.h"
 
@@ -69,6 +70,8 @@ public:
 	bool IsAllyOpenSpot(int spotId) const;
 	bool IsOpenSpot(int spotId) const { return openSpots[spotId] && (mexCount < mexMax); }
 	void SetOpenSpot(int spotId, bool value);
+	// Nearest cluster among clusters with spots taken by this AI
+	int FindNearestOwnCluster(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate) const;
 	bool IsIgnorePull(const IBuilderTask* task) const;
 	bool IsIgnoreStallingPull(const IBuilderTask* task) const;
 
@@ -118,6 +121,8 @@ private:
 	//       local spot's state descriptor needed for better expansion
 	std::vector<bool> openSpots;  // AI-local metal info
 	int mexCount;
+	std::vector<int> ownSpotCounts;  // cluster: number of spots taken by this AI
+	CSpotIndex ownClusterIndex;
 
 	std::set<CCircuitDef*> allEnergyDefs;
 	std::set<CCircuitDef*> availEnergyDefs;
@@ -33,9 +33,11 @@ namespace circuit {
 
 using namespace springai;
 
+#define FACTORY_UPDATE_BUDGET	500  // us
+
 CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 		: IUnitModule(circuit)
-		, updateIterator(0)
+		, updateStagger(TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 2, FACTORY_UPDATE_BUDGET)
 		, factoryPower(.0f)
 		, assistDef(nullptr)
 		, bpRatio(1.f)
@@ -119,7 +121,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 			facs.insert(fac.unit);
 		}
 		if (!facs.empty()) {
-			factoryPower += unit->GetBuildSpeed();
+			factoryPower += unit->GetBuildSpeed(frame);
 
 			bool isInHaven = false;
 			for (const AIFloat3& hav : havens) {
@@ -165,7 +167,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 			}
 		}
 		if (!assists[unit].empty()) {
-			factoryPower -= unit->GetBuildSpeed();
+			factoryPower -= unit->GetBuildSpeed(this->circuit->GetLastFrame());
 		}
 		assists.erase(unit);
 	};
@@ -449,7 +451,7 @@ CCircuitUnit* CFactoryManager::GetClosestFactory(AIFloat3 position)
 	const int frame = circuit->GetLastFrame();
 	for (SFactory& fac : factories) {
 		STerrainMapArea* area = fac.unit->GetArea();
-		if ((area != nullptr) && (area->sector.find(iS) == area->sector.end())) {
+		if ((area != nullptr) && !area->HasSector(iS)) {
 			continue;
 		}
 		const AIFloat3& facPos = fac.unit->GetPos(frame);
@@ -472,7 +474,7 @@ CCircuitUnit* CFactoryManager::GetClosestFactory(AIFloat3 position)
 //	const int frame = circuit->GetLastFrame();
 //	for (SFactory& fac : factories) {
 //		STerrainMapArea* area = fac.unit->GetArea();
-//		if ((area != nullptr) && (area->sector.find(iS) == area->sector.end())) {
+//		if ((area != nullptr) && !area->HasSector(iS)) {
 //			continue;
 //		}
 //		const AIFloat3& facPos = fac.unit->GetPos(frame);
@@ -997,37 +999,29 @@ void CFactoryManager::Release()
 
 void CFactoryManager::EnableFactory(CCircuitUnit* unit)
 {
-	factoryPower += unit->GetBuildSpeed();
+	factoryPower += unit->GetBuildSpeed(this->circuit->GetLastFrame());
 
 	// check nanos around
 	std::set<CCircuitUnit*> nanos;
 	float radius = assistDef->GetBuildDistance();
 	const AIFloat3& pos = unit->GetPos(this->circuit->GetLastFrame());
-	auto units = std::move(this->circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius));
-	int nanoId = assistDef->GetId();
-	int teamId = this->circuit->GetTeamId();
-	for (Unit* nano : units) {
-		if (nano == nullptr) {
-			continue;
+	this->circuit->ForEachFriendlyInRadius(pos, radius, [this, unit, &nanos](CAllyUnit* nano) {
+		if ((*nano->GetCircuitDef() != *assistDef) || nano->GetUnit()->IsBeingBuilt()) {
+			return false;
 		}
-		UnitDef* ndef = nano->GetDef();
-		if (ndef->GetUnitDefId() == nanoId && (nano->GetTeam() == teamId) && !nano->IsBeingBuilt()) {
-			CCircuitUnit* ass = this->circuit->GetTeamUnit(nano->GetUnitId());
-			// NOTE: OOAICallback::GetFriendlyUnits may return yet unregistered units created in GamePreload
-			if (ass != nullptr) {
-				nanos.insert(ass);
-
-				std::set<CCircuitUnit*>& facs = assists[ass];
-				if (facs.empty()) {
-					factoryPower += ass->GetBuildSpeed();
-				}
-				facs.insert(unit);
+		// NOTE: OOAICallback::GetFriendlyUnits may return yet unregistered units created in GamePreload
+		CCircuitUnit* ass = this->circuit->GetTeamUnit(nano->GetId());
+		if (ass != nullptr) {
+			nanos.insert(ass);
+
+			std::set<CCircuitUnit*>& facs = assists[ass];
+			if (facs.empty()) {
+				factoryPower += ass->GetBuildSpeed(this->circuit->GetLastFrame());
 			}
+			facs.insert(unit);
 		}
-		delete ndef;
-		delete nano;
-	}
-//	utils::free_clear(units);
+		return false;
+	});
 
 	if (factories.empty()) {
 		this->circuit->GetSetupManager()->SetBasePos(pos);
@@ -1099,7 +1093,7 @@ void CFactoryManager::DisableFactory(CCircuitUnit* unit)
 		checkBuilderFactory(circuit->GetLastFrame());
 		return;
 	}
-	factoryPower -= unit->GetBuildSpeed();
+	factoryPower -= unit->GetBuildSpeed(circuit->GetLastFrame());
 	for (auto it = factories.begin(); it != factories.end(); ++it) {
 		if (it->unit != unit) {
 			continue;
@@ -1108,7 +1102,7 @@ void CFactoryManager::DisableFactory(CCircuitUnit* unit)
 			std::set<CCircuitUnit*>& facs = assists[ass];
 			facs.erase(unit);
 			if (facs.empty()) {
-				factoryPower -= ass->GetBuildSpeed();
+				factoryPower -= ass->GetBuildSpeed(circuit->GetLastFrame());
 			}
 		}
 //			factories.erase(it);  // NOTE: micro-opt
@@ -1179,20 +1173,18 @@ IUnitTask* CFactoryManager::CreateAssistTask(CCircuitUnit* unit)
 	CCircuitDef* terraDef = builderManager->GetTerraDef();
 	const float maxCost = MAX_BUILD_SEC * economyManager->GetAvgMetalIncome() * economyManager->GetEcoFactor();
 	float curCost = std::numeric_limits<float>::max();
-	circuit->UpdateFriendlyUnits();
-	// NOTE: OOAICallback::GetFriendlyUnitsIn depends on unit's radius
-	auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius * 0.9f));
-	for (Unit* u : units) {
-		CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-		if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
-			continue;
+	// NOTE: Query depends on unit's radius
+	circuit->ForEachFriendlyInRadius(pos, radius * 0.9f, [&](CAllyUnit* candUnit) {
+		if (builderManager->IsReclaimed(candUnit)) {
+			return false;
 		}
+		Unit* u = candUnit->GetUnit();
 		if (u->IsBeingBuilt()) {
 			CCircuitDef* cdef = candUnit->GetCircuitDef();
 			const float maxHealth = u->GetMaxHealth();
 			const float buildTime = cdef->GetBuildTime() * (maxHealth - u->GetHealth()) / maxHealth;
 			if (buildTime >= curCost) {
-				continue;
+				return false;
 			}
 			if (IsHighPriority(candUnit) ||
 				(!isMetalEmpty && cdef->IsAssistable()) ||
@@ -1205,11 +1197,11 @@ IUnitTask* CFactoryManager::CreateAssistTask(CCircuitUnit* unit)
 		} else if ((repairTarget == nullptr) && (u->GetHealth() < u->GetMaxHealth())) {
 			repairTarget = candUnit;
 			if (isMetalEmpty) {
-				break;
+				return true;
 			}
 		}
-	}
-	utils::free_clear(units);
+		return false;
+	});
 	if (/*!isMetalEmpty && */(buildTarget != nullptr)) {
 		// Construction task
 		IBuilderTask::Priority priority = buildTarget->GetCircuitDef()->IsMobile() ?
@@ -1266,32 +1258,22 @@ void CFactoryManager::UpdateIdle()
 void CFactoryManager::UpdateFactory()
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	if (updateIterator >= updateTasks.size()) {
-		updateIterator = 0;
-	}
-
 	int lastFrame = circuit->GetLastFrame();
 	// stagger the Update's
-	unsigned int n = (updateTasks.size() / TEAM_SLOWUPDATE_RATE) + 1;
-
-	while ((updateIterator < updateTasks.size()) && (n != 0)) {
-		IUnitTask* task = updateTasks[updateIterator];
+	updateStagger.Update(updateTasks, [this, lastFrame](IUnitTask* task) {
 		if (task->IsDead()) {
-			updateTasks[updateIterator] = updateTasks.back();
-			updateTasks.pop_back();
 			delete task;
+			return false;
+		}
+		int frame = task->GetLastTouched();
+		int timeout = task->GetTimeout();
+		if ((frame != -1) && (timeout > 0) && (lastFrame - frame >= timeout)) {
+			AbortTask(task);
 		} else {
-			int frame = task->GetLastTouched();
-			int timeout = task->GetTimeout();
-			if ((frame != -1) && (timeout > 0) && (lastFrame - frame >= timeout)) {
-				AbortTask(task);
-			} else {
-				task->Update();
-			}
-			++updateIterator;
-			n--;
+			task->Update();
 		}
-	}
+		return true;
+	});
 }
 
 } // namespace circuit
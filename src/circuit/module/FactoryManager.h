@@ -11,6 +11,7 @@
 #include "module/UnitModule.h"
 #include "task/static/RecruitTask.h"
 #include "unit/CircuitUnit.h"
+#include "util/Stagger.h"
 
 #include <map>
 
@@ -52,6 +53,7 @@ public:
 
 	int GetFactoryCount() const { return factories.size(); }
 	float GetFactoryPower() const { return factoryPower; }
+	const CStagger& GetUpdateStagger() const { return updateStagger; }
 	bool CanEnqueueTask() const { return factoryTasks.size() < factories.size() * 2; }
 	const std::vector<CRecruitTask*>& GetTasks() const { return factoryTasks; }
 	CCircuitUnit* NeedUpgrade();
@@ -99,7 +101,7 @@ private:
 	std::map<CAllyUnit*, IBuilderTask*> unfinishedUnits;
 	std::vector<CRecruitTask*> factoryTasks;  // order matters
 	std::vector<IUnitTask*> updateTasks;  // owner
-	unsigned int updateIterator;
+	CStagger updateStagger;
 	float factoryPower;
 
 	CCircuitDef* airpadDef;
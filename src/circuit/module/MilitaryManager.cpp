@@ -46,15 +46,20 @@ namespace circuit {
 
 using namespace springai;
 
+#define FIGHT_UPDATE_BUDGET	2000  // us
+#define SQUAD_GOALS_TTL		(FRAMES_PER_SEC * 10)
+
 CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 		: IUnitModule(circuit)
-		, fightIterator(0)
+		, fightStagger(TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 2, FIGHT_UPDATE_BUDGET)
 		, defenceIdx(0)
 		, scoutIdx(0)
+		, squadGoalsFrame(-1)
 		, armyCost(0.f)
 		, enemyMobileCost(0.f)
 		, mobileThreat(0.f)
 		, staticThreat(0.f)
+		, enemyMeans(ZeroVector)
 		, radarDef(nullptr)
 		, sonarDef(nullptr)
 		, bigGunDef(nullptr)
@@ -559,8 +564,6 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 	if (!isPorc) {
 		unsigned threatCount = 0;
 		CThreatMap* threatMap = circuit->GetThreatMap();
-		const CMetalData::Clusters& clusters = mm->GetClusters();
-		const CMetalData::Metals& spots = mm->GetSpots();
 		const CMetalData::Graph& clusterGraph = mm->GetGraph();
 		CMetalData::Graph::Node node = clusterGraph.nodeFromId(cluster);
 		CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
@@ -570,11 +573,8 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 				continue;
 			}
 			// check if there is enemy neighbor
-			for (int idx : clusters[idx0].idxSpots) {
-				if (threatMap->GetAllThreatAt(spots[idx].position) > THREAT_MIN * 2) {
-					threatCount++;
-					break;
-				}
+			if (threatMap->GetAllClusterThreat(idx0) > THREAT_MIN * 2) {
+				threatCount++;
 			}
 			if (threatCount >= 2) {  // if 2 nearby clusters are a threat
 				isPorc = true;
@@ -583,13 +583,12 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 		}
 	}
 	if (!isPorc) {
-		for (IBuilderTask* t : builderManager->GetTasks(IBuilderTask::BuildType::DEFENCE)) {
-			if ((t->GetTarget() == nullptr) && (t->GetNextTask() != nullptr) &&
-				(closestPoint->position.SqDistance2D(t->GetTaskPos()) < SQUARE(SQUARE_SIZE)))
-			{
-				builderManager->AbortTask(t);
-				break;
-			}
+		IBuilderTask* task = builderManager->FindTaskNear(IBuilderTask::BuildType::DEFENCE, closestPoint->position, SQUARE_SIZE,
+				[](IBuilderTask* t) {
+					return (t->GetTarget() == nullptr) && (t->GetNextTask() != nullptr);
+				});
+		if (task != nullptr) {
+			builderManager->AbortTask(task);
 		}
 	}
 	unsigned num = std::min<unsigned>(isPorc ? defenders.size() : preventCount, defenders.size());
@@ -628,29 +627,15 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 	// Build sensors
 	auto checkSensor = [this, &backPos, builderManager](IBuilderTask::BuildType type, CCircuitDef* cdef, float range) {
 		bool isBuilt = false;
-		auto friendlies = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(backPos, range));
-		for (Unit* au : friendlies) {
-			if (au == nullptr) {
-				continue;
-			}
-			UnitDef* udef = au->GetDef();
-			CCircuitDef::Id defId = udef->GetUnitDefId();
-			delete udef;
-			if (defId == cdef->GetId()) {
+		circuit->ForEachFriendlyInRadius(backPos, range, [cdef, &isBuilt](CAllyUnit* au) {
+			if (*au->GetCircuitDef() == *cdef) {
 				isBuilt = true;
-				break;
+				return true;
 			}
-		}
-		utils::free_clear(friendlies);
+			return false;
+		});
 		if (!isBuilt) {
-			const IBuilderTask* task = nullptr;
-			const float qdist = range * range;
-			for (const IBuilderTask* t : builderManager->GetTasks(type)) {
-				if (backPos.SqDistance2D(t->GetTaskPos()) < qdist) {
-					task = t;
-					break;
-				}
-			}
+			const IBuilderTask* task = builderManager->FindTaskNear(type, backPos, range);
 			if (task == nullptr) {
 				builderManager->EnqueueTask(IBuilderTask::Priority::NORMAL, cdef, backPos, type);
 			}
@@ -737,30 +722,60 @@ AIFloat3 CMilitaryManager::GetScoutPosition(CCircuitUnit* unit)
 	return -RgtVector;
 }
 
+const CPathFinder::CGoalSet& CMilitaryManager::GetSquadGoals(IFighterTask::FightType type, STerrainMapArea* area)
+{
+	const int frame = circuit->GetLastFrame();
+	if (squadGoalsFrame + SQUAD_GOALS_TTL < frame) {
+		squadGoalsFrame = frame;
+		// areas are replaced on terrain update, drop entries nobody asked for
+		for (auto it = squadGoals.begin(); it != squadGoals.end();) {
+			if (it->second.frame + SQUAD_GOALS_TTL < frame) {
+				it = squadGoals.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+	const std::pair<IFighterTask::FightType, STerrainMapArea*> key = std::make_pair(type, area);
+	auto it = squadGoals.find(key);
+	if (it == squadGoals.end()) {
+		it = squadGoals.emplace(key, SSquadGoals {-1}).first;
+	} else if (it->second.frame == frame) {
+		return it->second.goals;
+	}
+	// bitmap is kept between frames, MakeGoalSet resets only touched words
+	it->second.frame = frame;
+
+	static F3Vec ourPositions;  // NOTE: micro-opt
+	CTerrainManager* terrainManager = circuit->GetTerrainManager();
+	for (IFighterTask* task : GetTasks(type)) {
+		const AIFloat3& ourPos = static_cast<ISquadTask*>(task)->GetLeaderPos(frame);
+		if (terrainManager->CanMoveToPos(area, ourPos)) {
+			ourPositions.push_back(ourPos);
+		}
+	}
+	CPathFinder* pathfinder = circuit->GetPathfinder();
+	CPathFinder::CGoalSet& goals = it->second.goals;
+	pathfinder->MakeGoalSet(goals, ourPositions, pathfinder->GetSquareSize());
+	ourPositions.clear();
+	return goals;
+}
+
 void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainMapArea* area)
 {
 	static F3Vec ourPositions;  // NOTE: micro-opt
 
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	CPathFinder* pathfinder = circuit->GetPathfinder();
-	const int frame = circuit->GetLastFrame();
 
 	/*
 	 * Check mobile groups
 	 */
 	const std::array<IFighterTask::FightType, 2> types = {IFighterTask::FightType::ATTACK, IFighterTask::FightType::DEFEND};
 	for (IFighterTask::FightType type : types) {
-		const std::set<IFighterTask*>& atkTasks = GetTasks(type);
-		for (IFighterTask* task : atkTasks) {
-			const AIFloat3& ourPos = static_cast<ISquadTask*>(task)->GetLeaderPos(frame);
-			if (terrainManager->CanMoveToPos(area, ourPos)) {
-				ourPositions.push_back(ourPos);
-			}
-		}
-
-		if (!ourPositions.empty()) {
-			pathfinder->FindBestPath(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
-			ourPositions.clear();
+		const CPathFinder::CGoalSet& goals = GetSquadGoals(type, area);
+		if (!goals.IsEmpty()) {
+			pathfinder->FindBestPath(posPath, startPos, goals, false);
 			if (!posPath.empty()) {
 				return;
 			}
@@ -833,25 +848,18 @@ void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainM
 	ourPositions.clear();
 }
 
-void CMilitaryManager::FillSafePos(const AIFloat3& pos, STerrainMapArea* area, F3Vec& outPositions)
+const CPathFinder::CGoalSet& CMilitaryManager::GetSafeGoals(const AIFloat3& pos, STerrainMapArea* area)
 {
-	CTerrainManager* terrainManager = circuit->GetTerrainManager();
-	const int frame = circuit->GetLastFrame();
-
 	const std::array<IFighterTask::FightType, 2> types = {IFighterTask::FightType::ATTACK, IFighterTask::FightType::DEFEND};
 	for (IFighterTask::FightType type : types) {
-		const std::set<IFighterTask*>& atkTasks = GetTasks(type);
-		for (IFighterTask* task : atkTasks) {
-			const AIFloat3& ourPos = static_cast<ISquadTask*>(task)->GetLeaderPos(frame);
-			if (terrainManager->CanMoveToPos(area, ourPos)) {
-				outPositions.push_back(ourPos);
-			}
-		}
-		if (!outPositions.empty()) {
-			return;
+		const CPathFinder::CGoalSet& goals = GetSquadGoals(type, area);
+		if (!goals.IsEmpty()) {
+			return goals;
 		}
 	}
 
+	static F3Vec outPositions;  // NOTE: micro-opt
+	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	CDefenceMatrix* defMat = defence;
 	CMetalData::PointPredicate predicate = [defMat, terrainManager, area](const int index) {
 		const std::vector<CDefenceMatrix::SDefPoint>& points = defMat->GetDefPoints(index);
@@ -874,6 +882,11 @@ void CMilitaryManager::FillSafePos(const AIFloat3& pos, STerrainMapArea* area, F
 	if (outPositions.empty()) {
 		outPositions.push_back(circuit->GetSetupManager()->GetBasePos());
 	}
+
+	CPathFinder* pathfinder = circuit->GetPathfinder();
+	pathfinder->MakeGoalSet(safeGoals, outPositions, pathfinder->GetSquareSize());
+	outPositions.clear();
+	return safeGoals;
 }
 
 IFighterTask* CMilitaryManager::AddDefendTask(int cluster)
@@ -1093,7 +1106,7 @@ void CMilitaryManager::UpdateDefenceTasks()
 			return false;
 		};
 		AIFloat3 center(tm->GetTerrainWidth() / 2, 0, tm->GetTerrainHeight() / 2);
-		int index = mm->FindNearestCluster(center, predicate);
+		int index = em->FindNearestOwnCluster(center, predicate);
 		if (index >= 0) {
 			dt->SetPosition(clusters[index].position);
 		}
@@ -1233,6 +1246,7 @@ void CMilitaryManager::ReadConfig()
 	initThrMod.inMobile = qthrMod.get("mobile", 1.f).asFloat();
 	initThrMod.inStatic = qthrMod.get("static", 0.f).asFloat();
 	maxAAThreat = quotas.get("aa_threat", 42.f).asFloat();
+	maxEnemyGroups = std::max(quotas.get("enemy_groups", 32).asUInt(), 1u);
 
 	const Json::Value& porc = root["porcupine"];
 	const Json::Value& defs = porc["unit"];
@@ -1383,25 +1397,15 @@ void CMilitaryManager::UpdateIdle()
 void CMilitaryManager::UpdateFight()
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	if (fightIterator >= fightUpdates.size()) {
-		fightIterator = 0;
-	}
-
 	// stagger the Update's
-	unsigned int n = (fightUpdates.size() / TEAM_SLOWUPDATE_RATE) + 1;
-
-	while ((fightIterator < fightUpdates.size()) && (n != 0)) {
-		IUnitTask* task = fightUpdates[fightIterator];
+	fightStagger.Update(fightUpdates, [](IUnitTask* task) {
 		if (task->IsDead()) {
-			fightUpdates[fightIterator] = fightUpdates.back();
-			fightUpdates.pop_back();
 			delete task;
-		} else {
-			task->Update();
-			++fightIterator;
-			n--;
+			return false;
 		}
-	}
+		task->Update();
+		return true;
+	});
 }
 
 void CMilitaryManager::AddArmyCost(CCircuitUnit* unit)
@@ -1417,113 +1421,115 @@ void CMilitaryManager::DelArmyCost(CCircuitUnit* unit)
 }
 
 /*
- * 2d only, ignores y component.
- * @see KAIK/AttackHandler::KMeansIteration for general reference
+ * Enemy groups follow k-means clusters, group aggregates are updated only for changed enemies.
+ * @see CKMeansCluster
  */
 void CMilitaryManager::KMeansIteration()
 {
 	const CCircuitAI::EnemyUnits& units = circuit->GetEnemyUnits();
-	// calculate a new K. change the formula to adjust max K, needs to be 1 minimum.
-	constexpr int KMEANS_BASE_MAX_K = 32;
-	int newK = std::min(KMEANS_BASE_MAX_K, 1 + (int)sqrtf(units.size()));
-
-	// change the number of means according to newK
-	assert(newK > 0/* && enemyGoups.size() > 0*/);
-	// add a new means, just use one of the positions
-	AIFloat3 newMeansPosition = units.begin()->second->GetPos();
-//	newMeansPosition.y = circuit->GetMap()->GetElevationAt(newMeansPosition.x, newMeansPosition.z) + K_MEANS_ELEVATION;
-	enemyGroups.resize(newK, SEnemyGroup(newMeansPosition));
-
-	// check all positions and assign them to means, complexity n*k for one iteration
-	std::vector<int> unitsClosestMeanID(units.size(), -1);
-	std::vector<int> numUnitsAssignedToMean(newK, 0);
-
-	{
-		int i = 0;
-		for (const auto& kv : units) {
-			CEnemyUnit* enemy = kv.second;
-			if (enemy->IsHidden()) {
-				continue;
-			}
-			AIFloat3 unitPos = enemy->GetPos();
-			float closestDistance = std::numeric_limits<float>::max();
-			int closestIndex = -1;
-
-			for (int m = 0; m < newK; m++) {
-				const AIFloat3& mean = enemyGroups[m].pos;
-				float distance = unitPos.SqDistance2D(mean);
 
-				if (distance < closestDistance) {
-					closestDistance = distance;
-					closestIndex = m;
-				}
-			}
-
-			// position i is closest to the mean at closestIndex
-			unitsClosestMeanID[i++] = closestIndex;
-			numUnitsAssignedToMean[closestIndex]++;
+	// forget dead and hidden enemies
+	for (auto it = enemyContribs.begin(); it != enemyContribs.end();) {
+		CEnemyUnit* enemy = circuit->GetEnemyUnit(it->first);
+		if ((enemy != nullptr) && !enemy->IsHidden()) {
+			++it;
+			continue;
 		}
+		enemyMeans.RemovePoint(it->first);
+		DelEnemyContrib(it->second);
+		it = enemyContribs.erase(it);
 	}
 
-	// change the means according to which positions are assigned to them
-	// use meanAverage for indexes with 0 pos'es assigned
-	// make a new means list
-//	std::vector<AIFloat3> newMeans(newK, ZeroVector);
-	std::vector<SEnemyGroup>& newMeans = enemyGroups;
-	for (unsigned i = 0; i < newMeans.size(); i++) {
-		SEnemyGroup& eg = newMeans[i];
-		eg.units.clear();
-		eg.units.reserve(numUnitsAssignedToMean[i]);
-		eg.pos = ZeroVector;
-		std::fill(eg.roleCosts.begin(), eg.roleCosts.end(), 0.f);
-		eg.cost = 0.f;
-		eg.threat = 0.f;
+	for (const auto& kv : units) {
+		if (!kv.second->IsHidden()) {
+			enemyMeans.SetPoint(kv.first, kv.second->GetPos());
+		}
+	}
+	// calculate a new K. change the formula to adjust max K, needs to be 1 minimum.
+	const int newK = std::min<int>(maxEnemyGroups, 1 + (int)sqrtf(units.size()));
+	enemyMeans.Iteration(newK);
+
+	const std::vector<AIFloat3>& means = enemyMeans.GetMeans();
+	if (enemyGroups.size() != means.size()) {
+		// group indices changed, collect aggregates from scratch
+		enemyGroups.assign(means.size(), SEnemyGroup(ZeroVector));
+		enemyContribs.clear();
 	}
 
-	{
-		int i = 0;
-		for (const auto& kv : units) {
-			CEnemyUnit* enemy = kv.second;
-			if (enemy->IsHidden()) {
-				continue;
-			}
-			int meanIndex = unitsClosestMeanID[i++];
-			SEnemyGroup& eg = newMeans[meanIndex];
-
-			// don't divide by 0
-			float num = std::max(1, numUnitsAssignedToMean[meanIndex]);
-			eg.pos += enemy->GetPos() / num;
-
-			eg.units.push_back(kv.first);
+	for (const auto& kv : units) {
+		CEnemyUnit* enemy = kv.second;
+		if (enemy->IsHidden()) {
+			continue;
+		}
+		SEnemyContrib contrib;
+		contrib.group = enemyMeans.GetMeanIndex(kv.first);
+		const CCircuitDef* cdef = enemy->GetCircuitDef();
+		if (cdef != nullptr) {
+			contrib.role = cdef->GetMainRole();
+			contrib.roleCost = cdef->GetCost();
+			contrib.cost = (!cdef->IsMobile() || enemy->IsInRadarOrLOS()) ? cdef->GetCost() : 0.f;
+			contrib.threat = enemy->GetThreat() * (cdef->IsMobile() ? initThrMod.inMobile : initThrMod.inStatic);
+		} else {
+			contrib.role = -1;
+			contrib.roleCost = 0.f;
+			contrib.cost = 0.f;
+			contrib.threat = enemy->GetThreat();
+		}
 
-			const CCircuitDef* cdef = enemy->GetCircuitDef();
-			if (cdef != nullptr) {
-				eg.roleCosts[cdef->GetMainRole()] += cdef->GetCost();
-				if (!cdef->IsMobile() || enemy->IsInRadarOrLOS()) {
-					eg.cost += cdef->GetCost();
-				}
-				eg.threat += enemy->GetThreat() * (cdef->IsMobile() ? initThrMod.inMobile : initThrMod.inStatic);
-			} else {
-				eg.threat += enemy->GetThreat();
-			}
+		auto it = enemyContribs.find(kv.first);
+		if (it == enemyContribs.end()) {
+			AddEnemyContrib(kv.first, contrib);
+			enemyContribs[kv.first] = contrib;
+			continue;
+		}
+		SEnemyContrib& prev = it->second;
+		if ((prev.group != contrib.group) || (prev.role != contrib.role) || (prev.roleCost != contrib.roleCost)
+			|| (prev.cost != contrib.cost) || (prev.threat != contrib.threat))
+		{
+			DelEnemyContrib(prev);
+			AddEnemyContrib(kv.first, contrib);
+			prev = contrib;
 		}
 	}
 
-	// do a check and see if there are any empty means and set the height
 	enemyPos = ZeroVector;
-	for (int i = 0; i < newK; i++) {
-		// if a newmean is unchanged, set it to the new means pos instead of (0, 0, 0)
-		if (newMeans[i].pos == ZeroVector) {
-			newMeans[i] = newMeansPosition;
-		} else {
-			// get the proper elevation for the y-coord
-//			newMeans[i].pos.y = circuit->GetMap()->GetElevationAt(newMeans[i].pos.x, newMeans[i].pos.z) + K_MEANS_ELEVATION;
-		}
-		enemyPos += newMeans[i].pos;
+	for (unsigned i = 0; i < means.size(); ++i) {
+		SEnemyGroup& eg = enemyGroups[i];
+		eg.pos = means[i];
+		if (eg.units.empty()) {  // drop accumulated error
+			std::fill(eg.roleCosts.begin(), eg.roleCosts.end(), 0.f);
+			eg.cost = 0.f;
+			eg.threat = 0.f;
+		}
+		enemyPos += eg.pos;
+	}
+	enemyPos /= means.size();
+}
+
+void CMilitaryManager::AddEnemyContrib(ICoreUnit::Id unitId, SEnemyContrib& contrib)
+{
+	SEnemyGroup& eg = enemyGroups[contrib.group];
+	contrib.slot = eg.units.size();
+	eg.units.push_back(unitId);
+	if (contrib.role >= 0) {
+		eg.roleCosts[contrib.role] += contrib.roleCost;
 	}
-	enemyPos /= newK;
+	eg.cost += contrib.cost;
+	eg.threat += contrib.threat;
+}
 
-//	return newMeans;
+void CMilitaryManager::DelEnemyContrib(const SEnemyContrib& contrib)
+{
+	SEnemyGroup& eg = enemyGroups[contrib.group];
+	const ICoreUnit::Id lastId = eg.units.back();
+	eg.units[contrib.slot] = lastId;
+	enemyContribs[lastId].slot = contrib.slot;
+	eg.units.pop_back();
+	if (contrib.role >= 0) {
+		eg.roleCosts[contrib.role] = std::max(eg.roleCosts[contrib.role] - contrib.roleCost, 0.f);
+	}
+	eg.cost = std::max(eg.cost - contrib.cost, 0.f);
+	eg.threat = std::max(eg.threat - contrib.threat, 0.f);
 }
 
 } // namespace circuit
@@ -9,12 +9,17 @@
 #define SRC_CIRCUIT_MODULE_MILITARYMANAGER_H_
 
 #include "module/UnitModule.h"
+#include "terrain/MicroPather.h"
 #include "task/fighter/FighterTask.h"
 #include "unit/CircuitUnit.h"
 #include "unit/CircuitDef.h"
+#include "util/math/KMeansCluster.h"
+#include "util/Stagger.h"
 
 #include <vector>
 #include <set>
+#include <map>
+#include <unordered_map>
 
 namespace circuit {
 
@@ -68,7 +73,11 @@ public:
 	bool HasDefence(int cluster);
 	springai::AIFloat3 GetScoutPosition(CCircuitUnit* unit);
 	void FindBestPos(F3Vec& posPath, springai::AIFloat3& startPos, STerrainMapArea* area);
-	void FillSafePos(const springai::AIFloat3& pos, STerrainMapArea* area, F3Vec& outPositions);
+	// Goals around squad leaders reachable within area, built once per frame and shared by callers
+	const NSMicroPather::CGoalSet& GetSquadGoals(IFighterTask::FightType type, STerrainMapArea* area);
+	// Squad goals or, if there are none, defence points of the nearest cluster, or base.
+	// Fallback set is valid until the next call.
+	const NSMicroPather::CGoalSet& GetSafeGoals(const springai::AIFloat3& pos, STerrainMapArea* area);
 
 	IFighterTask* AddDefendTask(int cluster);
 	IFighterTask* DelDefendTask(const springai::AIFloat3& pos);
@@ -97,6 +106,7 @@ public:
 	void AddResponse(CCircuitUnit* unit);
 	void DelResponse(CCircuitUnit* unit);
 	float GetArmyCost() const { return armyCost; }
+	const CStagger& GetFightStagger() const { return fightStagger; }
 	float RoleProbability(const CCircuitDef* cdef) const;
 	bool IsNeedBigGun(const CCircuitDef* cdef) const;
 	springai::AIFloat3 GetBigGunPos(CCircuitDef* bigDef) const;
@@ -129,6 +139,16 @@ private:
 	void DelArmyCost(CCircuitUnit* unit);
 
 	void KMeansIteration();
+	struct SEnemyContrib {
+		int group;
+		unsigned slot;  // index in SEnemyGroup::units
+		int role;  // -1 for unknown def
+		float roleCost;
+		float cost;
+		float threat;
+	};
+	void AddEnemyContrib(ICoreUnit::Id unitId, SEnemyContrib& contrib);
+	void DelEnemyContrib(const SEnemyContrib& contrib);
 
 	Handlers2 createdHandler;
 	Handlers1 finishedHandler;
@@ -138,7 +158,7 @@ private:
 
 	std::vector<std::set<IFighterTask*>> fightTasks;
 	std::vector<IUnitTask*> fightUpdates;  // owner
-	unsigned int fightIterator;
+	CStagger fightStagger;
 
 	CDefenceMatrix* defence;
 	unsigned int defenceIdx;
@@ -146,6 +166,14 @@ private:
 	std::vector<unsigned int> scoutPath;  // list of cluster ids
 	unsigned int scoutIdx;
 
+	struct SSquadGoals {
+		int frame;  // frame of goals content
+		NSMicroPather::CGoalSet goals;
+	};
+	int squadGoalsFrame;  // last sweep of unused entries
+	std::map<std::pair<IFighterTask::FightType, STerrainMapArea*>, SSquadGoals> squadGoals;
+	NSMicroPather::CGoalSet safeGoals;
+
 	struct SRoleInfo {
 		float cost;
 		float maxPerc;
@@ -178,6 +206,9 @@ private:
 	std::array<SEnemyInfo, static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_)> enemyInfos{{{0.f}, {0.f}}};
 	std::vector<SEnemyGroup> enemyGroups;
 	springai::AIFloat3 enemyPos;
+	CKMeansCluster enemyMeans;
+	std::unordered_map<ICoreUnit::Id, SEnemyContrib> enemyContribs;  // last contribution to enemyGroups
+	unsigned maxEnemyGroups;
 
 	struct SClusterInfo {
 		IFighterTask* defence;
@@ -15,7 +15,6 @@
 #include "util/Scheduler.h"
 #include "util/utils.h"
 #include "json/json.h"
-#include "lemon/kruskal.h"
 
 #include "AISCommands.h"
 #include "Log.h"
@@ -27,9 +26,9 @@ namespace circuit {
 
 using namespace springai;
 
-class CEnergyGrid::SpanningLink : public lemon::MapBase<CEnergyGrid::OwnedGraph::Edge, bool> {
+class CEnergyGrid::SpanningLink : public lemon::MapBase<CEnergyTree::OwnedGraph::Edge, bool> {
 public:
-	SpanningLink(const CEnergyGrid::SpanningTree& st, const std::vector<CEnergyLink>& links)
+	SpanningLink(const CEnergyTree::SpanningTree& st, const std::vector<CEnergyLink>& links)
 		: spanningTree(st)
 		, links(links)
 	{}
@@ -39,11 +38,11 @@ public:
 				&& !links[CMetalData::Graph::id(k)].IsBeingBuilt();
 	}
 private:
-	const CEnergyGrid::SpanningTree& spanningTree;
+	const CEnergyTree::SpanningTree& spanningTree;
 	const std::vector<CEnergyLink>& links;
 };
 
-class CEnergyGrid::DetectLink : public lemon::MapBase<CEnergyGrid::OwnedGraph::Edge, bool> {
+class CEnergyGrid::DetectLink : public lemon::MapBase<CEnergyTree::OwnedGraph::Edge, bool> {
 public:
 	DetectLink(const std::vector<CEnergyLink>& links) : links(links) {}
 	bool operator[](Key k) const {
@@ -58,9 +57,8 @@ CEnergyGrid::CEnergyGrid(CCircuitAI* circuit)
 		: circuit(circuit)
 		, markFrame(-1)
 		, isForceRebuild(false)
-		, ownedFilter(nullptr)
-		, ownedClusters(nullptr)
-		, edgeCosts(nullptr)
+		, baseWeight(1.f)
+		, energyTree(nullptr)
 		, spanningFilter(nullptr)
 		, spanningGraph(nullptr)
 		, spanningBfs(nullptr)
@@ -92,9 +90,7 @@ CEnergyGrid::~CEnergyGrid()
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
 
-	delete ownedFilter;
-	delete ownedClusters;
-	delete edgeCosts;
+	delete energyTree;
 
 	delete spanningFilter;
 	delete spanningGraph;
@@ -246,16 +242,19 @@ void CEnergyGrid::Init()
 	const CMetalData::Clusters& clusters = metalManager->GetClusters();
 	const CMetalData::Graph& clusterGraph = metalManager->GetGraph();
 
-	ownedFilter = new OwnedFilter(clusterGraph, false);
-	ownedClusters = new OwnedGraph(clusterGraph, *ownedFilter);
-	edgeCosts = new CMetalData::WeightMap(clusterGraph);
+	energyTree = new CEnergyTree(clusterGraph);
 
-	spanningFilter = new SpanningLink(spanningTree, links);
+	spanningFilter = new SpanningLink(energyTree->GetSpanningTree(), links);
 	spanningGraph = new SpanningGraph(metalManager->GetGraph(), *spanningFilter);
 	spanningBfs = new SpanningBFS(*spanningGraph);
 
 	linkedClusters.resize(clusters.size(), false);
 
+	const float width = circuit->GetTerrainManager()->GetTerrainWidth();
+	const float height = circuit->GetTerrainManager()->GetTerrainHeight();
+	baseWeight = width * width + height * height;
+	costBasePos = circuit->GetSetupManager()->GetBasePos();
+
 	links.reserve(clusterGraph.edgeNum());
 	for (int i = 0; i < clusterGraph.edgeNum(); ++i) {
 		CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(i);
@@ -365,6 +364,9 @@ void CEnergyGrid::CheckGrid()
 			continue;
 		}
 		link.CheckConnection();
+		if (link.IsFinished()) {
+			dirtyLinks.insert(edgeIdx);
+		}
 	}
 	linkPylons.clear();
 
@@ -374,6 +376,9 @@ void CEnergyGrid::CheckGrid()
 			continue;
 		}
 		link.CheckConnection();
+		if (!link.IsFinished()) {
+			dirtyLinks.insert(edgeIdx);
+		}
 	}
 	unlinkPylons.clear();
 }
@@ -391,65 +396,100 @@ void CEnergyGrid::MarkClusters()
 	}
 }
 
+void CEnergyGrid::SetLinkValid(CEnergyLink* link, bool value)
+{
+	link->SetValid(value);
+	dirtyLinks.insert(link - links.data());
+}
+
 void CEnergyGrid::RebuildTree()
 {
-	if (linkClusters.empty() && unlinkClusters.empty() && !isForceRebuild) {
+	if (linkClusters.empty() && unlinkClusters.empty() && dirtyLinks.empty() && !isForceRebuild) {
+		return;
+	}
+	const AIFloat3& basePos = circuit->GetSetupManager()->GetBasePos();
+	if (basePos != costBasePos) {  // every cost depends on base position
+		costBasePos = basePos;
+		isForceRebuild = true;
+	}
+
+	CEnergyTree::CostFunc calcCost = [this](const CMetalData::Graph::Edge edge) {
+		return CalcEdgeCost(edge);
+	};
+	if (isForceRebuild || !energyTree->Rebuild(unlinkClusters, linkClusters, dirtyLinks, calcCost)) {
+		KruskalTree();
 		return;
 	}
+
+	unlinkClusters.clear();
+	for (int index : linkClusters) {
+		SetStartVertices(index);
+	}
+	linkClusters.clear();
+	dirtyLinks.clear();
+}
+
+void CEnergyGrid::KruskalTree()
+{
 	isForceRebuild = false;
-	CMetalManager* metalManager = circuit->GetMetalManager();
-	const CMetalData::Graph& clusterGraph = metalManager->GetGraph();
+	const CMetalData::Graph& clusterGraph = circuit->GetMetalManager()->GetGraph();
 
-	// Remove destroyed edges
 	for (int index : unlinkClusters) {
-		OwnedGraph::Node node = ownedClusters->nodeFromId(index);
-		ownedClusters->disable(node);
-		OwnedGraph::IncEdgeIt edgeIt(*ownedClusters, node);
-		for (; edgeIt != lemon::INVALID; ++edgeIt) {
-			spanningTree.erase(edgeIt);
-		}
+		energyTree->DisableNode(index);
 	}
 	unlinkClusters.clear();
 
-	// Add new edges to Kruskal graph
 	for (int index : linkClusters) {
-		CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
-		ownedClusters->enable(node);
-		CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
-		for (; edgeIt != lemon::INVALID; ++edgeIt) {
-			int idx0 = clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt));
-			if (linkedClusters[idx0]) {
-				CEnergyLink& link = links[clusterGraph.id(edgeIt)];
-				link.SetStartVertex(idx0);
-			}
-		}
+		EnableNode(index);
 	}
 	linkClusters.clear();
+	dirtyLinks.clear();
 
-	const CMetalData::WeightMap& weights = metalManager->GetWeights();
-	const CMetalData::CenterMap& centers = metalManager->GetCenters();
-	float width = circuit->GetTerrainManager()->GetTerrainWidth();
-	float height = circuit->GetTerrainManager()->GetTerrainHeight();
-	float baseWeight = width * width + height * height;
-	float invBaseWeight = 1.0f / baseWeight;  // FIXME: only valid for 1 of the ally team
-	const AIFloat3& basePos = circuit->GetSetupManager()->GetBasePos();
-
-	for (const CMetalData::Graph::Edge edge : spanningTree) {
-		CEnergyLink& link = links[clusterGraph.id(edge)];
-		if (link.IsFinished() || link.IsBeingBuilt()) {
-			// Mark used edges as const
-			(*edgeCosts)[edge] = weights[edge] * invBaseWeight;
-		} else if (!link.IsValid()) {
-			(*edgeCosts)[edge] = weights[edge] * baseWeight;
-		} else {
-			// Adjust weight by distance to base
-			(*edgeCosts)[edge] = weights[edge] * basePos.SqDistance2D(centers[edge]) * invBaseWeight;
-		}
+	CMetalData::Graph::EdgeIt edgeIt(clusterGraph);
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		energyTree->SetCost(edgeIt, CalcEdgeCost(edgeIt));
 	}
 
 	// Build Kruskal's minimum spanning tree
-	spanningTree.clear();
-	lemon::kruskal(*ownedClusters, *edgeCosts, std::inserter(spanningTree, spanningTree.end()));
+	energyTree->Kruskal();
+}
+
+float CEnergyGrid::CalcEdgeCost(const CMetalData::Graph::Edge edge) const
+{
+	const CMetalData::Graph& clusterGraph = circuit->GetMetalManager()->GetGraph();
+	const CMetalData::WeightMap& weights = circuit->GetMetalManager()->GetWeights();
+	const CMetalData::CenterMap& centers = circuit->GetMetalManager()->GetCenters();
+	const float invBaseWeight = 1.0f / baseWeight;  // FIXME: only valid for 1 of the ally team
+
+	const CEnergyLink& link = links[clusterGraph.id(edge)];
+	if (link.IsFinished() || link.IsBeingBuilt()) {
+		// Mark used edges as const
+		return weights[edge] * invBaseWeight;
+	} else if (!link.IsValid()) {
+		return weights[edge] * baseWeight;
+	}
+	// Adjust weight by distance to base
+	return weights[edge] * costBasePos.SqDistance2D(centers[edge]) * invBaseWeight;
+}
+
+void CEnergyGrid::EnableNode(int index)
+{
+	energyTree->EnableNode(index);
+	SetStartVertices(index);
+}
+
+void CEnergyGrid::SetStartVertices(int index)
+{
+	const CMetalData::Graph& clusterGraph = circuit->GetMetalManager()->GetGraph();
+	CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
+	CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		int idx0 = clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt));
+		if (linkedClusters[idx0]) {
+			CEnergyLink& link = links[clusterGraph.id(edgeIt)];
+			link.SetStartVertex(idx0);
+		}
+	}
 }
 
 #ifdef DEBUG_VIS
@@ -505,7 +545,7 @@ void CEnergyGrid::UpdateVis()
 	figureKruskalId = fig->DrawLine(ZeroVector, ZeroVector, 0.0f, false, FRAMES_PER_SEC * 300, 0);
 	const CMetalData::Clusters& clusters = circuit->GetMetalManager()->GetClusters();
 	const CMetalData::Graph& clusterGraph = circuit->GetMetalManager()->GetGraph();
-	for (const CMetalData::Graph::Edge edge : spanningTree) {
+	for (const CMetalData::Graph::Edge edge : energyTree->GetSpanningTree()) {
 		const AIFloat3& posFrom = clusters[clusterGraph.id(clusterGraph.u(edge))].position;
 		const AIFloat3& posTo = clusters[clusterGraph.id(clusterGraph.v(edge))].position;
 		AIFloat3 pos0 = posFrom;
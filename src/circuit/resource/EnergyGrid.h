@@ -9,6 +9,7 @@
 #define SRC_CIRCUIT_RESOURCE_ENERGYGRID_H_
 
 #include "resource/EnergyLink.h"
+#include "resource/EnergyTree.h"
 #include "resource/MetalData.h"
 #include "unit/CircuitUnit.h"
 #include "unit/CircuitDef.h"
@@ -30,6 +31,7 @@ public:
 
 	void Update();
 	void SetForceRebuild(bool value) { isForceRebuild = value; }
+	void SetLinkValid(CEnergyLink* link, bool value);
 	CEnergyLink* GetLinkToBuild(CCircuitDef*& outDef, springai::AIFloat3& outPos);
 
 	float GetPylonRange(CCircuitDef::Id defId);
@@ -56,27 +58,31 @@ private:
 
 	std::vector<int> linkClusters;
 	std::vector<int> unlinkClusters;
+	std::set<int> dirtyLinks;  // edges with changed cost
 	bool isForceRebuild;
 
 	class SpanningLink;
 	class DetectLink;
-	using OwnedFilter = CMetalData::Graph::NodeMap<bool>;
-	using OwnedGraph = lemon::FilterNodes<const CMetalData::Graph, OwnedFilter>;
-	using SpanningTree = std::set<CMetalData::Graph::Edge>;
 	using SpanningGraph = lemon::FilterEdges<const CMetalData::Graph, SpanningLink>;
 	using SpanningBFS = lemon::Bfs<SpanningGraph>;
 
-	SpanningTree spanningTree;
-	OwnedFilter* ownedFilter;
-	OwnedGraph* ownedClusters;
-	CMetalData::WeightMap* edgeCosts;
+	CEnergyTree* energyTree;
 
 	SpanningLink* spanningFilter;
 	SpanningGraph* spanningGraph;
 	SpanningBFS* spanningBfs;  // breadth-first search
 
+	springai::AIFloat3 costBasePos;
+	float baseWeight;
+
 	void MarkClusters();
+	// Applies ownership and link changes to minimum spanning tree,
+	// batches of changes comparable to the tree size fall back to full Kruskal
 	void RebuildTree();
+	void KruskalTree();
+	float CalcEdgeCost(const CMetalData::Graph::Edge edge) const;
+	void EnableNode(int index);
+	void SetStartVertices(int index);
 
 #ifdef DEBUG_VIS
 private:
@@ -9,7 +9,8 @@
 #include "resource/EnergyLink.h"
 #include "util/utils.h"
 
-#include <queue>
+#include <algorithm>
+#include <limits>
 
 namespace circuit {
 
@@ -21,6 +22,8 @@ CEnergyLink::CEnergyLink(int idx0, const AIFloat3& P0, int idx1, const AIFloat3&
 		, isBeingBuilt(false)
 		, isFinished(false)
 		, isValid(true)
+		, cellSize(1.f)
+		, maxRange(.0f)
 {
 }
 
@@ -41,17 +44,33 @@ void CEnergyLink::AddPylon(ICoreUnit::Id unitId, const AIFloat3& pos, float rang
 	}
 
 	SPylon* pylon0 = new SPylon(pos, range);
+	if (range > maxRange) {
+		Rehash(range);
+	}
 
-	for (auto& kv : pylons) {
-		SPylon* pylon1 = kv.second;
-		float dist = range + pylon1->range;
-		if (pos.SqDistance2D(pylon1->pos) < dist * dist) {
-			pylon0->neighbors.insert(pylon1);
-			pylon1->neighbors.insert(pylon0);
+	// Neighbours are within range + maxRange, at most 1 cell away
+	const float radius = range + maxRange;
+	const int x1 = int((pos.x - radius) / cellSize), x2 = int((pos.x + radius) / cellSize);
+	const int z1 = int((pos.z - radius) / cellSize), z2 = int((pos.z + radius) / cellSize);
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			auto it = cells.find(GetCellKey(x, z));
+			if (it == cells.end()) {
+				continue;
+			}
+			for (SPylon* pylon1 : it->second) {
+				float dist = range + pylon1->range;
+				if (pos.SqDistance2D(pylon1->pos) < dist * dist) {
+					pylon0->neighbors.insert(pylon1);
+					pylon1->neighbors.insert(pylon0);
+					Union(pylon0, pylon1);
+				}
+			}
 		}
 	}
 
 	pylons[unitId] = pylon0;
+	InsertCell(pylon0);
 
 	float sqRange = range * range;
 	if (v0->pos.SqDistance2D(pos) < sqRange) {
@@ -70,11 +89,30 @@ bool CEnergyLink::RemovePylon(ICoreUnit::Id unitId)
 	}
 	SPylon* pylon0 = it->second;
 
+	if (!pylon0->neighbors.empty()) {
+		// Split component of removed pylon into singletons, MergeDirty joins them back by neighbours.
+		// Every pylon that refers to pylon0 has the same root.
+		SPylon* root = FindRoot(pylon0);
+		std::vector<SPylon*> members;
+		for (auto& kv : pylons) {
+			if ((kv.second != pylon0) && (FindRoot(kv.second) == root)) {
+				members.push_back(kv.second);
+			}
+		}
+		for (SPylon* pylon1 : members) {
+			pylon1->parent = pylon1;
+			pylon1->rank = 0;
+			dirtyPylons.insert(pylon1);
+		}
+	}
+	dirtyPylons.erase(pylon0);
+
 	for (SPylon* pylon1 : pylon0->neighbors) {
 		pylon1->neighbors.erase(pylon0);
 	}
 	v0->pylons.erase(pylon0);
 	v1->pylons.erase(pylon0);
+	EraseCell(pylon0);
 	delete pylon0;
 
 	return it != pylons.erase(it);
@@ -82,34 +120,17 @@ bool CEnergyLink::RemovePylon(ICoreUnit::Id unitId)
 
 void CEnergyLink::CheckConnection()
 {
-	int i = 0;
-	std::set<SPylon*> visited;
-	std::queue<SPylon*> queue;
+	MergeDirty();
 
+	std::set<SPylon*> roots;
 	for (SPylon* p : v0->pylons) {
-		queue.push(p);
+		roots.insert(FindRoot(p));
 	}
-
-	while (!queue.empty()) {
-		SPylon* q = queue.front();
-		queue.pop();
-		float dist = q->range;
-		if (v1->pos.SqDistance2D(q->pos) < dist * dist) {
+	for (SPylon* p : v1->pylons) {
+		if (roots.find(FindRoot(p)) != roots.end()) {
 			isFinished = true;
 			return;
 		}
-
-		if (i++ > 1000) {
-			isValid = false;
-			break;
-		}
-
-		visited.insert(q);
-		for (SPylon* child : q->neighbors) {
-			if (visited.find(child) == visited.end()) {
-				queue.push(child);
-			}
-		}
 	}
 
 	isFinished = false;
@@ -124,40 +145,97 @@ void CEnergyLink::SetStartVertex(int index)
 
 CEnergyLink::SPylon* CEnergyLink::GetConnectionHead(SVertex* v0, const AIFloat3& P1)
 {
-	SPylon* winner = nullptr;
-	float minDist = std::numeric_limits<float>::max();
-
-	int i = 0;
-	std::set<SPylon*> visited;
-	std::queue<SPylon*> queue;
+	MergeDirty();
 
+	std::set<SPylon*> roots;
 	for (SPylon* p : v0->pylons) {
-		queue.push(p);
+		roots.insert(FindRoot(p));
+	}
+	if (roots.empty()) {
+		return nullptr;
 	}
 
-	while (!queue.empty()) {
-		SPylon* q = queue.front();
-		queue.pop();
+	SPylon* winner = nullptr;
+	float minDist = std::numeric_limits<float>::max();
+	for (auto& kv : pylons) {
+		SPylon* q = kv.second;
+		if (roots.find(FindRoot(q)) == roots.end()) {
+			continue;
+		}
 		float dist = P1.distance2D(q->pos) - q->range;
 		if (dist < minDist) {
 			minDist = dist;
 			winner = q;
 		}
+	}
 
-		if (i++ > 1000) {
-			isValid = false;
-			return winner;
-		}
+	return winner;
+}
 
-		visited.insert(q);
-		for (SPylon* child : q->neighbors) {
-			if (visited.find(child) == visited.end()) {
-				queue.push(child);
-			}
-		}
+void CEnergyLink::InsertCell(SPylon* pylon)
+{
+	cells[GetCellKey(int(pylon->pos.x / cellSize), int(pylon->pos.z / cellSize))].push_back(pylon);
+}
+
+void CEnergyLink::EraseCell(SPylon* pylon)
+{
+	auto it = cells.find(GetCellKey(int(pylon->pos.x / cellSize), int(pylon->pos.z / cellSize)));
+	if (it == cells.end()) {
+		return;
+	}
+	std::vector<SPylon*>& cell = it->second;
+	auto itp = std::find(cell.begin(), cell.end(), pylon);
+	if (itp != cell.end()) {
+		*itp = cell.back();
+		cell.pop_back();
+	}
+	if (cell.empty()) {
+		cells.erase(it);
 	}
+}
 
-	return winner;
+void CEnergyLink::Rehash(float range)
+{
+	maxRange = range;
+	cellSize = std::max(2.f * maxRange, 1.f);
+	cells.clear();
+	for (auto& kv : pylons) {
+		InsertCell(kv.second);
+	}
+}
+
+CEnergyLink::SPylon* CEnergyLink::FindRoot(SPylon* pylon)
+{
+	while (pylon->parent != pylon) {
+		pylon = pylon->parent = pylon->parent->parent;
+	}
+	return pylon;
+}
+
+void CEnergyLink::Union(SPylon* pylon0, SPylon* pylon1)
+{
+	pylon0 = FindRoot(pylon0);
+	pylon1 = FindRoot(pylon1);
+	if (pylon0 == pylon1) {
+		return;
+	}
+	if (pylon0->rank < pylon1->rank) {
+		std::swap(pylon0, pylon1);
+	}
+	pylon1->parent = pylon0;
+	if (pylon0->rank == pylon1->rank) {
+		++pylon0->rank;
+	}
+}
+
+void CEnergyLink::MergeDirty()
+{
+	for (SPylon* pylon0 : dirtyPylons) {
+		for (SPylon* pylon1 : pylon0->neighbors) {
+			Union(pylon0, pylon1);
+		}
+	}
+	dirtyPylons.clear();
 }
 
 } // namespace circuit
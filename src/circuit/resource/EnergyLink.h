@@ -11,18 +11,23 @@
 #include "unit/CircuitUnit.h"
 
 #include <map>
+#include <cstdint>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace circuit {
 
 class CEnergyLink {
 public:
 	struct SPylon {
-		SPylon() : pos(-RgtVector), range(.0f) {}
-		SPylon(const springai::AIFloat3& p, float r) : pos(p), range(r) {}
+		SPylon() : pos(-RgtVector), range(.0f), parent(this), rank(0) {}
+		SPylon(const springai::AIFloat3& p, float r) : pos(p), range(r), parent(this), rank(0) {}
 		springai::AIFloat3 pos;
 		float range;
 		std::set<SPylon*> neighbors;
+		SPylon* parent;  // union-find over connected pylons
+		int rank;
 	};
 	struct SVertex {
 		SVertex(int index, const springai::AIFloat3& pos) : index(index), pos(pos) {}
@@ -49,12 +54,28 @@ public:
 	SVertex* GetV1() const { return v1; }
 
 private:
+	using CellKey = uint64_t;
+	CellKey GetCellKey(int x, int z) const { return (CellKey(uint32_t(x)) << 32) | uint32_t(z); }
+	void InsertCell(SPylon* pylon);
+	void EraseCell(SPylon* pylon);
+	void Rehash(float range);
+	SPylon* FindRoot(SPylon* pylon);
+	void Union(SPylon* pylon0, SPylon* pylon1);
+	void MergeDirty();
+
 	SVertex *v0, *v1;
 
 	std::map<ICoreUnit::Id, SPylon*> pylons;  // owner
 	bool isBeingBuilt;
 	bool isFinished;
 	bool isValid;
+
+	// Spatial hash of pylons, cell size is the largest connection distance
+	std::unordered_map<CellKey, std::vector<SPylon*>> cells;
+	float cellSize;
+	float maxRange;
+	// Components split by pylon removal, merged again on next query
+	std::set<SPylon*> dirtyPylons;
 };
 
 } // namespace circuit
@@ -0,0 +1,236 @@
+/*
+ * EnergyTree.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "resource/EnergyTree.h"
+#include "util/utils.h"
+#include "lemon/kruskal.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace circuit {
+
+CEnergyTree::CEnergyTree(const CMetalData::Graph& graph)
+		: graph(graph)
+		, ownedFilter(graph, false)
+		, ownedClusters(graph, ownedFilter)
+		, edgeCosts(graph)
+{
+}
+
+CEnergyTree::~CEnergyTree()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+bool CEnergyTree::IsOwnedEdge(const CMetalData::Graph::Edge edge) const
+{
+	return ownedFilter[graph.u(edge)] && ownedFilter[graph.v(edge)];
+}
+
+void CEnergyTree::Kruskal()
+{
+	spanningTree.clear();
+	lemon::kruskal(ownedClusters, edgeCosts, std::inserter(spanningTree, spanningTree.end()));
+}
+
+void CEnergyTree::InsertNode(int index)
+{
+	// Isolated node: first edge connects it, the rest are regular insertions
+	CMetalData::Graph::IncEdgeIt edgeIt(graph, graph.nodeFromId(index));
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		if (IsOwnedEdge(edgeIt)) {
+			InsertEdge(edgeIt);
+		}
+	}
+}
+
+void CEnergyTree::RemoveNode(int index)
+{
+	CMetalData::Graph::Node node = graph.nodeFromId(index);
+	ownedClusters.disable(node);
+	bool isCut = false;
+	CMetalData::Graph::IncEdgeIt edgeIt(graph, node);
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		isCut |= (spanningTree.erase(edgeIt) > 0);
+	}
+	if (isCut) {
+		ReconnectForest();
+	}
+}
+
+void CEnergyTree::UpdateEdge(int edgeIdx, float cost)
+{
+	CMetalData::Graph::Edge edge = graph.edgeFromId(edgeIdx);
+	const float prevCost = edgeCosts[edge];
+	edgeCosts[edge] = cost;
+	if (!IsOwnedEdge(edge)) {
+		return;
+	}
+
+	if (spanningTree.find(edge) != spanningTree.end()) {
+		if (cost > prevCost) {  // cheaper edge may cross the cut now
+			spanningTree.erase(edge);
+			ReconnectForest();
+		}
+	} else if (cost < prevCost) {  // may replace the most expensive edge of the cycle
+		InsertEdge(edge);
+	}
+}
+
+bool CEnergyTree::Rebuild(const std::vector<int>& removedNodes, const std::vector<int>& insertedNodes,
+						  std::set<int>& dirtyEdges, CostFunc& calcCost)
+{
+	if (spanningTree.empty()) {
+		return false;
+	}
+
+	// Refresh costs of tree edges, increased ones are re-evaluated below
+	for (const CMetalData::Graph::Edge edge : spanningTree) {
+		const float cost = calcCost(edge);
+		if (cost > edgeCosts[edge]) {
+			dirtyEdges.insert(graph.id(edge));
+		} else {
+			edgeCosts[edge] = cost;
+		}
+	}
+
+	const int opsCount = removedNodes.size() + insertedNodes.size() + dirtyEdges.size();
+	if (opsCount * 4 > GetSize()) {
+		return false;
+	}
+
+	// Apply single changes to current tree
+	for (int index : removedNodes) {
+		RemoveNode(index);
+	}
+
+	for (int index : insertedNodes) {
+		EnableNode(index);
+		CMetalData::Graph::IncEdgeIt edgeIt(graph, graph.nodeFromId(index));
+		for (; edgeIt != lemon::INVALID; ++edgeIt) {
+			if (IsOwnedEdge(edgeIt)) {
+				edgeCosts[edgeIt] = calcCost(edgeIt);
+			}
+		}
+		InsertNode(index);
+	}
+
+	for (int edgeIdx : dirtyEdges) {
+		UpdateEdge(edgeIdx, calcCost(graph.edgeFromId(edgeIdx)));
+	}
+	return true;
+}
+
+void CEnergyTree::InsertEdge(const CMetalData::Graph::Edge edge)
+{
+	CMetalData::Graph::Edge maxEdge;
+	if (!FindPathMaxEdge(graph.u(edge), graph.v(edge), maxEdge)) {
+		spanningTree.insert(edge);  // connects 2 trees of the forest
+	} else if (edgeCosts[maxEdge] > edgeCosts[edge]) {
+		spanningTree.erase(maxEdge);
+		spanningTree.insert(edge);
+	}
+}
+
+bool CEnergyTree::FindPathMaxEdge(const CMetalData::Graph::Node source, const CMetalData::Graph::Node target,
+								  CMetalData::Graph::Edge& outEdge)
+{
+	const int targetIdx = graph.id(target);
+	parentEdges.assign(graph.nodeNum(), -1);
+	nodeQueue.clear();
+	nodeQueue.push_back(graph.id(source));
+	parentEdges[nodeQueue.front()] = graph.edgeNum();  // visited root
+
+	// Breadth-first search over spanning tree edges
+	for (unsigned i = 0; (i < nodeQueue.size()) && (parentEdges[targetIdx] < 0); ++i) {
+		CMetalData::Graph::Node node = graph.nodeFromId(nodeQueue[i]);
+		CMetalData::Graph::IncEdgeIt edgeIt(graph, node);
+		for (; edgeIt != lemon::INVALID; ++edgeIt) {
+			const int idx = graph.id(graph.oppositeNode(node, edgeIt));
+			if ((parentEdges[idx] < 0) && (spanningTree.find(edgeIt) != spanningTree.end())) {
+				parentEdges[idx] = graph.id(edgeIt);
+				nodeQueue.push_back(idx);
+			}
+		}
+	}
+	if (parentEdges[targetIdx] < 0) {
+		return false;
+	}
+
+	float maxCost = -std::numeric_limits<float>::max();
+	CMetalData::Graph::Node node = target;
+	while (node != source) {
+		CMetalData::Graph::Edge edge = graph.edgeFromId(parentEdges[graph.id(node)]);
+		if (maxCost < edgeCosts[edge]) {
+			maxCost = edgeCosts[edge];
+			outEdge = edge;
+		}
+		node = graph.oppositeNode(node, edge);
+	}
+	return true;
+}
+
+void CEnergyTree::ReconnectForest()
+{
+	// Label trees of the forest
+	int labelCount = 0;
+	nodeLabels.assign(graph.nodeNum(), -1);
+	for (OwnedGraph::NodeIt nodeIt(ownedClusters); nodeIt != lemon::INVALID; ++nodeIt) {
+		if (nodeLabels[graph.id(nodeIt)] >= 0) {
+			continue;
+		}
+		nodeQueue.clear();
+		nodeQueue.push_back(graph.id(nodeIt));
+		nodeLabels[nodeQueue.front()] = labelCount;
+		for (unsigned i = 0; i < nodeQueue.size(); ++i) {
+			CMetalData::Graph::Node node = graph.nodeFromId(nodeQueue[i]);
+			CMetalData::Graph::IncEdgeIt edgeIt(graph, node);
+			for (; edgeIt != lemon::INVALID; ++edgeIt) {
+				const int idx = graph.id(graph.oppositeNode(node, edgeIt));
+				if ((nodeLabels[idx] < 0) && (spanningTree.find(edgeIt) != spanningTree.end())) {
+					nodeLabels[idx] = labelCount;
+					nodeQueue.push_back(idx);
+				}
+			}
+		}
+		++labelCount;
+	}
+	if (labelCount < 2) {
+		return;
+	}
+
+	// Kruskal over edges between trees: every edge of the forest stays in the new tree
+	std::vector<std::pair<float, int>> crossEdges;
+	for (OwnedGraph::EdgeIt edgeIt(ownedClusters); edgeIt != lemon::INVALID; ++edgeIt) {
+		if (nodeLabels[graph.id(graph.u(edgeIt))] != nodeLabels[graph.id(graph.v(edgeIt))]) {
+			crossEdges.push_back(std::make_pair(edgeCosts[edgeIt], graph.id(edgeIt)));
+		}
+	}
+	std::sort(crossEdges.begin(), crossEdges.end());
+
+	std::vector<int> roots(labelCount);
+	std::iota(roots.begin(), roots.end(), 0);
+	auto findRoot = [&roots](int label) {
+		while (roots[label] != label) {
+			label = roots[label] = roots[roots[label]];
+		}
+		return label;
+	};
+	for (const std::pair<float, int>& ce : crossEdges) {
+		CMetalData::Graph::Edge edge = graph.edgeFromId(ce.second);
+		const int root0 = findRoot(nodeLabels[graph.id(graph.u(edge))]);
+		const int root1 = findRoot(nodeLabels[graph.id(graph.v(edge))]);
+		if (root0 != root1) {
+			roots[root0] = root1;
+			spanningTree.insert(edge);
+		}
+	}
+}
+
+} // namespace circuit
@@ -0,0 +1,76 @@
+/*
+ * EnergyTree.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_RESOURCE_ENERGYTREE_H_
+#define SRC_CIRCUIT_RESOURCE_ENERGYTREE_H_
+
+#include "resource/MetalData.h"
+#include "lemon/adaptors.h"
+
+#include <set>
+#include <vector>
+#include <functional>
+
+namespace circuit {
+
+/*
+ * Minimum spanning forest of owned clusters of CMetalData::Graph.
+ * Edge costs are set by the owner (CEnergyGrid), tree keeps them as of last insertion.
+ */
+class CEnergyTree {
+public:
+	using OwnedFilter = CMetalData::Graph::NodeMap<bool>;
+	using OwnedGraph = lemon::FilterNodes<const CMetalData::Graph, OwnedFilter>;
+	using SpanningTree = std::set<CMetalData::Graph::Edge>;
+	using CostFunc = std::function<float (const CMetalData::Graph::Edge edge)>;
+
+	CEnergyTree(const CMetalData::Graph& graph);
+	virtual ~CEnergyTree();
+
+	const SpanningTree& GetSpanningTree() const { return spanningTree; }
+	bool IsEmpty() const { return spanningTree.empty(); }
+	int GetSize() const { return spanningTree.size(); }
+
+	float GetCost(const CMetalData::Graph::Edge edge) const { return edgeCosts[edge]; }
+	void SetCost(const CMetalData::Graph::Edge edge, float cost) { edgeCosts[edge] = cost; }
+	bool IsOwnedEdge(const CMetalData::Graph::Edge edge) const;
+	void EnableNode(int index) { ownedClusters.enable(graph.nodeFromId(index)); }
+	void DisableNode(int index) { ownedClusters.disable(graph.nodeFromId(index)); }
+
+	// Full rebuild over owned clusters with current costs
+	void Kruskal();
+	// Enabled node with costs of its owned edges set
+	void InsertNode(int index);
+	void RemoveNode(int index);
+	void UpdateEdge(int edgeIdx, float cost);
+	/*
+	 * Refreshes costs of tree edges, then applies removed and inserted nodes and dirty edges one by one.
+	 * Returns false if tree is empty or changes are comparable to its size, then full Kruskal is cheaper.
+	 */
+	bool Rebuild(const std::vector<int>& removedNodes, const std::vector<int>& insertedNodes,
+				 std::set<int>& dirtyEdges, CostFunc& calcCost);
+
+private:
+	void InsertEdge(const CMetalData::Graph::Edge edge);
+	bool FindPathMaxEdge(const CMetalData::Graph::Node source, const CMetalData::Graph::Node target,
+						 CMetalData::Graph::Edge& outEdge);
+	void ReconnectForest();
+
+	const CMetalData::Graph& graph;
+	SpanningTree spanningTree;
+	OwnedFilter ownedFilter;
+	OwnedGraph ownedClusters;
+	CMetalData::WeightMap edgeCosts;
+
+	std::vector<int> nodeQueue;  // scratch
+	std::vector<int> nodeLabels;  // scratch: node id: tree of the forest
+	std::vector<int> parentEdges;  // scratch: node id: edge id to BFS parent
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_RESOURCE_ENERGYTREE_H_
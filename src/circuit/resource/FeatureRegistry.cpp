@@ -0,0 +1,227 @@
+/*
+ * FeatureRegistry.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "resource/FeatureRegistry.h"
+#include "terrain/TerrainManager.h"
+#include "CircuitAI.h"
+#include "util/utils.h"
+
+#include "SSkirmishAICallback.h"
+#include "OOAICallback.h"
+#include "Map.h"
+#include "Resource.h"
+
+#include <algorithm>
+
+namespace circuit {
+
+using namespace springai;
+
+#define FEATURE_CELL_SIZE	512
+#define FEATURE_UPDATE_RATE	(FRAMES_PER_SEC * 3)
+
+CFeatureRegistry::CFeatureRegistry(CCircuitAI* circuit)
+		: circuit(circuit)
+		, updateFrame(-FEATURE_UPDATE_RATE)
+{
+	Resource* metalRes = circuit->GetCallback()->GetResourceByName("Metal");
+	metalResId = metalRes->GetResourceId();
+	delete metalRes;
+
+	Map* map = circuit->GetMap();
+	columns = (map->GetWidth() * SQUARE_SIZE + FEATURE_CELL_SIZE - 1) / FEATURE_CELL_SIZE;
+	rows = (map->GetHeight() * SQUARE_SIZE + FEATURE_CELL_SIZE - 1) / FEATURE_CELL_SIZE;
+	cells.resize(columns * rows);
+}
+
+CFeatureRegistry::~CFeatureRegistry()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CFeatureRegistry::Update()
+{
+	const int frame = circuit->GetLastFrame();
+	if (updateFrame + FEATURE_UPDATE_RATE > frame) {
+		return;
+	}
+	updateFrame = frame;
+
+	const SSkirmishAICallback* sAICallback = circuit->GetSkirmishAICallback();
+	const int skirmishAIId = circuit->GetSkirmishAIId();
+	std::vector<Id> newIds(sAICallback->getFeatures(skirmishAIId, nullptr, -1));
+	if (!newIds.empty()) {
+		const int size = sAICallback->getFeatures(skirmishAIId, newIds.data(), newIds.size());
+		newIds.resize(size);
+	}
+	std::sort(newIds.begin(), newIds.end());
+
+	// @see std::set_difference
+	auto first1 = newIds.cbegin();
+	auto last1  = newIds.cend();
+	auto first2 = featureIds.cbegin();
+	auto last2  = featureIds.cend();
+	while (first1 != last1) {
+		if (first2 == last2) {
+			while (first1 != last1) {
+				AddFeature(*first1++);  // everything else in first1..last1 is new features
+			}
+			break;
+		}
+		if (*first1 < *first2) {
+			AddFeature(*first1++);  // new feature
+		} else {
+			if (*first2 < *first1) {
+				RemoveFeature(*first2);  // gone feature
+			} else {
+				++first1;  // old feature
+			}
+			++first2;
+		}
+	}
+	while (first2 != last2) {  // everything else in first2..last2 is gone features
+		RemoveFeature(*first2++);
+	}
+
+	featureIds = std::move(newIds);
+}
+
+const CFeatureRegistry::SFeature* CFeatureRegistry::FindNearest(const AIFloat3& pos, float maxDist, float minMetal,
+																const FeaturePredicate& predicate)
+{
+	// NOTE: Update is rate limited, reclaimed feature may still be in the grid
+	const SFeature* result;
+	while (((result = FindNearestLocal(pos, maxDist, minMetal, predicate)) != nullptr) && !IsAlive(result->id)) {
+		FeatureDestroyed(result->id);
+	}
+	return result;
+}
+
+void CFeatureRegistry::FeatureDestroyed(Id featureId)
+{
+	RemoveFeature(featureId);
+	// id may be reused by a new feature, next Update must see it as new
+	auto it = std::lower_bound(featureIds.begin(), featureIds.end(), featureId);
+	if ((it != featureIds.end()) && (*it == featureId)) {
+		featureIds.erase(it);
+	}
+}
+
+const CFeatureRegistry::SFeature* CFeatureRegistry::FindNearestLocal(const AIFloat3& pos, float maxDist, float minMetal,
+																	 const FeaturePredicate& predicate) const
+{
+	const int cx = utils::clamp(int(pos.x / FEATURE_CELL_SIZE), 0, columns - 1);
+	const int cz = utils::clamp(int(pos.z / FEATURE_CELL_SIZE), 0, rows - 1);
+	const int maxSize = std::max(columns, rows);
+	const int maxRing = (maxDist < maxSize * FEATURE_CELL_SIZE) ? int(maxDist / FEATURE_CELL_SIZE) + 1 : maxSize;
+	const float maxSqDist = SQUARE(maxDist);
+
+	const SFeature* result = nullptr;
+	float minSqDist = maxSqDist;
+	auto checkCell = [this, &pos, minMetal, &predicate, &result, &minSqDist](int x, int z) {
+		if ((x < 0) || (x >= columns) || (z < 0) || (z >= rows)) {
+			return;
+		}
+		for (Id featureId : cells[z * columns + x]) {
+			const SFeature& feature = features.find(featureId)->second;
+			if (feature.metal < minMetal) {
+				continue;
+			}
+			const float sqDist = pos.SqDistance2D(feature.position);
+			if ((sqDist < minSqDist) && predicate(feature)) {
+				result = &feature;
+				minSqDist = sqDist;
+			}
+		}
+	};
+
+	for (int ring = 0; ring <= maxRing; ++ring) {
+		// cells of this ring are at least (ring - 1) * FEATURE_CELL_SIZE away
+		if ((result != nullptr) && (minSqDist <= SQUARE((ring - 1) * FEATURE_CELL_SIZE))) {
+			break;
+		}
+		if (ring == 0) {
+			checkCell(cx, cz);
+			continue;
+		}
+		for (int x = cx - ring; x <= cx + ring; ++x) {
+			checkCell(x, cz - ring);
+			checkCell(x, cz + ring);
+		}
+		for (int z = cz - ring + 1; z <= cz + ring - 1; ++z) {
+			checkCell(cx - ring, z);
+			checkCell(cx + ring, z);
+		}
+	}
+
+	return result;
+}
+
+bool CFeatureRegistry::IsAlive(Id featureId) const
+{
+	return circuit->GetSkirmishAICallback()->Feature_getDef(circuit->GetSkirmishAIId(), featureId) >= 0;
+}
+
+float CFeatureRegistry::GetDefMetal(int defId)
+{
+	auto it = defMetals.find(defId);
+	if (it != defMetals.end()) {
+		return it->second;
+	}
+
+	const SSkirmishAICallback* sAICallback = circuit->GetSkirmishAICallback();
+	const int skirmishAIId = circuit->GetSkirmishAIId();
+	float metal = .0f;
+	if (sAICallback->FeatureDef_isReclaimable(skirmishAIId, defId)) {
+		metal = sAICallback->FeatureDef_getContainedResource(skirmishAIId, defId, metalResId);
+	}
+	defMetals[defId] = metal;
+	return metal;
+}
+
+int CFeatureRegistry::GetCellIndex(const AIFloat3& pos) const
+{
+	const int x = utils::clamp(int(pos.x / FEATURE_CELL_SIZE), 0, columns - 1);
+	const int z = utils::clamp(int(pos.z / FEATURE_CELL_SIZE), 0, rows - 1);
+	return z * columns + x;
+}
+
+void CFeatureRegistry::AddFeature(Id featureId)
+{
+	const SSkirmishAICallback* sAICallback = circuit->GetSkirmishAICallback();
+	const int skirmishAIId = circuit->GetSkirmishAIId();
+
+	SFeature feature;
+	feature.id = featureId;
+	feature.defId = sAICallback->Feature_getDef(skirmishAIId, featureId);
+	float pos[3];
+	sAICallback->Feature_getPosition(skirmishAIId, featureId, pos);
+	feature.position = AIFloat3(pos[0], pos[1], pos[2]);
+	CTerrainManager::CorrectPosition(feature.position);  // Impulsed flying feature
+	feature.metal = (feature.defId < 0) ? .0f : GetDefMetal(feature.defId);
+
+	features[featureId] = feature;
+	cells[GetCellIndex(feature.position)].push_back(featureId);
+}
+
+void CFeatureRegistry::RemoveFeature(Id featureId)
+{
+	auto it = features.find(featureId);
+	if (it == features.end()) {
+		return;
+	}
+
+	std::vector<Id>& cell = cells[GetCellIndex(it->second.position)];
+	auto itc = std::find(cell.begin(), cell.end(), featureId);
+	if (itc != cell.end()) {
+		*itc = cell.back();
+		cell.pop_back();
+	}
+	features.erase(it);
+}
+
+} // namespace circuit
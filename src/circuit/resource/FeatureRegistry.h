@@ -0,0 +1,75 @@
+/*
+ * FeatureRegistry.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_RESOURCE_FEATUREREGISTRY_H_
+#define SRC_CIRCUIT_RESOURCE_FEATUREREGISTRY_H_
+
+#include "AIFloat3.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace circuit {
+
+class CCircuitAI;
+
+/*
+ * Local copy of visible features (wrecks, trees, rocks) with uniform grid index.
+ * Synced with engine by id diff not more often than FEATURE_UPDATE_RATE,
+ * so reclaim queries don't create engine wrappers for every feature.
+ */
+class CFeatureRegistry {
+public:
+	using Id = int;
+	struct SFeature {
+		Id id;
+		int defId;
+		springai::AIFloat3 position;
+		float metal;  // contained metal, 0 if not reclaimable
+	};
+	using FeaturePredicate = std::function<bool (const SFeature& feature)>;
+
+	CFeatureRegistry(CCircuitAI* circuit);
+	virtual ~CFeatureRegistry();
+
+	void Update();
+	// Nearest feature within maxDist (2D) with at least minMetal that satisfies predicate,
+	// result is checked against engine and gone features are erased on the way
+	const SFeature* FindNearest(const springai::AIFloat3& pos, float maxDist, float minMetal,
+								const FeaturePredicate& predicate);
+	// Feature is gone before next Update, e.g. reclaimed
+	void FeatureDestroyed(Id featureId);
+	int GetFeatureCount() const { return features.size(); }
+
+	void SetAuthority(CCircuitAI* authority) { circuit = authority; }
+
+private:
+	const SFeature* FindNearestLocal(const springai::AIFloat3& pos, float maxDist, float minMetal,
+									 const FeaturePredicate& predicate) const;
+	bool IsAlive(Id featureId) const;
+	float GetDefMetal(int defId);
+	int GetCellIndex(const springai::AIFloat3& pos) const;
+	void AddFeature(Id featureId);
+	void RemoveFeature(Id featureId);
+
+	CCircuitAI* circuit;
+	int updateFrame;
+	int metalResId;
+
+	std::unordered_map<Id, SFeature> features;
+	std::unordered_map<int, float> defMetals;  // FeatureDef id: contained metal
+	std::vector<Id> featureIds;  // sorted ids of last update
+
+	int columns;
+	int rows;
+	std::vector<std::vector<Id>> cells;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_RESOURCE_FEATUREREGISTRY_H_
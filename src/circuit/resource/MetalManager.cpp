@@ -18,25 +18,24 @@
 #include "Pathing.h"
 #include "Map.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace circuit {
 
 using namespace springai;
 
 class CMetalManager::SafeCluster : public lemon::MapBase<ClusterGraph::Node, bool> {
 public:
-	SafeCluster(CThreatMap* tm, const CMetalData::Clusters& cs)
-		: threatMap(tm)
-		, clusters(cs)
+	SafeCluster()
+		: safeClusters(nullptr)
 	{}
+	void SetSafeClusters(const std::vector<bool>* safe) { safeClusters = safe; }
 	Value operator[](Key k) const {
-		return (*this)[CMetalData::Graph::id(k)];
-	}
-	Value operator[](int u) const {
-		return threatMap->GetThreatAt(clusters[u].position) <= THREAT_MIN;
+		return (*safeClusters)[CMetalData::Graph::id(k)];
 	}
 private:
-	CThreatMap* threatMap;
-	const CMetalData::Clusters& clusters;
+	const std::vector<bool>* safeClusters;
 };
 
 class CMetalManager::DetectCluster : public lemon::MapBase<ClusterGraph::Node, bool> {
@@ -52,7 +51,7 @@ public:
 			return false;
 		}
 		for (int index : manager->GetClusters()[u].idxSpots) {
-			if (predicate(index)) {
+			if (manager->IsOpenSpot(index) && predicate(index)) {
 				indices.push_back(index);
 			}
 		}
@@ -77,6 +76,12 @@ CMetalManager::CMetalManager(CCircuitAI* circuit, CMetalData* metalData)
 		ParseMetalSpots();
 	}
 	metalInfos.resize(metalData->GetSpots().size(), {true, -1});
+
+	std::vector<AIFloat3> positions;
+	for (const CMetalData::SMetal& spot : metalData->GetSpots()) {
+		positions.push_back(spot.position);
+	}
+	openSpotIndex.Init(positions, true);
 }
 
 CMetalManager::~CMetalManager()
@@ -199,7 +204,7 @@ void CMetalManager::Init()
 		}
 	}
 
-	threatFilter = new SafeCluster(circuit->GetThreatMap(), GetClusters());
+	threatFilter = new SafeCluster();
 	filteredGraph = new ClusterGraph(GetGraph(), *threatFilter);
 	shortPath = new ShortPath(*filteredGraph, GetWeights());
 }
@@ -209,6 +214,7 @@ void CMetalManager::SetOpenSpot(int index, bool value)
 	if (metalInfos[index].isOpen != value) {
 		metalInfos[index].isOpen = value;
 		clusterInfos[metalInfos[index].clusterId].queuedCount += value ? -1 : 1;
+		value ? openSpotIndex.Insert(index) : openSpotIndex.Erase(index);
 	}
 }
 
@@ -317,7 +323,11 @@ bool CMetalManager::IsMexInFinished(int index) const
 int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate& predicate)
 {
 	int index = FindNearestCluster(pos);
-	if (index < 0 || !(*threatFilter)[index]) {
+	if (index < 0) {
+		return -1;
+	}
+	SSafeLayer& layer = GetSafeLayer();
+	if (!layer.safeClusters[index]) {
 		return -1;
 	}
 	MarkAllyMexes();
@@ -325,12 +335,17 @@ int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate
 	static std::vector<int> indices;  // NOTE: micro-opt
 	int result = -1;
 
+	// Walk clusters in order of distance, same as Dijkstra with goal map
 	DetectCluster goal(this, predicate, indices);
-	shortPath->init();
-	shortPath->addSource(filteredGraph->nodeFromId(index));
-	CMetalData::Graph::Node target = shortPath->start(goal);
+	bool isFound = false;
+	for (int target : GetClusterOrder(layer, index)) {
+		if (goal[GetGraph().nodeFromId(target)]) {
+			isFound = true;
+			break;
+		}
+	}
 
-	if (target != lemon::INVALID) {
+	if (isFound) {
 		float sqMinDist = std::numeric_limits<float>::max();
 		for (int index : indices) {
 			float sqDist = GetSpots()[index].position.SqDistance2D(pos);
@@ -345,4 +360,67 @@ int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate
 	return result;
 }
 
+CMetalManager::SSafeLayer& CMetalManager::GetSafeLayer()
+{
+	CThreatMap* threatMap = circuit->GetThreatMap();
+	const float* threatLayer = threatMap->GetThreatLayer();
+	auto it = std::find_if(safeLayers.begin(), safeLayers.end(), [threatLayer](const SSafeLayer& layer) {
+		return layer.threatLayer == threatLayer;
+	});
+	if (it == safeLayers.end()) {
+		const unsigned size = GetClusters().size();
+		safeLayers.push_back(SSafeLayer {threatLayer, -1, std::vector<bool>(size, false), std::vector<std::vector<int>>(size)});
+		it = std::prev(safeLayers.end());
+	}
+	SSafeLayer& layer = *it;
+
+	const int updateNum = threatMap->GetClusterUpdateNum();
+	if (layer.updateNum == updateNum) {
+		return layer;
+	}
+
+	// Orders stay valid while safety bits are the same
+	bool isChanged = false;
+	auto updateSafe = [threatMap, &layer, &isChanged](int i) {
+		const bool isSafe = threatMap->GetClusterThreat(i) <= THREAT_MIN;
+		if (layer.safeClusters[i] != isSafe) {
+			layer.safeClusters[i] = isSafe;
+			isChanged = true;
+		}
+	};
+	if ((layer.updateNum >= 0) && (layer.updateNum + 1 == updateNum)) {
+		// Only last update is missed: its dirty clusters are the changed ones
+		for (int i : threatMap->GetDirtyClusters()) {
+			updateSafe(i);
+		}
+	} else {
+		for (unsigned i = 0; i < layer.safeClusters.size(); ++i) {
+			updateSafe(i);
+		}
+	}
+	layer.updateNum = updateNum;
+	if (isChanged) {
+		for (std::vector<int>& order : layer.orders) {
+			order.clear();
+		}
+	}
+	return layer;
+}
+
+const std::vector<int>& CMetalManager::GetClusterOrder(SSafeLayer& layer, int source)
+{
+	std::vector<int>& order = layer.orders[source];
+	if (!order.empty()) {  // contains source at least
+		return order;
+	}
+
+	threatFilter->SetSafeClusters(&layer.safeClusters);
+	shortPath->init();
+	shortPath->addSource(filteredGraph->nodeFromId(source));
+	while (!shortPath->emptyQueue()) {
+		order.push_back(GetGraph().id(shortPath->processNextNode()));
+	}
+	return order;
+}
+
 } // namespace circuit
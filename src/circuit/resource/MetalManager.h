@@ -9,6 +9,7 @@
 #define SRC_CIRCUIT_METALMANAGER_H_
 
 #include "resource/MetalData.h"
+#include "resource/SpotIndex.h"
 #include "unit/CircuitUnit.h"
 #include "lemon/adaptors.h"
 #include "lemon/dijkstra.h"
@@ -62,6 +63,10 @@ public:
 	void SetOpenSpot(const springai::AIFloat3& pos, bool value);
 	bool IsOpenSpot(int index) const { return metalInfos[index].isOpen; }
 	bool IsOpenSpot(const springai::AIFloat3& pos) const;
+	// Searches only among open spots
+	int FindNearestOpenSpot(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate) const {
+		return openSpotIndex.FindNearest(pos, predicate);
+	}
 	void MarkAllyMexes();
 	void MarkAllyMexes(const std::vector<CAllyUnit*>& mexes);
 	bool IsClusterFinished(int index) const {
@@ -92,6 +97,7 @@ private:
 		unsigned int finishedCount;
 	};
 	std::vector<SMetalInfo> metalInfos;
+	CSpotIndex openSpotIndex;
 	std::vector<SClusterInfo> clusterInfos;
 
 	int markFrame;
@@ -109,6 +115,17 @@ private:
 	SafeCluster* threatFilter;
 	ClusterGraph* filteredGraph;
 	ShortPath* shortPath;
+
+	// Shortest-path order over safe clusters, per threat layer and source cluster
+	struct SSafeLayer {
+		const float* threatLayer;
+		int updateNum;  // CThreatMap::GetClusterUpdateNum of safeClusters
+		std::vector<bool> safeClusters;
+		std::vector<std::vector<int>> orders;  // source: clusters in order of distance, empty if not cached
+	};
+	std::vector<SSafeLayer> safeLayers;
+	SSafeLayer& GetSafeLayer();
+	const std::vector<int>& GetClusterOrder(SSafeLayer& layer, int source);
 };
 
 } // namespace circuit
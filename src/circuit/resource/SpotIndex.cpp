@@ -0,0 +1,103 @@
+/*
+ * SpotIndex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "resource/SpotIndex.h"
+
+namespace circuit {
+
+using namespace springai;
+using namespace nanoflann;
+
+CSpotIndex::CSpotIndex()
+		: adaptor(*this)
+		, tree(2 /*dim*/, adaptor, KDTreeSingleIndexAdaptorParams(8 /*max leaf*/))
+		, isDirty(false)
+{
+}
+
+CSpotIndex::~CSpotIndex()
+{
+}
+
+void CSpotIndex::Init(const std::vector<AIFloat3>& positions, bool isFull)
+{
+	points = positions;
+	members.clear();
+	slots.assign(points.size(), -1);
+	if (isFull) {
+		for (unsigned i = 0; i < points.size(); ++i) {
+			slots[i] = members.size();
+			members.push_back(i);
+		}
+	}
+	isDirty = true;
+}
+
+void CSpotIndex::Insert(int index)
+{
+	if (slots[index] >= 0) {
+		return;
+	}
+	slots[index] = members.size();
+	members.push_back(index);
+	isDirty = true;
+}
+
+void CSpotIndex::Erase(int index)
+{
+	const int slot = slots[index];
+	if (slot < 0) {
+		return;
+	}
+	members[slot] = members.back();
+	slots[members[slot]] = slot;
+	members.pop_back();
+	slots[index] = -1;
+	isDirty = true;
+}
+
+int CSpotIndex::FindNearest(const AIFloat3& pos) const
+{
+	Rebuild();
+
+	float query_pt[2] = {pos.x, pos.z};
+	int ret_index;
+	float out_dist_sqr;
+
+	if (tree.knnSearch(&query_pt[0], 1, &ret_index, &out_dist_sqr) > 0) {
+		return members[ret_index];
+	}
+	return -1;
+}
+
+int CSpotIndex::FindNearest(const AIFloat3& pos, CMetalData::PointPredicate& predicate) const
+{
+	Rebuild();
+
+	float query_pt[2] = {pos.x, pos.z};
+	int ret_index;
+	float out_dist_sqr;
+
+	CMetalData::PointPredicate memberPredicate = [this, &predicate](const int index) {
+		return predicate(members[index]);
+	};
+	if (tree.knnSearch(&query_pt[0], 1, &ret_index, &out_dist_sqr, memberPredicate) > 0) {
+		return members[ret_index];
+	}
+	return -1;
+}
+
+void CSpotIndex::Rebuild() const
+{
+	if (!isDirty) {
+		return;
+	}
+	isDirty = false;
+	tree.buildIndex();
+}
+
+} // namespace circuit
@@ -0,0 +1,64 @@
+/*
+ * SpotIndex.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_RESOURCE_SPOTINDEX_H_
+#define SRC_CIRCUIT_RESOURCE_SPOTINDEX_H_
+
+#include "resource/MetalData.h"
+
+namespace circuit {
+
+/*
+ * Kd-tree over changing subset of fixed points (metal spots or clusters).
+ * Members are tracked incrementally, tree is rebuilt on first query after change.
+ * Queries and predicates operate on indices of original points.
+ */
+class CSpotIndex {
+public:
+	CSpotIndex();
+	virtual ~CSpotIndex();
+
+	void Init(const std::vector<springai::AIFloat3>& positions, bool isFull);
+
+	void Insert(int index);
+	void Erase(int index);
+	bool Contains(int index) const { return slots[index] >= 0; }
+	bool IsEmpty() const { return members.empty(); }
+
+	int FindNearest(const springai::AIFloat3& pos) const;
+	int FindNearest(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate) const;
+
+private:
+	struct SAdaptor {
+		const CSpotIndex& owner;
+		SAdaptor(const CSpotIndex& o) : owner(o) {}
+		inline size_t kdtree_get_point_count() const { return owner.members.size(); }
+		inline float kdtree_get_pt(const size_t idx, const size_t dim) const {
+			const springai::AIFloat3& pos = owner.points[owner.members[idx]];
+			return (dim == 0) ? pos.x : pos.z;
+		}
+		template <class BBOX>
+		bool kdtree_get_bbox(BBOX& /* bb */) const { return false; }
+	};
+	using Tree = nanoflann::KDTreeSingleIndexAdaptor<
+			nanoflann::L2_Simple_Adaptor<float, SAdaptor>,
+			SAdaptor,
+			2 /* dim */, int>;
+
+	void Rebuild() const;
+
+	std::vector<springai::AIFloat3> points;
+	std::vector<int> members;  // indices of points
+	std::vector<int> slots;  // point index: position in members, -1 if not a member
+	SAdaptor adaptor;
+	mutable Tree tree;
+	mutable bool isDirty;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_RESOURCE_SPOTINDEX_H_
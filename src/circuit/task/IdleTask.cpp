@@ -28,11 +28,13 @@ void CIdleTask::AssignTo(CCircuitUnit* unit)
 {
 	unit->SetTask(this);
 	units.insert(unit);
+	newUnits.insert(unit);
 }
 
 void CIdleTask::RemoveAssignee(CCircuitUnit* unit)
 {
 	if (units.erase(unit) > 0) {
+		newUnits.erase(unit);
 		updateUnits.erase(unit);
 	}
 
@@ -68,6 +70,7 @@ void CIdleTask::Update()
 void CIdleTask::Close(bool done)
 {
 	units.clear();
+	newUnits.clear();
 	updateUnits.clear();
 }
 
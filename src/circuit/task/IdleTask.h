@@ -28,7 +28,11 @@ public:
 	virtual void OnUnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker) override;
 	virtual void OnUnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker) override;
 
+	// Units that went idle since manager took them last time
+	std::set<CCircuitUnit*>& GetNewUnits() { return newUnits; }
+
 private:
+	std::set<CCircuitUnit*> newUnits;
 	std::set<CCircuitUnit*> updateUnits;
 	unsigned int updateSlice;
 };
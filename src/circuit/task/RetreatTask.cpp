@@ -42,7 +42,7 @@ void CRetreatTask::AssignTo(CCircuitUnit* unit)
 	IUnitTask::AssignTo(unit);
 
 	if (unit->HasDGun()) {
-		CDGunAction* act = new CDGunAction(unit, unit->GetDGunRange() * 0.8f);
+		CDGunAction* act = new CDGunAction(unit, unit->GetDGunRange(manager->GetCircuit()->GetLastFrame()) * 0.8f);
 		unit->PushBack(act);
 	}
 
@@ -9,6 +9,7 @@
 #include "task/NilTask.h"
 #include "task/IdleTask.h"
 #include "unit/CircuitUnit.h"
+#include "CircuitAI.h"
 
 namespace circuit {
 
@@ -42,12 +43,12 @@ void ITaskManager::AssignTask(CCircuitUnit* unit)
 
 void ITaskManager::AddMetalPull(CCircuitUnit* unit)
 {
-	metalPull += unit->GetBuildSpeed();
+	metalPull += unit->GetBuildSpeed(GetCircuit()->GetLastFrame());
 }
 
 void ITaskManager::DelMetalPull(CCircuitUnit* unit)
 {
-	metalPull -= unit->GetBuildSpeed();
+	metalPull -= unit->GetBuildSpeed(GetCircuit()->GetLastFrame());
 }
 
 void ITaskManager::Init()
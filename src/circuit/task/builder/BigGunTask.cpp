@@ -33,25 +33,23 @@ void CBBigGunTask::Finish()
 	IBuilderTask::Finish();
 }
 
-CAllyUnit* CBBigGunTask::FindSameAlly(CCircuitUnit* builder, const std::vector<Unit*>& friendlies)
+CAllyUnit* CBBigGunTask::FindSameAlly(CCircuitUnit* builder, const AIFloat3& pos, float radius)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	const int frame = circuit->GetLastFrame();
 
-	for (Unit* au : friendlies) {
-		CAllyUnit* alu = circuit->GetFriendlyUnit(au);
-		if (alu == nullptr) {
-			continue;
+	CAllyUnit* result = nullptr;
+	circuit->ForEachFriendlyInRadius(pos, radius, [&](CAllyUnit* alu) {
+		if (alu->GetCircuitDef()->IsRoleSuper() && alu->GetUnit()->IsBeingBuilt()
+			&& terrainManager->CanBuildAtSafe(builder, alu->GetPos(frame)))
+		{
+			result = alu;
+			return true;
 		}
-		if (alu->GetCircuitDef()->IsRoleSuper() && au->IsBeingBuilt()) {
-			const AIFloat3& pos = alu->GetPos(frame);
-			if (terrainManager->CanBuildAtSafe(builder, pos)) {
-				return alu;
-			}
-		}
-	}
-	return nullptr;
+		return false;
+	});
+	return result;
 }
 
 } // namespace circuit
@@ -22,7 +22,7 @@ public:
 protected:
 	virtual void Finish() override;
 
-	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const std::vector<springai::Unit*>& friendlies) override;
+	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const springai::AIFloat3& pos, float radius) override;
 };
 
 } // namespace circuit
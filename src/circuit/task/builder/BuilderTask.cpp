@@ -83,7 +83,7 @@ void IBuilderTask::AssignTo(CCircuitUnit* unit)
 	}
 
 	if (unit->HasDGun()) {
-		CDGunAction* act = new CDGunAction(unit, unit->GetDGunRange());
+		CDGunAction* act = new CDGunAction(unit, unit->GetDGunRange(manager->GetCircuit()->GetLastFrame()));
 		unit->PushBack(act);
 	}
 }
@@ -132,10 +132,7 @@ void IBuilderTask::Execute(CCircuitUnit* unit)
 	circuit->GetThreatMap()->SetThreatType(unit);
 	// FIXME: Replace const 999.0f with build time?
 	if (circuit->IsAllyAware() && (cost > 999.0f)) {
-		circuit->UpdateFriendlyUnits();
-		auto friendlies = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, cost));
-		CAllyUnit* alu = FindSameAlly(unit, friendlies);
-		utils::free_clear(friendlies);
+		CAllyUnit* alu = FindSameAlly(unit, position, cost);
 		if (alu != nullptr) {
 			UnitDef* buildUDef = alu->GetCircuitDef()->GetUnitDef();
 			const AIFloat3& pos = alu->GetPos(frame);
@@ -365,7 +362,7 @@ bool IBuilderTask::IsEqualBuildPos(CCircuitUnit* unit) const
 
 void IBuilderTask::HideAssignee(CCircuitUnit* unit)
 {
-	buildPower -= unit->GetBuildSpeed();
+	buildPower -= unit->GetBuildSpeed(manager->GetCircuit()->GetLastFrame());
 	if ((buildDef != nullptr) && !manager->GetCircuit()->GetEconomyManager()->IsIgnorePull(this)) {
 		manager->DelMetalPull(unit);
 	}
@@ -373,31 +370,29 @@ void IBuilderTask::HideAssignee(CCircuitUnit* unit)
 
 void IBuilderTask::ShowAssignee(CCircuitUnit* unit)
 {
-	buildPower += unit->GetBuildSpeed();
+	buildPower += unit->GetBuildSpeed(manager->GetCircuit()->GetLastFrame());
 	if ((buildDef != nullptr) && !manager->GetCircuit()->GetEconomyManager()->IsIgnorePull(this)) {
 		manager->AddMetalPull(unit);
 	}
 }
 
-CAllyUnit* IBuilderTask::FindSameAlly(CCircuitUnit* builder, const std::vector<Unit*>& friendlies)
+CAllyUnit* IBuilderTask::FindSameAlly(CCircuitUnit* builder, const AIFloat3& pos, float radius)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	const int frame = circuit->GetLastFrame();
 
-	for (Unit* au : friendlies) {
-		CAllyUnit* alu = circuit->GetFriendlyUnit(au);
-		if (alu == nullptr) {
-			continue;
+	CAllyUnit* result = nullptr;
+	circuit->ForEachFriendlyInRadius(pos, radius, [&](CAllyUnit* alu) {
+		if ((*alu->GetCircuitDef() == *buildDef) && alu->GetUnit()->IsBeingBuilt()
+			&& terrainManager->CanBuildAtSafe(builder, alu->GetPos(frame)))
+		{
+			result = alu;
+			return true;
 		}
-		if ((*alu->GetCircuitDef() == *buildDef) && au->IsBeingBuilt()) {
-			const AIFloat3& pos = alu->GetPos(frame);
-			if (terrainManager->CanBuildAtSafe(builder, pos)) {
-				return alu;
-			}
-		}
-	}
-	return nullptr;
+		return false;
+	});
+	return result;
 }
 
 void IBuilderTask::FindBuildSite(CCircuitUnit* builder, const AIFloat3& pos, float searchRadius)
@@ -449,23 +444,14 @@ void IBuilderTask::ExecuteChain(SBuildChain* chain)
 			float pylonRange = economyManager->GetPylonRange();
 			float radius = pylonRange + ourRange;
 			const int frame = circuit->GetLastFrame();
-			circuit->UpdateFriendlyUnits();
-			auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(buildPos, radius));
-			for (Unit* u : units) {
-				CAllyUnit* p = circuit->GetFriendlyUnit(u);
-				if (p == nullptr) {
-					continue;
-				}
-				// NOTE: Is SqDistance2D necessary? Or must subtract model radius of pylon from "radius" variable
-				//        @see rts/Sim/Misc/QaudField.cpp
-				//        ...CQuadField::GetUnitsExact(const float3& pos, float radius, bool spherical)
-				//        const float totRad = radius + u->radius; -- suspicious
+			circuit->ForEachFriendlyInRadius(buildPos, radius, [this, pylonDef, radius, frame, &foundPylon](CAllyUnit* p) {
+				// NOTE: Query radius includes model radius of the unit, @see CAllyTeam::ForEachFriendlyInRadius
 				if ((*p->GetCircuitDef() == *pylonDef) && (buildPos.SqDistance2D(p->GetPos(frame)) < SQUARE(radius))) {
 					foundPylon = true;
-					break;
+					return true;
 				}
-			}
-			utils::free_clear(units);
+				return false;
+			});
 			if (!foundPylon) {
 				AIFloat3 pos = buildPos;
 				CMetalManager* metalManager = circuit->GetMetalManager();
@@ -103,7 +103,7 @@ public:
 protected:
 	void HideAssignee(CCircuitUnit* unit);
 	void ShowAssignee(CCircuitUnit* unit);
-	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const std::vector<springai::Unit*>& friendlies);
+	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const springai::AIFloat3& pos, float radius);
 	virtual void FindBuildSite(CCircuitUnit* builder, const springai::AIFloat3& pos, float searchRadius);
 
 	void ExecuteChain(SBuildChain* chain);
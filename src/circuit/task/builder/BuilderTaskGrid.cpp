@@ -0,0 +1,120 @@
+/*
+ * BuilderTaskGrid.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "task/builder/BuilderTaskGrid.h"
+#include "task/builder/BuilderTask.h"
+#include "util/utils.h"
+
+#include <algorithm>
+
+namespace circuit {
+
+using namespace springai;
+
+#define TASK_CELL_SIZE	512
+
+CBuilderTaskGrid::CBuilderTaskGrid()
+		: refreshFrame(-1)
+		, grid(TASK_CELL_SIZE)
+{
+}
+
+CBuilderTaskGrid::~CBuilderTaskGrid()
+{
+}
+
+void CBuilderTaskGrid::Init(float width, float height)
+{
+	grid.Init(width, height);
+	unplaced.clear();
+	for (auto& kv : entries) {
+		Insert(kv.first, kv.second);
+	}
+}
+
+void CBuilderTaskGrid::AddTask(IBuilderTask* task)
+{
+	const AIFloat3& pos = task->GetTaskPos();
+	auto pair = entries.emplace(task, pos);
+	if (pair.second) {
+		Insert(task, pos);
+	}
+}
+
+void CBuilderTaskGrid::RemoveTask(IBuilderTask* task)
+{
+	auto it = entries.find(task);
+	if (it == entries.end()) {
+		return;
+	}
+	Erase(task, it->second);
+	entries.erase(it);
+}
+
+void CBuilderTaskGrid::Refresh(int frame)
+{
+	if (refreshFrame == frame) {
+		return;
+	}
+	refreshFrame = frame;
+
+	for (auto& kv : entries) {
+		const AIFloat3& pos = kv.first->GetTaskPos();
+		if (pos == kv.second) {
+			continue;
+		}
+		if (utils::is_valid(pos) && utils::is_valid(kv.second)) {
+			grid.Move(kv.first, kv.second, pos);
+		} else {
+			Erase(kv.first, kv.second);
+			Insert(kv.first, pos);
+		}
+		kv.second = pos;
+	}
+}
+
+void CBuilderTaskGrid::ForEachInRadius(const AIFloat3& pos, float radius, const TaskFunc& func) const
+{
+	for (IBuilderTask* task : unplaced) {
+		if (func(task)) {
+			return;
+		}
+	}
+	grid.ForEachInRadius(pos, radius, func);
+}
+
+IBuilderTask* CBuilderTaskGrid::FindNear(const AIFloat3& pos, float radius, const TaskFunc& predicate) const
+{
+	const CUniformGrid<IBuilderTask*>::SItem* result = grid.FindNear(pos, radius, [&predicate](IBuilderTask* task) {
+		return (predicate == nullptr) || predicate(task);
+	});
+	return (result == nullptr) ? nullptr : result->item;
+}
+
+void CBuilderTaskGrid::Insert(IBuilderTask* task, const AIFloat3& pos)
+{
+	if (utils::is_valid(pos)) {
+		grid.Insert(task, pos);
+	} else {
+		unplaced.push_back(task);
+	}
+}
+
+void CBuilderTaskGrid::Erase(IBuilderTask* task, const AIFloat3& pos)
+{
+	if (utils::is_valid(pos)) {
+		grid.Erase(task, pos);
+		return;
+	}
+	auto it = std::find(unplaced.begin(), unplaced.end(), task);
+	if (it != unplaced.end()) {
+		*it = unplaced.back();
+		unplaced.pop_back();
+	}
+}
+
+} // namespace circuit
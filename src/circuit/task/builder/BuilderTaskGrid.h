@@ -0,0 +1,56 @@
+/*
+ * BuilderTaskGrid.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_TASK_BUILDER_BUILDERTASKGRID_H_
+#define SRC_CIRCUIT_TASK_BUILDER_BUILDERTASKGRID_H_
+
+#include "util/UniformGrid.h"
+
+#include "AIFloat3.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace circuit {
+
+class IBuilderTask;
+
+/*
+ * Uniform grid over builder tasks of a single BuildType, keyed by task position (GetTaskPos).
+ * Tasks without valid position are kept aside and reported by every query.
+ * Task positions are mutated by tasks themselves, Refresh re-buckets moved tasks.
+ */
+class CBuilderTaskGrid {
+public:
+	using TaskFunc = std::function<bool (IBuilderTask* task)>;  // return true to stop iteration
+
+	CBuilderTaskGrid();
+	virtual ~CBuilderTaskGrid();
+
+	void Init(float width, float height);
+	void AddTask(IBuilderTask* task);
+	void RemoveTask(IBuilderTask* task);
+	void Refresh(int frame);
+
+	void ForEachInRadius(const springai::AIFloat3& pos, float radius, const TaskFunc& func) const;
+	// Nearest task within radius that satisfies predicate
+	IBuilderTask* FindNear(const springai::AIFloat3& pos, float radius, const TaskFunc& predicate) const;
+
+private:
+	void Insert(IBuilderTask* task, const springai::AIFloat3& pos);
+	void Erase(IBuilderTask* task, const springai::AIFloat3& pos);
+
+	int refreshFrame;
+	std::unordered_map<IBuilderTask*, springai::AIFloat3> entries;  // task: position in grid
+	CUniformGrid<IBuilderTask*> grid;
+	std::vector<IBuilderTask*> unplaced;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TASK_BUILDER_BUILDERTASKGRID_H_
@@ -111,7 +111,7 @@ void CBMexTask::Execute(CCircuitUnit* unit)
 				terrainManager->CanBuildAtSafe(unit, spots[index].position) &&
 				map->IsPossibleToBuildAt(mexDef->GetUnitDef(), spots[index].position, UNIT_COMMAND_BUILD_NO_FACING));
 	};
-	int index = metalManager->FindNearestSpot(position, predicate);
+	int index = metalManager->FindNearestOpenSpot(position, predicate);
 
 	if (index >= 0) {
 		buildPos = spots[index].position;
@@ -171,15 +171,7 @@ void CBMexTask::OnUnitIdle(CCircuitUnit* unit)
 		utils::free_clear(enemies);
 		if (blocked) {
 			CBuilderManager* builderManager = circuit->GetBuilderManager();
-			IBuilderTask* task = nullptr;
-			const float qdist = SQUARE(200.0f);  // 200 elmos
-			// TODO: Push tasks into bgi::rtree
-			for (IBuilderTask* t : builderManager->GetTasks(IBuilderTask::BuildType::DEFENCE)) {
-				if (pos.SqDistance2D(t->GetTaskPos()) < qdist) {
-					task = t;
-					break;
-				}
-			}
+			IBuilderTask* task = builderManager->FindTaskNear(IBuilderTask::BuildType::DEFENCE, pos, 200.0f);  // 200 elmos
 			if (task == nullptr) {
 				AIFloat3 newPos = buildPos - (buildPos - pos).Normalize2D() * range * 0.9f;
 				task = builderManager->EnqueueTask(IBuilderTask::Priority::HIGH, def, newPos, IBuilderTask::BuildType::DEFENCE);
@@ -8,6 +8,7 @@
 #include "task/builder/ReclaimTask.h"
 #include "task/TaskManager.h"
 #include "module/EconomyManager.h"
+#include "resource/FeatureRegistry.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
 #include "CircuitAI.h"
@@ -15,8 +16,6 @@
 
 #include "OOAICallback.h"
 #include "AISCommands.h"
-#include "Feature.h"
-#include "FeatureDef.h"
 
 namespace circuit {
 
@@ -72,41 +71,20 @@ void CBReclaimTask::Update()
 			utils::free_clear(enemies);
 		}
 
-		auto features = std::move(circuit->GetCallback()->GetFeaturesIn(pos, 500.0f));
-		if (!features.empty()) {
-			CTerrainManager* terrainManager = circuit->GetTerrainManager();
-			circuit->GetThreatMap()->SetThreatType(unit);
-			float minSqDist = std::numeric_limits<float>::max();
-			Resource* metalRes = circuit->GetEconomyManager()->GetMetalRes();
-			for (Feature* feature : features) {
-				AIFloat3 featPos = feature->GetPosition();
-				CTerrainManager::CorrectPosition(featPos);  // Impulsed flying feature
-				if (!terrainManager->CanBuildAtSafe(unit, featPos)) {
-					continue;
-				}
-				FeatureDef* featDef = feature->GetDef();
-				if (!featDef->IsReclaimable()) {
-					delete featDef;
-					continue;
-				}
-				float reclaimValue = featDef->GetContainedResource(metalRes)/* * feature->GetReclaimLeft()*/;
-				delete featDef;
-				if (reclaimValue < 1.0f) {
-					continue;
-				}
-				float sqDist = pos.SqDistance2D(featPos);
-				if (sqDist < minSqDist) {
-					position = featPos;
-					minSqDist = sqDist;
-				}
-			}
-			if (minSqDist < std::numeric_limits<float>::max()) {
-				const float radius = 8.0f;  // unit->GetCircuitDef()->GetBuildDistance();
-				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->ReclaimInArea(position, radius, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
-				)
-			}
-			utils::free_clear(features);
+		CFeatureRegistry* featureRegistry = circuit->GetAllyTeam()->GetFeatureRegistry().get();
+		featureRegistry->Update();
+		CTerrainManager* terrainManager = circuit->GetTerrainManager();
+		circuit->GetThreatMap()->SetThreatType(unit);
+		auto isSafe = [terrainManager, unit](const CFeatureRegistry::SFeature& feature) {
+			return terrainManager->CanBuildAtSafe(unit, feature.position);
+		};
+		const CFeatureRegistry::SFeature* feature = featureRegistry->FindNearest(pos, 500.0f, 1.0f, isSafe);
+		if (feature != nullptr) {
+			position = feature->position;
+			const float radius = 8.0f;  // unit->GetCircuitDef()->GetBuildDistance();
+			TRY_UNIT(circuit, unit,
+				unit->GetUnit()->ReclaimInArea(position, radius, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
+			)
 		}
 	}
 }
@@ -154,17 +154,14 @@ CAllyUnit* IRepairTask::FindUnitToAssist(CCircuitUnit* unit)
 	float radius = unit->GetCircuitDef()->GetBuildDistance() + maxSpeed * 30;
 	maxSpeed = SQUARE(maxSpeed * 1.5f / FRAMES_PER_SEC);
 
-	circuit->UpdateFriendlyUnits();
-	auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius));
-	for (Unit* u : units) {
-		if ((u != nullptr) && (u->GetHealth() < u->GetMaxHealth()) && (u->GetVel().SqLength2D() <= maxSpeed)) {
-			target = circuit->GetFriendlyUnit(u);
-			if (target != nullptr) {
-				break;
-			}
+	circuit->ForEachFriendlyInRadius(pos, radius, [maxSpeed, &target](CAllyUnit* candUnit) {
+		Unit* u = candUnit->GetUnit();
+		if ((u->GetHealth() < u->GetMaxHealth()) && (u->GetVel().SqLength2D() <= maxSpeed)) {
+			target = candUnit;
+			return true;
 		}
-	}
-	utils::free_clear(units);
+		return false;
+	});
 	return target;
 }
 
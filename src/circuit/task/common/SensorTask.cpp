@@ -35,20 +35,13 @@ void ISensorTask::Update()
 
 	CCircuitAI* circuit = manager->GetCircuit();
 	bool isBuilt = false;
-	auto friendlies = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(GetPosition(), 500.f));
-	for (Unit* au : friendlies) {
-		if (au == nullptr) {
-			continue;
-		}
-		UnitDef* udef = au->GetDef();
-		CCircuitDef::Id defId = udef->GetUnitDefId();
-		delete udef;
-		if (defId == buildDef->GetId()) {
+	circuit->ForEachFriendlyInRadius(GetPosition(), 500.f, [this, &isBuilt](CAllyUnit* au) {
+		if (*au->GetCircuitDef() == *buildDef) {
 			isBuilt = true;
-			break;
+			return true;
 		}
-	}
-	utils::free_clear(friendlies);
+		return false;
+	});
 	if (isBuilt) {
 		manager->AbortTask(this);
 	}
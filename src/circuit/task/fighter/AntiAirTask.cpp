@@ -184,15 +184,13 @@ void CAntiAirTask::Update()
 			return;
 		}
 	} else {
-		static F3Vec ourPositions;  // NOTE: micro-opt
 		AIFloat3 startPos = leader->GetPos(frame);
-		circuit->GetMilitaryManager()->FillSafePos(startPos, leader->GetArea(), ourPositions);
+		const CPathFinder::CGoalSet& goals = circuit->GetMilitaryManager()->GetSafeGoals(startPos, leader->GetArea());
 
 		pPath->clear();
 		CPathFinder* pathfinder = circuit->GetPathfinder();
 		pathfinder->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
-		pathfinder->FindBestPath(*pPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
-		ourPositions.clear();
+		pathfinder->FindBestPath(*pPath, startPos, goals, false);
 
 		if (!pPath->empty()) {
 			position = pPath->back();
@@ -260,15 +258,13 @@ void CAntiAirTask::OnUnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 	}
 	CCircuitAI* circuit = manager->GetCircuit();
 	const int frame = circuit->GetLastFrame();
-	static F3Vec ourPositions;  // NOTE: micro-opt
 	AIFloat3 startPos = leader->GetPos(frame);
-	circuit->GetMilitaryManager()->FillSafePos(startPos, leader->GetArea(), ourPositions);
+	const CPathFinder::CGoalSet& goals = circuit->GetMilitaryManager()->GetSafeGoals(startPos, leader->GetArea());
 
 	pPath->clear();
 	CPathFinder* pathfinder = circuit->GetPathfinder();
 	pathfinder->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
-	pathfinder->FindBestPath(*pPath, startPos, pathfinder->GetSquareSize(), ourPositions);
-	ourPositions.clear();
+	pathfinder->FindBestPath(*pPath, startPos, goals);
 
 	if (!pPath->empty()) {
 		position = pPath->back();
@@ -13,6 +13,7 @@
 #include "terrain/ThreatMap.h"
 #include "terrain/PathFinder.h"
 #include "unit/EnemyUnit.h"
+#include "unit/EnemyStructures.h"
 #include "unit/action/MoveAction.h"
 #include "CircuitAI.h"
 #include "util/utils.h"
@@ -24,6 +25,8 @@ namespace circuit {
 
 using namespace springai;
 
+#define ART_GOAL_COUNT	16
+
 CArtilleryTask::CArtilleryTask(ITaskManager* mgr)
 		: IFighterTask(mgr, FightType::ARTY, 1.f)
 {
@@ -175,61 +178,47 @@ CEnemyUnit* CArtilleryTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos,
 	float minSqDist = SQUARE(range);
 
 	static F3Vec enemyPositions;  // NOTE: micro-opt
+	static std::vector<const CEnemyStructures::SStructure*> goals;  // NOTE: micro-opt
 	threatMap->SetThreatType(unit);
 	pathfinder->SetMapData(unit, threatMap, circuit->GetLastFrame());
 	bool isPosSafe = (threatMap->GetThreatAt(pos) <= THREAT_MIN);
 
-	const CCircuitAI::EnemyUnits& enemies = circuit->GetEnemyUnits();
+	CEnemyStructures* structures = circuit->GetEnemyStructures();
+	auto isVisible = [notAW](const CEnemyStructures::SStructure& s) {
+		return s.enemy->IsInRadarOrLOS() && !(notAW && (s.enemy->GetPos().y < -SQUARE_SIZE * 5));
+	};
 	if (isPosSafe) {
 		// Трубка 15, прицел 120, бац, бац …и мимо!
 		float maxThreat = .0f;
 		CEnemyUnit* bestTarget = nullptr;
 		CEnemyUnit* mediumTarget = nullptr;
 		CEnemyUnit* worstTarget = nullptr;
-		for (auto& kv : enemies) {
-			CEnemyUnit* enemy = kv.second;
-			if (!enemy->IsInRadarOrLOS() ||
-				(notAW && (enemy->GetPos().y < -SQUARE_SIZE * 5)))
-			{
-				continue;
-			}
-
-			CCircuitDef* edef = enemy->GetCircuitDef();
-			if ((edef == nullptr) || edef->IsMobile() || edef->IsAttrSiege()) {
-				continue;
-			}
-			int targetCat = edef->GetCategory();
-			if ((targetCat & canTargetCat) == 0) {
-				continue;
+		structures->ForEachInRadius(pos, range, [&](const CEnemyStructures::SStructure& s) {
+			if (s.isSiege || ((s.category & canTargetCat) == 0) || !isVisible(s)) {
+				return false;
 			}
-
+			CEnemyUnit* enemy = s.enemy;
 			const float sqDist = pos.SqDistance2D(enemy->GetPos());
-			if (sqDist < minSqDist) {
-				if (edef->IsEnemyRoleAny(CCircuitDef::RoleMask::BUILDER)) {
-					bestTarget = enemy;
-					minSqDist = sqDist;
-					maxThreat = std::numeric_limits<float>::max();
-				} else if (edef->GetPower() > maxThreat) {
-					bestTarget = enemy;
-					minSqDist = sqDist;
-					maxThreat = edef->GetPower();
-				} else if (bestTarget == nullptr) {
-					if ((targetCat & noChaseCat) == 0) {
-						mediumTarget = enemy;
-					} else if (mediumTarget == nullptr) {
-						worstTarget = enemy;
-					}
-				}
-				continue;
+			if (sqDist >= minSqDist) {
+				return false;
 			}
-
-			if ((targetCat & noChaseCat) != 0) {
-				continue;
+			if (s.isBuilder) {
+				bestTarget = enemy;
+				minSqDist = sqDist;
+				maxThreat = std::numeric_limits<float>::max();
+			} else if (s.power > maxThreat) {
+				bestTarget = enemy;
+				minSqDist = sqDist;
+				maxThreat = s.power;
+			} else if (bestTarget == nullptr) {
+				if ((s.category & noChaseCat) == 0) {
+					mediumTarget = enemy;
+				} else if (mediumTarget == nullptr) {
+					worstTarget = enemy;
+				}
 			}
-//			if (sqDist < SQUARE(2000.f)) {  // maxSqDist
-				enemyPositions.push_back(enemy->GetPos());
-//			}
-		}
+			return false;
+		});
 		if (bestTarget == nullptr) {
 			bestTarget = (mediumTarget != nullptr) ? mediumTarget : worstTarget;
 		}
@@ -237,34 +226,16 @@ CEnemyUnit* CArtilleryTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos,
 			position = bestTarget->GetPos();
 			return bestTarget;
 		}
-	} else {
-		// Avoid closest units and choose safe position
-		for (auto& kv : enemies) {
-			CEnemyUnit* enemy = kv.second;
-			if (!enemy->IsInRadarOrLOS() ||
-				(notAW && (enemy->GetPos().y < -SQUARE_SIZE * 5)))
-			{
-				continue;
-			}
-
-			CCircuitDef* edef = enemy->GetCircuitDef();
-			if ((edef == nullptr) || edef->IsMobile()) {
-				continue;
-			}
-			int targetCat = edef->GetCategory();
-			if (((targetCat & canTargetCat) == 0) || ((targetCat & noChaseCat) != 0)) {
-				continue;
-			}
-
-			const float sqDist = pos.SqDistance2D(enemy->GetPos());
-			if (sqDist < minSqDist) {
-				continue;
-			}
-
-//			if (sqDist < SQUARE(2000.f)) {  // maxSqDist
-				enemyPositions.push_back(enemy->GetPos());
-//			}
-		}
+	}
+	// Safe: nothing in range, move to closest targets.
+	// Unsafe: avoid closest units and choose safe position.
+	structures->FindNearest(pos, ART_GOAL_COUNT, [&](const CEnemyStructures::SStructure& s) {
+		return (!isPosSafe || !s.isSiege)
+				&& ((s.category & canTargetCat) != 0) && ((s.category & noChaseCat) == 0)
+				&& (pos.SqDistance2D(s.enemy->GetPos()) >= minSqDist) && isVisible(s);
+	}, goals);
+	for (const CEnemyStructures::SStructure* s : goals) {
+		enemyPositions.push_back(s->enemy->GetPos());
 	}
 
 	path.clear();
@@ -12,6 +12,7 @@
 #include "terrain/ThreatMap.h"
 #include "terrain/PathFinder.h"
 #include "unit/EnemyUnit.h"
+#include "unit/EnemyStructures.h"
 #include "unit/action/MoveAction.h"
 #include "CircuitAI.h"
 #include "util/utils.h"
@@ -24,6 +25,8 @@ namespace circuit {
 
 using namespace springai;
 
+#define BOMB_GOAL_COUNT	16
+
 CBombTask::CBombTask(ITaskManager* mgr, float powerMod)
 		: IFighterTask(mgr, FightType::BOMB, powerMod)
 {
@@ -201,16 +204,17 @@ CEnemyUnit* CBombTask::FindTarget(CCircuitUnit* unit, CEnemyUnit* lastTarget, co
 	const float sqRange = (lastTarget != nullptr) ? pos.SqDistance2D(lastTarget->GetPos()) + 1.f : SQUARE(2000.0f);
 	float maxThreat = .0f;
 
-	OOAICallback* callback = circuit->GetCallback();
 	float aoe = std::min(cdef->GetAoe() + SQUARE_SIZE, DEFAULT_SLACK * 2.f);
 	std::function<bool (const AIFloat3& pos)> noAllies = [](const AIFloat3& pos) {
 		return true;
 	};
 	if (aoe > SQUARE_SIZE * 2) {
-		noAllies = [callback, aoe](const AIFloat3& pos) {
-			auto friendlies = std::move(callback->GetFriendlyUnitsIn(pos, aoe));
-			bool result = friendlies.empty();
-			utils::free_clear(friendlies);
+		noAllies = [circuit, aoe](const AIFloat3& pos) {
+			bool result = true;
+			circuit->ForEachFriendlyInRadius(pos, aoe, [&result](CAllyUnit*) {
+				result = false;
+				return true;
+			});
 			return result;
 		};
 	}
@@ -219,27 +223,58 @@ CEnemyUnit* CBombTask::FindTarget(CCircuitUnit* unit, CEnemyUnit* lastTarget, co
 	CEnemyUnit* mediumTarget = nullptr;
 	CEnemyUnit* worstTarget = nullptr;
 	static F3Vec enemyPositions;  // NOTE: micro-opt
+	static std::vector<const CEnemyStructures::SStructure*> goals;  // NOTE: micro-opt
 	threatMap->SetThreatType(unit);
-	const CCircuitAI::EnemyUnits& enemies = circuit->GetEnemyUnits();
-	for (auto& kv : enemies) {
-		CEnemyUnit* enemy = kv.second;
+	auto isValid = [&](CEnemyUnit* enemy, float defThreat) {
 		if (enemy->IsHidden()) {
-			continue;
+			return false;
 		}
 		float power = threatMap->GetThreatAt(enemy->GetPos()) - enemy->GetThreat();
 		if ((maxPower <= power) ||
 			(notAW && (enemy->GetPos().y < -SQUARE_SIZE * 5)))
 		{
-			continue;
+			return false;
 		}
+		float sumPower = 0.f;
+		for (IFighterTask* task : enemy->GetTasks()) {
+			sumPower += task->GetAttackPower();
+		}
+		return sumPower <= defThreat;
+	};
+	auto isInRange = [&](CEnemyUnit* enemy) {
+		return (pos.SqDistance2D(enemy->GetPos()) < sqRange) && enemy->IsInRadarOrLOS()/* && (altitude < maxAltitude)*/;
+	};
+	auto pick = [&](CEnemyUnit* enemy, int targetCat, float defThreat, bool isBuilder) {
+		if (isBuilder) {
+			if (noAllies(enemy->GetPos())) {
+				bestTarget = enemy;
+				maxThreat = std::numeric_limits<float>::max();
+			}
+		} else if (maxThreat <= defThreat) {
+			if (noAllies(enemy->GetPos())) {
+				bestTarget = enemy;
+				maxThreat = defThreat;
+			}
+		} else if ((bestTarget == nullptr) && noAllies(enemy->GetPos())) {
+			if ((targetCat & noChaseCat) == 0) {
+				mediumTarget = enemy;
+			} else if (mediumTarget == nullptr) {
+				worstTarget = enemy;
+			}
+		}
+	};
 
+	// Mobile and unknown enemies, structures are indexed
+	const CCircuitAI::EnemyUnits& enemies = circuit->GetEnemyUnits();
+	for (auto& kv : enemies) {
+		CEnemyUnit* enemy = kv.second;
 		int targetCat;
 //		float altitude;
 		float defThreat;
 		bool isBuilder;
 		CCircuitDef* edef = enemy->GetCircuitDef();
 		if (edef != nullptr) {
-			if (edef->GetSpeed() > speed) {
+			if (!edef->IsMobile() || (edef->GetSpeed() > speed)) {
 				continue;
 			}
 			targetCat = edef->GetCategory();
@@ -255,40 +290,24 @@ CEnemyUnit* CBombTask::FindTarget(CCircuitUnit* unit, CEnemyUnit* lastTarget, co
 			defThreat = enemy->GetThreat();
 			isBuilder = false;
 		}
-
-		float sumPower = 0.f;
-		for (IFighterTask* task : enemy->GetTasks()) {
-			sumPower += task->GetAttackPower();
-		}
-		if (sumPower > defThreat) {
+		if (!isValid(enemy, defThreat)) {
 			continue;
 		}
 
-		float sqDist = pos.SqDistance2D(enemy->GetPos());
-		if ((sqDist < sqRange) && enemy->IsInRadarOrLOS()/* && (altitude < maxAltitude)*/) {
-			if (isBuilder) {
-				if (noAllies(enemy->GetPos())) {
-					bestTarget = enemy;
-					maxThreat = std::numeric_limits<float>::max();
-				}
-			} else if (maxThreat <= defThreat) {
-				if (noAllies(enemy->GetPos())) {
-					bestTarget = enemy;
-					maxThreat = defThreat;
-				}
-			} else if ((bestTarget == nullptr) && noAllies(enemy->GetPos())) {
-				if ((targetCat & noChaseCat) == 0) {
-					mediumTarget = enemy;
-				} else if (mediumTarget == nullptr) {
-					worstTarget = enemy;
-				}
-			}
-			continue;
-		}
-//		if (sqDist < SQUARE(2000.f)) {  // maxSqDist
+		if (isInRange(enemy)) {
+			pick(enemy, targetCat, defThreat, isBuilder);
+		} else {
 			enemyPositions.push_back(enemy->GetPos());
-//		}
+		}
 	}
+
+	CEnemyStructures* structures = circuit->GetEnemyStructures();
+	structures->ForEachInRadius(pos, sqrtf(sqRange), [&](const CEnemyStructures::SStructure& s) {
+		if (((s.category & canTargetCat) != 0) && isInRange(s.enemy) && isValid(s.enemy, s.power)) {
+			pick(s.enemy, s.category, s.power, s.isBuilder);
+		}
+		return false;
+	});
 	if (bestTarget == nullptr) {
 		bestTarget = (mediumTarget != nullptr) ? mediumTarget : worstTarget;
 	}
@@ -298,6 +317,12 @@ CEnemyUnit* CBombTask::FindTarget(CCircuitUnit* unit, CEnemyUnit* lastTarget, co
 		enemyPositions.clear();
 		return bestTarget;
 	}
+	structures->FindNearest(pos, BOMB_GOAL_COUNT, [&](const CEnemyStructures::SStructure& s) {
+		return ((s.category & canTargetCat) != 0) && !isInRange(s.enemy) && isValid(s.enemy, s.power);
+	}, goals);
+	for (const CEnemyStructures::SStructure* s : goals) {
+		enemyPositions.push_back(s->enemy->GetPos());
+	}
 	if (enemyPositions.empty()) {
 		return nullptr;
 	}
@@ -9,6 +9,7 @@
 #include "task/TaskManager.h"
 #include "module/MilitaryManager.h"
 #include "terrain/TerrainManager.h"
+#include "terrain/LineOfFire.h"
 #include "terrain/ThreatMap.h"
 #include "terrain/PathFinder.h"
 #include "unit/EnemyUnit.h"
@@ -189,6 +190,15 @@ CEnemyUnit* CScoutTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos, F3Ve
 	CEnemyUnit* bestTarget = nullptr;
 	CEnemyUnit* worstTarget = nullptr;
 	static F3Vec enemyPositions;  // NOTE: micro-opt
+	struct SCandidate {
+		float power;
+		float sqDist;
+		int targetCat;
+		float defThreat;
+		bool isBuilder;
+	};
+	static std::vector<CLineOfFire::SRay> rays;  // NOTE: micro-opt
+	static std::vector<SCandidate> candidates;  // NOTE: micro-opt
 	threatMap->SetThreatType(unit);
 	const CCircuitAI::EnemyUnits& enemies = circuit->GetEnemyUnits();
 	for (auto& kv : enemies) {
@@ -236,25 +246,8 @@ CEnemyUnit* CScoutTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos, F3Ve
 		float sqDist = pos.SqDistance2D(ePos);
 		if ((minPower > power) && (minSqDist > sqDist)) {
 			if (enemy->IsInRadarOrLOS()) {
-//				AIFloat3 dir = enemy->GetUnit()->GetPos() - pos;
-//				float rayRange = dir.LengthNormalize();
-//				CUnit::Id hitUID = circuit->GetDrawer()->TraceRay(pos, dir, rayRange, u, 0);
-//				if (hitUID == enemy->GetId()) {
-					if (((targetCat & noChaseCat) == 0) && !enemy->GetUnit()->IsBeingBuilt()) {
-						if (isBuilder) {
-							bestTarget = enemy;
-							minSqDist = sqDist;
-							maxThreat = std::numeric_limits<float>::max();
-						} else if (maxThreat <= defThreat) {
-							bestTarget = enemy;
-							minSqDist = sqDist;
-							maxThreat = defThreat;
-						}
-						minPower = power;
-					} else if (bestTarget == nullptr) {
-						worstTarget = enemy;
-					}
-//				}
+				rays.push_back({enemy, false});
+				candidates.push_back({power, sqDist, targetCat, defThreat, isBuilder});
 			}
 			continue;
 		}
@@ -262,6 +255,36 @@ CEnemyUnit* CScoutTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos, F3Ve
 			enemyPositions.push_back(ePos);
 //		}
 	}
+
+	// NOTE: Line of fire check is mostly to ensure shot won't go into terrain
+	if (!rays.empty()) {
+		circuit->GetLineOfFire()->TestRays(unit, rays);
+	}
+	for (unsigned i = 0; i < rays.size(); ++i) {
+		const SCandidate& c = candidates[i];
+		CEnemyUnit* enemy = rays[i].target;
+		if (!rays[i].isClear || (minPower <= c.power) || (minSqDist <= c.sqDist)) {
+			enemyPositions.push_back(enemy->GetPos());  // still a goal of path below
+			continue;
+		}
+		if (((c.targetCat & noChaseCat) == 0) && !enemy->GetUnit()->IsBeingBuilt()) {
+			if (c.isBuilder) {
+				bestTarget = enemy;
+				minSqDist = c.sqDist;
+				maxThreat = std::numeric_limits<float>::max();
+			} else if (maxThreat <= c.defThreat) {
+				bestTarget = enemy;
+				minSqDist = c.sqDist;
+				maxThreat = c.defThreat;
+			}
+			minPower = c.power;
+		} else if (bestTarget == nullptr) {
+			worstTarget = enemy;
+		}
+	}
+	rays.clear();
+	candidates.clear();
+
 	if (bestTarget == nullptr) {
 		bestTarget = worstTarget;
 	}
@@ -40,19 +40,17 @@ void CSReclaimTask::Update()
 		// Check for damaged units
 		CBuilderManager* builderManager = circuit->GetBuilderManager();
 		CAllyUnit* repairTarget = nullptr;
-		circuit->UpdateFriendlyUnits();
-		auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-		for (Unit* u : us) {
-			CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-			if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
-				continue;
+		circuit->ForEachFriendlyInRadius(position, radius * 0.9f, [builderManager, &repairTarget](CAllyUnit* candUnit) {
+			if (builderManager->IsReclaimed(candUnit)) {
+				return false;
 			}
+			Unit* u = candUnit->GetUnit();
 			if (!u->IsBeingBuilt() && (u->GetHealth() < u->GetMaxHealth())) {
 				repairTarget = candUnit;
-				break;
+				return true;
 			}
-		}
-		utils::free_clear(us);
+			return false;
+		});
 		if (repairTarget != nullptr) {
 			// Repair task
 			IBuilderTask* task = circuit->GetFactoryManager()->EnqueueRepair(IBuilderTask::Priority::NORMAL, repairTarget);
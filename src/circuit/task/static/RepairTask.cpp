@@ -49,20 +49,18 @@ void CSRepairTask::Update()
 			if (economyManager->IsMetalEmpty() && !factoryManager->IsHighPriority(repTarget)) {
 				// Check for damaged units
 				CBuilderManager* builderManager = circuit->GetBuilderManager();
-				circuit->UpdateFriendlyUnits();
 				float radius = (*units.begin())->GetCircuitDef()->GetBuildDistance();
-				auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-				for (Unit* u : us) {
-					CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-					if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
-						continue;
+				circuit->ForEachFriendlyInRadius(position, radius * 0.9f, [&](CAllyUnit* candUnit) {
+					if (builderManager->IsReclaimed(candUnit)) {
+						return false;
 					}
+					Unit* u = candUnit->GetUnit();
 					if (!u->IsBeingBuilt() && (u->GetHealth() < u->GetMaxHealth())) {
 						task = factoryManager->EnqueueRepair(IBuilderTask::Priority::NORMAL, candUnit);
-						break;
+						return true;
 					}
-				}
-				utils::free_clear(us);
+					return false;
+				});
 				if (task == nullptr) {
 					// Reclaim task
 					auto features = std::move(circuit->GetCallback()->GetFeaturesIn(position, radius));
@@ -77,22 +75,19 @@ void CSRepairTask::Update()
 			CFactoryManager* factoryManager = circuit->GetFactoryManager();
 			CBuilderManager* builderManager = circuit->GetBuilderManager();
 			float maxCost = MAX_BUILD_SEC * economyManager->GetAvgMetalIncome() * economyManager->GetEcoFactor();
-			circuit->UpdateFriendlyUnits();
 			float radius = (*units.begin())->GetCircuitDef()->GetBuildDistance();
-			auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-			for (Unit* u : us) {
-				CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-				if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
-					continue;
+			circuit->ForEachFriendlyInRadius(position, radius * 0.9f, [&](CAllyUnit* candUnit) {
+				if (builderManager->IsReclaimed(candUnit)) {
+					return false;
 				}
 				bool isHighPrio = factoryManager->IsHighPriority(candUnit);
-				if (u->IsBeingBuilt() && ((candUnit->GetCircuitDef()->GetBuildTime() < maxCost) || isHighPrio)) {
+				if (candUnit->GetUnit()->IsBeingBuilt() && ((candUnit->GetCircuitDef()->GetBuildTime() < maxCost) || isHighPrio)) {
 					IBuilderTask::Priority priority = isHighPrio ? IBuilderTask::Priority::HIGH : IBuilderTask::Priority::NORMAL;
 					task = factoryManager->EnqueueRepair(priority, candUnit);
-					break;
+					return true;
 				}
-			}
-			utils::free_clear(us);
+				return false;
+			});
 		}
 		if (task != nullptr) {
 			decltype(units) tmpUnits = units;
@@ -32,6 +32,8 @@ CBlockCircle::CBlockCircle(const int2& offset, int radius, const int2& ssize, SB
 			}
 		}
 	}
+
+	InitBits();
 }
 
 CBlockCircle::~CBlockCircle()
@@ -9,6 +9,7 @@
 #include "util/utils.h"
 
 #include <algorithm>
+#include <functional>
 
 namespace circuit {
 
@@ -75,6 +76,36 @@ IBlockMask::BlockRects IBlockMask::Init(const int2& offset, const int2& bsize, c
 	return {b1, b2, s1, s2};
 }
 
+void IBlockMask::InitBits()
+{
+	auto fillBits = [](SBlockingMap::SMaskBits& bits, int xsize, int zsize, std::function<BlockType (int x, int z)> getType) {
+		bits.wordsPerRow = (xsize + 63) / 64 + 1;
+		bits.blocked.assign(bits.wordsPerRow * zsize, 0);
+		bits.structs.assign(bits.wordsPerRow * zsize, 0);
+		for (int z = 0; z < zsize; z++) {
+			for (int x = 0; x < xsize; x++) {
+				const int i = z * bits.wordsPerRow + x / 64;
+				const SBlockingMap::Word bit = SBlockingMap::Word(1) << (x % 64);
+				switch (getType(x, z)) {
+					case BlockType::BLOCKED: {
+						bits.blocked[i] |= bit;
+						break;
+					}
+					case BlockType::STRUCT: {
+						bits.structs[i] |= bit;
+						break;
+					}
+					case BlockType::OPEN: { break; }
+				}
+			}
+		}
+	};
+	fillBits(bitsSouth, xsize, zsize, [this](int x, int z) { return GetTypeSouth(x, z); });
+	fillBits(bitsEast,  zsize, xsize, [this](int x, int z) { return GetTypeEast(x, z); });
+	fillBits(bitsNorth, xsize, zsize, [this](int x, int z) { return GetTypeNorth(x, z); });
+	fillBits(bitsWest,  zsize, xsize, [this](int x, int z) { return GetTypeWest(x, z); });
+}
+
 int IBlockMask::GetXSize()
 {
 	return xsize;
@@ -104,4 +135,23 @@ const int2& IBlockMask::GetStructOffset(int facing)
 	}
 }
 
+const SBlockingMap::SMaskBits& IBlockMask::GetBits(int facing)
+{
+	switch (facing) {
+		default:
+		case UNIT_FACING_SOUTH: {
+			return bitsSouth;
+		}
+		case UNIT_FACING_NORTH: {
+			return bitsNorth;
+		}
+		case UNIT_FACING_EAST: {
+			return bitsEast;
+		}
+		case UNIT_FACING_WEST: {
+			return bitsWest;
+		}
+	}
+}
+
 } // namespace circuit
@@ -25,6 +25,7 @@ public:
 	int GetXSize();
 	int GetZSize();
 	const int2& GetStructOffset(int facing);
+	const SBlockingMap::SMaskBits& GetBits(int facing);
 
 	inline BlockType GetTypeSouth(int x, int z);
 	inline BlockType GetTypeEast(int x, int z);
@@ -41,6 +42,8 @@ protected:
 	};
 	// @param offset to South facing
 	BlockRects Init(const int2& offset, const int2& bsize, const int2& ssize);
+	// fills bit rows of all facings, call once mask is filled
+	void InitBits();
 
 	// TODO: South, East, North, West masks for performance?
 	std::vector<BlockType> mask;  // South - default facing
@@ -50,6 +53,10 @@ protected:
 	int2 offsetEast;
 	int2 offsetNorth;
 	int2 offsetWest;
+	SBlockingMap::SMaskBits bitsSouth;
+	SBlockingMap::SMaskBits bitsEast;
+	SBlockingMap::SMaskBits bitsNorth;
+	SBlockingMap::SMaskBits bitsWest;
 	SBlockingMap::StructType structType;
 	int ignoreMask;
 };
@@ -30,6 +30,8 @@ CBlockRectangle::CBlockRectangle(const int2& offset, const int2& bsize, const in
 			}
 		}
 	}
+
+	InitBits();
 }
 
 CBlockRectangle::~CBlockRectangle()
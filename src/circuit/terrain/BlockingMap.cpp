@@ -7,6 +7,8 @@
 
 #include "terrain/BlockingMap.h"
 
+#include <algorithm>
+
 namespace circuit {
 
 SBlockingMap::StructTypes SBlockingMap::structTypes = {
@@ -41,4 +43,241 @@ SBlockingMap::StructMasks SBlockingMap::structMasks = {
 	{"all",       SBlockingMap::StructMask::ALL},
 };
 
+void SBlockingMap::InitBits()
+{
+	wordsPerRow = (columns + 63) / 64 + 1;
+	const int size = wordsPerRow * rows;
+	blockedBits.assign(size, 0);
+	structBits.assign(size, 0);
+	blockedPyramid.Init(columns, rows);
+	structPyramid.Init(columns, rows);
+	for (int i = 0; i < static_cast<ST>(StructType::_SIZE_); ++i) {
+		blockerBits[i].assign(size, 0);
+		notIgnoreBits[i].assign(size, 0);
+		blockerPyramids[i].Init(columns, rows);
+	}
+}
+
+const SBlockingMap::SearchOffsets& SBlockingMap::GetSearchOffsetTable(int radius)
+{
+	static std::vector<SSearchOffset> searchOffsets;
+	unsigned int size = radius * radius * 4;
+	if (size > searchOffsets.size()) {
+		searchOffsets.resize(size);
+
+		for (int y = 0; y < radius * 2; y++) {
+			for (int x = 0; x < radius * 2; x++) {
+				SSearchOffset& i = searchOffsets[y * radius * 2 + x];
+
+				i.dx = x - radius;
+				i.dy = y - radius;
+				i.qdist = i.dx * i.dx + i.dy * i.dy;
+			}
+		}
+
+		auto searchOffsetComparator = [](const SSearchOffset& a, const SSearchOffset& b) {
+			return a.qdist < b.qdist;
+		};
+		std::sort(searchOffsets.begin(), searchOffsets.end(), searchOffsetComparator);
+	}
+
+	return searchOffsets;
+}
+
+const SBlockingMap::SearchOffsetsLow& SBlockingMap::GetSearchOffsetTableLow(int radius)
+{
+	static SearchOffsetsLow searchOffsetsLow;
+	int radiusLow = radius / GRID_RATIO_LOW;
+	unsigned int sizeLow = radiusLow * radiusLow * 4;
+	if (sizeLow > searchOffsetsLow.size()) {
+		searchOffsetsLow.resize(sizeLow);
+
+		SearchOffsets searchOffsets;
+		searchOffsets.resize(radius * radius * 4);
+		for (int y = 0; y < radius * 2; y++) {
+			for (int x = 0; x < radius * 2; x++) {
+				SSearchOffset& i = searchOffsets[y * radius * 2 + x];
+				i.dx = x - radius;
+				i.dy = y - radius;
+				i.qdist = i.dx * i.dx + i.dy * i.dy;
+			}
+		}
+
+		auto searchOffsetComparator = [](const SSearchOffset& a, const SSearchOffset& b) {
+			return a.qdist < b.qdist;
+		};
+		for (int yl = 0; yl < radiusLow * 2; yl++) {
+			for (int xl = 0; xl < radiusLow * 2; xl++) {
+				SSearchOffsetLow& il = searchOffsetsLow[yl * radiusLow * 2 + xl];
+				il.dx = xl - radiusLow;
+				il.dy = yl - radiusLow;
+				il.qdist = il.dx * il.dx + il.dy * il.dy;
+
+				il.ofs.reserve(GRID_RATIO_LOW * GRID_RATIO_LOW);
+				const int xi = xl * GRID_RATIO_LOW;
+				il.ofsCorner = int2(xi - radius, yl * GRID_RATIO_LOW - radius);
+				for (int y = yl * GRID_RATIO_LOW; y < (yl + 1) * GRID_RATIO_LOW; y++) {
+					for (int x = xi; x < xi + GRID_RATIO_LOW; x++) {
+						il.ofs.push_back(searchOffsets[y * radius * 2 + x]);
+					}
+				}
+
+				std::sort(il.ofs.begin(), il.ofs.end(), searchOffsetComparator);
+			}
+		}
+
+		auto searchOffsetLowComparator = [](const SSearchOffsetLow& a, const SSearchOffsetLow& b) {
+			return a.qdist < b.qdist;
+		};
+		std::sort(searchOffsetsLow.begin(), searchOffsetsLow.end(), searchOffsetLowComparator);
+	}
+
+	return searchOffsetsLow;
+}
+
+int2 SBlockingMap::FindOpenSite(const int2& cell, int radius, const int2& size, SitePredicate& predicate) const
+{
+	const SearchOffsets& ofs = GetSearchOffsetTable(radius);
+
+	const int2 corner(cell.x - size.x / 2, cell.y - size.y / 2);
+
+	for (int so = 0; so < radius * radius * 4; so++) {
+		const int2 s1(corner.x + ofs[so].dx, corner.y + ofs[so].dy);
+		const int2 s2(s1.x + size.x, s1.y + size.y);
+		if (!IsInBounds(s1, s2) || !IsOpenSite(s1, s2)) {
+			continue;
+		}
+		if (predicate(s1, s2)) {
+			return s1;
+		}
+	}
+
+	return int2(-1, -1);
+}
+
+int2 SBlockingMap::FindOpenSiteLow(const int2& cell, int radius, const int2& size, SitePredicate& predicate) const
+{
+	const SearchOffsetsLow& ofsLow = GetSearchOffsetTableLow(radius);
+	const int radiusLow = radius / GRID_RATIO_LOW;
+
+	const int2 center(cell.x / GRID_RATIO_LOW, cell.y / GRID_RATIO_LOW);
+	const int2 corner(cell.x - size.x / 2, cell.y - size.y / 2);
+
+	const SM notIgnore = static_cast<SM>(StructMask::ALL);
+
+	for (int soLow = 0; soLow < radiusLow * radiusLow * 4; soLow++) {
+		const int xlow = center.x + ofsLow[soLow].dx;
+		const int zlow = center.y + ofsLow[soLow].dy;
+		if (!IsInBoundsLow(xlow, zlow) || IsBlockedLow(xlow, zlow, notIgnore)) {
+			continue;
+		}
+
+		// block's candidates all cover [c2, c3) and together cover [c1, c4)
+		const int2 c1(corner.x + ofsLow[soLow].ofsCorner.x, corner.y + ofsLow[soLow].ofsCorner.y);
+		const int2 c2(c1.x + GRID_RATIO_LOW - 1, c1.y + GRID_RATIO_LOW - 1);
+		const int2 c3(c1.x + size.x, c1.y + size.y);
+		const int2 c4(c2.x + size.x, c2.y + size.y);
+		if ((c2.x < c3.x) && (c2.y < c3.y) && IsInBounds(c2, c3) && !IsOpenRegion(c2, c3, notIgnore)) {
+			continue;
+		}
+		const bool isOpenBlock = IsInBounds(c1, c4) && IsOpenRegion(c1, c4, notIgnore);
+
+		const SearchOffsets& ofs = ofsLow[soLow].ofs;
+		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {
+			const int2 s1(corner.x + ofs[so].dx, corner.y + ofs[so].dy);
+			const int2 s2(s1.x + size.x, s1.y + size.y);
+			if (!IsInBounds(s1, s2) || (!isOpenBlock && !IsOpenSite(s1, s2))) {
+				continue;
+			}
+			if (predicate(s1, s2)) {
+				return s1;
+			}
+		}
+	}
+
+	return int2(-1, -1);
+}
+
+bool SBlockingMap::IsOpenRegion(const int2& r1, const int2& r2, SM notIgnoreMask) const
+{
+	if ((notIgnoreMask & static_cast<SM>(StructMask::ALL)) == static_cast<SM>(StructMask::ALL)) {
+		return IsEmptyRegion(blockedPyramid, blockedBits, r1, r2);
+	}
+	if (!IsEmptyRegion(structPyramid, structBits, r1, r2)) {
+		return false;
+	}
+	for (int t = 0; t < static_cast<ST>(StructType::_SIZE_); ++t) {
+		if ((notIgnoreMask & (1 << t)) && !IsEmptyRegion(blockerPyramids[t], blockerBits[t], r1, r2)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SBlockingMap::IsEmptyRegion(const SPyramid& pyramid, const std::vector<Word>& bits, const int2& r1, const int2& r2) const
+{
+	const int top = pyramid.levels.size() - 1;
+	const int shift = pyramid.levels[top].shift;
+	for (int nz = r1.y >> shift; nz <= (r2.y - 1) >> shift; nz++) {
+		for (int nx = r1.x >> shift; nx <= (r2.x - 1) >> shift; nx++) {
+			if (!IsEmptyNode(pyramid, bits, r1, r2, top, nx, nz)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool SBlockingMap::IsEmptyNode(const SPyramid& pyramid, const std::vector<Word>& bits, const int2& r1, const int2& r2,
+							   int level, int nx, int nz) const
+{
+	const SPyramid::SLevel& lvl = pyramid.levels[level];
+	if (lvl.counts[nz * lvl.columns + nx] == 0) {
+		return true;
+	}
+
+	// node's part within the map and the region
+	const int2 n1(nx << lvl.shift, nz << lvl.shift);
+	const int2 n2(std::min((nx + 1) << lvl.shift, columns), std::min((nz + 1) << lvl.shift, rows));
+	const int2 a(std::max(r1.x, n1.x), std::max(r1.y, n1.y));
+	const int2 b(std::min(r2.x, n2.x), std::min(r2.y, n2.y));
+	if ((a.x >= b.x) || (a.y >= b.y)) {
+		return true;
+	}
+	if ((a.x == n1.x) && (a.y == n1.y) && (b.x == n2.x) && (b.y == n2.y)) {
+		return false;  // covered whole non-empty node
+	}
+	if (level == 0) {
+		return IsEmptyBits(bits, a, b);
+	}
+
+	const int shift = pyramid.levels[level - 1].shift;
+	for (int cz = a.y >> shift; cz <= (b.y - 1) >> shift; cz++) {
+		for (int cx = a.x >> shift; cx <= (b.x - 1) >> shift; cx++) {
+			if (!IsEmptyNode(pyramid, bits, a, b, level - 1, cx, cz)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void SBlockingMap::SPyramid::Init(int columns, int rows)
+{
+	levels.clear();
+	int shift = 0;
+	while ((1 << shift) < GRID_RATIO_LOW) {
+		++shift;
+	}
+	do {
+		SLevel level;
+		level.shift = shift;
+		level.columns = ((columns - 1) >> shift) + 1;
+		level.rows = ((rows - 1) >> shift) + 1;
+		level.counts.assign(level.columns * level.rows, 0);
+		levels.push_back(std::move(level));
+		++shift;
+	} while ((levels.back().columns > 1) || (levels.back().rows > 1));
+}
+
 } // namespace circuit
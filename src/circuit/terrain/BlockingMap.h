@@ -12,6 +12,9 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include <functional>
+#include <stdint.h>
 
 #define GRID_RATIO_LOW		8
 #define STRUCT_BIT(bits)	static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::bits)
@@ -32,6 +35,7 @@ struct SBlockingMap {
 	using SM = std::underlying_type<StructMask>::type;
 	using StructTypes = std::map<std::string, StructType>;
 	using StructMasks = std::map<std::string, StructMask>;
+	using Word = uint64_t;  // bit row element
 
 	static inline StructTypes& GetStructTypes() { return structTypes; }
 	static inline StructMasks& GetStructMasks() { return structMasks; }
@@ -45,12 +49,57 @@ struct SBlockingMap {
 	inline void AddStruct(int x, int z, StructType structType, SM notIgnoreMask);
 	inline void DelStruct(int x, int z, StructType structType, SM notIgnoreMask);
 
+	// Bit rows of IBlockMask for one facing, rows of wordsPerRow words with zero padding word at the end
+	struct SMaskBits {
+		int wordsPerRow;
+		std::vector<Word> blocked;  // BlockType::BLOCKED cells
+		std::vector<Word> structs;  // BlockType::STRUCT cells
+	};
+	// Rectangle [r1, r2) has no cell blocked for any structure
+	inline bool IsOpenSite(const int2& r1, const int2& r2) const;
+	// Same as IsOpenSite but for large regions, skips empty and full parts via pyramids
+	bool IsOpenRegion(const int2& r1, const int2& r2, SM notIgnoreMask) const;
+	// Rectangle [m1, m2) is open for mask's facing, om - bounded offset within mask
+	inline bool IsOpenSite(const int2& m1, const int2& m2, const int2& om, const SMaskBits& maskBits,
+						   StructType structType, SM notIgnoreMask) const;
+	static inline Word GetRowBits(const Word* row, int x);  // 64 bits starting at x
+	void InitBits();
+
 	inline bool IsInBounds(const int2& r1, const int2& r2) const;
 	inline bool IsInBoundsLow(int x, int z) const;
 	inline void Bound(int2& r1, int2& r2);
 
 	static inline StructMask GetStructMask(StructType structType);
 
+	/*
+	 * Offsets of build-site search around a cell, sorted by distance.
+	 * Low table groups offsets into GRID_RATIO_LOW x GRID_RATIO_LOW blocks of gridLow.
+	 */
+	struct SSearchOffset {
+		int dx, dy;
+		int qdist;  // dx*dx + dy*dy
+	};
+	using SearchOffsets = std::vector<SSearchOffset>;
+	struct SSearchOffsetLow {
+		SearchOffsets ofs;
+		int2 ofsCorner;  // smallest (dx, dy) within ofs block
+		int dx, dy;
+		int qdist;  // dx*dx + dy*dy
+	};
+	using SearchOffsetsLow = std::vector<SSearchOffsetLow>;
+	static const SearchOffsets& GetSearchOffsetTable(int radius);
+	static const SearchOffsetsLow& GetSearchOffsetTableLow(int radius);
+
+	// Final test of open footprint [s1, s2), e.g. engine's build checks
+	using SitePredicate = std::function<bool (const int2& s1, const int2& s2)>;
+	/*
+	 * Nearest to cell open footprint of size within radius (in cells) that satisfies predicate.
+	 * Returns footprint's corner, or (-1, -1) if there is none.
+	 * Low version walks GRID_RATIO_LOW blocks of candidates and skips whole blocks via pyramids.
+	 */
+	int2 FindOpenSite(const int2& cell, int radius, const int2& size, SitePredicate& predicate) const;
+	int2 FindOpenSiteLow(const int2& cell, int radius, const int2& size, SitePredicate& predicate) const;
+
 	static StructTypes structTypes;
 	static StructMasks structMasks;
 
@@ -64,11 +113,46 @@ struct SBlockingMap {
 	int columns;
 	int rows;
 
+	/*
+	 * Bit planes of grid, row-major, wordsPerRow words per row (last one is zero padding).
+	 * Maintained by Mark/Add/Del methods, so footprint tests are few word operations per row.
+	 */
+	inline void UpdateBits(int x, int z, const SBlockCell& cell);
+	inline bool IsEmptyBits(const std::vector<Word>& bits, const int2& r1, const int2& r2) const;
+	int wordsPerRow;
+	std::vector<Word> blockedBits;  // IsBlocked(x, z, StructMask::ALL)
+	std::vector<Word> structBits;   // structMask != NONE
+	std::vector<Word> blockerBits[static_cast<ST>(StructType::_SIZE_)];    // blockerMask by type
+	std::vector<Word> notIgnoreBits[static_cast<ST>(StructType::_SIZE_)];  // notIgnoreMask by type
+
+	/*
+	 * Occupancy pyramid of a bit plane. Level 0 node covers GRID_RATIO_LOW x GRID_RATIO_LOW cells,
+	 * every next level doubles the side. Node keeps number of set cells: empty, full or mixed.
+	 */
+	struct SPyramid {
+		struct SLevel {
+			int shift;  // log2 of node side in cells
+			int columns;
+			int rows;
+			std::vector<unsigned> counts;
+		};
+		std::vector<SLevel> levels;
+
+		void Init(int columns, int rows);
+		inline void Add(int x, int z, int delta);
+	};
+	bool IsEmptyRegion(const SPyramid& pyramid, const std::vector<Word>& bits, const int2& r1, const int2& r2) const;
+	bool IsEmptyNode(const SPyramid& pyramid, const std::vector<Word>& bits, const int2& r1, const int2& r2,
+					 int level, int nx, int nz) const;
+	SPyramid blockedPyramid;  // blockedBits
+	SPyramid structPyramid;   // structBits
+	SPyramid blockerPyramids[static_cast<ST>(StructType::_SIZE_)];  // blockerBits
+
 	struct SBlockCellLow {
 		SM blockerMask;
 		unsigned short blockerCounts[static_cast<ST>(StructType::_SIZE_)];
 	};
-	// TODO: Replace with QuadTree
+	// Heuristic per-type density, exact hierarchical occupancy is in SPyramid
 	std::vector<SBlockCellLow> gridLow;  // granularity Map::GetWidth / 16, Map::GetHeight / 16
 	int columnsLow;
 	int rowsLow;
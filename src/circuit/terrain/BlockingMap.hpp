@@ -40,6 +40,7 @@ inline void SBlockingMap::MarkBlocker(int x, int z, StructType structType, SM no
 	cell.structMask = GetStructMask(structType);
 	const SM structMask = static_cast<SM>(cell.structMask);
 	cell.blockerMask |= structMask;
+	UpdateBits(x, z, cell);
 
 	SBlockCellLow& cellLow = gridLow[z / GRID_RATIO_LOW * columnsLow + x / GRID_RATIO_LOW];
 	if (cellLow.blockerCounts[static_cast<ST>(structType)]++ == BLOCK_THRESHOLD) {
@@ -53,6 +54,7 @@ inline void SBlockingMap::AddBlocker(int x, int z, StructType structType)
 	if (cell.blockerCounts[static_cast<ST>(structType)]++ == 0) {
 		const SM structMask = static_cast<SM>(GetStructMask(structType));
 		cell.blockerMask |= structMask;
+		UpdateBits(x, z, cell);
 
 		SBlockCellLow& cellLow = gridLow[z / GRID_RATIO_LOW * columnsLow + x / GRID_RATIO_LOW];
 		if (++cellLow.blockerCounts[static_cast<ST>(structType)] == BLOCK_THRESHOLD) {
@@ -67,6 +69,7 @@ inline void SBlockingMap::DelBlocker(int x, int z, StructType structType)
 	if (--cell.blockerCounts[static_cast<ST>(structType)] == 0) {
 		const int notStructMask = ~static_cast<SM>(GetStructMask(structType));
 		cell.blockerMask &= notStructMask;
+		UpdateBits(x, z, cell);
 
 		SBlockCellLow& cellLow = gridLow[z / GRID_RATIO_LOW * columnsLow + x / GRID_RATIO_LOW];
 		if (cellLow.blockerCounts[static_cast<ST>(structType)]-- == BLOCK_THRESHOLD) {
@@ -86,6 +89,7 @@ inline void SBlockingMap::AddStruct(int x, int z, StructType structType, SM notI
 	}
 	cell.notIgnoreMask = notIgnoreMask;
 	cell.structMask = GetStructMask(structType);
+	UpdateBits(x, z, cell);
 }
 
 inline void SBlockingMap::DelStruct(int x, int z, StructType structType, SM notIgnoreMask)
@@ -93,6 +97,7 @@ inline void SBlockingMap::DelStruct(int x, int z, StructType structType, SM notI
 	SBlockCell& cell = grid[z * columns + x];
 	cell.notIgnoreMask = 0;
 	cell.structMask = StructMask::NONE;
+	UpdateBits(x, z, cell);
 	if (cell.blockerCounts[static_cast<ST>(structType)] == 0) {
 		SBlockCellLow& cellLow = gridLow[z / GRID_RATIO_LOW * columnsLow + x / GRID_RATIO_LOW];
 		if (cellLow.blockerCounts[static_cast<ST>(structType)]-- == BLOCK_THRESHOLD) {
@@ -101,6 +106,107 @@ inline void SBlockingMap::DelStruct(int x, int z, StructType structType, SM notI
 	}
 }
 
+inline bool SBlockingMap::IsOpenSite(const int2& r1, const int2& r2) const
+{
+	return IsEmptyBits(blockedBits, r1, r2);
+}
+
+inline bool SBlockingMap::IsEmptyBits(const std::vector<Word>& bits, const int2& r1, const int2& r2) const
+{
+	for (int z = r1.y; z < r2.y; z++) {
+		const Word* row = &bits[z * wordsPerRow];
+		for (int x = r1.x; x < r2.x; x += 64) {
+			const int n = r2.x - x;
+			const Word lowBits = (n >= 64) ? ~Word(0) : ((Word(1) << n) - 1);
+			if (GetRowBits(row, x) & lowBits) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+inline bool SBlockingMap::IsOpenSite(const int2& m1, const int2& m2, const int2& om, const SMaskBits& maskBits,
+									 StructType structType, SM notIgnoreMask) const
+{
+	const std::vector<Word>& isStructBits = notIgnoreBits[static_cast<ST>(structType)];
+	int types[static_cast<ST>(StructType::_SIZE_)];
+	int typeCount = 0;
+	for (int t = 0; t < static_cast<ST>(StructType::_SIZE_); ++t) {
+		if (notIgnoreMask & (1 << t)) {
+			types[typeCount++] = t;
+		}
+	}
+
+	for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {
+		const int offset = z * wordsPerRow;
+		const Word* blockedRow = &maskBits.blocked[zm * maskBits.wordsPerRow];
+		const Word* structRow = &maskBits.structs[zm * maskBits.wordsPerRow];
+		for (int x = m1.x, xm = om.x; x < m2.x; x += 64, xm += 64) {
+			const int n = m2.x - x;
+			const Word lowBits = (n >= 64) ? ~Word(0) : ((Word(1) << n) - 1);
+
+			// BLOCKED mask cell fails on struct that doesn't ignore us
+			const Word blocked = GetRowBits(blockedRow, xm) & lowBits;
+			if (blocked && (GetRowBits(&isStructBits[offset], x) & blocked)) {
+				return false;
+			}
+
+			// STRUCT mask cell fails on any struct or not ignored blocker
+			const Word structs = GetRowBits(structRow, xm) & lowBits;
+			if (structs == 0) {
+				continue;
+			}
+			Word occupied = GetRowBits(&structBits[offset], x);
+			for (int i = 0; i < typeCount; ++i) {
+				occupied |= GetRowBits(&blockerBits[types[i]][offset], x);
+			}
+			if (occupied & structs) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+inline SBlockingMap::Word SBlockingMap::GetRowBits(const Word* row, int x)
+{
+	const int i = x >> 6;
+	const int s = x & 63;
+	return (s == 0) ? row[i] : ((row[i] >> s) | (row[i + 1] << (64 - s)));
+}
+
+inline void SBlockingMap::UpdateBits(int x, int z, const SBlockCell& cell)
+{
+	const int i = z * wordsPerRow + (x >> 6);
+	const Word bit = Word(1) << (x & 63);
+	auto setBit = [i, bit](std::vector<Word>& bits, bool value) {
+		const bool wasSet = (bits[i] & bit);
+		bits[i] = value ? (bits[i] | bit) : (bits[i] & ~bit);
+		return (value == wasSet) ? 0 : (value ? 1 : -1);
+	};
+	auto setPyramidBit = [x, z, &setBit](std::vector<Word>& bits, SPyramid& pyramid, bool value) {
+		const int delta = setBit(bits, value);
+		if (delta != 0) {
+			pyramid.Add(x, z, delta);
+		}
+	};
+	const SM structMask = static_cast<SM>(cell.structMask);
+	setPyramidBit(blockedBits, blockedPyramid, cell.blockerMask || structMask);
+	setPyramidBit(structBits, structPyramid, structMask);
+	for (int t = 0; t < static_cast<ST>(StructType::_SIZE_); ++t) {
+		setPyramidBit(blockerBits[t], blockerPyramids[t], cell.blockerMask & (1 << t));
+		setBit(notIgnoreBits[t], cell.notIgnoreMask & (1 << t));
+	}
+}
+
+inline void SBlockingMap::SPyramid::Add(int x, int z, int delta)
+{
+	for (SLevel& level : levels) {
+		level.counts[(z >> level.shift) * level.columns + (x >> level.shift)] += delta;
+	}
+}
+
 inline bool SBlockingMap::IsInBounds(const int2& r1, const int2& r2) const
 {
 	return (r1.x >= 0) && (r1.y >= 0) && (r2.x < columns) && (r2.y < rows);
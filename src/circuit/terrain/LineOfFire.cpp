@@ -0,0 +1,210 @@
+/*
+ * LineOfFire.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "terrain/LineOfFire.h"
+#include "terrain/TerrainData.h"
+#include "setup/SetupManager.h"
+#include "unit/CircuitDef.h"
+#include "unit/CircuitUnit.h"
+#include "unit/EnemyUnit.h"
+#include "CircuitAI.h"
+#include "util/utils.h"
+
+#include "Drawer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace circuit {
+
+using namespace springai;
+
+CLineOfFire::CLineOfFire(CCircuitAI* circuit, CTerrainData* terrainData)
+		: circuit(circuit)
+		, terrainData(terrainData)
+		, cacheFrame(-1)
+		, validCount(0)
+		, mismatchCount(0)
+{
+	isValidate = circuit->GetSetupManager()->GetConfig()["debug"].get("validate_lof", false).asBool();
+}
+
+CLineOfFire::~CLineOfFire()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+	if (isValidate) {
+		circuit->LOG("LineOfFire: %i mismatches of %i validated rays", mismatchCount, validCount);
+	}
+}
+
+void CLineOfFire::TestRays(CCircuitUnit* shooter, std::vector<SRay>& rays)
+{
+	const int frame = circuit->GetLastFrame();
+	if (cacheFrame != frame) {
+		cacheFrame = frame;
+		cache.clear();
+	}
+
+	const AIFloat3& pos = shooter->GetPos(frame);
+	bool isGathered = false;
+	for (SRay& ray : rays) {
+		const uint64_t key = (uint64_t(uint32_t(shooter->GetId())) << 32) | uint32_t(ray.target->GetId());
+		auto it = cache.find(key);
+		if (it != cache.end()) {
+			ray.isClear = it->second;
+			continue;
+		}
+
+		if (!isGathered) {
+			GatherObstacles(shooter, pos, rays);
+			isGathered = true;
+		}
+		ray.isClear = TestRay(pos, ray.target);
+		cache[key] = ray.isClear;
+
+		if (isValidate) {
+			Validate(shooter, pos, ray.target, ray.isClear);
+		}
+	}
+}
+
+bool CLineOfFire::IsTerrainClear(const AIFloat3& start, const AIFloat3& end) const
+{
+	const float dx = end.x - start.x;
+	const float dy = end.y - start.y;
+	const float dz = end.z - start.z;
+	const float len2D = sqrtf(SQUARE(dx) + SQUARE(dz));
+	// NOTE: Unit positions are on the ground, skip squares of shooter and target
+	const float tSkip = SQUARE_SIZE / std::max(len2D, 1.f);
+	if (tSkip * 2 >= 1.f) {
+		return true;
+	}
+
+	const std::vector<float>& heightMap = terrainData->GetHeightMap();
+	const SAreaData* areaData = terrainData->pAreaData.load();
+	const int mapWidth = CTerrainData::terrainWidth / SQUARE_SIZE;
+	const int mapHeight = CTerrainData::terrainHeight / SQUARE_SIZE;
+	const int sectorXSize = terrainData->sectorXSize;
+	const int sectorZSize = terrainData->sectorZSize;
+	const int cellSize = CTerrainData::convertStoP;
+	const float tStep = (SQUARE_SIZE / 2) / len2D;
+
+	auto isSpanClear = [&](int cx, int cz, float t0, float t1) {
+		const float y0 = start.y + dy * t0;
+		const float y1 = start.y + dy * t1;
+		if ((cx >= 0) && (cx < sectorXSize) && (cz >= 0) && (cz < sectorZSize)) {
+			const STerrainMapSector& sector = areaData->sector[cz * sectorXSize + cx];
+			if (std::min(y0, y1) >= sector.maxElevation) {  // above the whole sector
+				return true;
+			}
+			if ((std::max(y0, y1) < sector.minElevation) && (t0 > tSkip) && (t1 < 1.f - tSkip)) {  // below the whole sector
+				return false;
+			}
+		}
+		t0 = std::max(t0, tSkip);
+		t1 = std::min(t1, 1.f - tSkip);
+		for (float t = t0; t < t1; t += tStep) {
+			const int hx = utils::clamp(int((start.x + dx * t) / SQUARE_SIZE), 0, mapWidth - 1);
+			const int hz = utils::clamp(int((start.z + dz * t) / SQUARE_SIZE), 0, mapHeight - 1);
+			if (start.y + dy * t < heightMap[hz * mapWidth + hx]) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// 2D DDA over sectors, t in [0, 1]
+	int cx = int(start.x) / cellSize;
+	int cz = int(start.z) / cellSize;
+	const int stepX = (dx > 0.f) ? 1 : -1;
+	const int stepZ = (dz > 0.f) ? 1 : -1;
+	const float tDeltaX = (dx != 0.f) ? cellSize / std::fabs(dx) : std::numeric_limits<float>::max();
+	const float tDeltaZ = (dz != 0.f) ? cellSize / std::fabs(dz) : std::numeric_limits<float>::max();
+	float tMaxX = (dx > 0.f) ? ((cx + 1) * cellSize - start.x) / dx
+				: (dx < 0.f) ? (cx * cellSize - start.x) / dx : std::numeric_limits<float>::max();
+	float tMaxZ = (dz > 0.f) ? ((cz + 1) * cellSize - start.z) / dz
+				: (dz < 0.f) ? (cz * cellSize - start.z) / dz : std::numeric_limits<float>::max();
+	float t = 0.f;
+	while (t < 1.f) {
+		const float tNext = std::min(std::min(tMaxX, tMaxZ), 1.f);
+		if (!isSpanClear(cx, cz, t, tNext)) {
+			return false;
+		}
+		t = tNext;
+		if (tMaxX < tMaxZ) {
+			cx += stepX;
+			tMaxX += tDeltaX;
+		} else {
+			cz += stepZ;
+			tMaxZ += tDeltaZ;
+		}
+	}
+	return true;
+}
+
+void CLineOfFire::GatherObstacles(CCircuitUnit* shooter, const AIFloat3& pos, const std::vector<SRay>& rays)
+{
+	obstacles.clear();
+	float maxSqDist = 0.f;
+	for (const SRay& ray : rays) {
+		const AIFloat3& tpos = ray.target->GetPos();
+		maxSqDist = std::max(maxSqDist, pos.SqDistance2D(tpos));
+		CCircuitDef* edef = ray.target->GetCircuitDef();
+		if (edef != nullptr) {
+			obstacles.push_back({tpos, SQUARE(edef->GetRadius()), ray.target->GetId()});
+		}
+	}
+
+	const int frame = circuit->GetLastFrame();
+	const ICoreUnit::Id shooterId = shooter->GetId();
+	circuit->ForEachFriendlyInRadius(pos, sqrtf(maxSqDist), [this, frame, shooterId](CAllyUnit* unit) {
+		if (unit->GetId() != shooterId) {
+			obstacles.push_back({unit->GetPos(frame), SQUARE(unit->GetCircuitDef()->GetRadius()), unit->GetId()});
+		}
+		return false;
+	});
+}
+
+bool CLineOfFire::TestRay(const AIFloat3& pos, CEnemyUnit* target) const
+{
+	const AIFloat3& tpos = target->GetPos();
+	AIFloat3 dir = tpos - pos;
+	const float length = dir.LengthNormalize();
+	CCircuitDef* edef = target->GetCircuitDef();
+	const float hitLength = std::max(length - ((edef != nullptr) ? edef->GetRadius() : 0.f), 0.f);
+
+	for (const SSphere& sphere : obstacles) {
+		if (sphere.id == target->GetId()) {
+			continue;
+		}
+		const AIFloat3 toCenter = sphere.pos - pos;
+		const float proj = toCenter.dot(dir);
+		if ((proj <= 0.f) || (proj >= hitLength)) {
+			continue;
+		}
+		if (toCenter.SqLength() - SQUARE(proj) <= sphere.sqRadius) {
+			return false;
+		}
+	}
+
+	return IsTerrainClear(pos, pos + dir * hitLength);
+}
+
+void CLineOfFire::Validate(CCircuitUnit* shooter, const AIFloat3& pos, CEnemyUnit* target, bool isClear)
+{
+	AIFloat3 dir = target->GetPos() - pos;
+	const float rayRange = dir.LengthNormalize();
+	ICoreUnit::Id hitUID = circuit->GetDrawer()->TraceRay(pos, dir, rayRange, shooter->GetUnit(), 0);
+	++validCount;
+	if ((hitUID == target->GetId()) != isClear) {
+		++mismatchCount;
+		circuit->LOG("LineOfFire mismatch: shooter=%i target=%i local=%i engine_hit=%i | %i of %i",
+				shooter->GetId(), target->GetId(), isClear, hitUID, mismatchCount, validCount);
+	}
+}
+
+} // namespace circuit
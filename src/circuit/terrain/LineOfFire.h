@@ -0,0 +1,69 @@
+/*
+ * LineOfFire.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_LINEOFFIRE_H_
+#define SRC_CIRCUIT_TERRAIN_LINEOFFIRE_H_
+
+#include "AIFloat3.h"
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace circuit {
+
+class CCircuitAI;
+class CCircuitUnit;
+class CEnemyUnit;
+class CTerrainData;
+
+/*
+ * Local replacement of Drawer::TraceRay for target selection.
+ * Ray-marches height map using sector min/max elevation as coarse level,
+ * units are tested as bounding spheres (friendlies and candidate enemies).
+ * Features are not tested.
+ */
+class CLineOfFire {
+public:
+	struct SRay {
+		CEnemyUnit* target;
+		bool isClear;  // output of TestRays
+	};
+
+	CLineOfFire(CCircuitAI* circuit, CTerrainData* terrainData);
+	virtual ~CLineOfFire();
+
+	// All rays of one shooter are tested against single set of obstacles.
+	// Results are cached within a frame.
+	void TestRays(CCircuitUnit* shooter, std::vector<SRay>& rays);
+	bool IsTerrainClear(const springai::AIFloat3& start, const springai::AIFloat3& end) const;
+
+private:
+	struct SSphere {
+		springai::AIFloat3 pos;
+		float sqRadius;
+		int id;
+	};
+	void GatherObstacles(CCircuitUnit* shooter, const springai::AIFloat3& pos, const std::vector<SRay>& rays);
+	bool TestRay(const springai::AIFloat3& pos, CEnemyUnit* target) const;
+	void Validate(CCircuitUnit* shooter, const springai::AIFloat3& pos, CEnemyUnit* target, bool isClear);
+
+	CCircuitAI* circuit;
+	CTerrainData* terrainData;
+
+	int cacheFrame;
+	std::unordered_map<uint64_t, bool> cache;  // (shooter id, target id): is clear
+	std::vector<SSphere> obstacles;
+
+	bool isValidate;  // compare every fresh result with TraceRay
+	int validCount;
+	int mismatchCount;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_LINEOFFIRE_H_
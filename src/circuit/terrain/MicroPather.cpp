@@ -47,6 +47,7 @@
 #include "util/Defines.h"
 
 #include <cstdlib>  // malloc(), free()
+#include <cstring>  // memcpy()
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -62,64 +63,38 @@ using namespace NSMicroPather;
 
 class OpenQueueBH {
 public:
-	OpenQueueBH(PathNode** heapArray)
-		: heapArray(heapArray)
+	OpenQueueBH(SOpenListMem& mem)
+		: heapArray(mem.heapArray)
+		, nodes(mem.nodes)
+		, nodeData(mem.nodeData)
 		, size(0)
 	{}
 
 	~OpenQueueBH() {}
 
-	void Push(PathNode* pNode) {
-		pNode->inOpen = 1;
+	void Push(unsigned node) {
+		nodeData[node].inOpen = 1;
 
-		if (size > 0) {
-			size++;
-			heapArray[size] = pNode;
-			pNode->myIndex =  size;
+		size++;
+		heapArray[size] = {nodeData[node].totalCost, node};
+		nodes[node].myIndex = size;
 
-			int i = size;
-
-			while((i > 1) && (heapArray[i >> 1]->totalCost > heapArray[i]->totalCost)) {
-				// L("Swap them: " << i);
-				PathNode* temp = heapArray[i >> 1];
-				heapArray[i >> 1] = heapArray[i];
-				heapArray[i] = temp;
-
-				temp->myIndex = i;
-				heapArray[i >> 1]->myIndex = i >> 1;
-
-				i >>= 1;
-			}
-		} else {
-			// tree was empty
-			size++;
-			heapArray[1] = pNode;
-			pNode->myIndex = size;
-		}
+		SiftUp(size);
 	}
 
-	void Update(PathNode* pNode) {
+	void Update(unsigned node) {
+		const int i = nodes[node].myIndex;
+		heapArray[i].cost = nodeData[node].totalCost;
 		if (size > 1) {
 			// heapify now
-			int i = pNode->myIndex;
-
-			while (i > 1 && ((heapArray[i >> 1]->totalCost) > (heapArray[i]->totalCost))) {
-				// swap them
-				PathNode* temp = heapArray[i >> 1];
-				heapArray[i >> 1] = heapArray[i];
-				heapArray[i] = temp;
-
-				temp->myIndex = i;
-				heapArray[i >> 1]->myIndex =  i >> 1;
-				i >>= 1;
-			}
+			SiftUp(i);
 		}
 	}
 
-	PathNode* Pop() {
+	unsigned Pop() {
 		// get the first one
-		PathNode* min = heapArray[1];
-		min->inOpen = 0;
+		const unsigned min = heapArray[1].index;
+		nodeData[min].inOpen = 0;
 		heapArray[1] = heapArray[size];
 		size--;
 
@@ -127,8 +102,7 @@ public:
 			return min;
 		}
 
-		heapArray[1]->myIndex = 1;
-		# define Parent(x) (x >> 1)
+		nodes[heapArray[1].index].myIndex = 1;
 		# define Left(x)  (x << 1)
 		# define Right(x) ((x << 1) + 1)
 
@@ -144,22 +118,16 @@ public:
 			const int left = Left(index);
 			const int right = Right(index);
 
-			if (left <= size && ((heapArray[left]->totalCost) < (heapArray[index]->totalCost)))
+			if (left <= size && (Cost(left) < Cost(index)))
 				smalest = left;
 			else
 				smalest = index;
 
-			if (right <= size && ((heapArray[right]->totalCost) < (heapArray[smalest]->totalCost)))
+			if (right <= size && (Cost(right) < Cost(smalest)))
 				smalest = right;
 
 			if (smalest != index) {
-				// swap them
-				PathNode* temp = heapArray[index];
-				heapArray[index] = heapArray[smalest];
-				heapArray[smalest] = temp;
-
-				temp->myIndex = smalest;
-				heapArray[index]->myIndex = index;
+				Swap(index, smalest);
 			} else {
 				heapFixed = true;
 			}
@@ -174,23 +142,289 @@ public:
 	}
 
 private:
-	PathNode** heapArray;
+	float Cost(int i) const {
+		return heapArray[i].cost;
+	}
+
+	void Swap(int i, int j) {
+		const SOpenEntry temp = heapArray[i];
+		heapArray[i] = heapArray[j];
+		heapArray[j] = temp;
+
+		nodes[temp.index].myIndex = j;
+		nodes[heapArray[i].index].myIndex = i;
+	}
+
+	void SiftUp(int i) {
+		while ((i > 1) && (Cost(i >> 1) > Cost(i))) {
+			Swap(i >> 1, i);
+			i >>= 1;
+		}
+	}
+
+	SOpenEntry* heapArray;
+	PathNode* nodes;
+	SNodeData* nodeData;
 	int size;
 };
 
+class OpenQueue4H {
+public:
+	OpenQueue4H(SOpenListMem& mem)
+		: heap(mem.quadHeap)
+		, nodes(mem.nodes)
+		, nodeData(mem.nodeData)
+		, size(0)
+	{}
+
+	~OpenQueue4H() {}
+
+	void Push(unsigned node) {
+		nodeData[node].inOpen = 1;
+		SiftUp(size++, {nodeData[node].totalCost, node});
+	}
+
+	void Update(unsigned node) {
+		SiftUp(nodes[node].myIndex, {nodeData[node].totalCost, node});
+	}
+
+	unsigned Pop() {
+		const unsigned min = heap[0].index;
+		nodeData[min].inOpen = 0;
+		if (--size > 0) {
+			SiftDown(heap[size]);
+		}
+		return min;
+	}
+
+	int Size() const { return size; }
+	bool Empty() {
+		return (size == 0);
+	}
+
+private:
+	void Place(int i, const SOpenEntry entry) {
+		heap[i] = entry;
+		nodes[entry.index].myIndex = i;
+	}
+
+	void SiftUp(int i, const SOpenEntry entry) {
+		while (i > 0) {
+			const int parent = (i - 1) >> 2;
+			if (heap[parent].cost <= entry.cost) {
+				break;
+			}
+			Place(i, heap[parent]);
+			i = parent;
+		}
+		Place(i, entry);
+	}
+
+	void SiftDown(const SOpenEntry entry) {
+		int i = 0;
+		while (true) {
+			const int first = (i << 2) + 1;
+			if (first >= size) {
+				break;
+			}
+			const int last = std::min(first + 4, size);
+			int smallest = first;
+			for (int c = first + 1; c < last; ++c) {
+				if (heap[c].cost < heap[smallest].cost) {
+					smallest = c;
+				}
+			}
+			if (heap[smallest].cost >= entry.cost) {
+				break;
+			}
+			Place(i, heap[smallest]);
+			i = smallest;
+		}
+		Place(i, entry);
+	}
+
+	SOpenEntry* heap;
+	PathNode* nodes;
+	SNodeData* nodeData;
+	int size;
+};
+
+/*
+ * Monotone radix heap. Non-negative floats keep their order when compared as unsigned ints,
+ * so cost bits are used directly as keys and no quantization error is introduced.
+ * Entry goes into bucket by the highest bit that differs from the last extracted key.
+ * Decrease-key pushes a duplicate, stale entries are dropped on extraction.
+ * Keys below the last extracted one (float rounding) are clamped, that only affects tie order.
+ */
+class OpenQueueRH {
+public:
+	OpenQueueRH(SOpenListMem& mem)
+		: buckets(mem.radix)
+		, nodeData(mem.nodeData)
+		, last(0)
+		, size(0)
+	{
+		for (int i = 0; i < RADIX_BUCKETS; ++i) {
+			buckets[i].clear();
+		}
+	}
+
+	~OpenQueueRH() {}
+
+	void Push(unsigned node) {
+		nodeData[node].inOpen = 1;
+		Insert({nodeData[node].totalCost, node});
+	}
+
+	void Update(unsigned node) {
+		Insert({nodeData[node].totalCost, node});
+	}
+
+	// NOTE: Empty() must be called before Pop(), it brings valid minimum into buckets[0]
+	unsigned Pop() {
+		const unsigned min = buckets[0].back().index;
+		buckets[0].pop_back();
+		--size;
+		nodeData[min].inOpen = 0;
+		return min;
+	}
+
+	int Size() const { return size; }  // includes stale entries
+	bool Empty() {
+		std::vector<SOpenEntry>& first = buckets[0];
+		while (true) {
+			while (!first.empty() && IsStale(first.back())) {
+				first.pop_back();
+				--size;
+			}
+			if (!first.empty()) {
+				return false;
+			}
+			if (size == 0) {
+				return true;
+			}
+			Redistribute();
+		}
+	}
+
+private:
+	bool IsStale(const SOpenEntry& entry) const {
+		return !nodeData[entry.index].inOpen || (nodeData[entry.index].totalCost != entry.cost);
+	}
+
+	unsigned Key(float cost) const {
+		uint32_t key;
+		memcpy(&key, &cost, sizeof(key));
+		return std::max(key, last);
+	}
+
+	int Bucket(unsigned key) const {
+		return (key == last) ? 0 : 32 - __builtin_clz(key ^ last);
+	}
+
+	void Insert(const SOpenEntry entry) {
+		buckets[Bucket(Key(entry.cost))].push_back(entry);
+		++size;
+	}
+
+	void Redistribute() {
+		int i = 1;
+		while (buckets[i].empty()) {
+			++i;
+		}
+		std::vector<SOpenEntry>& source = buckets[i];
+		unsigned minKey = std::numeric_limits<unsigned>::max();
+		for (const SOpenEntry& entry : source) {
+			minKey = std::min(minKey, Key(entry.cost));
+		}
+		last = minKey;
+		// all entries of the bucket fall into lower buckets
+		for (const SOpenEntry& entry : source) {
+			if (IsStale(entry)) {
+				--size;
+			} else {
+				buckets[Bucket(Key(entry.cost))].push_back(entry);
+			}
+		}
+		source.clear();
+	}
+
+	std::vector<SOpenEntry>* buckets;
+	SNodeData* nodeData;
+	unsigned last;
+	int size;
+};
+
+#define OPEN_QUEUE_DISPATCH(funcImpl, ...)			\
+	queryStats = {0, 0};							\
+	switch (openListType) {							\
+		default:									\
+		case OpenListType::BINARY_HEAP: {			\
+			return funcImpl<OpenQueueBH>(__VA_ARGS__);	\
+		}											\
+		case OpenListType::QUAD_HEAP: {				\
+			return funcImpl<OpenQueue4H>(__VA_ARGS__);	\
+		}											\
+		case OpenListType::RADIX_HEAP: {			\
+			return funcImpl<OpenQueueRH>(__VA_ARGS__);	\
+		}											\
+	}
+
+
+CGoalSet::CGoalSet()
+		: mapSizeX(0)
+		, mapSizeY(0)
+		, goalCount(0)
+{
+}
+
+void CGoalSet::Init(int sizeX, int sizeY)
+{
+	mapSizeX = sizeX;
+	mapSizeY = sizeY;
+	bits.assign((sizeX * sizeY + 63) / 64, 0);
+	touched.clear();
+	targets.clear();
+	goalCount = 0;
+}
+
+void CGoalSet::Clear()
+{
+	for (unsigned word : touched) {
+		bits[word] = 0;
+	}
+	touched.clear();
+	targets.clear();
+	goalCount = 0;
+}
+
+void CGoalSet::AddGoal(unsigned index)
+{
+	uint64_t& word = bits[index >> 6];
+	const uint64_t mask = uint64_t(1) << (index & 63);
+	if (word & mask) {
+		return;  // overlapping goal areas
+	}
+	if (word == 0) {
+		touched.push_back(index >> 6);
+	}
+	word |= mask;
+	++goalCount;
+}
+
 
 CMicroPather::CMicroPather(Graph* _graph, int sizeX, int sizeY)
 		: mapSizeX(sizeX)
 		, mapSizeY(sizeY)
 		, isRunning(false)
 		, ALLOCATE(sizeX * sizeY)
-		, BLOCKSIZE(ALLOCATE - 1)
 		, graph(_graph)
-		, pathNodeMem(0)
-		, availMem(0)
-		, pathNodeCount(0)
+		, pathNodeMem(nullptr)
+		, nodeData(nullptr)
+		, openListType(OpenListType::BINARY_HEAP)
 		, frame(0)
 		, checksum(0)
+		, queryStats({0, 0})
 {
 //	@param allocate		The block size that the node cache is allocated from. In some
 //						cases setting this parameter will improve the perfomance of the pather.
@@ -227,12 +461,15 @@ CMicroPather::CMicroPather(Graph* _graph, int sizeX, int sizeY)
 
 CMicroPather::~CMicroPather()
 {
-	free(pathNodeMemForFree);
-	free(heapArrayMem);
+	free(pathNodeMem);
+	free(nodeData);
+	free(openListMem.heapArray);
+	free(openListMem.quadHeap);
 }
 
 // make sure that costArray doesn't contain values below 1.0 (for speed), and below 0.0 (for eternal loop)
-void CMicroPather::SetMapData(bool* canMoveArray, float* costArray)
+// canMoveArray: 1 bit per node, edges must be 0, must have 1 padding word at the end
+void CMicroPather::SetMapData(const uint64_t* canMoveArray, float* costArray)
 {
 	this->canMoveArray = canMoveArray;
 	this->costArray = costArray;
@@ -242,57 +479,63 @@ void CMicroPather::Reset()
 {
 	// L("Reseting pather, frame is: " << frame);
 	for (unsigned i = 0; i < ALLOCATE; i++) {
-		PathNode* directNode = &pathNodeMem[i];
-		directNode->Reuse(0);
+		nodeData[i].frame = 0;
 	}
 
 	frame = 1;
 }
 
 // must only be called once...
-PathNode* CMicroPather::AllocatePathNode()
+void CMicroPather::AllocatePathNode()
 {
-	PathNode* result = 0x0;
-
-	if (availMem == 0) {
-		PathNode* newBlock = (PathNode*) malloc(sizeof(PathNode) * ALLOCATE);
-		// L("pathNodeMemForFree: " << ((unsigned) newBlock));
-		pathNodeMemForFree = newBlock;
-		pathNodeMem = newBlock;
-		// L(" sizeof(PathNode): " << sizeof(PathNode));
-		availMem = BLOCKSIZE;
+	if (pathNodeMem == nullptr) {
+		pathNodeMem = (PathNode*) malloc(sizeof(PathNode) * ALLOCATE);
+		nodeData = (SNodeData*) malloc(sizeof(SNodeData) * ALLOCATE);
 
 		// make all the nodes in one go (step one)
 		for (unsigned i = 0; i < ALLOCATE; i++) {
-			result = &pathNodeMem[i];
-			++pathNodeCount;
-			result->Init(0, FLT_BIG, 0);
+			pathNodeMem[i].Init();
+			nodeData[i].frame = 0;
+			nodeData[i].costFromStart = FLT_BIG;
+			nodeData[i].totalCost = FLT_BIG;
+			nodeData[i].parent = NO_PARENT;
+			nodeData[i].inOpen = 0;
+			nodeData[i].inClosed = 0;
 		}
 
-		result = newBlock;
-		heapArrayMem = (PathNode**) malloc(sizeof(PathNode*) * ALLOCATE);
+		openListMem.nodes = pathNodeMem;
+		openListMem.nodeData = nodeData;
+		openListMem.heapArray = (SOpenEntry*) malloc(sizeof(SOpenEntry) * (ALLOCATE + 1));
+		openListMem.quadHeap = (SOpenEntry*) malloc(sizeof(SOpenEntry) * ALLOCATE);
 	}
 	else {
 		// this is bad....
 		// AllocatePathNodeCalledTwice
 		assert(false);
 	}
+}
 
-	return result;
+// Prepares node's search data for the current frame
+inline void CMicroPather::Reuse(unsigned index)
+{
+	nodeData[index].frame = frame;
+	nodeData[index].costFromStart = (FLT_BIG / 2.0f);
+	nodeData[index].inOpen = 0;
+	nodeData[index].inClosed = 0;
 }
 
-void CMicroPather::GoalReached(PathNode* node, void* start, void* end, std::vector<void*>* path)
+void CMicroPather::GoalReached(unsigned node, void* start, void* end, std::vector<void*>* path)
 {
 	path->clear();
 
 	// we have reached the goal, how long is the path?
 	// (used to allocate the vector which is returned)
 	int count = 1;
-	PathNode* it = node;
+	unsigned it = node;
 
-	while (it->parent) {
+	while (nodeData[it].parent != NO_PARENT) {
 		++count;
-		it = it->parent;
+		it = nodeData[it].parent;
 	}
 
 	// now that the path has a known length, allocate
@@ -310,43 +553,41 @@ void CMicroPather::GoalReached(PathNode* node, void* start, void* end, std::vect
 		(*path)[count - 1] = end;
 
 		count -= 2;
-		it = node->parent;
+		it = nodeData[node].parent;
 
-		while (it->parent) {
-			(*path)[count] = (void*) ((((size_t) it) - ((size_t) pathNodeMem)) / sizeof(PathNode));
-			it = it->parent;
+		while (nodeData[it].parent != NO_PARENT) {
+			(*path)[count] = (void*) static_cast<intptr_t>(it);
+			it = nodeData[it].parent;
 			--count;
 		}
 	}
 
 	#ifdef DEBUG_PATH
 	printf("Path: ");
-	printf("Cost = %.1f Checksum %d\n", node->costFromStart, checksum);
+	printf("Cost = %.1f Checksum %d\n", nodeData[node].costFromStart, checksum);
 	#endif
 }
 
-float CMicroPather::CheckSafety(PathNode* node)
+float CMicroPather::CheckSafety(unsigned node)
 {
-	PathNode* it = node;
+	unsigned it = node;
 	float prevCost = THREAT_BASE;
 
-	while (it->parent) {
-		size_t index = (((size_t) it) - ((size_t) pathNodeMem)) / sizeof(PathNode);
-		const float cost = costArray[index];
+	while (nodeData[it].parent != NO_PARENT) {
+		const float cost = costArray[it];
 		if (cost < prevCost) {
 			return -1.0f;
 		}
 		prevCost = cost;
-		it = it->parent;
+		it = nodeData[it].parent;
 	}
 
-	size_t index = (((size_t) it) - ((size_t) pathNodeMem)) / sizeof(PathNode);
-	const float cost = costArray[(size_t)index];
+	const float cost = costArray[it];
 	if (cost < prevCost) {
 		return -1.0f;
 	}
 
-	return node->costFromStart;
+	return nodeData[node].costFromStart;
 }
 
 float CMicroPather::LeastCostEstimateLocal(int nodeStartIndex)
@@ -375,6 +616,31 @@ inline float CMicroPather::DiagonalDistance(int xStart, int yStart, int xEnd, in
 	return (dx + dy) - 0.5858f * std::min(dx, dy);
 }
 
+// Passability of (index - 1, index, index + 1) as bits 0..2
+inline unsigned CMicroPather::MoveBits3(int index) const
+{
+	const int pos = index - 1;
+	const int bit = pos & 63;
+	const uint64_t* word = &canMoveArray[pos >> 6];
+	uint64_t bits = word[0] >> bit;
+	if (bit > 61) {
+		bits |= word[1] << (64 - bit);
+	}
+	return bits & 7;
+}
+
+// Passability of 8 neighbours, bit i corresponds to offsets[i]
+inline unsigned CMicroPather::NeighbourMask(int index) const
+{
+	const unsigned up   = MoveBits3(index - mapSizeX);
+	const unsigned mid  = MoveBits3(index);
+	const unsigned down = MoveBits3(index + mapSizeX);
+	return ((mid & 1)) | ((mid >> 2 & 1) << 1)
+		| ((down >> 1 & 1) << 2) | ((up >> 1 & 1) << 3)
+		| ((up & 1) << 4) | ((up >> 2 & 1) << 5)
+		| ((down & 1) << 6) | ((down >> 2 & 1) << 7);
+}
+
 void CMicroPather::FixStartEndNode(void** startNode, void** endNode)
 {
 	size_t index = (size_t) *startNode;
@@ -443,6 +709,12 @@ void CMicroPather::FixNode(void** Node)
 }
 
 int CMicroPather::Solve(void* startNode, void* endNode, std::vector<void*>* path, float* cost)
+{
+	OPEN_QUEUE_DISPATCH(SolveImpl, startNode, endNode, path, cost);
+}
+
+template<class OpenQueue>
+int CMicroPather::SolveImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost)
 {
 	assert(!isRunning);
 	isRunning = true;
@@ -456,50 +728,48 @@ int CMicroPather::Solve(void* startNode, void* endNode, std::vector<void*>* path
 	{
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t) startNode]) {
+		if (!CanMove((size_t) startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
-		if (!canMoveArray[(size_t) endNode]) {
+		if (!CanMove((size_t) endNode)) {
 			// can't move into the endNode: just fail fast
 			isRunning = false;
 			return NO_SOLUTION;
 		}
 	}
 
-	++frame;
-
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// Make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		const float estToGoal = LeastCostEstimateLocal( (size_t) startNode);
-
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
-	PathNode* endPathNode = &(pathNodeMem[(size_t) endNode]);
+	const unsigned endIndex = (size_t) endNode;
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		if (node == endPathNode) {
+		if (node == endIndex) {
 			GoalReached(node, startNode, endNode, path);
-			*cost = node->costFromStart;
+			*cost = nodeData[node].costFromStart;
 			isRunning = false;
 			return SOLVED;
 		}
 		else {
 			// we have not reached the goal, add the neighbors (emulate GetNodeNeighbors)
-			int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+			int indexStart = node;
 
 			#ifdef USE_ASSERTIONS
 			const int ystart = indexStart / mapSizeX;
@@ -510,19 +780,14 @@ int CMicroPather::Solve(void* startNode, void* endNode, std::vector<void*>* path
 			assert((ystart != 0) && (ystart != mapSizeY - 1));
 			#endif
 
-			float nodeCostFromStart = node->costFromStart;
+			float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -530,7 +795,7 @@ int CMicroPather::Solve(void* startNode, void* endNode, std::vector<void*>* path
 				const int xend = indexEnd - yend * mapSizeX;
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 
 				// no node can be at the edge!
 				assert((xend != 0) && (xend != mapSizeX - 1));
@@ -541,42 +806,46 @@ int CMicroPather::Solve(void* startNode, void* endNode, std::vector<void*>* path
 
 				newCost += (i > 3) ? costArray[indexEnd] * SQRT_2 : costArray[indexEnd];
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
 	return NO_SOLUTION;
 }
 
-int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*>& endNodes, std::vector<void*>& targets, std::vector<void*>* path, float* cost)
+int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost)
+{
+	OPEN_QUEUE_DISPATCH(FindBestPathToAnyGivenPointImpl, startNode, goals, path, cost);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindBestPathToAnyGivenPointImpl(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost)
 {
 	assert(!isRunning);
 	isRunning = true;
 	*cost = 0.0f;
 
-	if (endNodes.size() <= 0) {
+	if (goals.IsEmpty()) {
 		// just fail fast
 		isRunning = false;
 		return NO_SOLUTION;
@@ -584,76 +853,59 @@ int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*
 
 	{
 		// select best goal node
-		void* endNode = endNodes[0];
+		void* endNode = (void*) static_cast<intptr_t>(goals.GetTargets().front());
 		const int yStart = (size_t)startNode / mapSizeX;
 		const int xStart = (size_t)startNode - yStart * mapSizeX;
 
 		float leastCost = std::numeric_limits<float>::max();
-		for (void*& target : targets) {
-			FixNode(&target);
-			const int y = (size_t)target / mapSizeX;
-			const int x = (size_t)target - y * mapSizeX;
+		for (unsigned target : goals.GetTargets()) {
+			const int y = target / mapSizeX;
+			const int x = target - y * mapSizeX;
 			const float cost = DiagonalDistance(xStart, yStart, x, y);
 
 			if (leastCost > cost) {
 				leastCost = cost;
-				endNode = target;
+				endNode = (void*) static_cast<intptr_t>(target);
 			}
 		}
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// Make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		const float estToGoal = LeastCostEstimateLocal((size_t)startNode);
-
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
-	}
-
-	// mark the endNodes
-	for (unsigned i = 0; i < endNodes.size(); i++) {
-		FixNode(&endNodes[i]);
-		PathNode* tempEndNode = &pathNodeMem[(size_t) endNodes[i]];
-		tempEndNode->isEndNode = 1;
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		if (node->isEndNode) {
-			void* theEndNode = (void*) ((((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode));
+		if (goals.IsGoal(node)) {
+			void* theEndNode = (void*) static_cast<intptr_t>(node);
 
 			GoalReached(node, startNode, theEndNode, path);
-			*cost = node->costFromStart;
+			*cost = nodeData[node].costFromStart;
 			isRunning = false;
-
-			// unmark the endNodes
-			for (unsigned i = 0; i < endNodes.size(); i++) {
-				PathNode* tempEndNode = &pathNodeMem[(size_t) endNodes[i]];
-				tempEndNode->isEndNode = 0;
-			}
-
 			return SOLVED;
 		} else {
 			// we have not reached the goal, add the neighbors (emulate GetNodeNeighbors)
-			const int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+			const int indexStart = node;
 
 			#ifdef USE_ASSERTIONS
 			const int ystart = indexStart / mapSizeX;
@@ -664,19 +916,14 @@ int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*
 			assert((ystart > 0) && (ystart < mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				const int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -688,7 +935,7 @@ int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*
 				assert((yend > 0) && (yend < mapSizeY - 1));
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 				#endif
 
 				float newCost = nodeCostFromStart;
@@ -697,49 +944,47 @@ int CMicroPather::FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*
 				// sqrt(2) ~= 1.4142f
 				newCost += (i > 3) ? nodeCost * SQRT_2 : nodeCost;
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
-	}
-
-	// unmark the endNodes
-	for (unsigned i = 0; i < endNodes.size(); i++) {
-		PathNode* tempEndNode = &pathNodeMem[(size_t)endNodes[i]];
-		tempEndNode->isEndNode = 0;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
 	return NO_SOLUTION;
 }
 
-int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<void*>& endNodes, std::vector<void*>& targets, std::vector<void*>* path, float* cost)
+int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost)
+{
+	OPEN_QUEUE_DISPATCH(FindBestPathToAnyGivenPointSafeImpl, startNode, goals, path, cost);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindBestPathToAnyGivenPointSafeImpl(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost)
 {
 	assert(!isRunning);
 	isRunning = true;
 	*cost = 0.0f;
 
-	if (endNodes.size() <= 0) {
+	if (goals.IsEmpty()) {
 		// just fail fast
 		isRunning = false;
 		return NO_SOLUTION;
@@ -747,54 +992,44 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 
 	{
 		// select best goal node
-		void* endNode = endNodes[0];
+		void* endNode = (void*) static_cast<intptr_t>(goals.GetTargets().front());
 		const int yStart = (size_t)startNode / mapSizeX;
 		const int xStart = (size_t)startNode - yStart * mapSizeX;
 
 		float leastCost = std::numeric_limits<float>::max();
-		for (void*& target : targets) {
-			FixNode(&target);
-			const int y = (size_t)target / mapSizeX;
-			const int x = (size_t)target - y * mapSizeX;
+		for (unsigned target : goals.GetTargets()) {
+			const int y = target / mapSizeX;
+			const int x = target - y * mapSizeX;
 			const float cost = DiagonalDistance(xStart, yStart, x, y);
 
 			if (leastCost > cost) {
 				leastCost = cost;
-				endNode = target;
+				endNode = (void*) static_cast<intptr_t>(target);
 			}
 		}
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// Make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		const float estToGoal = LeastCostEstimateLocal((size_t)startNode);
-
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
-	}
-
-	// mark the endNodes
-	for (unsigned i = 0; i < endNodes.size(); i++) {
-		FixNode(&endNodes[i]);
-		PathNode* tempEndNode = &pathNodeMem[(size_t) endNodes[i]];
-		tempEndNode->isEndNode = 1;
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		pathNodeMem[startIndex].checkIdx = 0;
+		open.Push(startIndex);
 	}
 
 	static std::array<std::function<bool (float diff)>, 2> peakCheck = {
@@ -803,25 +1038,19 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 	};
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		if (node->isEndNode) {
-			void* theEndNode = (void*) ((((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode));
+		if (goals.IsGoal(node)) {
+			void* theEndNode = (void*) static_cast<intptr_t>(node);
 
 			GoalReached(node, startNode, theEndNode, path);
-			*cost = node->costFromStart;
+			*cost = nodeData[node].costFromStart;
 			isRunning = false;
-
-			// unmark the endNodes
-			for (unsigned i = 0; i < endNodes.size(); i++) {
-				PathNode* tempEndNode = &pathNodeMem[(size_t) endNodes[i]];
-				tempEndNode->isEndNode = 0;
-			}
-
 			return SOLVED;
 		} else {
 			// we have not reached the goal, add the neighbors (emulate GetNodeNeighbors)
-			const int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+			const int indexStart = node;
 
 			#ifdef USE_ASSERTIONS
 			const int ystart = indexStart / mapSizeX;
@@ -832,20 +1061,15 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 			assert((ystart > 0) && (ystart < mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 			const float nodeCostStart = costArray[indexStart];
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				const int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -857,7 +1081,7 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 				assert((yend > 0) && (yend < mapSizeY - 1));
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 				#endif
 
 				float newCost = nodeCostFromStart;
@@ -866,12 +1090,12 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 				// sqrt(2) ~= 1.4142f
 				newCost += (i > 3) ? nodeCost * SQRT_2 : nodeCost;
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
-				unsigned checkIdx = node->checkIdx;
+				unsigned checkIdx = pathNodeMem[node].checkIdx;
 				if (peakCheck[checkIdx](nodeCost - nodeCostStart)) {
 					if (++checkIdx >= peakCheck.size()) {
 						continue;
@@ -879,31 +1103,23 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
-				directNode->checkIdx = checkIdx;
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				pathNodeMem[indexEnd].checkIdx = checkIdx;
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
-	}
-
-	// unmark the endNodes
-	for (unsigned i = 0; i < endNodes.size(); i++) {
-		PathNode* tempEndNode = &pathNodeMem[(size_t)endNodes[i]];
-		tempEndNode->isEndNode = 0;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
@@ -911,6 +1127,12 @@ int CMicroPather::FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<v
 }
 
 int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius)
+{
+	OPEN_QUEUE_DISPATCH(FindBestPathToPointOnRadiusImpl, startNode, endNode, path, cost, radius);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindBestPathToPointOnRadiusImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius)
 {
 	assert(!isRunning);
 	isRunning = true;
@@ -925,27 +1147,26 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 	{
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		float estToGoal = LeastCostEstimateLocal( (size_t) startNode);
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
 	// make the radius
@@ -966,9 +1187,10 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 	// L("yEndNode: " << yEndNode << ", xEndNode: " << xEndNode);
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+		int indexStart = node;
 		int ystart = indexStart / mapSizeX;
 		int xstart = indexStart - ystart * mapSizeX;
 		// L("counter: " << counter << ", ystart: " << ystart << ", xstart: " << xstart);
@@ -985,7 +1207,7 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 
 				GoalReached(node, startNode, (void*) static_cast<intptr_t>(indexStart), path);
 
-				*cost = node->costFromStart;
+				*cost = nodeData[node].costFromStart;
 				isRunning = false;
 				return SOLVED;
 			}
@@ -999,19 +1221,14 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 			assert(ystart > 0 && (ystart != mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -1019,7 +1236,7 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 				int xend = indexEnd - yend * mapSizeX;
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 
 				// no node can be at the edge!
 				assert((xend != 0) && (xend != mapSizeX - 1));
@@ -1030,30 +1247,28 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 
 				newCost += (i > 3) ? costArray[indexEnd] * SQRT_2 : costArray[indexEnd];
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
@@ -1061,6 +1276,12 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 }
 
 int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius, float threat)
+{
+	OPEN_QUEUE_DISPATCH(FindBestPathToPointOnRadiusImpl, startNode, endNode, path, cost, radius, threat);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindBestPathToPointOnRadiusImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius, float threat)
 {
 	assert(!isRunning);
 	isRunning = true;
@@ -1075,27 +1296,26 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 	{
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		float estToGoal = LeastCostEstimateLocal( (size_t) startNode);
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
 	// make the radius
@@ -1116,9 +1336,10 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 	// L("yEndNode: " << yEndNode << ", xEndNode: " << xEndNode);
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+		int indexStart = node;
 		int ystart = indexStart / mapSizeX;
 		int xstart = indexStart - ystart * mapSizeX;
 		// L("counter: " << counter << ", ystart: " << ystart << ", xstart: " << xstart);
@@ -1135,7 +1356,7 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 
 				GoalReached(node, startNode, (void*) static_cast<intptr_t>(indexStart), path);
 
-				*cost = node->costFromStart;
+				*cost = nodeData[node].costFromStart;
 				isRunning = false;
 				return SOLVED;
 			}
@@ -1149,19 +1370,14 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 			assert(ystart > 0 && (ystart != mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -1169,7 +1385,7 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 				int xend = indexEnd - yend * mapSizeX;
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 
 				// no node can be at the edge!
 				assert((xend != 0) && (xend != mapSizeX - 1));
@@ -1181,30 +1397,28 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 				const float nodeCost = std::max(THREAT_BASE, costArray[indexEnd] - threat);
 				newCost += (i > 3) ? nodeCost * SQRT_2 : nodeCost;
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
@@ -1212,6 +1426,12 @@ int CMicroPather::FindBestPathToPointOnRadius(void* startNode, void* endNode, st
 }
 
 int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, float* cost, int radius)
+{
+	OPEN_QUEUE_DISPATCH(FindBestCostToPointOnRadiusImpl, startNode, endNode, cost, radius);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindBestCostToPointOnRadiusImpl(void* startNode, void* endNode, float* cost, int radius)
 {
 	assert(!isRunning);
 	isRunning = true;
@@ -1226,27 +1446,26 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 	{
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		float estToGoal = LeastCostEstimateLocal( (size_t) startNode);
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
 	// make the radius
@@ -1267,9 +1486,10 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 	// L("yEndNode: " << yEndNode << ", xEndNode: " << xEndNode);
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+		int indexStart = node;
 		int ystart = indexStart / mapSizeX;
 		int xstart = indexStart - ystart * mapSizeX;
 		// L("counter: " << counter << ", ystart: " << ystart << ", xstart: " << xstart);
@@ -1284,7 +1504,7 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 			if (relativeX <= xend[relativeY]) {
 				// L("Its a hit: " << counter);
 
-				*cost = node->costFromStart;
+				*cost = nodeData[node].costFromStart;
 				isRunning = false;
 				return SOLVED;
 			}
@@ -1298,19 +1518,14 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 			assert(ystart > 0 && (ystart != mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -1318,7 +1533,7 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 				int xend = indexEnd - yend * mapSizeX;
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 
 				// no node can be at the edge!
 				assert((xend != 0) && (xend != mapSizeX - 1));
@@ -1329,30 +1544,28 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 
 				newCost += (i > 3) ? costArray[indexEnd] * SQRT_2 : costArray[indexEnd];
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
@@ -1360,6 +1573,12 @@ int CMicroPather::FindBestCostToPointOnRadius(void* startNode, void* endNode, fl
 }
 
 int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode, float* cost, int radius)
+{
+	OPEN_QUEUE_DISPATCH(FindDirectCostToPointOnRadiusImpl, startNode, endNode, cost, radius);
+}
+
+template<class OpenQueue>
+int CMicroPather::FindDirectCostToPointOnRadiusImpl(void* startNode, void* endNode, float* cost, int radius)
 {
 	assert(!isRunning);
 	isRunning = true;
@@ -1374,27 +1593,26 @@ int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode,
 	{
 		FixStartEndNode(&startNode, &endNode);
 
-		if (!canMoveArray[(size_t)startNode]) {
+		if (!CanMove((size_t)startNode)) {
 			// L("Pather: trying to move from a blocked start pos");
 		}
 	}
 
-	++frame;
-	if (frame > 65534) {
-		// L("frame > 65534, pather reset needed");
+	if (++frame == 0) {
+		// 32-bit generation wrapped around
 		Reset();
 	}
 
 	// make the priority queue
-	OpenQueueBH open(heapArrayMem);
+	OpenQueue open(openListMem);
 
 	{
-		PathNode* tempStartNode = &pathNodeMem[(size_t) startNode];
-		float estToGoal = LeastCostEstimateLocal( (size_t) startNode);
-		tempStartNode->Reuse(frame);
-		tempStartNode->costFromStart = 0;
-		tempStartNode->totalCost = estToGoal;
-		open.Push(tempStartNode);
+		const unsigned startIndex = (size_t) startNode;
+		Reuse(startIndex);
+		nodeData[startIndex].parent = NO_PARENT;
+		nodeData[startIndex].costFromStart = 0;
+		nodeData[startIndex].totalCost = LeastCostEstimateLocal(startIndex);
+		open.Push(startIndex);
 	}
 
 	// make the radius
@@ -1415,9 +1633,10 @@ int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode,
 	// L("yEndNode: " << yEndNode << ", xEndNode: " << xEndNode);
 
 	while (!open.Empty()) {
-		PathNode* node = open.Pop();
+		const unsigned node = open.Pop();
+		++queryStats.expanded;
 
-		int indexStart = (((size_t) node) - ((size_t) pathNodeMem)) / sizeof(PathNode);
+		int indexStart = node;
 		int ystart = indexStart / mapSizeX;
 		int xstart = indexStart - ystart * mapSizeX;
 		// L("counter: " << counter << ", ystart: " << ystart << ", xstart: " << xstart);
@@ -1446,19 +1665,14 @@ int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode,
 			assert(ystart > 0 && (ystart != mapSizeY - 1));
 			#endif
 
-			const float nodeCostFromStart = node->costFromStart;
+			const float nodeCostFromStart = nodeData[node].costFromStart;
 
-			for (int i = 0; i < 8; ++i) {
+			for (unsigned moveMask = NeighbourMask(indexStart); moveMask != 0; moveMask &= moveMask - 1) {
+				const int i = __builtin_ctz(moveMask);
 				int indexEnd = offsets[i] + indexStart;
 
-				if (!canMoveArray[indexEnd]) {
-					continue;
-				}
-
-				PathNode* directNode = &pathNodeMem[indexEnd];
-
-				if (directNode->frame != frame) {
-					directNode->Reuse(frame);
+				if (nodeData[indexEnd].frame != frame) {
+					Reuse(indexEnd);
 				}
 
 				#ifdef USE_ASSERTIONS
@@ -1466,7 +1680,7 @@ int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode,
 				int xend = indexEnd - yend * mapSizeX;
 
 				// we can move to that spot
-				assert(canMoveArray[yend * mapSizeX + xend]);
+				assert(CanMove(yend * mapSizeX + xend));
 
 				// no node can be at the edge!
 				assert((xend != 0) && (xend != mapSizeX - 1));
@@ -1477,30 +1691,28 @@ int CMicroPather::FindDirectCostToPointOnRadius(void* startNode, void* endNode,
 
 				newCost += (i > 3) ? THREAT_BASE * SQRT_2 : THREAT_BASE;
 
-				if (directNode->costFromStart <= newCost) {
+				if (nodeData[indexEnd].costFromStart <= newCost) {
 					// do nothing, this path is not better than existing one
 					continue;
 				}
 
 				// it's better, update its data
-				directNode->parent = node;
-				directNode->costFromStart = newCost;
-				directNode->totalCost = newCost + LeastCostEstimateLocal(indexEnd);
+				nodeData[indexEnd].parent = node;
+				nodeData[indexEnd].costFromStart = newCost;
+				nodeData[indexEnd].totalCost = newCost + LeastCostEstimateLocal(indexEnd);
 
-				#ifdef USE_ASSERTIONS
-				assert(((size_t) indexEnd) == ((((size_t) directNode) - ((size_t) pathNodeMem)) / sizeof(PathNode)));
-				#endif
 
-				if (directNode->inOpen) {
-					open.Update(directNode);
+				if (nodeData[indexEnd].inOpen) {
+					open.Update(indexEnd);
 				} else {
-					directNode->inClosed = 0;
-					open.Push(directNode);
+					nodeData[indexEnd].inClosed = 0;
+					open.Push(indexEnd);
+					queryStats.openPeak = std::max<unsigned>(queryStats.openPeak, open.Size());
 				}
 			}
 		}
 
-		node->inClosed = 1;
+		nodeData[node].inClosed = 1;
 	}
 
 	isRunning = false;
@@ -60,6 +60,7 @@
 
 #include <vector>
 #include <cfloat>
+#include <cstdint>
 
 #ifdef _DEBUG
 	#ifndef DEBUG
@@ -69,14 +70,8 @@
 
 #define FLT_BIG (FLT_MAX / 2.0)
 
-/*
- * USE_LIST and USE_BINARY_HASH change the some of details the pather algorithms. They
- * are set optimally in my experiments, but different applications may benefit
- * from a different combination of these #defines.
- */
-
-// #define USE_LIST
-// #define USE_BINARY_HASH
+// Parent of the start node. Index 0 is the map corner, always impassable, hence never a parent.
+#define NO_PARENT	0u
 
 namespace NSMicroPather {
 	/*
@@ -115,87 +110,72 @@ namespace NSMicroPather {
 
 
 
+	/*
+	 * Open list engines, selectable per query with CMicroPather::SetOpenListType().
+	 * BINARY_HEAP: pointer-based binary heap, the original engine.
+	 * QUAD_HEAP:   4-ary heap of (cost, node index) pairs kept in a separate array,
+	 *              sifting compares costs without dereferencing PathNodes.
+	 * RADIX_HEAP:  monotone radix heap keyed by float cost bits, decrease-key is done
+	 *              by lazy re-insertion. Relies on consistent heuristic (costArray >= 1.0).
+	 */
+	enum class OpenListType: unsigned char {BINARY_HEAP = 0, QUAD_HEAP, RADIX_HEAP};
+
+	class PathNode;
+
+	/*
+	 * Hot per-node search data, 16 bytes: everything a relaxation reads or writes sits in one cache line.
+	 * frame tells whether the rest belongs to the current search.
+	 */
+	struct SNodeData {
+		unsigned frame;			// generation of node's search data
+		float costFromStart;	// exact
+		float totalCost;		// could be a function, but save some math
+		unsigned parent:30;		// parent index, used to reconstruct the path
+		unsigned inOpen:1;
+		unsigned inClosed:1;
+	};
+	static_assert(sizeof(SNodeData) == 16, "SNodeData must stay 16 bytes");
+
+	// Counters of the last query
+	struct SQueryStats {
+		unsigned expanded;  // nodes popped from open list
+		unsigned openPeak;  // max open list size, radix heap counts stale entries too
+	};
+
+	struct SOpenEntry {
+		float cost;
+		unsigned index;
+	};
+
+	#define RADIX_BUCKETS	33
+
+	// Memory shared by open list engines, allocated once per pather
+	struct SOpenListMem {
+		PathNode* nodes;
+		SNodeData* nodeData;
+		SOpenEntry* heapArray; // 1-based binary heap
+		SOpenEntry* quadHeap;  // 0-based 4-ary heap
+		std::vector<SOpenEntry> radix[RADIX_BUCKETS];
+	};
+
+	/*
+	 * Cold part of the node: heap position and safe search predicate.
+	 * Hot search data (generation, g/f costs, parent index, open/closed flags) is kept apart in SNodeData,
+	 * Reuse doesn't touch this part: fields are written before they are read.
+	 */
 	class PathNode {
 		// trashy trick to get rid of compiler warning because this class has a private constructor and destructor
 		// (it can never be "new" or created on the stack, only by special allocators)
 		friend class none;
 
 		public:
-			void Init(unsigned _frame, float _costFromStart, PathNode* _parent) {
-				costFromStart = _costFromStart;
-				totalCost = _costFromStart;
+			void Init() {
+				myIndex = 0;
 				checkIdx = 0;
-				parent = _parent;
-				frame = _frame;
-
-				#ifdef USE_BINARY_HASH
-				right = 0;
-				#endif
-				#ifdef USE_LIST
-				next = 0;
-				prev = 0;
-				#endif
-				inOpen = 0;
-				inClosed = 0;
-				isTarget = 0;
-				isEndNode = 0;
 			}
 
-			inline void Reuse(unsigned _frame) {
-				costFromStart = (FLT_BIG / 2.0f);
-				checkIdx = 0;
-				parent = 0;
-				frame = _frame;
-
-				inOpen = 0;
-				inClosed = 0;
-			}
-
-			int myIndex;
-			float costFromStart;	// exact
-			float totalCost;		// could be a function, but save some math.
-			unsigned checkIdx;		// index of current predicate
-			PathNode* parent;		// the parent is used to reconstruct the path
-
-			// Binary tree, where the 'state' is what is being compared.
-			// Also used as a "next" pointer for memory layout.
-
-			#ifdef USE_BINARY_HASH
-			PathNode* right;
-			#endif
-			#ifdef USE_LIST
-			PathNode* next, *prev;
-			#endif
-
-			unsigned inOpen:1;
-			unsigned inClosed:1;
-			unsigned isTarget:1;
-			unsigned isEndNode:1;	// this must be cleared by the call that sets it
-			unsigned frame:16;		// this might be set to more that 16
-
-			#ifdef USE_LIST
-			void Unlink() {
-				next -> prev = prev;
-				prev -> next = next;
-				next = prev = 0;
-			}
-			void AddBefore(PathNode* addThis) {
-				addThis -> next = this;
-				addThis -> prev = prev;
-				prev -> next = addThis;
-				prev = addThis;
-			}
-			#ifdef DEBUG
-			void CheckList() {
-				assert(totalCost == FLT_BIG);
-
-				for (PathNode* it = next; it != this; it = it -> next) {
-					assert(it -> prev == this || it -> totalCost >= it -> prev -> totalCost);
-					assert(it -> totalCost <= it -> next -> totalCost);
-				}
-			}
-			#endif
-			#endif
+			int myIndex;			// position in the open list, set on push
+			unsigned checkIdx;		// index of current predicate, set on relaxation
 
 		private:
 			PathNode();
@@ -203,6 +183,35 @@ namespace NSMicroPather {
 		};
 
 
+	/*
+	 * Goal nodes of multi-target search: bitmap over path nodes.
+	 * Targets are the centres of goal areas, the closest one steers the heuristic.
+	 * Set is not modified by searches and can be shared by any number of them.
+	 */
+	class CGoalSet {
+		public:
+			CGoalSet();
+
+			void Init(int sizeX, int sizeY);  // also clears
+			void Clear();  // resets only touched words
+			bool IsInit(int sizeX, int sizeY) const { return (mapSizeX == sizeX) && (mapSizeY == sizeY); }
+
+			void AddTarget(unsigned index) { targets.push_back(index); }
+			void AddGoal(unsigned index);
+
+			bool IsGoal(unsigned index) const { return (bits[index >> 6] >> (index & 63)) & 1; }
+			bool IsEmpty() const { return targets.empty() || (goalCount == 0); }
+			const std::vector<unsigned>& GetTargets() const { return targets; }
+
+		private:
+			int mapSizeX;
+			int mapSizeY;
+			std::vector<uint64_t> bits;
+			std::vector<unsigned> touched;  // indices of non-zero words
+			std::vector<unsigned> targets;
+			unsigned goalCount;
+	};
+
 	// create a MicroPather object to solve for a best path
 	class CMicroPather {
 		friend class NSMicroPather::PathNode;
@@ -237,57 +246,72 @@ namespace NSMicroPather {
 			 */
 			int Solve(void* startState, void* endState, std::vector<void*>* path, float* totalCost);
 
-			// Should not be called unless there is danger for frame overflow (16bit atm)
+			// Clears generation of every node. Searches call it only on 32-bit frame wrap-around.
 			void Reset();
 
+			void SetOpenListType(OpenListType type) { openListType = type; }
+			OpenListType GetOpenListType() const { return openListType; }
+
 			/**
 			  * Return the "checksum" of the last path returned by Solve(). Useful for debugging,
 			  * and a quick way to see if 2 paths are the same.
 			  */
 			unsigned Checksum() const { return checksum; }
+			const SQueryStats& GetQueryStats() const { return queryStats; }
 
 			// Tournesol's stuff
 			unsigned int* lockUpCount;
-			bool* canMoveArray;
+			const uint64_t* canMoveArray;  // bitset, 1 bit per node
 			float* costArray;
 			int mapSizeX;
 			int mapSizeY;
 			int offsets[8];
 			int xEndNode, yEndNode;
 			bool isRunning;
-			void SetMapData(bool* canMoveArray, float* costArray);
-			int FindBestPathToAnyGivenPoint(void* startNode, std::vector<void*>& endNodes, std::vector<void*>& targets,
-											std::vector<void*>* path, float* cost);
-			int FindBestPathToAnyGivenPointSafe(void* startNode, std::vector<void*>& endNodes, std::vector<void*>& targets,
-											std::vector<void*>* path, float* cost);
+			void SetMapData(const uint64_t* canMoveArray, float* costArray);
+			bool CanMove(int index) const { return (canMoveArray[index >> 6] >> (index & 63)) & 1; }
+			int FindBestPathToAnyGivenPoint(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost);
+			int FindBestPathToAnyGivenPointSafe(void* startNode, const CGoalSet& goals, std::vector<void*>* path, float* cost);
 			int FindBestPathToPointOnRadius(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius);
 			int FindBestPathToPointOnRadius(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius, float threat);
 			int FindBestCostToPointOnRadius(void* startNode, void* endNode, float* cost, int radius);
 			int FindDirectCostToPointOnRadius(void* startNode, void* endNode, float* cost, int radius);
 
 		private:
-			void GoalReached(PathNode* node, void* start, void* end, std::vector<void*> *path);
-			float CheckSafety(PathNode* node);
+			template<class OpenQueue> int SolveImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost);
+			template<class OpenQueue> int FindBestPathToAnyGivenPointImpl(void* startNode, const CGoalSet& goals,
+																		  std::vector<void*>* path, float* cost);
+			template<class OpenQueue> int FindBestPathToAnyGivenPointSafeImpl(void* startNode, const CGoalSet& goals,
+																			  std::vector<void*>* path, float* cost);
+			template<class OpenQueue> int FindBestPathToPointOnRadiusImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius);
+			template<class OpenQueue> int FindBestPathToPointOnRadiusImpl(void* startNode, void* endNode, std::vector<void*>* path, float* cost, int radius, float threat);
+			template<class OpenQueue> int FindBestCostToPointOnRadiusImpl(void* startNode, void* endNode, float* cost, int radius);
+			template<class OpenQueue> int FindDirectCostToPointOnRadiusImpl(void* startNode, void* endNode, float* cost, int radius);
+
+			inline void Reuse(unsigned index);
+			void GoalReached(unsigned node, void* start, void* end, std::vector<void*> *path);
+			float CheckSafety(unsigned node);
 			float LeastCostEstimateLocal(int nodeStartIndex);
 			static inline float DiagonalDistance(int xStart, int yStart, int xEnd, int yEnd);
+			inline unsigned MoveBits3(int index) const;
+			inline unsigned NeighbourMask(int index) const;
 			void FixStartEndNode(void** startNode, void** endNode);
 			void FixNode(void** Node);
 
-			// allocates the node array, don't call more than once
-			PathNode* AllocatePathNode();
+			// allocates the node arrays, don't call more than once
+			void AllocatePathNode();
 
-			const unsigned ALLOCATE;		// how big a block of pathnodes to allocate at once
-			const unsigned BLOCKSIZE;		// how many useable pathnodes are in a block
+			const unsigned ALLOCATE;		// how many nodes to allocate
 
 			Graph* graph;
-			PathNode* pathNodeMem;			// pointer to root of PathNode blocks
-			PathNode* pathNodeMemForFree;	// pointer to root of PathNode blocks
-			PathNode** heapArrayMem;		// pointer to root of a PathNode pointer array
+			PathNode* pathNodeMem;			// cold per-node data
+			SNodeData* nodeData;			// hot per-node data
+			SOpenListMem openListMem;		// open list engines' memory
+			OpenListType openListType;		// engine used by the next query
 
-			unsigned availMem;				// # PathNodes available in the current block
-			unsigned pathNodeCount;			// the # of PathNodes in use
 			unsigned frame;					// incremented with every solve, used to determine if cached data needs to be refreshed
 			unsigned checksum;				// the checksum of the last successful "Solve".
+			SQueryStats queryStats;			// counters of the last query
 	};
 }
 
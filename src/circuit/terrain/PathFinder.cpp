@@ -6,20 +6,12 @@
  *      Original implementation: https://github.com/spring/KAIK/blob/master/PathFinder.cpp
  */
 
+// NOTE: Engine-independent part of CPathFinder, offline tools (bench/) link it without the AI.
+//       Unit and blocking map glue is in PathFinderGame.cpp.
+
 #include "terrain/PathFinder.h"
 #include "terrain/TerrainData.h"
-#include "terrain/TerrainManager.h"
-#include "terrain/ThreatMap.h"
-#include "unit/CircuitUnit.h"
 #include "util/utils.h"
-#ifdef DEBUG_VIS
-#include "CircuitAI.h"
-#endif
-
-#include "Map.h"
-#ifdef DEBUG_VIS
-#include "Figure.h"
-#endif
 
 namespace circuit {
 
@@ -30,8 +22,8 @@ std::vector<int> CPathFinder::blockArray;
 
 CPathFinder::CPathFinder(CTerrainData* terrainData)
 		: terrainData(terrainData)
-		, airMoveArray(nullptr)
 		, isUpdated(true)
+		, discRadius(-1)
 #ifdef DEBUG_VIS
 		, isVis(false)
 		, toggleFrame(-1)
@@ -47,12 +39,12 @@ CPathFinder::CPathFinder(CTerrainData* terrainData)
 	micropather  = new CMicroPather(this, pathMapXSize, pathMapYSize);
 
 	const std::vector<STerrainMapMobileType>& moveTypes = terrainData->pAreaData.load()->mobileType;
-	moveArrays.reserve(moveTypes.size());
+	moveArrays.resize(moveTypes.size());
 
-	const int totalcells = pathMapXSize * pathMapYSize;
-	for (const STerrainMapMobileType& mt : moveTypes) {
-		bool* moveArray = new bool[totalcells];
-		moveArrays.push_back(moveArray);
+	for (unsigned j = 0; j < moveTypes.size(); ++j) {
+		const STerrainMapMobileType& mt = moveTypes[j];
+		MoveBits& moveArray = moveArrays[j];
+		InitMoveBits(moveArray);
 
 //		for (int i = 0; i < totalcells; ++i) {
 //			// NOTE: Not all passable sectors have area
@@ -62,40 +54,20 @@ CPathFinder::CPathFinder(CTerrainData* terrainData)
 		for (int z = 1; z < pathMapYSize - 1; ++z) {
 			for (int x = 1; x < pathMapXSize - 1; ++x) {
 				// NOTE: Not all passable sectors have area
-				moveArray[z * pathMapXSize + x] = (mt.sector[k].area != nullptr);
+				if (mt.sector[k].area != nullptr) {
+					SetMoveBit(moveArray, x, z);
+				}
 				++k;
 			}
 		}
-
-		// make sure that the edges are no-go
-		for (int i = 0; i < pathMapXSize; ++i) {
-			moveArray[i] = false;
-			int k = pathMapXSize * (pathMapYSize - 1) + i;
-			moveArray[k] = false;
-		}
-		for (int i = 0; i < pathMapYSize; ++i) {
-			int k = i * pathMapXSize;
-			moveArray[k] = false;
-			k = i * pathMapXSize + pathMapXSize - 1;
-			moveArray[k] = false;
-		}
 	}
 
-	airMoveArray = new bool[totalcells];
-	for (int i = 0; i < totalcells; ++i) {
-		airMoveArray[i] = true;
-	}
-	// make sure that the edges are no-go
-	for (int i = 0; i < pathMapXSize; ++i) {
-		airMoveArray[i] = false;
-		int k = pathMapXSize * (pathMapYSize - 1) + i;
-		airMoveArray[k] = false;
-	}
-	for (int i = 0; i < pathMapYSize; ++i) {
-		int k = i * pathMapXSize;
-		airMoveArray[k] = false;
-		k = i * pathMapXSize + pathMapXSize - 1;
-		airMoveArray[k] = false;
+	// edges are no-go
+	InitMoveBits(airMoveArray);
+	for (int z = 1; z < pathMapYSize - 1; ++z) {
+		for (int x = 1; x < pathMapXSize - 1; ++x) {
+			SetMoveBit(airMoveArray, x, z);
+		}
 	}
 
 	blockArray.resize(terrainData->sectorXSize * terrainData->sectorZSize, 0);
@@ -104,82 +76,32 @@ CPathFinder::CPathFinder(CTerrainData* terrainData)
 CPathFinder::~CPathFinder()
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
-	for (bool* ma : moveArrays) {
-		delete[] ma;
-	}
-	delete[] airMoveArray;
 	delete micropather;
 }
 
-void CPathFinder::UpdateAreaUsers(CTerrainManager* terrainManager)
+/*
+ * Clears all bits, edges of the map stay no-go.
+ * Extra word at the end allows to read 3 neighbours without bounds check.
+ */
+void CPathFinder::InitMoveBits(MoveBits& moveBits) const
 {
-	if (isUpdated) {
-		return;
-	}
-	isUpdated = true;
-
-	std::fill(blockArray.begin(), blockArray.end(), 0);
-	const int granularity = squareSize / (SQUARE_SIZE * 2);
-	const SBlockingMap& blockMap = terrainManager->GetBlockingMap();
-	for (int x = 0; x < blockMap.columns; ++x) {
-		for (int z = 0; z < blockMap.rows; ++z) {
-			if (blockMap.IsStruct(x, z, SBlockingMap::StructMask::ALL)) {
-				const int moveX = x / granularity;
-				const int moveY = z / granularity;
-				++blockArray[moveY * terrainData->sectorXSize + moveX];
-			}
-		}
-	}
-
-	const std::vector<STerrainMapMobileType>& moveTypes = terrainData->GetNextAreaData()->mobileType;
-	const int blockThreshold = granularity * granularity / 5;
-	for (unsigned j = 0; j < moveTypes.size(); ++j) {
-		const STerrainMapMobileType& mt = moveTypes[j];
-		bool* moveArray = moveArrays[j];
-
-		int k = 0;
-		for (int z = 1; z < pathMapYSize - 1; ++z) {
-			for (int x = 1; x < pathMapXSize - 1; ++x) {
-				// NOTE: Not all passable sectors have area
-				moveArray[z * pathMapXSize + x] = (mt.sector[k].area != nullptr) && (blockArray[k] < blockThreshold);
-				++k;
-			}
-		}
+	const int totalcells = pathMapXSize * pathMapYSize;
+	moveBits.assign((totalcells + 63) / 64 + 1, 0);
+}
 
-		// make sure that the edges are no-go
-		for (int i = 0; i < pathMapXSize; ++i) {
-			moveArray[i] = false;
-			int k = pathMapXSize * (pathMapYSize - 1) + i;
-			moveArray[k] = false;
-		}
-		for (int i = 0; i < pathMapYSize; ++i) {
-			int k = i * pathMapXSize;
-			moveArray[k] = false;
-			k = i * pathMapXSize + pathMapXSize - 1;
-			moveArray[k] = false;
-		}
-	}
-	micropather->Reset();
+void CPathFinder::SetMoveBit(MoveBits& moveBits, int x, int z) const
+{
+	const int index = z * pathMapXSize + x;
+	moveBits[index >> 6] |= uint64_t(1) << (index & 63);
 }
 
-void CPathFinder::SetMapData(CCircuitUnit* unit, CThreatMap* threatMap, int frame)
+/*
+ * mobileTypeId < 0 is air, costArray is one of CThreatMap arrays (or of the same layout)
+ */
+void CPathFinder::SetMapData(int mobileTypeId, float* costArray)
 {
-	CCircuitDef* cdef = unit->GetCircuitDef();
-	STerrainMapMobileType::Id mobileTypeId = cdef->GetMobileId();
-	bool* moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
-	float* costArray;
-	if ((unit->GetPos(frame).y < .0f) && !cdef->IsSonarStealth()) {
-		costArray = threatMap->GetAmphThreatArray();  // cloak doesn't work under water
-	} else if (unit->GetUnit()->IsCloaked()) {
-		costArray = threatMap->GetCloakThreatArray();
-	} else if (cdef->IsAbleToFly()) {
-		costArray = threatMap->GetAirThreatArray();
-	} else if (cdef->IsAmphibious()) {
-		costArray = threatMap->GetAmphThreatArray();
-	} else {
-		costArray = threatMap->GetSurfThreatArray();
-	}
-	micropather->SetMapData(moveArray, costArray);
+	const MoveBits& moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
+	micropather->SetMapData(moveArray.data(), costArray);
 }
 
 void* CPathFinder::XY2Node(int x, int y)
@@ -236,16 +158,19 @@ float CPathFinder::MakePath(F3Vec& posPath, AIFloat3& startPos, AIFloat3& endPos
 
 	radius /= squareSize;
 
-	if (micropather->FindBestPathToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &path, &pathCost, radius) == CMicroPather::SOLVED) {
+	stats.Begin();
+	const int result = micropather->FindBestPathToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &path, &pathCost, radius);
+	stats.End(CPathStats::Query::MAKE_PATH, micropather->GetQueryStats(), path.size(), result == CMicroPather::SOLVED);
+
+	if (result == CMicroPather::SOLVED) {
 		posPath.reserve(path.size());
 
 		// TODO: Consider performing transformations in place where move_along_path executed.
 		//       Current task implementations recalc path every ~2 seconds,
 		//       therefore only first few positions actually used.
-		Map* map = terrainData->GetMap();
 		for (void* node : path) {
 			float3 mypos = Node2Pos(node);
-			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
+			mypos.y = GetElevation(mypos);
 			posPath.push_back(mypos);
 		}
 	}
@@ -273,16 +198,19 @@ float CPathFinder::MakePath(F3Vec& posPath, AIFloat3& startPos, AIFloat3& endPos
 
 	radius /= squareSize;
 
-	if (micropather->FindBestPathToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &path, &pathCost, radius, threat) == CMicroPather::SOLVED) {
+	stats.Begin();
+	const int result = micropather->FindBestPathToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &path, &pathCost, radius, threat);
+	stats.End(CPathStats::Query::MAKE_PATH, micropather->GetQueryStats(), path.size(), result == CMicroPather::SOLVED);
+
+	if (result == CMicroPather::SOLVED) {
 		posPath.reserve(path.size());
 
 		// TODO: Consider performing transformations in place where move_along_path executed.
 		//       Current task implementations recalc path every ~2 seconds,
 		//       therefore only first few positions actually used.
-		Map* map = terrainData->GetMap();
 		for (void* node : path) {
 			float3 mypos = Node2Pos(node);
-			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
+			mypos.y = GetElevation(mypos);
 			posPath.push_back(mypos);
 		}
 	}
@@ -310,7 +238,9 @@ float CPathFinder::PathCost(const springai::AIFloat3& startPos, springai::AIFloa
 
 	radius /= squareSize;
 
-	micropather->FindBestCostToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &pathCost, radius);
+	stats.Begin();
+	const int result = micropather->FindBestCostToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &pathCost, radius);
+	stats.End(CPathStats::Query::PATH_COST, micropather->GetQueryStats(), 0, result == CMicroPather::SOLVED);
 
 	return pathCost;
 }
@@ -331,138 +261,84 @@ float CPathFinder::PathCostDirect(const springai::AIFloat3& startPos, springai::
 
 	radius /= squareSize;
 
-	micropather->FindDirectCostToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &pathCost, radius);
+	stats.Begin();
+	const int result = micropather->FindDirectCostToPointOnRadius(XY2Node(sx, sy), XY2Node(ex, ey), &pathCost, radius);
+	stats.End(CPathStats::Query::PATH_COST_DIRECT, micropather->GetQueryStats(), 0, result == CMicroPather::SOLVED);
 
 	return pathCost;
 }
 
-float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRange, F3Vec& possibleTargets, bool safe)
+/*
+ * Goal area of every target is a disc of <maxRange> radius, overlapping discs share nodes.
+ * <maxRange> must be >= squareSize, otherwise goal set stays empty.
+ */
+void CPathFinder::MakeGoalSet(CGoalSet& goals, const F3Vec& targets, float maxRange)
 {
-	float pathCost = 0.0f;
-
-	// <maxRange> must always be >= squareSize, otherwise
-	// <radius> will become 0 and the write to offsets[0]
-	// below is undefined
+	if (goals.IsInit(pathMapXSize, pathMapYSize)) {
+		goals.Clear();
+	} else {
+		goals.Init(pathMapXSize, pathMapYSize);
+	}
 	if (maxRange < float(squareSize)) {
-		return pathCost;
+		return;
 	}
 
-	path.clear();
-
-	const unsigned int radius = maxRange / squareSize;
-	unsigned int offsetSize = 0;
-
-	std::vector<std::pair<int, int> > offsets;
-	std::vector<int> xend;
-
-	// make a list with the points that will count as end nodes
-	static std::vector<void*> endNodes;  // NOTE: micro-opt
-//	endNodes.reserve(possibleTargets.size() * radius * 10);
-
-	{
-		const unsigned int DoubleRadius = radius * 2;
-		const unsigned int SquareRadius = radius * radius;
-
-		xend.resize(DoubleRadius + 1);
-		offsets.resize(DoubleRadius * 5);
-
-		for (size_t a = 0; a < DoubleRadius + 1; a++) {
-			const float z = (int) (a - radius);
-			const float floatsqrradius = SquareRadius;
-			xend[a] = int(sqrt(floatsqrradius - z * z));
-		}
-
-		offsets[0].first = 0;
-		offsets[0].second = 0;
-
-		size_t index = 1;
-		size_t index2 = 1;
-
-		for (size_t a = 1; a < radius + 1; a++) {
-			int endPosIdx = xend[a];
-			int startPosIdx = xend[a - 1];
-
-			while (startPosIdx <= endPosIdx) {
-				assert(index < offsets.size());
-				offsets[index].first = startPosIdx;
-				offsets[index].second = a;
-				startPosIdx++;
-				index++;
+	const int radius = maxRange / squareSize;
+	if (discRadius != radius) {
+		discRadius = radius;
+		discOffsets.clear();
+		for (int dy = -radius; dy <= radius; ++dy) {
+			const int xend = int(sqrtf(float(SQUARE(radius) - SQUARE(dy))));
+			for (int dx = -xend; dx <= xend; ++dx) {
+				discOffsets.push_back(std::make_pair(dx, dy));
 			}
-
-			startPosIdx--;
-		}
-
-		index2 = index;
-
-		for (size_t a = 0; a < index2 - 2; a++) {
-			assert(index < offsets.size());
-			assert(a < offsets.size());
-			offsets[index].first = offsets[a].first;
-			offsets[index].second = DoubleRadius - (offsets[a].second);
-			index++;
 		}
-
-		index2 = index;
-
-		for (size_t a = 0; a < index2; a++) {
-			assert(index < offsets.size());
-			assert(a < offsets.size());
-			offsets[index].first = -(offsets[a].first);
-			offsets[index].second = offsets[a].second;
-			index++;
-		}
-
-		for (size_t a = 0; a < index; a++) {
-			assert(a < offsets.size());
-//			offsets[a].first = offsets[a].first; // ??
-			offsets[a].second = offsets[a].second - radius;
-		}
-
-		offsetSize = index;
 	}
 
-	static std::vector<void*> nodeTargets;  // NOTE: micro-opt
-//	nodeTargets.reserve(possibleTargets.size());
-	for (unsigned int i = 0; i < possibleTargets.size(); i++) {
-		AIFloat3& f = possibleTargets[i];
-
+	for (const AIFloat3& target : targets) {
+		AIFloat3 f = target;
 		CTerrainData::CorrectPosition(f);
-		void* node = Pos2Node(f);
-		NSMicroPather::PathNode* pn = micropather->GetNode((size_t)node);
-		if (pn->isTarget) {
-			continue;
-		}
-		pn->isTarget = 1;
-		nodeTargets.push_back(node);
-
 		int x, y;
-		Node2XY(node, &x, &y);
-
-		for (unsigned int j = 0; j < offsetSize; j++) {
-			const int sx = x + offsets[j].first;
-			const int sy = y + offsets[j].second;
-
-			if (sx >= 0 && sx < pathMapXSize && sy >= 0 && sy < pathMapYSize) {
-				endNodes.push_back(XY2Node(sx, sy));
+		Pos2XY(f, &x, &y);
+		// no node can be at the edge!
+		x = utils::clamp(x, 1, pathMapXSize - 2);
+		y = utils::clamp(y, 1, pathMapYSize - 2);
+		goals.AddTarget(y * pathMapXSize + x);
+
+		for (const std::pair<int, int>& offset : discOffsets) {
+			int sx = x + offset.first;
+			int sy = y + offset.second;
+			if ((sx < 0) || (sx >= pathMapXSize) || (sy < 0) || (sy >= pathMapYSize)) {
+				continue;
 			}
+			sx = utils::clamp(sx, 1, pathMapXSize - 2);
+			sy = utils::clamp(sy, 1, pathMapYSize - 2);
+			goals.AddGoal(sy * pathMapXSize + sx);
 		}
 	}
-	for (void* node : nodeTargets) {
-		micropather->GetNode((size_t)node)->isTarget = 0;
+}
+
+float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, const CGoalSet& goals, bool safe)
+{
+	float pathCost = 0.0f;
+	if (goals.IsEmpty()) {
+		return pathCost;
 	}
 
+	path.clear();
+
 	CTerrainData::CorrectPosition(startPos);
 
-	int result = safe ? micropather->FindBestPathToAnyGivenPointSafe(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost) :
-						micropather->FindBestPathToAnyGivenPoint(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost);
+	stats.Begin();
+	int result = safe ? micropather->FindBestPathToAnyGivenPointSafe(Pos2Node(startPos), goals, &path, &pathCost) :
+						micropather->FindBestPathToAnyGivenPoint(Pos2Node(startPos), goals, &path, &pathCost);
+	stats.End(CPathStats::Query::BEST_PATH, micropather->GetQueryStats(), path.size(), result == CMicroPather::SOLVED);
 	if (result == CMicroPather::SOLVED) {
 		posPath.reserve(path.size());
 
-		Map* map = terrainData->GetMap();
 		for (void* node : path) {
 			float3 mypos = Node2Pos(node);
-			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
+			mypos.y = GetElevation(mypos);
 			posPath.push_back(mypos);
 		}
 	}
@@ -471,11 +347,15 @@ float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRan
 	UpdateVis(posPath);
 #endif
 
-	endNodes.clear();
-	nodeTargets.clear();
 	return pathCost;
 }
 
+float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRange, const F3Vec& possibleTargets, bool safe)
+{
+	MakeGoalSet(goalSet, possibleTargets, maxRange);
+	return FindBestPath(posPath, startPos, goalSet, safe);
+}
+
 float CPathFinder::FindBestPathToRadius(F3Vec& posPath, AIFloat3& startPos, float radiusAroundTarget, const AIFloat3& target)
 {
 	F3Vec posTargets;
@@ -483,74 +363,4 @@ float CPathFinder::FindBestPathToRadius(F3Vec& posPath, AIFloat3& startPos, floa
 	return FindBestPath(posPath, startPos, radiusAroundTarget, posTargets);
 }
 
-#ifdef DEBUG_VIS
-void CPathFinder::SetMapData(CThreatMap* threatMap)
-{
-	if ((dbgDef == nullptr) || (dbgType < 0) || (dbgType > 3)) {
-		return;
-	}
-	STerrainMapMobileType::Id mobileTypeId = dbgDef->GetMobileId();
-	bool* moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
-	float* costArray[] = {threatMap->GetAirThreatArray(), threatMap->GetSurfThreatArray(), threatMap->GetAmphThreatArray(), threatMap->GetCloakThreatArray()};
-	micropather->SetMapData(moveArray, costArray[dbgType]);
-}
-
-void CPathFinder::UpdateVis(const F3Vec& path)
-{
-	if (!isVis) {
-		return;
-	}
-
-	Figure* fig = circuit->GetDrawer()->GetFigure();
-	int figId = fig->DrawLine(ZeroVector, ZeroVector, 16.0f, true, FRAMES_PER_SEC * 5, 0);
-	for (unsigned i = 1; i < path.size(); ++i) {
-		fig->DrawLine(path[i - 1], path[i], 16.0f, true, FRAMES_PER_SEC * 20, figId);
-	}
-	fig->SetColor(figId, AIColor((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX), 255);
-	delete fig;
-}
-
-void CPathFinder::ToggleVis(CCircuitAI* circuit)
-{
-	if (toggleFrame >= circuit->GetLastFrame()) {
-		return;
-	}
-	toggleFrame = circuit->GetLastFrame();
-
-	isVis = !isVis;
-	this->circuit = circuit;
-
-//	Map* map = circuit->GetMap();
-//	auto node2pos = [this, map](void* node) {
-//		const size_t index = (size_t)node;
-//		AIFloat3 pos;
-//		pos.z = (index / pathMapXSize - 1) * squareSize;
-//		pos.x = (index - ((index / pathMapXSize) * pathMapXSize) - 1) * squareSize;
-//		pos.y = map->GetElevationAt(pos.x, pos.z) + SQUARE_SIZE;
-//		return pos;
-//	};
-//	Drawer* draw = circuit->GetDrawer();
-//	if (isVis) {
-//		Figure* fig = circuit->GetDrawer()->GetFigure();
-//		int figId = fig->DrawLine(ZeroVector, ZeroVector, 16.0f, false, FRAMES_PER_SEC * 5, 0);
-//		for (int x = 1; x < pathMapXSize - 1; ++x) {
-//			for (int z = 2; z < pathMapYSize - 1; ++z) {
-//				AIFloat3 p0 = node2pos(XY2Node(x, z - 1));
-//				AIFloat3 p1 = node2pos(XY2Node(x, z));
-//				fig->DrawLine(p0, p1, 16.0f, false, FRAMES_PER_SEC * 200, figId);
-//			}
-//		}
-//		for (int z = 1; z < pathMapYSize - 1; ++z) {
-//			for (int x = 2; x < pathMapXSize - 1; ++x) {
-//				AIFloat3 p0 = node2pos(XY2Node(x - 1, z));
-//				AIFloat3 p1 = node2pos(XY2Node(x, z));
-//				fig->DrawLine(p0, p1, 16.0f, false, FRAMES_PER_SEC * 200, figId);
-//			}
-//		}
-//		fig->SetColor(figId, AIColor(1.0, 0., 0.), 255);
-//		delete fig;
-//	}
-}
-#endif
-
 } // namespace circuit
@@ -10,6 +10,7 @@
 #define SRC_CIRCUIT_TERRAIN_PATHFINDER_H_
 
 #include "terrain/MicroPather.h"
+#include "terrain/PathStats.h"
 #include "util/Defines.h"
 
 namespace circuit {
@@ -25,6 +26,8 @@ class CCircuitDef;
 
 class CPathFinder: public NSMicroPather::Graph {
 public:
+	using CGoalSet = NSMicroPather::CGoalSet;
+
 	CPathFinder(CTerrainData* terrainData);
 	virtual ~CPathFinder();
 
@@ -39,23 +42,35 @@ public:
 	void Pos2XY(springai::AIFloat3 pos, int* x, int* y);
 
 	void SetMapData(CCircuitUnit* unit, CThreatMap* threatMap, int frame);
+	void SetMapData(int mobileTypeId, float* costArray);
+	void SetOpenListType(NSMicroPather::OpenListType type) { micropather->SetOpenListType(type); }
 
 	unsigned Checksum() const { return micropather->Checksum(); }
 	float MakePath(F3Vec& posPath, springai::AIFloat3& startPos, springai::AIFloat3& endPos, int radius);
 	float MakePath(F3Vec& posPath, springai::AIFloat3& startPos, springai::AIFloat3& endPos, int radius, float threat);
 	float PathCost(const springai::AIFloat3& startPos, springai::AIFloat3& endPos, int radius);
 	float PathCostDirect(const springai::AIFloat3& startPos, springai::AIFloat3& endPos, int radius);
-	float FindBestPath(F3Vec& posPath, springai::AIFloat3& startPos, float myMaxRange, F3Vec& possibleTargets, bool safe = true);
+	// Goal set can be built once and shared by searches of different units
+	void MakeGoalSet(CGoalSet& goals, const F3Vec& targets, float maxRange);
+	float FindBestPath(F3Vec& posPath, springai::AIFloat3& startPos, const CGoalSet& goals, bool safe = true);
+	float FindBestPath(F3Vec& posPath, springai::AIFloat3& startPos, float myMaxRange, const F3Vec& possibleTargets, bool safe = true);
 	float FindBestPathToRadius(F3Vec& posPath, springai::AIFloat3& startPos, float radiusAroundTarget, const springai::AIFloat3& target);
 
 	int GetSquareSize() const { return squareSize; }
+	CPathStats& GetStats() { return stats; }
 
 private:
+	// Game build reads Map, CircuitBench defines its own over the stand-in height map
+	float GetElevation(const springai::AIFloat3& pos) const;
+
 	CTerrainData* terrainData;
 
 	NSMicroPather::CMicroPather* micropather;
-	bool* airMoveArray;
-	std::vector<bool*> moveArrays;
+	using MoveBits = std::vector<uint64_t>;  // 1 bit per path node
+	MoveBits airMoveArray;
+	std::vector<MoveBits> moveArrays;
+	void InitMoveBits(MoveBits& moveBits) const;
+	void SetMoveBit(MoveBits& moveBits, int x, int z) const;
 	static std::vector<int> blockArray;
 	bool isUpdated;
 
@@ -64,6 +79,11 @@ private:
 	int pathMapYSize;
 
 	std::vector<void*> path;
+	CGoalSet goalSet;  // scratch for positional FindBestPath
+	int discRadius;
+	std::vector<std::pair<int, int>> discOffsets;  // goal disc of discRadius
+
+	CPathStats stats;
 
 #ifdef DEBUG_VIS
 private:
@@ -0,0 +1,177 @@
+/*
+ * PathFinderGame.cpp
+ *
+ *  Created on: Aug 25, 2015
+ *      Author: rlcevg
+ */
+
+#include "terrain/PathFinder.h"
+#include "terrain/TerrainData.h"
+#include "terrain/TerrainManager.h"
+#include "terrain/ThreatMap.h"
+#include "task/builder/BuilderTask.h"
+#include "task/fighter/FighterTask.h"
+#include "unit/CircuitUnit.h"
+#include "util/utils.h"
+#ifdef DEBUG_VIS
+#include "CircuitAI.h"
+#endif
+
+#include "Map.h"
+#ifdef DEBUG_VIS
+#include "Figure.h"
+#endif
+
+namespace circuit {
+
+using namespace springai;
+
+void CPathFinder::UpdateAreaUsers(CTerrainManager* terrainManager)
+{
+	if (isUpdated) {
+		return;
+	}
+	isUpdated = true;
+
+	std::fill(blockArray.begin(), blockArray.end(), 0);
+	const int granularity = squareSize / (SQUARE_SIZE * 2);
+	const SBlockingMap& blockMap = terrainManager->GetBlockingMap();
+	for (int x = 0; x < blockMap.columns; ++x) {
+		for (int z = 0; z < blockMap.rows; ++z) {
+			if (blockMap.IsStruct(x, z, SBlockingMap::StructMask::ALL)) {
+				const int moveX = x / granularity;
+				const int moveY = z / granularity;
+				++blockArray[moveY * terrainData->sectorXSize + moveX];
+			}
+		}
+	}
+
+	const std::vector<STerrainMapMobileType>& moveTypes = terrainData->GetNextAreaData()->mobileType;
+	const int blockThreshold = granularity * granularity / 5;
+	for (unsigned j = 0; j < moveTypes.size(); ++j) {
+		const STerrainMapMobileType& mt = moveTypes[j];
+		MoveBits& moveArray = moveArrays[j];
+		InitMoveBits(moveArray);
+
+		int k = 0;
+		for (int z = 1; z < pathMapYSize - 1; ++z) {
+			for (int x = 1; x < pathMapXSize - 1; ++x) {
+				// NOTE: Not all passable sectors have area
+				if ((mt.sector[k].area != nullptr) && (blockArray[k] < blockThreshold)) {
+					SetMoveBit(moveArray, x, z);
+				}
+				++k;
+			}
+		}
+	}
+	micropather->Reset();
+}
+
+float CPathFinder::GetElevation(const AIFloat3& pos) const
+{
+	return terrainData->GetMap()->GetElevationAt(pos.x, pos.z);
+}
+
+void CPathFinder::SetMapData(CCircuitUnit* unit, CThreatMap* threatMap, int frame)
+{
+	CCircuitDef* cdef = unit->GetCircuitDef();
+	float* costArray;
+	if ((unit->GetPos(frame).y < .0f) && !cdef->IsSonarStealth()) {
+		costArray = threatMap->GetAmphThreatArray();  // cloak doesn't work under water
+	} else if (unit->GetUnit()->IsCloaked()) {
+		costArray = threatMap->GetCloakThreatArray();
+	} else if (cdef->IsAbleToFly()) {
+		costArray = threatMap->GetAirThreatArray();
+	} else if (cdef->IsAmphibious()) {
+		costArray = threatMap->GetAmphThreatArray();
+	} else {
+		costArray = threatMap->GetSurfThreatArray();
+	}
+	SetMapData(cdef->GetMobileId(), costArray);
+
+	IUnitTask* task = unit->GetTask();
+	int taskType = -1;
+	int subtype = -1;
+	if (task != nullptr) {
+		taskType = static_cast<int>(task->GetType());
+		if (task->GetType() == IUnitTask::Type::FIGHTER) {
+			subtype = static_cast<int>(static_cast<IFighterTask*>(task)->GetFightType());
+		} else if (task->GetType() == IUnitTask::Type::BUILDER) {
+			subtype = static_cast<int>(static_cast<IBuilderTask*>(task)->GetBuildType());
+		}
+	}
+	stats.SetCaller(taskType, subtype, cdef->GetId());
+}
+
+#ifdef DEBUG_VIS
+void CPathFinder::SetMapData(CThreatMap* threatMap)
+{
+	if ((dbgDef == nullptr) || (dbgType < 0) || (dbgType > 3)) {
+		return;
+	}
+	STerrainMapMobileType::Id mobileTypeId = dbgDef->GetMobileId();
+	const MoveBits& moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
+	float* costArray[] = {threatMap->GetAirThreatArray(), threatMap->GetSurfThreatArray(), threatMap->GetAmphThreatArray(), threatMap->GetCloakThreatArray()};
+	micropather->SetMapData(moveArray.data(), costArray[dbgType]);
+	stats.SetCaller(-1, -1, dbgDef->GetId());
+}
+
+void CPathFinder::UpdateVis(const F3Vec& path)
+{
+	if (!isVis) {
+		return;
+	}
+
+	Figure* fig = circuit->GetDrawer()->GetFigure();
+	int figId = fig->DrawLine(ZeroVector, ZeroVector, 16.0f, true, FRAMES_PER_SEC * 5, 0);
+	for (unsigned i = 1; i < path.size(); ++i) {
+		fig->DrawLine(path[i - 1], path[i], 16.0f, true, FRAMES_PER_SEC * 20, figId);
+	}
+	fig->SetColor(figId, AIColor((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX), 255);
+	delete fig;
+}
+
+void CPathFinder::ToggleVis(CCircuitAI* circuit)
+{
+	if (toggleFrame >= circuit->GetLastFrame()) {
+		return;
+	}
+	toggleFrame = circuit->GetLastFrame();
+
+	isVis = !isVis;
+	this->circuit = circuit;
+
+//	Map* map = circuit->GetMap();
+//	auto node2pos = [this, map](void* node) {
+//		const size_t index = (size_t)node;
+//		AIFloat3 pos;
+//		pos.z = (index / pathMapXSize - 1) * squareSize;
+//		pos.x = (index - ((index / pathMapXSize) * pathMapXSize) - 1) * squareSize;
+//		pos.y = map->GetElevationAt(pos.x, pos.z) + SQUARE_SIZE;
+//		return pos;
+//	};
+//	Drawer* draw = circuit->GetDrawer();
+//	if (isVis) {
+//		Figure* fig = circuit->GetDrawer()->GetFigure();
+//		int figId = fig->DrawLine(ZeroVector, ZeroVector, 16.0f, false, FRAMES_PER_SEC * 5, 0);
+//		for (int x = 1; x < pathMapXSize - 1; ++x) {
+//			for (int z = 2; z < pathMapYSize - 1; ++z) {
+//				AIFloat3 p0 = node2pos(XY2Node(x, z - 1));
+//				AIFloat3 p1 = node2pos(XY2Node(x, z));
+//				fig->DrawLine(p0, p1, 16.0f, false, FRAMES_PER_SEC * 200, figId);
+//			}
+//		}
+//		for (int z = 1; z < pathMapYSize - 1; ++z) {
+//			for (int x = 2; x < pathMapXSize - 1; ++x) {
+//				AIFloat3 p0 = node2pos(XY2Node(x - 1, z));
+//				AIFloat3 p1 = node2pos(XY2Node(x, z));
+//				fig->DrawLine(p0, p1, 16.0f, false, FRAMES_PER_SEC * 200, figId);
+//			}
+//		}
+//		fig->SetColor(figId, AIColor(1.0, 0., 0.), 255);
+//		delete fig;
+//	}
+}
+#endif
+
+} // namespace circuit
@@ -0,0 +1,96 @@
+/*
+ * PathStats.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+// NOTE: Dump is in PathStatsGame.cpp, offline tools (bench/) link this part without the AI.
+
+#include "terrain/PathStats.h"
+#include "util/utils.h"
+
+#include <algorithm>
+
+namespace circuit {
+
+constexpr int CPathStats::HIST_BINS;
+
+void CPathStats::SHistogram::Add(unsigned value)
+{
+	const int bin = (value == 0) ? 0 : std::min(32 - __builtin_clz(value), HIST_BINS - 1);
+	++bins[bin];
+	sum += value;
+	max = std::max(max, value);
+}
+
+unsigned CPathStats::SHistogram::Percentile(unsigned count, float p) const
+{
+	const unsigned rank = unsigned(count * p);
+	unsigned total = 0;
+	for (int i = 0; i < HIST_BINS - 1; ++i) {
+		total += bins[i];
+		if (total > rank) {
+			return std::min((1u << i) - 1, max);
+		}
+	}
+	return max;
+}
+
+CPathStats::CPathStats()
+		: isEnabled(false)
+		, callerTask(-1)
+		, callerSubtype(-1)
+		, callerDefId(-1)
+{
+}
+
+CPathStats::~CPathStats()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CPathStats::Begin()
+{
+	if (isEnabled) {
+		startTime = clock::now();
+	}
+}
+
+void CPathStats::End(Query query, const NSMicroPather::SQueryStats& stats, unsigned length, bool isSolved)
+{
+	if (!isEnabled) {
+		return;
+	}
+	const unsigned timeUs = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - startTime).count();
+
+	const uint64_t key = uint64_t(query) | (uint64_t(callerTask + 1) << 8) | (uint64_t(callerSubtype + 1) << 16)
+			| (uint64_t(uint32_t(callerDefId)) << 32);
+	auto it = records.find(key);
+	if (it == records.end()) {
+		SRecord record;
+		record.query = query;
+		record.task = callerTask;
+		record.subtype = callerSubtype;
+		record.defId = callerDefId;
+		record.count = record.solved = 0;
+		for (SHistogram& h : record.metrics) {
+			h.bins.fill(0);
+			h.sum = 0;
+			h.max = 0;
+		}
+		it = records.emplace(key, record).first;
+	}
+
+	SRecord& record = it->second;
+	++record.count;
+	if (isSolved) {
+		++record.solved;
+	}
+	record.metrics[static_cast<size_t>(Metric::EXPANDED)].Add(stats.expanded);
+	record.metrics[static_cast<size_t>(Metric::OPEN_PEAK)].Add(stats.openPeak);
+	record.metrics[static_cast<size_t>(Metric::TIME_US)].Add(timeUs);
+	record.metrics[static_cast<size_t>(Metric::LENGTH)].Add(length);
+}
+
+} // namespace circuit
@@ -0,0 +1,77 @@
+/*
+ * PathStats.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_PATHSTATS_H_
+#define SRC_CIRCUIT_TERRAIN_PATHSTATS_H_
+
+#include "terrain/MicroPather.h"
+
+#include <array>
+#include <chrono>
+#include <unordered_map>
+#include <cstdint>
+
+namespace circuit {
+
+class CCircuitAI;
+
+/*
+ * Per-query pathfinder accounting, attributed to caller tag (task type and subtype, unit def).
+ * Every metric is aggregated into fixed log2 histogram, no per-query storage.
+ */
+class CPathStats {
+public:
+	enum class Query: char {MAKE_PATH = 0, PATH_COST, PATH_COST_DIRECT, BEST_PATH, _SIZE_};
+	enum class Metric: char {EXPANDED = 0, OPEN_PEAK, TIME_US, LENGTH, _SIZE_};
+	static constexpr int HIST_BINS = 24;  // bin 0: value 0, bin i: [2^(i-1), 2^i), last bin is open
+
+	struct SHistogram {
+		std::array<unsigned, HIST_BINS> bins;
+		uint64_t sum;
+		unsigned max;
+		void Add(unsigned value);
+		unsigned Percentile(unsigned count, float p) const;  // upper edge of the bin
+	};
+	struct SRecord {
+		Query query;
+		int task;  // IUnitTask::Type, -1 if unknown
+		int subtype;  // IFighterTask::FightType or IBuilderTask::BuildType, -1 if none
+		int defId;  // CCircuitDef::Id, -1 if unknown
+		unsigned count;
+		unsigned solved;
+		std::array<SHistogram, static_cast<size_t>(Metric::_SIZE_)> metrics;
+	};
+
+	CPathStats();
+	virtual ~CPathStats();
+
+	void SetEnabled(bool value) { isEnabled = value; }
+	bool IsEnabled() const { return isEnabled; }
+
+	// Caller stays until next call, CPathFinder::SetMapData sets it from unit
+	void SetCaller(int task, int subtype, int defId) { callerTask = task; callerSubtype = subtype; callerDefId = defId; }
+	void Begin();
+	void End(Query query, const NSMicroPather::SQueryStats& stats, unsigned length, bool isSolved);
+
+	// Records ordered by total time, worst callers first
+	void Dump(CCircuitAI* circuit) const;
+	void Clear() { records.clear(); }
+
+private:
+	using clock = std::chrono::steady_clock;
+
+	bool isEnabled;
+	int callerTask;
+	int callerSubtype;
+	int callerDefId;
+	clock::time_point startTime;
+	std::unordered_map<uint64_t, SRecord> records;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_PATHSTATS_H_
@@ -0,0 +1,76 @@
+/*
+ * PathStatsGame.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "terrain/PathStats.h"
+#include "task/builder/BuilderTask.h"
+#include "task/fighter/FighterTask.h"
+#include "unit/CircuitDef.h"
+#include "CircuitAI.h"
+
+#include "UnitDef.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace circuit {
+
+using namespace springai;
+
+void CPathStats::Dump(CCircuitAI* circuit) const
+{
+	if (records.empty()) {
+		return;
+	}
+	static const char* queryNames[] = {"make_path", "path_cost", "path_cost_direct", "best_path"};
+	static const char* taskNames[] = {"nil", "player", "idle", "wait", "retreat", "builder", "factory", "fighter"};
+	constexpr int taskCount = static_cast<int>(IUnitTask::Type::_SIZE_);
+	static_assert(sizeof(taskNames) / sizeof(taskNames[0]) == size_t(taskCount), "taskNames must match IUnitTask::Type");
+	static const char* fightNames[] = {"rally", "guard", "defend", "scout", "raid", "attack", "bomb", "melee", "arty",
+			"aa", "ah", "support", "super"};
+	constexpr int fightCount = static_cast<int>(IFighterTask::FightType::_SIZE_);
+	static_assert(sizeof(fightNames) / sizeof(fightNames[0]) == size_t(fightCount), "fightNames must match IFighterTask::FightType");
+	static const char* buildNames[] = {"factory", "nano", "store", "pylon", "energy", "defence", "bunker", "big_gun",
+			"radar", "sonar", "mex", "repair", "reclaim", "terraform", "-", "recruit", "patrol", "guard"};
+	constexpr int buildCount = static_cast<int>(IBuilderTask::BuildType::GUARD) + 1;
+	static_assert(sizeof(buildNames) / sizeof(buildNames[0]) == size_t(buildCount), "buildNames must match IBuilderTask::BuildType");
+	static const char* metricNames[] = {"expanded", "open_peak", "time_us", "length"};
+	static_assert(sizeof(queryNames) / sizeof(queryNames[0]) == static_cast<size_t>(Query::_SIZE_), "queryNames must match Query");
+	static_assert(sizeof(metricNames) / sizeof(metricNames[0]) == static_cast<size_t>(Metric::_SIZE_), "metricNames must match Metric");
+
+	std::vector<const SRecord*> sorted;
+	sorted.reserve(records.size());
+	for (auto& kv : records) {
+		sorted.push_back(&kv.second);
+	}
+	const size_t TIME = static_cast<size_t>(Metric::TIME_US);
+	std::sort(sorted.begin(), sorted.end(), [TIME](const SRecord* a, const SRecord* b) {
+		return a->metrics[TIME].sum > b->metrics[TIME].sum;
+	});
+
+	circuit->LOG("<PathStats> %i: %u callers", circuit->GetSkirmishAIId(), unsigned(sorted.size()));
+	for (const SRecord* r : sorted) {
+		const char* taskName = ((r->task >= 0) && (r->task < taskCount)) ? taskNames[r->task] : "unknown";
+		const char* subtypeName = "-";
+		if ((r->task == static_cast<int>(IUnitTask::Type::FIGHTER)) && (r->subtype >= 0) && (r->subtype < fightCount)) {
+			subtypeName = fightNames[r->subtype];
+		} else if ((r->task == static_cast<int>(IUnitTask::Type::BUILDER)) && (r->subtype >= 0) && (r->subtype < buildCount)) {
+			subtypeName = buildNames[r->subtype];
+		}
+		CCircuitDef* cdef = (r->defId >= 0) ? circuit->GetCircuitDef(r->defId) : nullptr;
+		const std::string defName = (cdef != nullptr) ? cdef->GetUnitDef()->GetName() : "unknown";
+		circuit->LOG("%s | %s | %s | %s | count: %u | solved: %u", queryNames[static_cast<int>(r->query)],
+				taskName, subtypeName, defName.c_str(), r->count, r->solved);
+		for (size_t i = 0; i < r->metrics.size(); ++i) {
+			const SHistogram& h = r->metrics[i];
+			circuit->LOG("\t%s: sum %llu | avg %.1f | p50 %u | p95 %u | max %u", metricNames[i],
+					(unsigned long long)h.sum, float(h.sum) / r->count,
+					h.Percentile(r->count, 0.5f), h.Percentile(r->count, 0.95f), h.max);
+		}
+	}
+}
+
+} // namespace circuit
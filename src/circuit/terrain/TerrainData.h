@@ -60,6 +60,8 @@ struct STerrainMapAreaSector {
 	std::map<STerrainMapImmobileType*, STerrainMapSector*> sectorAlternativeI;  // uninitialized
 };
 
+#define SECTOR_UNKNOWN	-2
+
 struct STerrainMapArea {
 	STerrainMapArea(STerrainMapMobileType* TMMobileType) :
 		areaUsable(false),
@@ -70,9 +72,12 @@ struct STerrainMapArea {
 	bool areaUsable;  // Should units of this type be used in this area
 	STerrainMapMobileType* mobileType;
 	std::map<int, STerrainMapAreaSector*> sector;         // key = sector index, a list of all sectors belonging to it
-	std::map<int, STerrainMapAreaSector*> sectorClosest;  // key = sector indexes not in "sector", indicates the sector belonging to this map-area with the closest distance
+	// index = sector index, value = index of this map-area's sector with the closest distance, -1 if none, SECTOR_UNKNOWN if not determined
 	// NOTE: use TerrainData::GetClosestSector: these values are not initialized but are instead loaded as they become needed
+	std::vector<int> sectorClosest;
 	float percentOfMap;  // 0-100
+
+	bool HasSector(int iS) const;
 };
 
 #define MAP_AREA_LIST_SIZE	50
@@ -106,6 +111,10 @@ struct STerrainMapMobileType {
 	int udCount;
 };
 
+inline bool STerrainMapArea::HasSector(int iS) const {
+	return mobileType->sector[iS].area == this;
+}
+
 struct STerrainMapSector {
 	STerrainMapSector() :
 		isWater(false),
@@ -139,12 +148,21 @@ struct STerrainMapImmobileType {
 
 	bool typeUsable;  // Should units of this type be used on this map
 	std::map<int, STerrainMapSector*> sector;         // a list of sectors useable by these units
-	std::map<int, STerrainMapSector*> sectorClosest;  // key = sector indexes not in "sector", indicates the closest sector in "sector"
+	// index = sector index, value = index of the closest sector in "sector" (own index for members), -1 if none, SECTOR_UNKNOWN if not determined
+	std::vector<int> sectorClosest;
 	float minElevation;
 	float maxElevation;
 	bool canHover;
 	bool canFloat;
 	int udCount;
+
+	bool HasSector(int iS) const { return sectorClosest[iS] == iS; }
+	void ResetClosest(int sectorCount) {
+		sectorClosest.assign(sectorCount, SECTOR_UNKNOWN);
+		for (auto& kv : sector) {
+			sectorClosest[kv.first] = kv.first;
+		}
+	}
 };
 
 struct SAreaData {
@@ -169,6 +187,11 @@ public:
 	CTerrainData();
 	virtual ~CTerrainData();
 	void Init(CCircuitAI* circuit);
+	/*
+	 * Engine-free part of Init: sectors and areas of already detected mobile/immobile types.
+	 * heights: mapWidth x mapHeight, slopes: (mapWidth / 2) x (mapHeight / 2)
+	 */
+	void InitAreas(int mapWidth, int mapHeight, std::vector<float>&& heights, const std::vector<float>& slopes);
 
 	static springai::Map* GetMap() { return map; }
 	static void CorrectPosition(springai::AIFloat3& position);
@@ -191,8 +214,8 @@ public:
 
 	SAreaData areaData0, areaData1;  // Double-buffer for threading
 	std::atomic<SAreaData*> pAreaData;
-	std::map<int, STerrainMapMobileType::Id> udMobileType;    // key = ud->id, Used to find a TerrainMapMobileType for a unit
-	std::map<int, STerrainMapImmobileType::Id> udImmobileType;  // key = ud->id, Used to find a TerrainMapImmobileType for a unit
+	std::vector<STerrainMapMobileType::Id> udMobileType;    // index = ud->id, Used to find a TerrainMapMobileType for a unit, -1 if none
+	std::vector<STerrainMapImmobileType::Id> udImmobileType;  // index = ud->id, Used to find a TerrainMapImmobileType for a unit, -1 if none
 
 	bool waterIsHarmful;  // Units are damaged by it (Lava/Acid map)
 	bool waterIsAVoid;    // (Space map)
@@ -210,13 +233,17 @@ private:
 // ---- Threaded areas updater ---- BEGIN
 private:
 	void CheckHeightMap();
-	void UpdateAreas();
 	void ScheduleUsersUpdate();
 public:
+	// Maps for the next UpdateAreas, the same layout as InitAreas takes
+	void SetNextMaps(std::vector<float>&& heights, std::vector<float>&& slopes);
+	void UpdateAreas();
 	void DidUpdateAreaUsers();
 	SAreaData* GetNextAreaData() {
 		return (pAreaData.load() == &areaData0) ? &areaData1 : &areaData0;
 	}
+	// Height map that corresponds to pAreaData
+	const std::vector<float>& GetHeightMap() const { return *pHeightMap.load(); }
 
 private:
 	static springai::Map* map;
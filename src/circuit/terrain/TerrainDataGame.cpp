@@ -0,0 +1,488 @@
+/*
+ * TerrainDataGame.cpp
+ *
+ *  Created on: Dec 15, 2014
+ *      Author: rlcevg
+ */
+
+// NOTE: Game side of CTerrainData: unit-def and map queries, logging and scheduling of the areas updater.
+
+#include "terrain/TerrainData.h"
+#include "terrain/TerrainManager.h"
+#include "terrain/PathFinder.h"
+#include "CircuitAI.h"
+#include "util/GameAttribute.h"
+#include "util/Scheduler.h"
+#include "util/utils.h"
+#ifdef DEBUG_VIS
+#include "util/DebugDrawer.h"
+#endif
+
+#include "Sim/MoveTypes/MoveDefHandler.h"
+#include "OOAICallback.h"
+#include "Log.h"
+#include "Map.h"
+#include "MoveData.h"
+//#include "File.h"
+
+#include <functional>
+#include <sstream>
+
+namespace circuit {
+
+using namespace springai;
+
+// FIXME: Make Engine consts available to AI. @see rts/Sim/MoveTypes/MoveDefHandler.cpp
+#define MAX_ALLOWED_WATER_DAMAGE_GMM	1e3f
+#define MAX_ALLOWED_WATER_DAMAGE_HMM	1e4f
+
+void CTerrainData::Init(CCircuitAI* circuit)
+{
+	map = circuit->GetMap();
+	scheduler = circuit->GetScheduler();
+	gameAttribute = circuit->GetGameAttribute();
+	circuit->LOG("Loading the Terrain-Map ...");
+
+	/*
+	 *  Reading the WaterDamage
+	 */
+	waterIsHarmful = false;
+	waterIsAVoid = false;
+
+	float waterDamage = map->GetWaterDamage();  // scaled by (UNIT_SLOWUPDATE_RATE / GAME_SPEED)
+	std::string waterText = "  Water Damage: " + utils::float_to_string(waterDamage/*, "%-.*G"*/);
+	// @see rts/Sim/MoveTypes/MoveDefHandler.cpp
+	if (waterDamage > 0) {  // >= MAX_ALLOWED_WATER_DAMAGE_GMM
+		waterIsHarmful = true;
+		waterText += " (This map's water is harmful to land units";
+//		if (waterDamage >= MAX_ALLOWED_WATER_DAMAGE_HMM) {  // TODO: Mark water blocks as threat?
+			waterIsAVoid = true;
+			waterText += " as well as hovercraft";
+//		}
+		waterText += ")";
+	}
+	circuit->LOG(waterText.c_str());
+
+//	Map* map = circuit->GetMap();
+//	std::string mapArchiveFileName = "maps/";
+//	mapArchiveFileName += utils::MakeFileSystemCompatible(map->GetName());
+//	mapArchiveFileName += ".smd";
+//
+//	File* file = circuit->GetCallback()->GetFile();
+//	int mapArchiveFileSize = file->GetSize(mapArchiveFileName.c_str());
+//	if (mapArchiveFileSize > 0) {
+//		circuit->LOG("Searching the Map-Archive File: '%s'  File Size: %i", mapArchiveFileName.c_str(), mapArchiveFileSize);
+//		char* archiveFile = new char[mapArchiveFileSize];
+//		file->GetContent(mapArchiveFileName.c_str(), archiveFile, mapArchiveFileSize);
+//		int waterDamage = GetFileValue(mapArchiveFileSize, archiveFile, "WaterDamage");
+//		waterIsAVoid = GetFileValue(mapArchiveFileSize, archiveFile, "VoidWater") > 0;
+//		circuit->LOG("  Void Water: %s", waterIsAVoid ? "true  (This map has no water)" : "false");
+//
+//		std::string waterText = "  Water Damage: " + utils::int_to_string(waterDamage);
+//		if (waterDamage > 0) {
+//			waterIsHarmful = true;
+//			waterText += " (This map's water is harmful to land units";
+//			if (waterDamage > 10000) {
+//				waterIsAVoid = true; // UNTESTED
+//				waterText += " as well as hovercraft";
+//			}
+//			waterText += ")";
+//		}
+//		circuit->LOG(waterText.c_str());
+//		delete [] archiveFile;
+//	} else {
+//		circuit->LOG("Could not find Map-Archive file for reading additional map info: %s", mapArchiveFileName.c_str());
+//	}
+//	delete file;
+
+	std::vector<STerrainMapMobileType>& mobileType = pAreaData.load()->mobileType;
+	std::vector<STerrainMapImmobileType>& immobileType = pAreaData.load()->immobileType;
+
+	/*
+	 *  MoveType Detection and TerrainMapMobileType Initialization
+	 */
+	auto defs = std::move(circuit->GetCallback()->GetUnitDefs());
+	int maxDefId = 0;
+	for (auto def : defs) {
+		maxDefId = std::max(maxDefId, def->GetUnitDefId());
+	}
+	udMobileType.assign(maxDefId + 1, -1);
+	udImmobileType.assign(maxDefId + 1, -1);
+	for (auto def : defs) {
+		if (def->IsAbleToFly()) {
+
+			udMobileType[def->GetUnitDefId()] = -1;
+
+		} else if (def->GetSpeed() > .0f) {
+
+			std::shared_ptr<MoveData> moveData(def->GetMoveData());
+			float maxSlope = moveData->GetMaxSlope();
+			float depth = moveData->GetDepth();
+			float minWaterDepth = (moveData->GetSpeedModClass() == MoveDef::Ship) ? depth : def->GetMinWaterDepth();
+			float maxWaterDepth = def->GetMaxWaterDepth();
+			bool canHover = def->IsAbleToHover();
+			bool canFloat = def->IsFloater();  // TODO: Remove submarines from floaters? @see CCircuitDef::isSubmarine
+			STerrainMapMobileType* MT = nullptr;
+			int mtIdx = 0;
+			for (; (unsigned)mtIdx < mobileType.size(); ++mtIdx) {
+				STerrainMapMobileType& mt = mobileType[mtIdx];
+				if (((mt.maxElevation == -minWaterDepth) && (mt.maxSlope == maxSlope) && (mt.canHover == canHover) && (mt.canFloat == canFloat)) &&
+					((mt.minElevation == -depth) || ((mt.canHover || mt.canFloat) && (mt.minElevation <= 0) && (-maxWaterDepth <= 0))))
+				{
+					MT = &mt;
+					break;
+				}
+			}
+			if (MT == nullptr) {
+				STerrainMapMobileType MT2;
+				mobileType.push_back(MT2);
+				MT = &mobileType.back();
+				mtIdx = mobileType.size() - 1;
+				MT->maxSlope = maxSlope;
+				MT->maxElevation = -minWaterDepth;
+				MT->minElevation = -depth;
+				MT->canHover = canHover;
+				MT->canFloat = canFloat;
+				MT->moveData = moveData;
+			} else {
+				if (MT->moveData->GetCrushStrength() < moveData->GetCrushStrength()) {
+					std::swap(MT->moveData, moveData);  // figured it would be easier on the pathfinder
+				}
+				moveData = nullptr;  // delete moveData;
+			}
+			MT->udCount++;
+			udMobileType[def->GetUnitDefId()] = mtIdx;
+
+		} else {
+
+			float minWaterDepth = def->GetMinWaterDepth();
+			float maxWaterDepth = def->GetMaxWaterDepth();
+			bool canHover = def->IsAbleToHover();
+			bool canFloat = def->IsFloater();
+			STerrainMapImmobileType* IT = nullptr;
+			int itIdx = 0;
+			for (auto& it : immobileType) {
+				if (((it.maxElevation == -minWaterDepth) && (it.canHover == canHover) && (it.canFloat == canFloat)) &&
+					((it.minElevation == -maxWaterDepth) || ((it.canHover || it.canFloat) && (it.minElevation <= 0) && (-maxWaterDepth <= 0))))
+				{
+					IT = &it;
+					break;
+				}
+				++itIdx;
+			}
+			if (IT == nullptr) {
+				STerrainMapImmobileType IT2;
+				immobileType.push_back(IT2);
+				IT = &immobileType.back();
+				itIdx = immobileType.size() - 1;
+				IT->maxElevation = -minWaterDepth;
+				IT->minElevation = -maxWaterDepth;
+				IT->canHover = canHover;
+				IT->canFloat = canFloat;
+			}
+			IT->udCount++;
+			udImmobileType[def->GetUnitDefId()] = itIdx;
+		}
+	}
+	utils::free_clear(defs);
+
+	circuit->LOG("  Determining Usable Terrain for all units ...");
+	const int mapWidth = map->GetWidth();
+	const int mapHeight = map->GetHeight();
+	InitAreas(mapWidth, mapHeight, std::move(map->GetHeightMap()), map->GetSlopeMap());
+
+	const SAreaData& areaData = *pAreaData.load();
+	const float percentLand = areaData.percentLand;
+	const float minElevation = areaData.minElevation;
+
+	circuit->LOG("  Sector-Map Block Size: %i", convertStoP);
+	circuit->LOG("  Sector-Map Size: %li (x%i, z%i)", sectorXSize * sectorZSize, sectorXSize, sectorZSize);
+
+	circuit->LOG("  Map Land Percent: %.2f%%", percentLand);
+	if (percentLand < 85.0f) {
+		circuit->LOG("  Water is a void: %s", waterIsAVoid ? "true" : "false");
+		circuit->LOG("  Water is harmful: %s", waterIsHarmful ? "true" : "false");
+	}
+	circuit->LOG("  Minimum Elevation: %.2f", minElevation);
+
+	for (auto& it : immobileType) {
+		std::string itText = "  Immobile-Type: Min/Max Elevation=(";
+		if (it.canHover) {
+			itText += "hover";
+		} else if (it.canFloat || (it.minElevation < -10000)) {
+			itText += "any";
+		} else {
+			itText += utils::float_to_string(it.minElevation/*, "%-.*G"*/);
+		}
+		itText += " / ";
+		if (it.maxElevation < 10000) {
+			itText += utils::float_to_string(it.maxElevation/*, "%-.*G"*/);
+		} else {
+			itText += "any";
+		}
+		float percentMap = (100.0 * it.sector.size()) / (sectorXSize * sectorZSize);
+		itText += ")  \tIs buildable across " + utils::float_to_string(percentMap/*, "%-.4G"*/) + "%% of the map. (used by %d unit-defs)";
+		circuit->LOG(itText.c_str(), it.udCount);
+	}
+
+	for (const auto& mt : mobileType) {
+		std::ostringstream mtText;
+		mtText.precision(2);
+		mtText << std::fixed;
+
+		mtText << "  Mobile-Type: Min/Max Elevation=(";
+		if (mt.canFloat) {
+			mtText << "any";
+		} else if (mt.canHover) {
+			mtText << "hover";
+		} else {
+			mtText << mt.minElevation;
+		}
+		mtText << " / ";
+		if (mt.maxElevation < 10000) {
+			mtText << mt.maxElevation;
+		} else {
+			mtText << "any";
+		}
+		mtText << ")  \tMax Slope=(" << mt.maxSlope << ")";
+		mtText << ")  \tMove-Data used:'" << mt.moveData->GetName() << "'";
+
+		if (mt.area.size() + 1 >= MAP_AREA_LIST_SIZE) {
+			mtText << "\nWARNING: The MapArea limit has been reached (possible error).";
+		}
+		float percentOfMap = 0.0;
+		for (const auto& area : mt.area) {
+			percentOfMap += area.percentOfMap;
+		}
+		mtText << "  \tHas " << mt.area.size() << " Map-Area(s) occupying " << percentOfMap << "%% of the map. (used by " << mt.udCount << " unit-defs)";
+		circuit->LOG(mtText.str().c_str());
+	}
+
+	scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CTerrainData::CheckHeightMap, this), FRAMES_PER_SEC * 20);
+	scheduler->RunOnRelease(std::make_shared<CGameTask>(&CTerrainData::DelegateAuthority, this, circuit));
+
+#ifdef DEBUG_VIS
+	debugDrawer = circuit->GetDebugDrawer();
+//	std::ostringstream deb;
+//	for (int iS = 0; iS < sectorXSize * sectorZSize; iS++) {
+//		if (iS % sectorXSize == 0) deb << "\n";
+//		if (sector[iS].maxElevation < 0.0) deb << "~";
+//		else if (sector[iS].maxSlope > 0.5) deb << "^";
+//		else if (sector[iS].maxSlope > 0.25) deb << "#";
+//		else deb << "*";
+//	}
+//	for (auto& mt : mobileType) {
+//		deb << "\n\n " << mt.moveData->GetName() << " h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << mt.area.size();
+//		for (int iS = 0; iS < sectorXSize * sectorZSize; iS++) {
+//			if (iS % sectorXSize == 0) deb << "\n";
+//			if (mt.sector[iS].area != nullptr) deb << "*";
+//			else if (sector[iS].maxElevation < 0.0) deb << "~";
+//			else if (sector[iS].maxSlope > 0.5) deb << "^";
+//			else deb << "x";
+//		}
+//	}
+//	int itId = 0;
+//	for (auto& mt : immobileType) {
+//		deb << "\n\n " << itId++ << " h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << mt.sector.size();
+//		for (int iS = 0; iS < sectorXSize * sectorZSize; iS++) {
+//			if (iS % sectorXSize == 0) deb << "\n";
+//			if (mt.sector.find(iS) != mt.sector.end()) deb << "*";
+//			else if (sector[iS].maxElevation < 0.0) deb << "~";
+//			else if (sector[iS].maxSlope > 0.5) deb << "^";
+//			else deb << "x";
+//		}
+//	}
+//	deb << "\n";
+//	circuit->LOG(deb.str().c_str());
+#endif
+
+	isInitialized = true;
+}
+
+//int CTerrainData::GetFileValue(int& fileSize, char*& file, std::string entry)
+//{
+//	for(size_t i = 0; i < entry.size(); i++) {
+//		if (!islower(entry[i])) {
+//			entry[i] = tolower(entry[i]);
+//		}
+//	}
+//	size_t entryIndex = 0;
+//	std::string entryValue = "";
+//	for (int i = 0; i < fileSize; i++) {
+//		if (entryIndex >= entry.size()) {
+//			// Entry Found: Reading the value
+//			if (file[i] >= '0' && file[i] <= '9') {
+//				entryValue += file[i];
+//			} else if (file[i] == ';') {
+//				return atoi(entryValue.c_str());
+//			}
+//		} else if ((entry[entryIndex] == file[i]) || (!islower(file[i]) && (entry[entryIndex] == tolower(file[i])))) {  // the current letter matches
+//			entryIndex++;
+//		} else {
+//			entryIndex = 0;
+//		}
+//	}
+//	return 0;
+//}
+
+void CTerrainData::DelegateAuthority(CCircuitAI* curOwner)
+{
+	for (CCircuitAI* circuit : gameAttribute->GetCircuits()) {
+		if (circuit->IsInitialized() && (circuit != curOwner)) {
+			map = circuit->GetMap();
+			scheduler = circuit->GetScheduler();
+			scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CTerrainData::CheckHeightMap, this), FRAMES_PER_SEC * 20);
+			scheduler->RunTaskAfter(std::make_shared<CGameTask>(&CTerrainData::CheckHeightMap, this), FRAMES_PER_SEC);
+			scheduler->RunOnRelease(std::make_shared<CGameTask>(&CTerrainData::DelegateAuthority, this, circuit));
+			break;
+		}
+	}
+}
+
+void CTerrainData::CheckHeightMap()
+{
+	SCOPED_TIME(*gameAttribute->GetCircuits().begin(), __PRETTY_FUNCTION__);
+	if (isUpdating) {
+		return;
+	}
+	isUpdating = true;
+	SetNextMaps(std::move(map->GetHeightMap()), std::move(map->GetSlopeMap()));
+	scheduler->RunParallelTask(std::make_shared<CGameTask>(&CTerrainData::UpdateAreas, this),
+							   std::make_shared<CGameTask>(&CTerrainData::ScheduleUsersUpdate, this));
+}
+
+void CTerrainData::ScheduleUsersUpdate()
+{
+	aiToUpdate = 0;
+	const int interval = gameAttribute->GetCircuits().size();
+	for (CCircuitAI* circuit : gameAttribute->GetCircuits()) {
+		if (circuit->IsInitialized()) {
+			// Chain update: CTerrainManager -> CBuilderManager -> CPathFinder
+			auto task = std::make_shared<CGameTask>(&CTerrainManager::UpdateAreaUsers,
+													circuit->GetTerrainManager(),
+													interval);
+			circuit->GetScheduler()->RunTaskAfter(task, ++aiToUpdate);
+			circuit->GetPathfinder()->SetUpdated(false);  // one pathfinder for few allies
+		}
+	}
+	// Check if there are any ai to update
+	++aiToUpdate;
+	DidUpdateAreaUsers();
+}
+
+#ifdef DEBUG_VIS
+#define WATER(x, i) {	\
+	x[i * 3 + 0] = .2f;  /*R*/	\
+	x[i * 3 + 1] = .2f;  /*G*/	\
+	x[i * 3 + 2] = .8f;  /*B*/	\
+}
+#define HILL(x, i) {	\
+	x[i * 3 + 0] = .65f;  /*R*/	\
+	x[i * 3 + 1] = .16f;  /*G*/	\
+	x[i * 3 + 2] = .16f;  /*B*/	\
+}
+#define LAND(x, i) {	\
+	x[i * 3 + 0] = .2f;  /*R*/	\
+	x[i * 3 + 1] = .8f;  /*G*/	\
+	x[i * 3 + 2] = .2f;  /*B*/	\
+}
+#define MOUNTAIN(x, i) {	\
+	x[i * 3 + 0] = 1.f;  /*R*/	\
+	x[i * 3 + 1] = .0f;  /*G*/	\
+	x[i * 3 + 2] = .0f;  /*B*/	\
+}
+#define BLOCK(x, i) {	\
+	x[i * 3 + 0] = .0f;  /*R*/	\
+	x[i * 3 + 1] = .0f;  /*G*/	\
+	x[i * 3 + 2] = .0f;  /*B*/	\
+}
+
+void CTerrainData::UpdateVis()
+{
+	if ((debugDrawer == nullptr) || sdlWindows.empty()) {
+		return;
+	}
+
+	SAreaData& areaData = *GetNextAreaData();
+	std::vector<STerrainMapSector>& sector = areaData.sector;
+	int winNum = 0;
+
+	std::pair<Uint32, float*> win = sdlWindows[winNum++];
+	for (int i = 0; i < sectorXSize * sectorZSize; ++i) {
+		if (sector[i].maxElevation < 0.0) WATER(win.second, i)
+		else if (sector[i].maxSlope > 0.5) MOUNTAIN(win.second, i)
+		else if (sector[i].maxSlope > 0.25) HILL(win.second, i)
+		else LAND(win.second, i)
+	}
+	debugDrawer->DrawTex(win.first, win.second);
+
+	for (const STerrainMapMobileType& mt : areaData.mobileType) {
+		std::pair<Uint32, float*> win = sdlWindows[winNum++];
+		for (int i = 0; i < sectorXSize * sectorZSize; ++i) {
+			if (mt.sector[i].area != nullptr) LAND(win.second, i)
+			else if (sector[i].maxElevation < 0.0) WATER(win.second, i)
+			else if (sector[i].maxSlope > 0.5) HILL(win.second, i)
+			else BLOCK(win.second, i)
+		}
+		debugDrawer->DrawTex(win.first, win.second);
+	}
+
+	for (const STerrainMapImmobileType& mt : areaData.immobileType) {
+		std::pair<Uint32, float*> win = sdlWindows[winNum++];
+		for (int i = 0; i < sectorXSize * sectorZSize; ++i) {
+			if (mt.HasSector(i)) LAND(win.second, i)
+			else if (sector[i].maxElevation < 0.0) WATER(win.second, i)
+			else if (sector[i].maxSlope > 0.5) HILL(win.second, i)
+			else BLOCK(win.second, i)
+		}
+		debugDrawer->DrawTex(win.first, win.second);
+	}
+}
+
+void CTerrainData::ToggleVis(int frame)
+{
+	if ((debugDrawer == nullptr) || (toggleFrame >= frame)) {
+		return;
+	}
+	toggleFrame = frame;
+
+	if (sdlWindows.empty()) {
+		// ~area
+		SAreaData& areaData = *GetNextAreaData();
+
+		std::pair<Uint32, float*> win;
+		win.second = new float [sectorXSize * sectorZSize * 3];
+		win.first = debugDrawer->AddSDLWindow(sectorXSize, sectorZSize, "Circuit AI :: Terrain");
+		sdlWindows.push_back(win);
+
+		for (const STerrainMapMobileType& mt : areaData.mobileType) {
+			std::pair<Uint32, float*> win;
+			win.second = new float [sectorXSize * sectorZSize * 3];
+			std::ostringstream label;
+			label << "Circuit AI :: Terrain :: Mobile [" << mt.moveData->GetName() << "] h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << mt.area.size();
+			win.first = debugDrawer->AddSDLWindow(sectorXSize, sectorZSize, label.str().c_str());
+			sdlWindows.push_back(win);
+		}
+
+		int itId = 0;
+		for (const STerrainMapImmobileType& mt : areaData.immobileType) {
+			std::pair<Uint32, float*> win;
+			win.second = new float [sectorXSize * sectorZSize * 3];
+			std::ostringstream label;
+			label << "Circuit AI :: Terrain :: Immobile [" << itId++ << "] h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << mt.sector.size();
+			win.first = debugDrawer->AddSDLWindow(sectorXSize, sectorZSize, label.str().c_str());
+			sdlWindows.push_back(win);
+		}
+
+		UpdateVis();
+	} else {
+		for (const std::pair<Uint32, float*>& win : sdlWindows) {
+			debugDrawer->DelSDLWindow(win.first);
+			delete[] win.second;
+		}
+		sdlWindows.clear();
+	}
+}
+#endif
+
+} // namespace circuit
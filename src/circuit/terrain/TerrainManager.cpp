@@ -53,6 +53,7 @@ CTerrainManager::CTerrainManager(CCircuitAI* circuit, CTerrainData* terrainData)
 	blockingMap.rows = mapHeight / 2;
 	SBlockingMap::SBlockCell cell = {0};
 	blockingMap.grid.resize(blockingMap.columns * blockingMap.rows, cell);
+	blockingMap.InitBits();
 	blockingMap.columnsLow = mapWidth / (GRID_RATIO_LOW * 2);
 	blockingMap.rowsLow = mapHeight / (GRID_RATIO_LOW * 2);
 	SBlockingMap::SBlockCellLow cellLow = {0};
@@ -374,45 +375,14 @@ AIFloat3 CTerrainManager::FindBuildSite(CCircuitDef* cdef, const AIFloat3& pos,
 	const int xsize = (((facing & 1) == 0) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 	const int zsize = (((facing & 1) == 1) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 
-	auto isOpenSite = [this](const int2& s1, const int2& s2) {
-		const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
-		for (int x = s1.x; x < s2.x; x++) {
-			for (int z = s1.y; z < s2.y; z++) {
-				if (blockingMap.IsBlocked(x, z, notIgnore)) {
-					return false;
-				}
-			}
-		}
-		return true;
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
-	const std::vector<SSearchOffset>& ofs = GetSearchOffsetTable(endr);
-
-	const int cornerX1 = int(pos.x / (SQUARE_SIZE * 2)) - (xsize / 2);
-	const int cornerZ1 = int(pos.z / (SQUARE_SIZE * 2)) - (zsize / 2);
+	const int2 cell(int(pos.x / (SQUARE_SIZE * 2)), int(pos.z / (SQUARE_SIZE * 2)));
 
 	AIFloat3 probePos(ZeroVector);
-	Map* map = circuit->GetMap();
-
-	for (int so = 0; so < endr * endr * 4; so++) {
-		int2 s1(cornerX1 + ofs[so].dx, cornerZ1 + ofs[so].dy);
-		int2 s2(    s1.x + xsize,          s1.y + zsize);
-		if (!blockingMap.IsInBounds(s1, s2) || !isOpenSite(s1, s2)) {
-			continue;
-		}
-
-		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
-		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
-		if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
-			probePos.y = map->GetElevationAt(probePos.x, probePos.z);
-			if (predicate(probePos)) {
-				return probePos;
-			}
-		}
-	}
+	SBlockingMap::SitePredicate sitePredicate = MakeSitePredicate(cdef, facing, predicate, probePos);
+	const int2 site = blockingMap.FindOpenSite(cell, endr, int2(xsize, zsize), sitePredicate);
 
-	return -RgtVector;
+	return (site.x < 0) ? -RgtVector : probePos;
 }
 
 const SBlockingMap& CTerrainManager::GetBlockingMap()
@@ -509,142 +479,36 @@ void CTerrainManager::MarkAllyBuildings()
 	}
 }
 
-const CTerrainManager::SearchOffsets& CTerrainManager::GetSearchOffsetTable(int radius)
-{
-	static std::vector<SSearchOffset> searchOffsets;
-	unsigned int size = radius * radius * 4;
-	if (size > searchOffsets.size()) {
-		searchOffsets.resize(size);
-
-		for (int y = 0; y < radius * 2; y++) {
-			for (int x = 0; x < radius * 2; x++) {
-				SSearchOffset& i = searchOffsets[y * radius * 2 + x];
-
-				i.dx = x - radius;
-				i.dy = y - radius;
-				i.qdist = i.dx * i.dx + i.dy * i.dy;
-			}
-		}
-
-		auto searchOffsetComparator = [](const SSearchOffset& a, const SSearchOffset& b) {
-			return a.qdist < b.qdist;
-		};
-		std::sort(searchOffsets.begin(), searchOffsets.end(), searchOffsetComparator);
-	}
-
-	return searchOffsets;
-}
-
-const CTerrainManager::SearchOffsetsLow& CTerrainManager::GetSearchOffsetTableLow(int radius)
-{
-	static SearchOffsetsLow searchOffsetsLow;
-	int radiusLow = radius / GRID_RATIO_LOW;
-	unsigned int sizeLow = radiusLow * radiusLow * 4;
-	if (sizeLow > searchOffsetsLow.size()) {
-		searchOffsetsLow.resize(sizeLow);
-
-		SearchOffsets searchOffsets;
-		searchOffsets.resize(radius * radius * 4);
-		for (int y = 0; y < radius * 2; y++) {
-			for (int x = 0; x < radius * 2; x++) {
-				SSearchOffset& i = searchOffsets[y * radius * 2 + x];
-				i.dx = x - radius;
-				i.dy = y - radius;
-				i.qdist = i.dx * i.dx + i.dy * i.dy;
-			}
-		}
-
-		auto searchOffsetComparator = [](const SSearchOffset& a, const SSearchOffset& b) {
-			return a.qdist < b.qdist;
-		};
-		for (int yl = 0; yl < radiusLow * 2; yl++) {
-			for (int xl = 0; xl < radiusLow * 2; xl++) {
-				SSearchOffsetLow& il = searchOffsetsLow[yl * radiusLow * 2 + xl];
-				il.dx = xl - radiusLow;
-				il.dy = yl - radiusLow;
-				il.qdist = il.dx * il.dx + il.dy * il.dy;
-
-				il.ofs.reserve(GRID_RATIO_LOW * GRID_RATIO_LOW);
-				const int xi = xl * GRID_RATIO_LOW;
-				for (int y = yl * GRID_RATIO_LOW; y < (yl + 1) * GRID_RATIO_LOW; y++) {
-					for (int x = xi; x < xi + GRID_RATIO_LOW; x++) {
-						il.ofs.push_back(searchOffsets[y * radius * 2 + x]);
-					}
-				}
-
-				std::sort(il.ofs.begin(), il.ofs.end(), searchOffsetComparator);
-			}
-		}
-
-		auto searchOffsetLowComparator = [](const SSearchOffsetLow& a, const SSearchOffsetLow& b) {
-			return a.qdist < b.qdist;
-		};
-		std::sort(searchOffsetsLow.begin(), searchOffsetsLow.end(), searchOffsetLowComparator);
-	}
-
-	return searchOffsetsLow;
-}
-
 AIFloat3 CTerrainManager::FindBuildSiteLow(CCircuitDef* cdef, const AIFloat3& pos, float searchRadius, int facing, TerrainPredicate& predicate)
 {
 	UnitDef* unitDef = cdef->GetUnitDef();
 	const int xsize = (((facing & 1) == 0) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 	const int zsize = (((facing & 1) == 1) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 
-	auto isOpenSite = [this](const int2& s1, const int2& s2) {
-		const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
-		for (int x = s1.x; x < s2.x; x++) {
-			for (int z = s1.y; z < s2.y; z++) {
-				if (blockingMap.IsBlocked(x, z, notIgnore)) {
-					return false;
-				}
-			}
-		}
-		return true;
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
-	const SearchOffsetsLow& ofsLow = GetSearchOffsetTableLow(endr);
-	const int endrLow = endr / GRID_RATIO_LOW;
-
-	const int centerX = int(pos.x / (SQUARE_SIZE * 2 * GRID_RATIO_LOW));
-	const int centerZ = int(pos.z / (SQUARE_SIZE * 2 * GRID_RATIO_LOW));
-
-	const int cornerX1 = int(pos.x / (SQUARE_SIZE * 2)) - (xsize / 2);
-	const int cornerZ1 = int(pos.z / (SQUARE_SIZE * 2)) - (zsize / 2);
-
-	const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
+	const int2 cell(int(pos.x / (SQUARE_SIZE * 2)), int(pos.z / (SQUARE_SIZE * 2)));
 
 	AIFloat3 probePos(ZeroVector);
-	Map* map = circuit->GetMap();
-
-	for (int soLow = 0; soLow < endrLow * endrLow * 4; soLow++) {
-		int xlow = centerX + ofsLow[soLow].dx;
-		int zlow = centerZ + ofsLow[soLow].dy;
-		if (!blockingMap.IsInBoundsLow(xlow, zlow) || blockingMap.IsBlockedLow(xlow, zlow, notIgnore)) {
-			continue;
-		}
+	SBlockingMap::SitePredicate sitePredicate = MakeSitePredicate(cdef, facing, predicate, probePos);
+	const int2 site = blockingMap.FindOpenSiteLow(cell, endr, int2(xsize, zsize), sitePredicate);
 
-		const SearchOffsets& ofs = ofsLow[soLow].ofs;
-		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {
-			int2 s1(cornerX1 + ofs[so].dx, cornerZ1 + ofs[so].dy);
-			int2 s2(    s1.x + xsize,          s1.y + zsize);
-			if (!blockingMap.IsInBounds(s1, s2) || !isOpenSite(s1, s2)) {
-				continue;
-			}
+	return (site.x < 0) ? -RgtVector : probePos;
+}
 
-			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
-			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
-			if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
-				probePos.y = map->GetElevationAt(probePos.x, probePos.z);
-				if (predicate(probePos)) {
-					return probePos;
-				}
-			}
+SBlockingMap::SitePredicate CTerrainManager::MakeSitePredicate(CCircuitDef* cdef, int facing, TerrainPredicate& predicate,
+															   AIFloat3& outPos)
+{
+	UnitDef* unitDef = cdef->GetUnitDef();
+	Map* map = circuit->GetMap();
+	return [this, cdef, unitDef, facing, &predicate, &outPos, map](const int2& s1, const int2& s2) {
+		outPos.x = (s1.x + s2.x) * SQUARE_SIZE;
+		outPos.z = (s1.y + s2.y) * SQUARE_SIZE;
+		if (!CanBeBuiltAtSafe(cdef, outPos) || !map->IsPossibleToBuildAt(unitDef, outPos, facing)) {
+			return false;
 		}
-	}
-
-	return -RgtVector;
+		outPos.y = map->GetElevationAt(outPos.x, outPos.z);
+		return predicate(outPos);
+	};
 }
 
 AIFloat3 CTerrainManager::FindBuildSiteByMask(CCircuitDef* cdef, const AIFloat3& pos, float searchRadius, int facing, IBlockMask* mask, TerrainPredicate& predicate)
@@ -675,32 +539,8 @@ AIFloat3 CTerrainManager::FindBuildSiteByMask(CCircuitDef* cdef, const AIFloat3&
 		}
 	}
 
-#define DECLARE_TEST(testName, facingType)																	\
-	auto testName = [this, mask, notIgnore, structMask](const int2& m1, const int2& m2, const int2& om) {	\
-		for (int x = m1.x, xm = om.x; x < m2.x; x++, xm++) {												\
-			for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {											\
-				switch (mask->facingType(xm, zm)) {															\
-					case IBlockMask::BlockType::BLOCKED: {													\
-						if (blockingMap.IsStruct(x, z, structMask)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::STRUCT: {													\
-						if (blockingMap.IsBlocked(x, z, notIgnore)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::OPEN: { break; }											\
-				}																							\
-			}																								\
-		}																									\
-		return true;																						\
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
-	const SearchOffsets& ofs = GetSearchOffsetTable(endr);
+	const SBlockingMap::SearchOffsets& ofs = SBlockingMap::GetSearchOffsetTable(endr);
 
 	int2 structCorner;
 	structCorner.x = int(pos.x / (SQUARE_SIZE * 2)) - (xssize / 2);
@@ -710,59 +550,35 @@ AIFloat3 CTerrainManager::FindBuildSiteByMask(CCircuitDef* cdef, const AIFloat3&
 	int2 maskCorner = structCorner - offset;
 
 	const int notIgnore = ~mask->GetIgnoreMask();
-	SBlockingMap::StructMask structMask = SBlockingMap::GetStructMask(mask->GetStructType());
+	const SBlockingMap::StructType structType = mask->GetStructType();
+	const SBlockingMap::SMaskBits& maskBits = mask->GetBits(facing);
 
 	AIFloat3 probePos(ZeroVector);
 	Map* map = circuit->GetMap();
 
-#define DO_TEST(testName)																				\
-	for (int so = 0; so < endr * endr * 4; so++) {														\
-		int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);								\
-		int2 s2(          s1.x + xssize,               s1.y + zssize);									\
-		if (!blockingMap.IsInBounds(s1, s2)) {															\
-			continue;																					\
-		}																								\
-																										\
-		int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);									\
-		int2 m2(        m1.x + xmsize,             m1.y + zmsize);										\
-		int2 om = m1;																					\
-		blockingMap.Bound(m1, m2);																		\
-		om = m1 - om;																					\
-		if (!testName(m1, m2, om)) {																	\
-			continue;																					\
-		}																								\
-																										\
-		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;														\
-		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;														\
-		if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {	\
-			probePos.y = map->GetElevationAt(probePos.x, probePos.z);									\
-			if (predicate(probePos)) {																	\
-				return probePos;																		\
-			}																							\
-		}																								\
-	}
-
-	switch (facing) {
-		default:
-		case UNIT_FACING_SOUTH: {
-			DECLARE_TEST(isOpenSouth, GetTypeSouth);
-			DO_TEST(isOpenSouth);
-			break;
-		}
-		case UNIT_FACING_EAST: {
-			DECLARE_TEST(isOpenEast, GetTypeEast);
-			DO_TEST(isOpenEast);
-			break;
+	for (int so = 0; so < endr * endr * 4; so++) {
+		int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);
+		int2 s2(          s1.x + xssize,               s1.y + zssize);
+		if (!blockingMap.IsInBounds(s1, s2)) {
+			continue;
 		}
-		case UNIT_FACING_NORTH: {
-			DECLARE_TEST(isOpenNorth, GetTypeNorth);
-			DO_TEST(isOpenNorth);
-			break;
+
+		int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);
+		int2 m2(        m1.x + xmsize,             m1.y + zmsize);
+		int2 om = m1;
+		blockingMap.Bound(m1, m2);
+		om = m1 - om;
+		if (!blockingMap.IsOpenSite(m1, m2, om, maskBits, structType, notIgnore)) {
+			continue;
 		}
-		case UNIT_FACING_WEST: {
-			DECLARE_TEST(isOpenWest, GetTypeWest);
-			DO_TEST(isOpenWest);
-			break;
+
+		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
+		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
+		if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
+			probePos.y = map->GetElevationAt(probePos.x, probePos.z);
+			if (predicate(probePos)) {
+				return probePos;
+			}
 		}
 	}
 
@@ -793,32 +609,8 @@ AIFloat3 CTerrainManager::FindBuildSiteByMaskLow(CCircuitDef* cdef, const AIFloa
 		}
 	}
 
-#define DECLARE_TEST_LOW(testName, facingType)																\
-	auto testName = [this, mask, notIgnore, structMask](const int2& m1, const int2& m2, const int2& om) {	\
-		for (int x = m1.x, xm = om.x; x < m2.x; x++, xm++) {												\
-			for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {											\
-				switch (mask->facingType(xm, zm)) {															\
-					case IBlockMask::BlockType::BLOCKED: {													\
-						if (blockingMap.IsStruct(x, z, structMask)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::STRUCT: {													\
-						if (blockingMap.IsBlocked(x, z, notIgnore)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::OPEN: { break; }											\
-				}																							\
-			}																								\
-		}																									\
-		return true;																						\
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
-	const SearchOffsetsLow& ofsLow = GetSearchOffsetTableLow(endr);
+	const SBlockingMap::SearchOffsetsLow& ofsLow = SBlockingMap::GetSearchOffsetTableLow(endr);
 	const int endrLow = endr / GRID_RATIO_LOW;
 
 	int2 structCorner;
@@ -833,67 +625,51 @@ AIFloat3 CTerrainManager::FindBuildSiteByMaskLow(CCircuitDef* cdef, const AIFloa
 	structCenter.y = int(pos.z / (SQUARE_SIZE * 2 * GRID_RATIO_LOW));
 
 	const int notIgnore = ~mask->GetIgnoreMask();
-	SBlockingMap::StructMask structMask = SBlockingMap::GetStructMask(mask->GetStructType());
+	const SBlockingMap::StructType structType = mask->GetStructType();
+	const SBlockingMap::SMaskBits& maskBits = mask->GetBits(facing);
 
 	AIFloat3 probePos(ZeroVector);
 	Map* map = circuit->GetMap();
 
-#define DO_TEST_LOW(testName)																					\
-	for (int soLow = 0; soLow < endrLow * endrLow * 4; soLow++) {												\
-		int2 low(structCenter.x + ofsLow[soLow].dx, structCenter.y + ofsLow[soLow].dy);							\
-		if (!blockingMap.IsInBoundsLow(low.x, low.y) || blockingMap.IsBlockedLow(low.x, low.y, notIgnore)) {	\
-			continue;																							\
-		}																										\
-																												\
-		const SearchOffsets& ofs = ofsLow[soLow].ofs;															\
-		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {											\
-			int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);									\
-			int2 s2(          s1.x + xssize,               s1.y + zssize);										\
-			if (!blockingMap.IsInBounds(s1, s2)) {																\
-				continue;																						\
-			}																									\
-																												\
-			int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);										\
-			int2 m2(        m1.x + xmsize,             m1.y + zmsize);											\
-			int2 om = m1;																						\
-			blockingMap.Bound(m1, m2);																			\
-			om = m1 - om;																						\
-			if (!testName(m1, m2, om)) {																		\
-				continue;																						\
-			}																									\
-																												\
-			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;															\
-			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;															\
-			if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {		\
-				probePos.y = map->GetElevationAt(probePos.x, probePos.z);										\
-				if (predicate(probePos)) {																		\
-					return probePos;																			\
-				}																								\
-			}																									\
-		}																										\
-	}
-
-	switch (facing) {
-		default:
-		case UNIT_FACING_SOUTH: {
-			DECLARE_TEST_LOW(isOpenSouth, GetTypeSouth);
-			DO_TEST_LOW(isOpenSouth);
-			break;
-		}
-		case UNIT_FACING_EAST: {
-			DECLARE_TEST_LOW(isOpenEast, GetTypeEast);
-			DO_TEST_LOW(isOpenEast);
-			break;
+	for (int soLow = 0; soLow < endrLow * endrLow * 4; soLow++) {
+		int2 low(structCenter.x + ofsLow[soLow].dx, structCenter.y + ofsLow[soLow].dy);
+		if (!blockingMap.IsInBoundsLow(low.x, low.y) || blockingMap.IsBlockedLow(low.x, low.y, notIgnore)) {
+			continue;
 		}
-		case UNIT_FACING_NORTH: {
-			DECLARE_TEST_LOW(isOpenNorth, GetTypeNorth);
-			DO_TEST_LOW(isOpenNorth);
-			break;
+
+		// structure part of every candidate within the block covers [c1, c2)
+		const int2 c1(structCorner.x + ofsLow[soLow].ofsCorner.x + GRID_RATIO_LOW - 1,
+					  structCorner.y + ofsLow[soLow].ofsCorner.y + GRID_RATIO_LOW - 1);
+		const int2 c2(c1.x - GRID_RATIO_LOW + 1 + xssize, c1.y - GRID_RATIO_LOW + 1 + zssize);
+		if ((c1.x < c2.x) && (c1.y < c2.y) && blockingMap.IsInBounds(c1, c2) && !blockingMap.IsOpenRegion(c1, c2, notIgnore)) {
+			continue;
 		}
-		case UNIT_FACING_WEST: {
-			DECLARE_TEST_LOW(isOpenWest, GetTypeWest);
-			DO_TEST_LOW(isOpenWest);
-			break;
+
+		const SBlockingMap::SearchOffsets& ofs = ofsLow[soLow].ofs;
+		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {
+			int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);
+			int2 s2(          s1.x + xssize,               s1.y + zssize);
+			if (!blockingMap.IsInBounds(s1, s2)) {
+				continue;
+			}
+
+			int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);
+			int2 m2(        m1.x + xmsize,             m1.y + zmsize);
+			int2 om = m1;
+			blockingMap.Bound(m1, m2);
+			om = m1 - om;
+			if (!blockingMap.IsOpenSite(m1, m2, om, maskBits, structType, notIgnore)) {
+				continue;
+			}
+
+			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
+			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
+			if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
+				probePos.y = map->GetElevationAt(probePos.x, probePos.z);
+				if (predicate(probePos)) {
+					return probePos;
+				}
+			}
 		}
 	}
 
@@ -1112,56 +888,51 @@ std::vector<STerrainMapAreaSector>& CTerrainManager::GetSectorList(STerrainMapAr
 
 STerrainMapAreaSector* CTerrainManager::GetClosestSector(STerrainMapArea* sourceArea, const int destinationSIndex)
 {
-	auto iAS = sourceArea->sectorClosest.find(destinationSIndex);
-	if (iAS != sourceArea->sectorClosest.end()) {  // It's already been determined
-		return iAS->second;
+	std::vector<STerrainMapAreaSector>& TMSectors = GetSectorList(sourceArea);
+	if (sourceArea->sectorClosest.empty()) {
+		sourceArea->sectorClosest.resize(TMSectors.size(), SECTOR_UNKNOWN);
+	}
+	int& closest = sourceArea->sectorClosest[destinationSIndex];
+	if (closest != SECTOR_UNKNOWN) {  // It's already been determined
+		return (closest < 0) ? nullptr : &TMSectors[closest];
 	}
 
-	std::vector<STerrainMapAreaSector>& TMSectors = GetSectorList(sourceArea);
 	if (sourceArea == TMSectors[destinationSIndex].area) {
-		sourceArea->sectorClosest[destinationSIndex] = &TMSectors[destinationSIndex];
+		closest = destinationSIndex;
 		return &TMSectors[destinationSIndex];
 	}
 
 	AIFloat3* destination = &TMSectors[destinationSIndex].S->position;
-	STerrainMapAreaSector* SClosest = nullptr;
+	closest = -1;
 	float sqDisClosest = std::numeric_limits<float>::max();
 	for (auto& iS : sourceArea->sector) {
 		float sqDist = iS.second->S->position.SqDistance2D(*destination);  // TODO: Consider SqDistance() instead of 2D
 		if (sqDist < sqDisClosest) {
-			SClosest = iS.second;
+			closest = iS.first;
 			sqDisClosest = sqDist;
 		}
 	}
-	sourceArea->sectorClosest[destinationSIndex] = SClosest;
-	return SClosest;
+	return (closest < 0) ? nullptr : &TMSectors[closest];
 }
 
 STerrainMapSector* CTerrainManager::GetClosestSector(STerrainMapImmobileType* sourceIT, const int destinationSIndex)
 {
-	auto iS = sourceIT->sectorClosest.find(destinationSIndex);
-	if (iS != sourceIT->sectorClosest.end()) {  // It's already been determined
-		return iS->second;
-	}
-
-	if (sourceIT->sector.find(destinationSIndex) != sourceIT->sector.end()) {
-		STerrainMapSector* SClosest = &areaData->sector[destinationSIndex];
-		sourceIT->sectorClosest[destinationSIndex] = SClosest;
-		return SClosest;
+	int& closest = sourceIT->sectorClosest[destinationSIndex];
+	if (closest != SECTOR_UNKNOWN) {  // It's already been determined, members point to themselves
+		return (closest < 0) ? nullptr : &areaData->sector[closest];
 	}
 
 	const AIFloat3* destination = &areaData->sector[destinationSIndex].position;
-	STerrainMapSector* SClosest = nullptr;
+	closest = -1;
 	float sqDisClosest = std::numeric_limits<float>::max();
 	for (auto& iS : sourceIT->sector) {
 		float sqDist = iS.second->position.SqDistance2D(*destination);  // TODO: Consider SqDistance() instead of 2D
 		if (sqDist < sqDisClosest) {
-			SClosest = iS.second;
+			closest = iS.first;
 			sqDisClosest = sqDist;
 		}
 	}
-	sourceIT->sectorClosest[destinationSIndex] = SClosest;
-	return SClosest;
+	return (closest < 0) ? nullptr : &areaData->sector[closest];
 }
 
 STerrainMapAreaSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* sourceArea, const int sourceSIndex, STerrainMapMobileType* destinationMT)
@@ -1245,19 +1016,61 @@ STerrainMapSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* destin
 
 bool CTerrainManager::CanBeBuiltAt(CCircuitDef* cdef, const AIFloat3& position, const float range)
 {
-	int iS = GetSectorIndex(position);
+	const int iS = GetSectorIndex(position);
+	SBuildClass& buildClass = GetBuildClass(cdef);
+	float& distance = buildClass.sectorDist[iS];
+	if (distance < 0.f) {
+		distance = CalcBuildDistance(buildClass, iS);
+	}
+#ifdef DEBUG
+	else if (distance != CalcBuildDistance(buildClass, iS)) {
+		circuit->LOG("CanBeBuiltAt: stale distance for def %i at sector %i", cdef->GetId(), iS);
+	}
+#endif
+	// 0 - the current sector is the best sector
+	return (distance == 0.f) || (distance < range);
+}
+
+CTerrainManager::SBuildClass& CTerrainManager::GetBuildClass(CCircuitDef* cdef)
+{
+	const CCircuitDef::Id defId = cdef->GetId();
+	if (defId >= (int)defBuildClass.size()) {
+		defBuildClass.resize(defId + 1, -1);
+	}
+	int& index = defBuildClass[defId];
+	if (index < 0) {
+		const STerrainMapMobileType::Id mobileId = cdef->GetMobileId();
+		const STerrainMapImmobileType::Id immobileId = cdef->GetImmobileId();
+		for (index = 0; index < (int)buildClasses.size(); ++index) {
+			if ((buildClasses[index].mobileId == mobileId) && (buildClasses[index].immobileId == immobileId)) {
+				break;
+			}
+		}
+		if (index == (int)buildClasses.size()) {
+			buildClasses.push_back({mobileId, immobileId, {}});
+		}
+	}
+	SBuildClass& buildClass = buildClasses[index];
+	if (buildClass.sectorDist.empty()) {
+		buildClass.sectorDist.resize(areaData->sector.size(), -1.f);
+	}
+	return buildClass;
+}
+
+float CTerrainManager::CalcBuildDistance(const SBuildClass& buildClass, int iS)
+{
 	STerrainMapSector* sector;
-	STerrainMapMobileType* mobileType = GetMobileTypeById(cdef->GetMobileId());
-	STerrainMapImmobileType* immobileType = GetImmobileTypeById(cdef->GetImmobileId());
+	STerrainMapMobileType* mobileType = GetMobileTypeById(buildClass.mobileId);
+	STerrainMapImmobileType* immobileType = GetImmobileTypeById(buildClass.immobileId);
 	if (mobileType != nullptr) {  // a factory or mobile unit
 		STerrainMapAreaSector* AS = GetAlternativeSector(nullptr, iS, mobileType);
 		if (AS == nullptr) {
-			return false;  // FIXME: do not use units with typeUsable=false
+			return std::numeric_limits<float>::max();  // FIXME: do not use units with typeUsable=false
 		}
 		if (immobileType != nullptr) {  // a factory
 			sector = GetAlternativeSector(AS->area, iS, immobileType);
 			if (sector == nullptr) {
-				return false;
+				return std::numeric_limits<float>::max();
 			}
 		} else {
 			sector = AS->S;
@@ -1265,16 +1078,16 @@ bool CTerrainManager::CanBeBuiltAt(CCircuitDef* cdef, const AIFloat3& position,
 	} else if (immobileType != nullptr) {  // buildings
 		sector = GetClosestSector(immobileType, iS);
 		if (sector == nullptr) {
-			return false;  // FIXME: do not use buildings with typeUsable=false
+			return std::numeric_limits<float>::max();  // FIXME: do not use buildings with typeUsable=false
 		}
 	} else {
-		return true;  // flying units
+		return 0.f;  // flying units
 	}
 
 	if (sector == &GetSector(iS)) {  // the current sector is the best sector
-		return true;
+		return 0.f;
 	}
-	return sector->position.distance2D(GetSector(iS).position) < range;
+	return sector->position.distance2D(GetSector(iS).position);
 }
 
 bool CTerrainManager::CanBeBuiltAtSafe(CCircuitDef* cdef, const AIFloat3& position, const float range)
@@ -1295,7 +1108,7 @@ bool CTerrainManager::CanBuildAt(CCircuitUnit* unit, const AIFloat3& destination
 		return true;
 	}
 	int iS = GetSectorIndex(destination);
-	if (area->sector.find(iS) != area->sector.end()) {
+	if (area->HasSector(iS)) {
 		return true;
 	}
 	return GetClosestSector(area, iS)->S->position.distance2D(destination) < unit->GetCircuitDef()->GetBuildDistance();
@@ -1315,7 +1128,7 @@ bool CTerrainManager::CanMobileBuildAt(STerrainMapArea* area, CCircuitDef* build
 		return true;
 	}
 	int iS = GetSectorIndex(destination);
-	if (area->sector.find(iS) != area->sector.end()) {
+	if (area->HasSector(iS)) {
 		return true;
 	}
 	return GetClosestSector(area, iS)->S->position.distance2D(destination) < builderDef->GetBuildDistance();
@@ -1332,6 +1145,9 @@ bool CTerrainManager::CanMobileBuildAtSafe(STerrainMapArea* area, CCircuitDef* b
 void CTerrainManager::UpdateAreaUsers(int interval)
 {
 	areaData = terrainData->GetNextAreaData();
+	for (SBuildClass& buildClass : buildClasses) {
+		buildClass.sectorDist.clear();
+	}
 	const int frame = circuit->GetLastFrame();
 	for (auto& kv : circuit->GetTeamUnits()) {
 		CCircuitUnit* unit = kv.second;
@@ -77,19 +77,6 @@ private:
 	std::deque<SStructure> markedAllies;  // sorted by insertion
 	void MarkAllyBuildings();
 
-	struct SSearchOffset {
-		int dx, dy;
-		int qdist;  // dx*dx + dy*dy
-	};
-	using SearchOffsets = std::vector<SSearchOffset>;
-	struct SSearchOffsetLow {
-		SearchOffsets ofs;
-		int dx, dy;
-		int qdist;  // dx*dx + dy*dy
-	};
-	using SearchOffsetsLow = std::vector<SSearchOffsetLow>;
-	static const SearchOffsets& GetSearchOffsetTable(int radius);
-	static const SearchOffsetsLow& GetSearchOffsetTableLow(int radius);
 	springai::AIFloat3 FindBuildSiteLow(CCircuitDef* cdef,
 										const springai::AIFloat3& pos,
 										float searchRadius,
@@ -108,6 +95,11 @@ private:
 											  int facing,
 											  IBlockMask* mask,
 											  TerrainPredicate& predicate);
+	// Engine build checks and predicate of SBlockingMap's open site, outPos is the site's position
+	SBlockingMap::SitePredicate MakeSitePredicate(CCircuitDef* cdef,
+												  int facing,
+												  TerrainPredicate& predicate,
+												  springai::AIFloat3& outPos);
 
 	SBlockingMap blockingMap;
 	std::unordered_map<CCircuitDef::Id, IBlockMask*> blockInfos;  // owner
@@ -179,6 +171,21 @@ private:
 	SAreaData* areaData;
 	CTerrainData* terrainData;
 
+	/*
+	 * (build class × sector) table for CanBeBuiltAt, build class is a unique pair of mobile and immobile types.
+	 * Each cell holds distance from the sector to the best sector to build at, filled on first request
+	 * and dropped on areaData swap.
+	 */
+	struct SBuildClass {
+		STerrainMapMobileType::Id mobileId;
+		STerrainMapImmobileType::Id immobileId;
+		std::vector<float> sectorDist;  // empty - not used with current areaData
+	};
+	std::vector<SBuildClass> buildClasses;
+	std::vector<int> defBuildClass;  // CCircuitDef::Id: index in buildClasses, -1 - unknown
+	SBuildClass& GetBuildClass(CCircuitDef* cdef);
+	float CalcBuildDistance(const SBuildClass& buildClass, int iS);
+
 #ifdef DEBUG_VIS
 private:
 	int dbgTextureId;
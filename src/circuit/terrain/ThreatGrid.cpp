@@ -0,0 +1,260 @@
+/*
+ * ThreatGrid.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "terrain/ThreatGrid.h"
+#include "terrain/TerrainData.h"
+#include "util/Defines.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace circuit {
+
+#define THREAT_DECAY	0.05f
+
+void SThreatGrid::Init(int width, int height)
+{
+	this->width = width;
+	this->height = height;
+	mapSize = width * height;
+
+	airThreat.assign(mapSize, THREAT_BASE);
+	surfThreat.assign(mapSize, THREAT_BASE);
+	amphThreat.assign(mapSize, THREAT_BASE);
+	cloakThreat.assign(mapSize, THREAT_BASE);
+	shield.assign(mapSize, 0.f);
+}
+
+void SThreatGrid::AddAir(int posx, int posz, float threat, int range)
+{
+	const int rangeSq = SQUARE(range);
+
+	const int beginX = std::max(int(posx - range + 1),          1);
+	const int endX   = std::min(int(posx + range    ),  width - 1);
+	const int beginZ = std::max(int(posz - range + 1),          1);
+	const int endZ   = std::min(int(posz + range    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+			const int sum = dxSq + dzSq;
+			if (sum > rangeSq) {
+				continue;
+			}
+
+			const int index = z * width + x;
+			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
+			airThreat[index] += heat;
+		}
+	}
+}
+
+void SThreatGrid::DelAir(int posx, int posz, float threat, int range)
+{
+	const int rangeSq = SQUARE(range);
+
+	// Threat circles are large and often have appendix, decrease it by 1 for micro-optimization
+	const int beginX = std::max(int(posx - range + 1),          1);
+	const int endX   = std::min(int(posx + range    ),  width - 1);
+	const int beginZ = std::max(int(posz - range + 1),          1);
+	const int endZ   = std::min(int(posz + range    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+			const int sum = dxSq + dzSq;
+			if (sum > rangeSq) {
+				continue;
+			}
+
+			const int index = z * width + x;
+			// MicroPather cannot deal with negative costs
+			// (which may arise due to floating-point drift)
+			// nor with zero-cost nodes (see MP::SetMapData,
+			// threat is not used as an additive overlay)
+			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
+			airThreat[index] = std::max<float>(airThreat[index] - heat, THREAT_BASE);
+		}
+	}
+}
+
+void SThreatGrid::AddAmph(int posx, int posz, float threat, int rangeLand, int rangeWater,
+						  const std::vector<STerrainMapSector>& sector)
+{
+	const int widthSec = width - 2;
+	const int rangeLandSq = SQUARE(rangeLand);
+	const int rangeWaterSq = SQUARE(rangeWater);
+	const int range = std::max(rangeLand, rangeWater);
+
+	const int beginX = std::max(int(posx - range + 1),          1);
+	const int endX   = std::min(int(posx + range    ),  width - 1);
+	const int beginZ = std::max(int(posz - range + 1),          1);
+	const int endZ   = std::min(int(posz + range    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+
+			const int sum = dxSq + dzSq;
+			const int index = z * width + x;
+			const int idxSec = (z - 1) * widthSec + (x - 1);
+			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
+			bool isWaterThreat = (sum <= rangeWaterSq) && sector[idxSec].isWater;
+			if (isWaterThreat || ((sum <= rangeLandSq) && (sector[idxSec].position.y >= -SQUARE_SIZE * 5)))
+			{
+				amphThreat[index] += heat;
+			}
+			if (isWaterThreat || (sum <= rangeLandSq)) {
+				surfThreat[index] += heat;
+			}
+		}
+	}
+}
+
+void SThreatGrid::DelAmph(int posx, int posz, float threat, int rangeLand, int rangeWater,
+						  const std::vector<STerrainMapSector>& sector)
+{
+	const int widthSec = width - 2;
+	const int rangeLandSq = SQUARE(rangeLand);
+	const int rangeWaterSq = SQUARE(rangeWater);
+	const int range = std::max(rangeLand, rangeWater);
+
+	const int beginX = std::max(int(posx - range + 1),          1);
+	const int endX   = std::min(int(posx + range    ),  width - 1);
+	const int beginZ = std::max(int(posz - range + 1),          1);
+	const int endZ   = std::min(int(posz + range    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+
+			const int sum = dxSq + dzSq;
+			const int index = z * width + x;
+			const int idxSec = (z - 1) * widthSec + (x - 1);
+			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
+			bool isWaterThreat = (sum <= rangeWaterSq) && sector[idxSec].isWater;
+			if (isWaterThreat || ((sum <= rangeLandSq) && (sector[idxSec].position.y >= -SQUARE_SIZE * 5)))
+			{
+				amphThreat[index] = std::max<float>(amphThreat[index] - heat, THREAT_BASE);
+			}
+			if (isWaterThreat || (sum <= rangeLandSq)) {
+				surfThreat[index] = std::max<float>(surfThreat[index] - heat, THREAT_BASE);
+			}
+		}
+	}
+}
+
+void SThreatGrid::AddDecloaker(int posx, int posz, int rangeCloak)
+{
+	const float threatCloak = 16 * THREAT_BASE;
+	const int rangeCloakSq = SQUARE(rangeCloak);
+
+	// For small decloak ranges full range shouldn't hit performance
+	const int beginX = std::max(int(posx - rangeCloak + 1),          1);
+	const int endX   = std::min(int(posx + rangeCloak    ),  width - 1);
+	const int beginZ = std::max(int(posz - rangeCloak + 1),          1);
+	const int endZ   = std::min(int(posz + rangeCloak    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+			const int sum = dxSq + dzSq;
+			if (sum > rangeCloakSq) {
+				continue;
+			}
+
+			const int index = z * width + x;
+			const float heat = threatCloak * (1.0f - 0.5f * sqrtf(sum) / rangeCloak);
+			cloakThreat[index] += heat;
+		}
+	}
+}
+
+void SThreatGrid::DelDecloaker(int posx, int posz, int rangeCloak)
+{
+	const float threatCloak = 16 * THREAT_BASE;
+	const int rangeCloakSq = SQUARE(rangeCloak);
+
+	// For small decloak ranges full range shouldn't hit performance
+	const int beginX = std::max(int(posx - rangeCloak + 1),          1);
+	const int endX   = std::min(int(posx + rangeCloak    ),  width - 1);
+	const int beginZ = std::max(int(posz - rangeCloak + 1),          1);
+	const int endZ   = std::min(int(posz + rangeCloak    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int dxSq = SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			const int dzSq = SQUARE(posz - z);
+			const int sum = dxSq + dzSq;
+			if (sum > rangeCloakSq) {
+				continue;
+			}
+
+			const int index = z * width + x;
+			const float heat = threatCloak * (1.0f - 0.5f * sqrtf(sum) / rangeCloak);
+			cloakThreat[index] = std::max<float>(cloakThreat[index] - heat, THREAT_BASE);
+		}
+	}
+}
+
+void SThreatGrid::AddShield(int posx, int posz, float shieldVal, int rangeShield)
+{
+	const int rangeShieldSq = SQUARE(rangeShield);
+
+	const int beginX = std::max(int(posx - rangeShield + 1),          1);
+	const int endX   = std::min(int(posx + rangeShield    ),  width - 1);
+	const int beginZ = std::max(int(posz - rangeShield + 1),          1);
+	const int endZ   = std::min(int(posz + rangeShield    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int rrx = rangeShieldSq - SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			if (SQUARE(posz - z) > rrx) {
+				continue;
+			}
+			shield[z * width + x] += shieldVal;
+		}
+	}
+}
+
+void SThreatGrid::DelShield(int posx, int posz, float shieldVal, int rangeShield)
+{
+	const int rangeShieldSq = SQUARE(rangeShield);
+
+	const int beginX = std::max(int(posx - rangeShield + 1),          1);
+	const int endX   = std::min(int(posx + rangeShield    ),  width - 1);
+	const int beginZ = std::max(int(posz - rangeShield + 1),          1);
+	const int endZ   = std::min(int(posz + rangeShield    ), height - 1);
+
+	for (int x = beginX; x < endX; ++x) {
+		const int rrx = rangeShieldSq - SQUARE(posx - x);
+		for (int z = beginZ; z < endZ; ++z) {
+			if (SQUARE(posz - z) > rrx) {
+				continue;
+			}
+			const int index = z * width + x;
+			shield[index] = std::max(shield[index] - shieldVal, 0.f);
+		}
+	}
+}
+
+void SThreatGrid::Decay()
+{
+	for (int index = 0; index < mapSize; ++index) {
+		airThreat[index]  = std::max<float>(airThreat[index]  - THREAT_DECAY, THREAT_BASE);
+		surfThreat[index] = std::max<float>(surfThreat[index] - THREAT_DECAY, THREAT_BASE);
+		amphThreat[index] = std::max<float>(amphThreat[index] - THREAT_DECAY, THREAT_BASE);
+		// except for cloakThreat
+	}
+}
+
+} // namespace circuit
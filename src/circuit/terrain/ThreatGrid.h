@@ -0,0 +1,58 @@
+/*
+ * ThreatGrid.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_THREATGRID_H_
+#define SRC_CIRCUIT_TERRAIN_THREATGRID_H_
+
+#include <vector>
+
+namespace circuit {
+
+struct STerrainMapSector;
+
+/*
+ * Threat layers of CThreatMap and their stamping, without enemy units.
+ * Cell is a terrain sector, grid has 1 cell border for pathfinder edges.
+ * pos(x, z) and ranges are in cells.
+ */
+struct SThreatGrid {
+	/*
+	 * http://stackoverflow.com/questions/872544/precision-of-floating-point
+	 * Single precision: for accuracy of +/-0.5 (or 2^-1) the maximum size that the number can be is 2^23.
+	 */
+	using Threats = std::vector<float>;
+
+	void Init(int width, int height);
+
+	void AddAir(int posx, int posz, float threat, int range);
+	void DelAir(int posx, int posz, float threat, int range);
+	// sector: STerrainMapSector of current areas, width-2 x height-2
+	void AddAmph(int posx, int posz, float threat, int rangeLand, int rangeWater,
+				 const std::vector<STerrainMapSector>& sector);
+	void DelAmph(int posx, int posz, float threat, int rangeLand, int rangeWater,
+				 const std::vector<STerrainMapSector>& sector);
+	void AddDecloaker(int posx, int posz, int rangeCloak);
+	void DelDecloaker(int posx, int posz, int rangeCloak);
+	void AddShield(int posx, int posz, float shieldVal, int rangeShield);
+	void DelShield(int posx, int posz, float shieldVal, int rangeShield);
+	// Decay whole grid to compensate for precision errors, except for cloakThreat
+	void Decay();
+
+	int width;
+	int height;
+	int mapSize;
+
+	Threats airThreat;  // air layer
+	Threats surfThreat;  // surface (water and land)
+	Threats amphThreat;  // under water and surface on land
+	Threats cloakThreat;
+	Threats shield;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_THREATGRID_H_
@@ -8,6 +8,7 @@
 
 #include "terrain/ThreatMap.h"
 #include "terrain/TerrainManager.h"
+#include "resource/MetalManager.h"
 #include "setup/SetupManager.h"
 #include "unit/CircuitUnit.h"
 #include "unit/EnemyUnit.h"
@@ -20,34 +21,29 @@
 
 //#undef NDEBUG
 #include <cassert>
+#include <algorithm>
+#include <iterator>
 
 namespace circuit {
 
 using namespace springai;
 
-#define THREAT_DECAY	0.05f
-
 CThreatMap::CThreatMap(CCircuitAI* circuit, float decloakRadius)
 		: circuit(circuit)
 //		, currMaxThreat(.0f)  // maximum threat (normalizer)
 //		, currSumThreat(.0f)  // threat summed over all cells
 //		, currAvgThreat(.0f)  // average threat over all cells
+		, clusterUpdateNum(0)
 {
 	areaData = circuit->GetTerrainManager()->GetAreaData();
 	squareSize = circuit->GetTerrainManager()->GetConvertStoP();
-	width = circuit->GetTerrainManager()->GetSectorXSize() + 2;  // +2 for pathfinder edges
-	height = circuit->GetTerrainManager()->GetSectorZSize() + 2;  // +2 for pathfinder edges
-	mapSize = width * height;
+	grid.Init(circuit->GetTerrainManager()->GetSectorXSize() + 2,  // +2 for pathfinder edges
+			  circuit->GetTerrainManager()->GetSectorZSize() + 2);
 
 	rangeDefault = (DEFAULT_SLACK * 4) / squareSize;
 	distCloak = (decloakRadius + DEFAULT_SLACK) / squareSize;
 
-	airThreat.resize(mapSize, THREAT_BASE);
-	surfThreat.resize(mapSize, THREAT_BASE);
-	amphThreat.resize(mapSize, THREAT_BASE);
-	cloakThreat.resize(mapSize, THREAT_BASE);
-	threatArray = &surfThreat[0];
-	shield.resize(mapSize, 0.f);
+	threatArray = &grid.surfThreat[0];
 
 	Map* map = circuit->GetMap();
 	int mapWidth = map->GetWidth();
@@ -173,17 +169,14 @@ void CThreatMap::Update()
 	}
 
 	// decay whole threatMap to compensate for precision errors
-	for (int index = 0; index < mapSize; ++index) {
-		airThreat[index]  = std::max<float>(airThreat[index]  - THREAT_DECAY, THREAT_BASE);
-		surfThreat[index] = std::max<float>(surfThreat[index] - THREAT_DECAY, THREAT_BASE);
-		amphThreat[index] = std::max<float>(amphThreat[index] - THREAT_DECAY, THREAT_BASE);
-		// except for cloakThreat
-	}
+	grid.Decay();
 //	airMetal    = std::max(airMetal    - THREAT_DECAY, .0f);
 //	staticMetal = std::max(staticMetal - THREAT_DECAY, .0f);
 //	landMetal   = std::max(landMetal   - THREAT_DECAY, .0f);
 //	waterMetal  = std::max(waterMetal  - THREAT_DECAY, .0f);
 
+	UpdateClusters();
+
 #ifdef DEBUG_VIS
 	UpdateVis();
 #endif
@@ -346,10 +339,10 @@ float CThreatMap::GetAllThreatAt(const AIFloat3& position) const
 		   (position.z >= 0) && (position.z < CTerrainManager::GetTerrainHeight()));
 	int x, z;
 	PosToXZ(position, x, z);
-	const int index = z * width + x;
-//	float air = airThreat[index] - THREAT_BASE;
-	float land = surfThreat[index] - THREAT_BASE;
-//	float water = amphThreat[index] - THREAT_BASE;
+	const int index = z * grid.width + x;
+//	float air = grid.airThreat[index] - THREAT_BASE;
+	float land = grid.surfThreat[index] - THREAT_BASE;
+//	float water = grid.amphThreat[index] - THREAT_BASE;
 	return /*air + */land/* + water*/;
 }
 
@@ -357,12 +350,12 @@ void CThreatMap::SetThreatType(CCircuitUnit* unit)
 {
 	assert(unit != nullptr);
 	if (unit->GetCircuitDef()->IsAbleToFly()) {
-		threatArray = &airThreat[0];
+		threatArray = &grid.airThreat[0];
 //	} else if (unit->GetPos(circuit->GetLastFrame()).y < -SQUARE_SIZE * 5) {
 	} else if (unit->GetCircuitDef()->IsAmphibious()) {
-		threatArray = &amphThreat[0];
+		threatArray = &grid.amphThreat[0];
 	} else {
-		threatArray = &surfThreat[0];
+		threatArray = &grid.surfThreat[0];
 	}
 }
 
@@ -372,7 +365,17 @@ float CThreatMap::GetThreatAt(const AIFloat3& position) const
 		   (position.z >= 0) && (position.z < CTerrainManager::GetTerrainHeight()));
 	int x, z;
 	PosToXZ(position, x, z);
-	return threatArray[z * width + x] - THREAT_BASE;
+	return threatArray[z * grid.width + x] - THREAT_BASE;
+}
+
+float CThreatMap::GetClusterThreat(int cluster) const
+{
+	return clusterThreats.empty() ? 0.f : clusterThreats[cluster].maxThreat[GetLayer()];
+}
+
+float CThreatMap::GetAllClusterThreat(int cluster) const
+{
+	return clusterThreats.empty() ? 0.f : clusterThreats[cluster].maxThreat[Layer::SURF];
 }
 
 float CThreatMap::GetThreatAt(CCircuitUnit* unit, const AIFloat3& position) const
@@ -383,13 +386,13 @@ float CThreatMap::GetThreatAt(CCircuitUnit* unit, const AIFloat3& position) cons
 	int x, z;
 	PosToXZ(position, x, z);
 	if (unit->GetCircuitDef()->IsAbleToFly()) {
-		return airThreat[z * width + x] - THREAT_BASE;
+		return grid.airThreat[z * grid.width + x] - THREAT_BASE;
 	}
 //	if (unit->GetPos(circuit->GetLastFrame()).y < -SQUARE_SIZE * 5) {
 	if (unit->GetCircuitDef()->IsAmphibious()) {
-		return amphThreat[z * width + x] - THREAT_BASE;
+		return grid.amphThreat[z * grid.width + x] - THREAT_BASE;
 	}
-	return surfThreat[z * width + x] - THREAT_BASE;
+	return grid.surfThreat[z * grid.width + x] - THREAT_BASE;
 }
 
 float CThreatMap::GetUnitThreat(CCircuitUnit* unit) const
@@ -404,6 +407,57 @@ inline void CThreatMap::PosToXZ(const AIFloat3& pos, int& x, int& z) const
 	z = (int)pos.z / squareSize + 1;
 }
 
+int CThreatMap::GetLayer() const
+{
+	return (threatArray == &grid.airThreat[0]) ? Layer::AIR : (threatArray == &grid.amphThreat[0]) ? Layer::AMPH : Layer::SURF;
+}
+
+void CThreatMap::UpdateClusters()
+{
+	if (clusterThreats.empty()) {
+		CMetalManager* metalManager = circuit->GetMetalManager();
+		if (!metalManager->HasMetalClusters()) {
+			return;
+		}
+		const CMetalData::Clusters& clusters = metalManager->GetClusters();
+		const CMetalData::Metals& spots = metalManager->GetSpots();
+		clusterThreats.resize(clusters.size());
+		for (unsigned i = 0; i < clusters.size(); ++i) {
+			SClusterThreat& ct = clusterThreats[i];
+			int x, z;
+			PosToXZ(clusters[i].position, x, z);
+			ct.cells.push_back(z * grid.width + x);
+			for (int idx : clusters[i].idxSpots) {
+				PosToXZ(spots[idx].position, x, z);
+				ct.cells.push_back(z * grid.width + x);
+			}
+			std::sort(ct.cells.begin(), ct.cells.end());
+			ct.cells.erase(std::unique(ct.cells.begin(), ct.cells.end()), ct.cells.end());
+			std::fill(std::begin(ct.maxThreat), std::end(ct.maxThreat), 0.f);
+		}
+	}
+
+	dirtyClusters.clear();
+	const SThreatGrid::Threats* layers[Layer::_SIZE_] = {&grid.airThreat, &grid.surfThreat, &grid.amphThreat};
+	for (unsigned i = 0; i < clusterThreats.size(); ++i) {
+		SClusterThreat& ct = clusterThreats[i];
+		bool isDirty = false;
+		for (int l = 0; l < Layer::_SIZE_; ++l) {
+			const SThreatGrid::Threats& threats = *layers[l];
+			float maxThreat = 0.f;
+			for (int index : ct.cells) {
+				maxThreat = std::max(maxThreat, threats[index] - THREAT_BASE);
+			}
+			isDirty |= ((ct.maxThreat[l] > THREAT_MIN) != (maxThreat > THREAT_MIN));
+			ct.maxThreat[l] = maxThreat;
+		}
+		if (isDirty) {
+			dirtyClusters.push_back(i);
+		}
+	}
+	++clusterUpdateNum;
+}
+
 void CThreatMap::AddEnemyUnit(const CEnemyUnit* e)
 {
 	CCircuitDef* cdef = e->GetCircuitDef();
@@ -464,266 +518,58 @@ void CThreatMap::AddEnemyAir(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float threat = e->GetThreat()/* - THREAT_DECAY*/;
-	const int range = e->GetRange(CCircuitDef::ThreatType::AIR);
-	const int rangeSq = SQUARE(range);
-
-	const int beginX = std::max(int(posx - range + 1),          1);
-	const int endX   = std::min(int(posx + range    ),  width - 1);
-	const int beginZ = std::max(int(posz - range + 1),          1);
-	const int endZ   = std::min(int(posz + range    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-			const int sum = dxSq + dzSq;
-			if (sum > rangeSq) {
-				continue;
-			}
-
-			const int index = z * width + x;
-			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
-			airThreat[index] += heat;
-
-//			currSumThreat += heat;
-		}
-	}
-
-//	currAvgThreat = currSumThreat / landThreat.size();
+	grid.AddAir(posx, posz, e->GetThreat()/* - THREAT_DECAY*/, e->GetRange(CCircuitDef::ThreatType::AIR));
 }
 
 void CThreatMap::DelEnemyAir(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float threat = e->GetThreat()/* + THREAT_DECAY*/;
-	const int range = e->GetRange(CCircuitDef::ThreatType::AIR);
-	const int rangeSq = SQUARE(range);
-
-	// Threat circles are large and often have appendix, decrease it by 1 for micro-optimization
-	const int beginX = std::max(int(posx - range + 1),          1);
-	const int endX   = std::min(int(posx + range    ),  width - 1);
-	const int beginZ = std::max(int(posz - range + 1),          1);
-	const int endZ   = std::min(int(posz + range    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-			const int sum = dxSq + dzSq;
-			if (sum > rangeSq) {
-				continue;
-			}
-
-			const int index = z * width + x;
-			// MicroPather cannot deal with negative costs
-			// (which may arise due to floating-point drift)
-			// nor with zero-cost nodes (see MP::SetMapData,
-			// threat is not used as an additive overlay)
-			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
-			airThreat[index] = std::max<float>(airThreat[index] - heat, THREAT_BASE);
-
-//			currSumThreat -= heat;
-		}
-	}
-
-//	currAvgThreat = currSumThreat / landThreat.size();
+	grid.DelAir(posx, posz, e->GetThreat()/* + THREAT_DECAY*/, e->GetRange(CCircuitDef::ThreatType::AIR));
 }
 
 void CThreatMap::AddEnemyAmph(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-	const int widthSec = width - 2;
-
-	const float threat = e->GetThreat()/* - THREAT_DECAY*/;
-	const int rangeLand = e->GetRange(CCircuitDef::ThreatType::LAND);
-	const int rangeLandSq = SQUARE(rangeLand);
-	const int rangeWater = e->GetRange(CCircuitDef::ThreatType::WATER);
-	const int rangeWaterSq = SQUARE(rangeWater);
-	const int range = std::max(rangeLand, rangeWater);
-	const std::vector<STerrainMapSector>& sector = areaData->sector;
-
-	const int beginX = std::max(int(posx - range + 1),          1);
-	const int endX   = std::min(int(posx + range    ),  width - 1);
-	const int beginZ = std::max(int(posz - range + 1),          1);
-	const int endZ   = std::min(int(posz + range    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-
-			const int sum = dxSq + dzSq;
-			const int index = z * width + x;
-			const int idxSec = (z - 1) * widthSec + (x - 1);
-			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
-			bool isWaterThreat = (sum <= rangeWaterSq) && sector[idxSec].isWater;
-			if (isWaterThreat || ((sum <= rangeLandSq) && (sector[idxSec].position.y >= -SQUARE_SIZE * 5)))
-			{
-				amphThreat[index] += heat;
-			}
-			if (isWaterThreat || (sum <= rangeLandSq)) {
-				surfThreat[index] += heat;
-			}
-		}
-	}
+	grid.AddAmph(posx, posz, e->GetThreat()/* - THREAT_DECAY*/, e->GetRange(CCircuitDef::ThreatType::LAND),
+				 e->GetRange(CCircuitDef::ThreatType::WATER), areaData->sector);
 }
 
 void CThreatMap::DelEnemyAmph(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-	const int widthSec = width - 2;
-
-	const float threat = e->GetThreat()/* + THREAT_DECAY*/;
-	const int rangeLand = e->GetRange(CCircuitDef::ThreatType::LAND);
-	const int rangeLandSq = SQUARE(rangeLand);
-	const int rangeWater = e->GetRange(CCircuitDef::ThreatType::WATER);
-	const int rangeWaterSq = SQUARE(rangeWater);
-	const int range = std::max(rangeLand, rangeWater);
-	const std::vector<STerrainMapSector>& sector = areaData->sector;
-
-	const int beginX = std::max(int(posx - range + 1),          1);
-	const int endX   = std::min(int(posx + range    ),  width - 1);
-	const int beginZ = std::max(int(posz - range + 1),          1);
-	const int endZ   = std::min(int(posz + range    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-
-			const int sum = dxSq + dzSq;
-			const int index = z * width + x;
-			const int idxSec = (z - 1) * widthSec + (x - 1);
-			const float heat = threat * (1.5f - 1.0f * sqrtf(sum) / range);
-			bool isWaterThreat = (sum <= rangeWaterSq) && sector[idxSec].isWater;
-			if (isWaterThreat || ((sum <= rangeLandSq) && (sector[idxSec].position.y >= -SQUARE_SIZE * 5)))
-			{
-				amphThreat[index] = std::max<float>(amphThreat[index] - heat, THREAT_BASE);
-			}
-			if (isWaterThreat || (sum <= rangeLandSq)) {
-				surfThreat[index] = std::max<float>(surfThreat[index] - heat, THREAT_BASE);
-			}
-		}
-	}
+	grid.DelAmph(posx, posz, e->GetThreat()/* + THREAT_DECAY*/, e->GetRange(CCircuitDef::ThreatType::LAND),
+				 e->GetRange(CCircuitDef::ThreatType::WATER), areaData->sector);
 }
 
 void CThreatMap::AddDecloaker(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float threatCloak = 16 * THREAT_BASE;
-	const int rangeCloak = e->GetRange(CCircuitDef::ThreatType::CLOAK);
-	const int rangeCloakSq = SQUARE(rangeCloak);
-
-	// For small decloak ranges full range shouldn't hit performance
-	const int beginX = std::max(int(posx - rangeCloak + 1),          1);
-	const int endX   = std::min(int(posx + rangeCloak    ),  width - 1);
-	const int beginZ = std::max(int(posz - rangeCloak + 1),          1);
-	const int endZ   = std::min(int(posz + rangeCloak    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-			const int sum = dxSq + dzSq;
-			if (sum > rangeCloakSq) {
-				continue;
-			}
-
-			const int index = z * width + x;
-			const float heat = threatCloak * (1.0f - 0.5f * sqrtf(sum) / rangeCloak);
-			cloakThreat[index] += heat;
-		}
-	}
+	grid.AddDecloaker(posx, posz, e->GetRange(CCircuitDef::ThreatType::CLOAK));
 }
 
 void CThreatMap::DelDecloaker(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float threatCloak = 16 * THREAT_BASE;
-	const int rangeCloak = e->GetRange(CCircuitDef::ThreatType::CLOAK);
-	const int rangeCloakSq = SQUARE(rangeCloak);
-
-	// For small decloak ranges full range shouldn't hit performance
-	const int beginX = std::max(int(posx - rangeCloak + 1),          1);
-	const int endX   = std::min(int(posx + rangeCloak    ),  width - 1);
-	const int beginZ = std::max(int(posz - rangeCloak + 1),          1);
-	const int endZ   = std::min(int(posz + rangeCloak    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int dxSq = SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			const int dzSq = SQUARE(posz - z);
-			const int sum = dxSq + dzSq;
-			if (sum > rangeCloakSq) {
-				continue;
-			}
-
-			const int index = z * width + x;
-			const float heat = threatCloak * (1.0f - 0.5f * sqrtf(sum) / rangeCloak);
-			cloakThreat[index] = std::max<float>(cloakThreat[index] - heat, THREAT_BASE);
-		}
-	}
+	grid.DelDecloaker(posx, posz, e->GetRange(CCircuitDef::ThreatType::CLOAK));
 }
 
 void CThreatMap::AddShield(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float shieldVal = e->GetShieldPower();
-	const int rangeShield = e->GetRange(CCircuitDef::ThreatType::SHIELD);
-	const int rangeShieldSq = SQUARE(rangeShield);
-
-	const int beginX = std::max(int(posx - rangeShield + 1),          1);
-	const int endX   = std::min(int(posx + rangeShield    ),  width - 1);
-	const int beginZ = std::max(int(posz - rangeShield + 1),          1);
-	const int endZ   = std::min(int(posz + rangeShield    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int rrx = rangeShieldSq - SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			if (SQUARE(posz - z) > rrx) {
-				continue;
-			}
-			shield[z * width + x] += shieldVal;
-		}
-	}
+	grid.AddShield(posx, posz, e->GetShieldPower(), e->GetRange(CCircuitDef::ThreatType::SHIELD));
 }
 
 void CThreatMap::DelShield(const CEnemyUnit* e)
 {
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
-
-	const float shieldVal = e->GetShieldPower();
-	const int rangeShield = e->GetRange(CCircuitDef::ThreatType::SHIELD);
-	const int rangeShieldSq = SQUARE(rangeShield);
-
-	const int beginX = std::max(int(posx - rangeShield + 1),          1);
-	const int endX   = std::min(int(posx + rangeShield    ),  width - 1);
-	const int beginZ = std::max(int(posz - rangeShield + 1),          1);
-	const int endZ   = std::min(int(posz + rangeShield    ), height - 1);
-
-	for (int x = beginX; x < endX; ++x) {
-		const int rrx = rangeShieldSq - SQUARE(posx - x);
-		for (int z = beginZ; z < endZ; ++z) {
-			if (SQUARE(posz - z) > rrx) {
-				continue;
-			}
-			const int index = z * width + x;
-			shield[index] = std::max(shield[index] - shieldVal, 0.f);
-		}
-	}
+	grid.DelShield(posx, posz, e->GetShieldPower(), e->GetRange(CCircuitDef::ThreatType::SHIELD));
 }
 
 void CThreatMap::SetEnemyUnitRange(CEnemyUnit* e) const
@@ -772,7 +618,7 @@ float CThreatMap::GetEnemyUnitThreat(CEnemyUnit* enemy) const
 	}
 	int x, z;
 	PosToXZ(enemy->GetPos(), x, z);
-	return enemy->GetDamage() * sqrtf(health + shield[z * width + x] * 2.0f);  // / unit->GetUnit()->GetMaxHealth();
+	return enemy->GetDamage() * sqrtf(health + grid.shield[z * grid.width + x] * 2.0f);  // / unit->GetUnit()->GetMaxHealth();
 }
 
 bool CThreatMap::IsInLOS(const AIFloat3& pos) const
@@ -817,26 +663,26 @@ void CThreatMap::UpdateVis()
 	Uint32 sdlWindowId;
 	float* dbgMap;
 	std::tie(sdlWindowId, dbgMap) = sdlWindows[0];
-	for (unsigned i = 0; i < airThreat.size(); ++i) {
-		dbgMap[i] = std::min<float>((airThreat[i] - THREAT_BASE) / 40.0f /*currMaxThreat*/, 1.0f);
+	for (unsigned i = 0; i < grid.airThreat.size(); ++i) {
+		dbgMap[i] = std::min<float>((grid.airThreat[i] - THREAT_BASE) / 40.0f /*currMaxThreat*/, 1.0f);
 	}
 	circuit->GetDebugDrawer()->DrawMap(sdlWindowId, dbgMap);
 
 	std::tie(sdlWindowId, dbgMap) = sdlWindows[1];
-	for (unsigned i = 0; i < surfThreat.size(); ++i) {
-		dbgMap[i] = std::min<float>((surfThreat[i] - THREAT_BASE) / 40.0f, 1.0f);
+	for (unsigned i = 0; i < grid.surfThreat.size(); ++i) {
+		dbgMap[i] = std::min<float>((grid.surfThreat[i] - THREAT_BASE) / 40.0f, 1.0f);
 	}
 	circuit->GetDebugDrawer()->DrawMap(sdlWindowId, dbgMap);
 
 	std::tie(sdlWindowId, dbgMap) = sdlWindows[2];
-	for (unsigned i = 0; i < amphThreat.size(); ++i) {
-		dbgMap[i] = std::min<float>((amphThreat[i] - THREAT_BASE) / 40.0f, 1.0f);
+	for (unsigned i = 0; i < grid.amphThreat.size(); ++i) {
+		dbgMap[i] = std::min<float>((grid.amphThreat[i] - THREAT_BASE) / 40.0f, 1.0f);
 	}
 	circuit->GetDebugDrawer()->DrawMap(sdlWindowId, dbgMap);
 
 	std::tie(sdlWindowId, dbgMap) = sdlWindows[3];
-	for (unsigned i = 0; i < cloakThreat.size(); ++i) {
-		dbgMap[i] = std::min<float>((cloakThreat[i] - THREAT_BASE) / 16.0f, 1.0f);
+	for (unsigned i = 0; i < grid.cloakThreat.size(); ++i) {
+		dbgMap[i] = std::min<float>((grid.cloakThreat[i] - THREAT_BASE) / 16.0f, 1.0f);
 	}
 	circuit->GetDebugDrawer()->DrawMap(sdlWindowId, dbgMap);
 }
@@ -848,24 +694,24 @@ void CThreatMap::ToggleVis()
 		std::pair<Uint32, float*> win;
 		std::string label;
 
-		win.second = new float [airThreat.size()];
+		win.second = new float [grid.airThreat.size()];
 		label = utils::int_to_string(circuit->GetSkirmishAIId(), "Circuit AI [%i] :: AIR Threat Map");
-		win.first = circuit->GetDebugDrawer()->AddSDLWindow(width, height, label.c_str());
+		win.first = circuit->GetDebugDrawer()->AddSDLWindow(grid.width, grid.height, label.c_str());
 		sdlWindows.push_back(win);
 
-		win.second = new float [surfThreat.size()];
+		win.second = new float [grid.surfThreat.size()];
 		label = utils::int_to_string(circuit->GetSkirmishAIId(), "Circuit AI [%i] :: SURFACE Threat Map");
-		win.first = circuit->GetDebugDrawer()->AddSDLWindow(width, height, label.c_str());
+		win.first = circuit->GetDebugDrawer()->AddSDLWindow(grid.width, grid.height, label.c_str());
 		sdlWindows.push_back(win);
 
-		win.second = new float [amphThreat.size()];
+		win.second = new float [grid.amphThreat.size()];
 		label = utils::int_to_string(circuit->GetSkirmishAIId(), "Circuit AI [%i] :: AMPHIBIOUS Threat Map");
-		win.first = circuit->GetDebugDrawer()->AddSDLWindow(width, height, label.c_str());
+		win.first = circuit->GetDebugDrawer()->AddSDLWindow(grid.width, grid.height, label.c_str());
 		sdlWindows.push_back(win);
 
-		win.second = new float [cloakThreat.size()];
+		win.second = new float [grid.cloakThreat.size()];
 		label = utils::int_to_string(circuit->GetSkirmishAIId(), "Circuit AI [%i] :: CLOAK Threat Map");
-		win.first = circuit->GetDebugDrawer()->AddSDLWindow(width, height, label.c_str());
+		win.first = circuit->GetDebugDrawer()->AddSDLWindow(grid.width, grid.height, label.c_str());
 		sdlWindows.push_back(win);
 
 		UpdateVis();
@@ -9,6 +9,7 @@
 #ifndef SRC_CIRCUIT_TERRAIN_THREATMAP_H_
 #define SRC_CIRCUIT_TERRAIN_THREATMAP_H_
 
+#include "terrain/ThreatGrid.h"
 #include "CircuitAI.h"
 
 #include <map>
@@ -42,24 +43,28 @@ public:
 	void SetThreatType(CCircuitUnit* unit);
 	float GetThreatAt(const springai::AIFloat3& position) const;
 	float GetThreatAt(CCircuitUnit* unit, const springai::AIFloat3& position) const;
-
-	float* GetAirThreatArray() { return &airThreat[0]; }
-	float* GetSurfThreatArray() { return &surfThreat[0]; }
-	float* GetAmphThreatArray() { return &amphThreat[0]; }
-	float* GetCloakThreatArray() { return &cloakThreat[0]; }
-	int GetThreatMapWidth() const { return width; }
-	int GetThreatMapHeight() const { return height; }
+	const float* GetThreatLayer() const { return threatArray; }  // current layer of SetThreatType
+
+	float* GetAirThreatArray() { return &grid.airThreat[0]; }
+	float* GetSurfThreatArray() { return &grid.surfThreat[0]; }
+	float* GetAmphThreatArray() { return &grid.amphThreat[0]; }
+	float* GetCloakThreatArray() { return &grid.cloakThreat[0]; }
+	int GetThreatMapWidth() const { return grid.width; }
+	int GetThreatMapHeight() const { return grid.height; }
+
+	// Threat over cells of metal cluster (centre and spots), refreshed on Update.
+	// Cell of the threat map is a terrain sector, thus sector summary is GetThreatAt.
+	float GetClusterThreat(int cluster) const;  // max, current layer of SetThreatType
+	float GetAllClusterThreat(int cluster) const;  // max, @see GetAllThreatAt
+	// Clusters with changed safety (threat > THREAT_MIN) in any layer on update number GetClusterUpdateNum
+	const std::vector<int>& GetDirtyClusters() const { return dirtyClusters; }
+	int GetClusterUpdateNum() const { return clusterUpdateNum; }
 
 	float GetUnitThreat(CCircuitUnit* unit) const;
 	int GetSquareSize() const { return squareSize; }
-	int GetMapSize() const { return mapSize; }
+	int GetMapSize() const { return grid.mapSize; }
 
 private:
-	/*
-	 * http://stackoverflow.com/questions/872544/precision-of-floating-point
-	 * Single precision: for accuracy of +/-0.5 (or 2^-1) the maximum size that the number can be is 2^23.
-	 */
-	using Threats = std::vector<float>;
 	CCircuitAI* circuit;
 	SAreaData* areaData;
 
@@ -86,28 +91,33 @@ private:
 	bool IsInLOS(const springai::AIFloat3& pos) const;
 //	bool IsInRadar(const springai::AIFloat3& pos) const;
 
+	enum Layer: int {AIR = 0, SURF, AMPH, _SIZE_};
+	int GetLayer() const;
+	void UpdateClusters();
+
 //	float currAvgThreat;
 //	float currMaxThreat;
 //	float currSumThreat;
 
 	int squareSize;
-	int width;
-	int height;
-	int mapSize;
 
 	int rangeDefault;
 	int distCloak;
 
 	CCircuitAI::EnemyUnits hostileUnits;
 	CCircuitAI::EnemyUnits peaceUnits;
-	Threats airThreat;  // air layer
-	Threats surfThreat;  // surface (water and land)
-	Threats amphThreat;  // under water and surface on land
-	Threats cloakThreat;
-	Threats shield;
+	SThreatGrid grid;
 	float* threatArray;
 	// TODO: shield-map - units under shield should get threat boost
 
+	struct SClusterThreat {
+		std::vector<int> cells;  // threat map indices
+		float maxThreat[Layer::_SIZE_];
+	};
+	std::vector<SClusterThreat> clusterThreats;
+	std::vector<int> dirtyClusters;
+	int clusterUpdateNum;
+
 //	std::vector<int> radarMap;
 	std::vector<int> sonarMap;
 	std::vector<int> losMap;
@@ -9,6 +9,7 @@
 #include "unit/FactoryData.h"
 #include "resource/MetalManager.h"
 #include "resource/EnergyGrid.h"
+#include "resource/FeatureRegistry.h"
 #include "setup/DefenceMatrix.h"
 #include "setup/SetupManager.h"
 #include "terrain/PathFinder.h"
@@ -17,15 +18,22 @@
 #include "util/GameAttribute.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
+#include "json/json.h"
 
+#include "SSkirmishAICallback.h"
 #include "AIFloat3.h"
 #include "OOAICallback.h"
+#include "Map.h"
 #include "Team.h"
+#include "WrappUnit.h"
 
 namespace circuit {
 
 using namespace springai;
 
+#define FRIENDLY_CELL_SIZE	256
+#define FRIENDLY_POS_TTL	(FRAMES_PER_SEC / 2)  // frames between samples of a mobile unit
+
 bool CAllyTeam::SBox::ContainsPoint(const AIFloat3& point) const
 {
 	return (point.x >= left) && (point.x <= right) &&
@@ -38,6 +46,12 @@ CAllyTeam::CAllyTeam(const TeamIds& tids, const SBox& sb)
 		, initCount(0)
 		, resignSize(0)
 		, lastUpdate(-1)
+		, isEngineQuery(false)
+		, gridFrame(-1)
+		, gridColumns(0)
+		, gridRows(0)
+		, maxUnitRadius(0.f)
+		, maxUnitSpeed(0.f)
 {
 }
 
@@ -68,27 +82,42 @@ void CAllyTeam::Init(CCircuitAI* circuit)
 	circuit->GetScheduler()->RunTaskAt(std::make_shared<CGameTask>(&CMetalManager::Init, metalManager));
 
 	energyGrid = std::make_shared<CEnergyGrid>(circuit);
+	featureRegistry = std::make_shared<CFeatureRegistry>(circuit);
 	defence = std::make_shared<CDefenceMatrix>(circuit);
 	pathfinder = std::make_shared<CPathFinder>(&circuit->GetGameAttribute()->GetTerrainData());
 	factoryData = std::make_shared<CFactoryData>(circuit);
 
+	isEngineQuery = circuit->GetSetupManager()->GetConfig()["debug"].get("engine_query", false).asBool();
+	pathfinder->GetStats().SetEnabled(circuit->GetSetupManager()->GetConfig()["debug"].get("path_stats", false).asBool());
+	const std::string openList = circuit->GetSetupManager()->GetConfig()["debug"].get("open_list", "binary").asString();
+	if (openList == "quad") {
+		pathfinder->SetOpenListType(NSMicroPather::OpenListType::QUAD_HEAP);
+	} else if (openList == "radix") {
+		pathfinder->SetOpenListType(NSMicroPather::OpenListType::RADIX_HEAP);
+	}
+	Map* map = circuit->GetMap();
+	gridColumns = (map->GetWidth() * SQUARE_SIZE + FRIENDLY_CELL_SIZE - 1) / FRIENDLY_CELL_SIZE;
+	gridRows = (map->GetHeight() * SQUARE_SIZE + FRIENDLY_CELL_SIZE - 1) / FRIENDLY_CELL_SIZE;
+	friendlyGrid.resize(gridColumns * gridRows);
+
 	circuit->GetScheduler()->RunOnRelease(std::make_shared<CGameTask>(&CAllyTeam::DelegateAuthority, this, circuit));
 }
 
 void CAllyTeam::Release()
 {
 	resignSize++;
+	// Friendly units may hold wrappers and defs of the releasing member, next query rebuilds them
+	ClearFriendlyUnits();
+	lastUpdate = -1;
 	if (--initCount > 0) {
 		return;
 	}
 
-	for (auto& kv : friendlyUnits) {
-		delete kv.second;
-	}
-	friendlyUnits.clear();
+	friendlyGrid.clear();
 
 	metalManager = nullptr;
 	energyGrid = nullptr;
+	featureRegistry = nullptr;
 	defence = nullptr;
 	pathfinder = nullptr;
 	factoryData = nullptr;
@@ -96,28 +125,46 @@ void CAllyTeam::Release()
 
 void CAllyTeam::UpdateFriendlyUnits(CCircuitAI* circuit)
 {
-	if (lastUpdate >= circuit->GetLastFrame()) {
+	const int frame = circuit->GetLastFrame();
+	if (lastUpdate >= frame) {
 		return;
 	}
 
-	for (auto& kv : friendlyUnits) {
-		delete kv.second;
+	// Alive units keep their CAllyUnit, engine wrappers are allocated only for new ids
+	const SSkirmishAICallback* sAICallback = circuit->GetSkirmishAICallback();
+	const int skirmishAIId = circuit->GetSkirmishAIId();
+	std::vector<ICoreUnit::Id> unitIds(sAICallback->getFriendlyUnits(skirmishAIId, nullptr, -1));
+	if (!unitIds.empty()) {
+		const int size = sAICallback->getFriendlyUnits(skirmishAIId, unitIds.data(), unitIds.size());
+		unitIds.resize(size);
 	}
-	friendlyUnits.clear();
-	const std::vector<Unit*>& units = circuit->GetCallback()->GetFriendlyUnits();
-	for (Unit* u : units) {
-		// FIXME: Why engine returns vector with some nullptrs?
-		// TODO: Check every GetEnemy/FriendlyUnits for nullptr
+
+	Units newUnits;
+	for (ICoreUnit::Id unitId : unitIds) {
+		CCircuitDef* cdef = circuit->GetCircuitDef(sAICallback->Unit_getDef(skirmishAIId, unitId));
+		if (cdef == nullptr) {
+			continue;
+		}
+		auto it = friendlyUnits.find(unitId);
+		// NOTE: CCircuitDef is per member, id keeps units of other member's update
+		if ((it != friendlyUnits.end()) && (it->second->GetCircuitDef()->GetId() == cdef->GetId())) {
+			newUnits[unitId] = it->second;
+			friendlyUnits.erase(it);
+			continue;
+		}
+		Unit* u = WrappUnit::GetInstance(skirmishAIId, unitId);
 		if (u == nullptr) {
 			continue;
 		}
-		int unitId = u->GetUnitId();
-		UnitDef* unitDef = u->GetDef();
-		CAllyUnit* unit = new CAllyUnit(unitId, u, circuit->GetCircuitDef(unitDef->GetUnitDefId()));
-		delete unitDef;
-		friendlyUnits[unitId] = unit;
+		newUnits[unitId] = new CAllyUnit(unitId, u, cdef);
+		gridPending.push_back(unitId);
 	}
-	lastUpdate = circuit->GetLastFrame();
+	for (auto& kv : friendlyUnits) {  // dead units
+		RemoveFriendly(kv.second);
+		delete kv.second;
+	}
+	friendlyUnits = std::move(newUnits);
+	lastUpdate = frame;
 }
 
 CAllyUnit* CAllyTeam::GetFriendlyUnit(ICoreUnit::Id unitId) const
@@ -126,6 +173,56 @@ CAllyUnit* CAllyTeam::GetFriendlyUnit(ICoreUnit::Id unitId) const
 	return (it != friendlyUnits.end()) ? it->second : nullptr;
 }
 
+void CAllyTeam::ForEachFriendlyInRadius(CCircuitAI* circuit, const AIFloat3& pos, float radius,
+										const FriendlyFunc& func)
+{
+	UpdateFriendlyUnits(circuit);
+
+	if (isEngineQuery) {
+		auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius));
+		for (Unit* u : units) {
+			CAllyUnit* unit = (u == nullptr) ? nullptr : GetFriendlyUnit(u->GetUnitId());
+			if ((unit != nullptr) && func(unit)) {
+				break;
+			}
+		}
+		utils::free_clear(units);
+		return;
+	}
+
+	UpdateFriendlyGrid();
+
+	const float range = radius + maxUnitRadius + maxUnitSpeed * FRIENDLY_POS_TTL;
+	const int x1 = utils::clamp(int((pos.x - range) / FRIENDLY_CELL_SIZE), 0, gridColumns - 1);
+	const int x2 = utils::clamp(int((pos.x + range) / FRIENDLY_CELL_SIZE), 0, gridColumns - 1);
+	const int z1 = utils::clamp(int((pos.z - range) / FRIENDLY_CELL_SIZE), 0, gridRows - 1);
+	const int z2 = utils::clamp(int((pos.z + range) / FRIENDLY_CELL_SIZE), 0, gridRows - 1);
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			for (const SFriendly& friendly : friendlyGrid[z * gridColumns + x]) {
+				// NOTE: Engine tests sphere around unit's midPos, 2D is good enough for AI
+				const float maxDist = radius + friendly.radius;
+				if ((friendly.frame == lastUpdate) || !friendly.unit->GetCircuitDef()->IsMobile()) {
+					if (pos.SqDistance2D(friendly.pos) > SQUARE(maxDist)) {
+						continue;
+					}
+				} else {
+					// Old sample: cull by the distance any unit could travel since, then test actual position
+					const float drift = maxUnitSpeed * (lastUpdate - friendly.frame);
+					if ((pos.SqDistance2D(friendly.pos) > SQUARE(maxDist + drift))
+						|| (pos.SqDistance2D(friendly.unit->GetPos(lastUpdate)) > SQUARE(maxDist)))
+					{
+						continue;
+					}
+				}
+				if (func(friendly.unit)) {
+					return;
+				}
+			}
+		}
+	}
+}
+
 void CAllyTeam::OccupyCluster(int clusterId, int teamId)
 {
 	auto it = occupants.find(clusterId);
@@ -151,10 +248,102 @@ void CAllyTeam::DelegateAuthority(CCircuitAI* curOwner)
 		if (circuit->IsInitialized() && (circuit != curOwner) && (circuit->GetAllyTeamId() == curOwner->GetAllyTeamId())) {
 			metalManager->SetAuthority(circuit);
 			energyGrid->SetAuthority(circuit);
+			featureRegistry->SetAuthority(circuit);
 			circuit->GetScheduler()->RunOnRelease(std::make_shared<CGameTask>(&CAllyTeam::DelegateAuthority, this, circuit));
 			break;
 		}
 	}
 }
 
+void CAllyTeam::ClearFriendlyUnits()
+{
+	for (auto& kv : friendlyUnits) {
+		delete kv.second;
+	}
+	friendlyUnits.clear();
+	for (std::vector<SFriendly>& cell : friendlyGrid) {
+		cell.clear();
+	}
+	friendlyCells.clear();
+	gridPending.clear();
+	gridResample.clear();
+	gridFrame = -1;
+	maxUnitRadius = maxUnitSpeed = 0.f;
+}
+
+/*
+ * Only new units and mobile units with sample older than FRIENDLY_POS_TTL touch the engine,
+ * static units are sampled once
+ */
+void CAllyTeam::UpdateFriendlyGrid()
+{
+	if (gridFrame >= lastUpdate) {
+		return;
+	}
+	gridFrame = lastUpdate;
+
+	for (ICoreUnit::Id unitId : gridPending) {
+		CAllyUnit* unit = GetFriendlyUnit(unitId);
+		if ((unit != nullptr) && (friendlyCells.find(unitId) == friendlyCells.end())) {
+			InsertFriendly(unit);
+		}
+	}
+	gridPending.clear();
+
+	while (!gridResample.empty() && (gridResample.front().first + FRIENDLY_POS_TTL <= lastUpdate)) {
+		const int frame = gridResample.front().first;
+		CAllyUnit* unit = GetFriendlyUnit(gridResample.front().second);
+		gridResample.pop_front();
+		auto it = friendlyCells.find((unit != nullptr) ? unit->GetId() : -1);
+		if (it == friendlyCells.end()) {
+			continue;  // dead
+		}
+		std::vector<SFriendly>& cell = friendlyGrid[it->second];
+		auto fit = std::find_if(cell.begin(), cell.end(), [unit](const SFriendly& f) { return f.unit == unit; });
+		if ((fit == cell.end()) || (fit->frame != frame)) {
+			continue;  // outdated entry of reused id
+		}
+		*fit = cell.back();
+		cell.pop_back();
+		friendlyCells.erase(it);
+		InsertFriendly(unit);
+	}
+}
+
+void CAllyTeam::InsertFriendly(CAllyUnit* unit)
+{
+	CCircuitDef* cdef = unit->GetCircuitDef();
+	SFriendly friendly;
+	friendly.unit = unit;
+	friendly.pos = unit->GetPos(lastUpdate);
+	friendly.radius = cdef->GetRadius();
+	friendly.frame = lastUpdate;
+	maxUnitRadius = std::max(maxUnitRadius, friendly.radius);
+	if (cdef->IsMobile()) {
+		maxUnitSpeed = std::max(maxUnitSpeed, cdef->GetSpeed() / FRAMES_PER_SEC);
+		gridResample.push_back(std::make_pair(lastUpdate, unit->GetId()));
+	}
+	const int x = utils::clamp(int(friendly.pos.x / FRIENDLY_CELL_SIZE), 0, gridColumns - 1);
+	const int z = utils::clamp(int(friendly.pos.z / FRIENDLY_CELL_SIZE), 0, gridRows - 1);
+	const int index = z * gridColumns + x;
+	friendlyGrid[index].push_back(friendly);
+	friendlyCells[unit->GetId()] = index;
+}
+
+void CAllyTeam::RemoveFriendly(CAllyUnit* unit)
+{
+	auto it = friendlyCells.find(unit->GetId());
+	if (it == friendlyCells.end()) {
+		return;
+	}
+	std::vector<SFriendly>& cell = friendlyGrid[it->second];
+	auto fit = std::find_if(cell.begin(), cell.end(), [unit](const SFriendly& f) { return f.unit == unit; });
+	if (fit == cell.end()) {
+		return;  // id is taken by another unit
+	}
+	*fit = cell.back();
+	cell.pop_back();
+	friendlyCells.erase(it);
+}
+
 } // namespace circuit
@@ -10,9 +10,13 @@
 
 #include "unit/AllyUnit.h"
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace springai {
 	class AIFloat3;
@@ -23,6 +27,7 @@ namespace circuit {
 class CCircuitAI;
 class CMetalManager;
 class CEnergyGrid;
+class CFeatureRegistry;
 class CDefenceMatrix;
 class CPathFinder;
 class CFactoryData;
@@ -50,6 +55,7 @@ public:
 		int teamId;  // cluster leader
 		unsigned count;  // number of commanders
 	};
+	using FriendlyFunc = std::function<bool (CAllyUnit* unit)>;  // return true to stop iteration
 
 public:
 	CAllyTeam(const TeamIds& tids, const SBox& sb);
@@ -66,9 +72,16 @@ public:
 	void UpdateFriendlyUnits(CCircuitAI* circuit);
 	CAllyUnit* GetFriendlyUnit(ICoreUnit::Id unitId) const;
 	const Units& GetFriendlyUnits() const { return friendlyUnits; }
+	/*
+	 * Calls func for every friendly unit which footprint touches the circle (2D),
+	 * the same units as OOAICallback::GetFriendlyUnitsIn but without engine wrappers.
+	 */
+	void ForEachFriendlyInRadius(CCircuitAI* circuit, const springai::AIFloat3& pos, float radius,
+								 const FriendlyFunc& func);
 
 	std::shared_ptr<CMetalManager>& GetMetalManager() { return metalManager; }
 	std::shared_ptr<CEnergyGrid>& GetEnergyGrid() { return energyGrid; }
+	std::shared_ptr<CFeatureRegistry>& GetFeatureRegistry() { return featureRegistry; }
 	std::shared_ptr<CDefenceMatrix>& GetDefenceMatrix() { return defence; }
 	std::shared_ptr<CPathFinder>& GetPathfinder() { return pathfinder; }
 	std::shared_ptr<CFactoryData>& GetFactoryData() { return factoryData; }
@@ -78,6 +91,10 @@ public:
 
 private:
 	void DelegateAuthority(CCircuitAI* curOwner);
+	void ClearFriendlyUnits();
+	void UpdateFriendlyGrid();
+	void InsertFriendly(CAllyUnit* unit);
+	void RemoveFriendly(CAllyUnit* unit);
 
 	TeamIds teamIds;
 	SBox startBox;
@@ -87,10 +104,28 @@ private:
 	int lastUpdate;
 	Units friendlyUnits;  // owner
 
+	struct SFriendly {
+		CAllyUnit* unit;
+		springai::AIFloat3 pos;  // sampled on frame
+		float radius;
+		int frame;
+	};
+	bool isEngineQuery;  // validation: use OOAICallback::GetFriendlyUnitsIn
+	int gridFrame;
+	int gridColumns;
+	int gridRows;
+	float maxUnitRadius;
+	float maxUnitSpeed;  // elmos per frame
+	std::vector<std::vector<SFriendly>> friendlyGrid;
+	std::unordered_map<ICoreUnit::Id, int> friendlyCells;  // unit: cell index
+	std::vector<ICoreUnit::Id> gridPending;  // new units, not in grid yet
+	std::deque<std::pair<int, ICoreUnit::Id>> gridResample;  // mobile units ordered by sample frame
+
 	std::map<int, SClusterTeam> occupants;  // Cluster owner on start. clusterId: SClusterTeam
 
 	std::shared_ptr<CMetalManager> metalManager;
 	std::shared_ptr<CEnergyGrid> energyGrid;
+	std::shared_ptr<CFeatureRegistry> featureRegistry;
 	std::shared_ptr<CDefenceMatrix> defence;
 	std::shared_ptr<CPathFinder> pathfinder;
 	std::shared_ptr<CFactoryData> factoryData;
@@ -215,6 +215,7 @@ public:
 	float GetRetreat()   const { return retreat; }
 
 	bool IsYTargetable(float elevation, float posY);
+	float GetRadius();
 	const springai::AIFloat3& GetMidPosOffset() const { return midPosOffset; }
 
 private:
@@ -288,6 +289,7 @@ private:
 
 	float height;
 	float topOffset;  // top point offset in water
+	float radius;
 	springai::AIFloat3 midPosOffset;
 };
 
@@ -21,6 +21,19 @@ namespace circuit {
 
 using namespace springai;
 
+#define RULES_HOT_RATE	(FRAMES_PER_SEC * 2)
+
+decltype(CCircuitUnit::rulesKeys) CCircuitUnit::rulesKeys = {{
+	// name, default value, refresh rate, is hot
+	{"disarmed",         0.f, 1,              false},  // RulesParam::DISARMED
+	{"noammo",           0.f, 1,              false},  // RulesParam::NO_AMMO
+	{"jumpReload",       1.f, 1,              false},  // RulesParam::JUMP_RELOAD
+	{"is_jumping",       0.f, 1,              false},  // RulesParam::IS_JUMPING
+	{"buildpower_mult",  1.f, RULES_HOT_RATE, true},   // RulesParam::BUILDPOWER_MULT
+	{"comm_range_mult",  1.f, RULES_HOT_RATE, true},   // RulesParam::COMM_RANGE_MULT
+	{"disableAiControl", 0.f, 1,              false},  // RulesParam::DISABLE_AI_CONTROL
+}};
+
 CCircuitUnit::CCircuitUnit(Id unitId, Unit* unit, CCircuitDef* cdef)
 		: CAllyUnit(unitId, unit, cdef)
 		, taskFrame(-1)
@@ -31,12 +44,16 @@ CCircuitUnit::CCircuitUnit(Id unitId, Unit* unit, CCircuitDef* cdef)
 		, failFrame(-1)
 		, isForceExecute(false)
 		, isDead(false)
-		, isDisarmed(false)
-		, disarmFrame(-1)
 		, isWeaponReady(true)
 		, ammoFrame(-1)
 		, isMorphing(false)
 {
+	for (SRulesValue& rv : rulesValues) {
+		rv.value = 0.f;
+		rv.expireFrame = 0;
+	}
+	rulesStats.reads = rulesStats.hits = 0;
+
 	WeaponMount* wpMnt;
 	if (cdef->IsRoleComm()) {
 		dgun = nullptr;
@@ -116,11 +133,7 @@ void CCircuitUnit::ManualFire(CEnemyUnit* target, int timeOut)
 
 bool CCircuitUnit::IsDisarmed(int frame)
 {
-	if (disarmFrame != frame) {
-		disarmFrame = frame;
-		isDisarmed = unit->GetRulesParamFloat("disarmed", 0) > 0.f;
-	}
-	return isDisarmed;
+	return GetRulesParam(RulesParam::DISARMED, frame) > 0.f;
 }
 
 bool CCircuitUnit::IsWeaponReady(int frame)
@@ -128,7 +141,7 @@ bool CCircuitUnit::IsWeaponReady(int frame)
 	if (ammoFrame != frame) {
 		ammoFrame = frame;
 		if (circuitDef->IsPlane()) {
-			isWeaponReady = unit->GetRulesParamFloat("noammo", 0) < 1.f;
+			isWeaponReady = GetRulesParam(RulesParam::NO_AMMO, frame) < 1.f;
 		} else {
 			isWeaponReady = (weapon == nullptr) ? false : weapon->GetReloadFrame() <= frame;
 		}
@@ -146,14 +159,14 @@ bool CCircuitUnit::IsShieldCharged(float percent)
 	return shield->GetShieldPower() > circuitDef->GetMaxShield() * percent;
 }
 
-bool CCircuitUnit::IsJumpReady()
+bool CCircuitUnit::IsJumpReady(int frame)
 {
-	return circuitDef->IsAbleToJump() && !(unit->GetRulesParamFloat("jumpReload", 1) < 1.f);
+	return circuitDef->IsAbleToJump() && !(GetRulesParam(RulesParam::JUMP_RELOAD, frame) < 1.f);
 }
 
-bool CCircuitUnit::IsJumping()
+bool CCircuitUnit::IsJumping(int frame)
 {
-	return unit->GetRulesParamFloat("is_jumping", 0) > 0.f;
+	return GetRulesParam(RulesParam::IS_JUMPING, frame) > 0.f;
 }
 
 float CCircuitUnit::GetDamage()
@@ -177,14 +190,14 @@ float CCircuitUnit::GetShieldPower()
 	return 0.f;
 }
 
-float CCircuitUnit::GetBuildSpeed()
+float CCircuitUnit::GetBuildSpeed(int frame)
 {
-	return circuitDef->GetBuildSpeed() * unit->GetRulesParamFloat("buildpower_mult", 1.f);
+	return circuitDef->GetBuildSpeed() * GetRulesParam(RulesParam::BUILDPOWER_MULT, frame);
 }
 
-float CCircuitUnit::GetDGunRange()
+float CCircuitUnit::GetDGunRange(int frame)
 {
-	return dgun->GetRange() * unit->GetRulesParamFloat("comm_range_mult", 1.f);
+	return dgun->GetRange() * GetRulesParam(RulesParam::COMM_RANGE_MULT, frame);
 }
 
 float CCircuitUnit::GetHealthPercent()
@@ -197,7 +210,7 @@ void CCircuitUnit::Attack(CEnemyUnit* target, int timeout)
 	TRY_UNIT(manager->GetCircuit(), this,
 		const AIFloat3& pos = target->GetPos();
 		if (circuitDef->IsAttrMelee()) {
-			if (IsJumpReady()) {
+			if (IsJumpReady(manager->GetCircuit()->GetLastFrame())) {
 				unit->ExecuteCustomCommand(CMD_JUMP, {pos.x, pos.y, pos.z}, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
 				unit->Attack(target->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
 			} else {
@@ -218,7 +231,7 @@ void CCircuitUnit::Attack(const AIFloat3& position, int timeout)
 	const AIFloat3& pos = utils::get_radial_pos(position, SQUARE_SIZE * 4);
 	TRY_UNIT(manager->GetCircuit(), this,
 		if (circuitDef->IsAttrMelee()) {
-			if (IsJumpReady()) {
+			if (IsJumpReady(manager->GetCircuit()->GetLastFrame())) {
 				unit->ExecuteCustomCommand(CMD_JUMP, {pos.x, pos.y, pos.z}, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
 				unit->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
 			} else {
@@ -236,7 +249,7 @@ void CCircuitUnit::Attack(const AIFloat3& position, CEnemyUnit* target, int time
 	const AIFloat3& pos = utils::get_radial_pos(position, SQUARE_SIZE * 4);
 	TRY_UNIT(manager->GetCircuit(), this,
 		if (circuitDef->IsAttrMelee()) {
-			if (IsJumpReady()) {
+			if (IsJumpReady(manager->GetCircuit()->GetLastFrame())) {
 				unit->ExecuteCustomCommand(CMD_JUMP, {pos.x, pos.y, pos.z}, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
 				unit->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
 			} else {
@@ -352,4 +365,40 @@ void CCircuitUnit::StopUpgrade()
 	)
 }
 
+float CCircuitUnit::GetRulesParam(RulesParam key, int frame)
+{
+	const RulesParamT idx = static_cast<RulesParamT>(key);
+	if (frame < rulesValues[idx].expireFrame) {
+		++rulesStats.hits;
+		return rulesValues[idx].value;
+	}
+	return ReadRulesParam(idx, frame);
+}
+
+void CCircuitUnit::RefreshRulesParams(int frame)
+{
+	for (RulesParamT idx = 0; idx < static_cast<RulesParamT>(RulesParam::_SIZE_); ++idx) {
+		if (rulesKeys[idx].isHot && (rulesValues[idx].expireFrame > 0)) {
+			ReadRulesParam(idx, frame);
+		}
+	}
+}
+
+CCircuitUnit::SRulesStats CCircuitUnit::PopRulesStats()
+{
+	SRulesStats result = rulesStats;
+	rulesStats.reads = rulesStats.hits = 0;
+	return result;
+}
+
+float CCircuitUnit::ReadRulesParam(RulesParamT idx, int frame)
+{
+	const SRulesKey& key = rulesKeys[idx];
+	SRulesValue& rv = rulesValues[idx];
+	rv.value = unit->GetRulesParamFloat(key.name, key.defValue);
+	rv.expireFrame = std::max(frame + key.refreshRate, 1);
+	++rulesStats.reads;
+	return rv.value;
+}
+
 } // namespace circuit
@@ -11,6 +11,8 @@
 #include "unit/AllyUnit.h"
 #include "util/ActionList.h"
 
+#include <array>
+
 namespace springai {
 	class Weapon;
 }
@@ -51,6 +53,18 @@ struct STerrainMapArea;
 
 class CCircuitUnit: public CAllyUnit, public CActionList {
 public:
+	/*
+	 * Interned UnitRulesParam keys, @see CCircuitUnit::rulesKeys for names and refresh rates.
+	 * Add new key before _SIZE_ and describe it in the table.
+	 */
+	enum class RulesParam: char {DISARMED = 0, NO_AMMO, JUMP_RELOAD, IS_JUMPING, BUILDPOWER_MULT, COMM_RANGE_MULT,
+								 DISABLE_AI_CONTROL, _SIZE_};
+	using RulesParamT = std::underlying_type<RulesParam>::type;
+	struct SRulesStats {
+		unsigned reads;  // engine callbacks
+		unsigned hits;  // served from cache
+	};
+
 	CCircuitUnit(const CCircuitUnit& that) = delete;
 	CCircuitUnit& operator=(const CCircuitUnit&) = delete;
 	CCircuitUnit(Id unitId, springai::Unit* unit, CCircuitDef* cdef);
@@ -85,12 +99,12 @@ public:
 	bool IsWeaponReady(int frame);
 	bool IsDGunReady(int frame);
 	bool IsShieldCharged(float percent);
-	bool IsJumpReady();
-	bool IsJumping();
+	bool IsJumpReady(int frame);
+	bool IsJumping(int frame);
 	float GetDamage();
 	float GetShieldPower();
-	float GetBuildSpeed();
-	float GetDGunRange();
+	float GetBuildSpeed(int frame);
+	float GetDGunRange(int frame);
 	float GetHealthPercent();
 
 	void Attack(CEnemyUnit* target, int timeout);
@@ -106,7 +120,29 @@ public:
 	void StopUpgrade();
 	bool IsMorphing() const { return isMorphing; }
 
+	float GetRulesParam(RulesParam key, int frame);
+	// Batched re-read of hot keys that were requested at least once
+	void RefreshRulesParams(int frame);
+	SRulesStats PopRulesStats();
+
 private:
+	struct SRulesKey {
+		const char* name;
+		float defValue;
+		int refreshRate;  // frames the value stays valid
+		bool isHot;  // refreshed by RefreshRulesParams
+	};
+	static const std::array<SRulesKey, static_cast<RulesParamT>(RulesParam::_SIZE_)> rulesKeys;
+
+	struct SRulesValue {
+		float value;
+		int expireFrame;  // 0 - never requested
+	};
+	std::array<SRulesValue, static_cast<RulesParamT>(RulesParam::_SIZE_)> rulesValues;
+	SRulesStats rulesStats;
+
+	float ReadRulesParam(RulesParamT idx, int frame);
+
 	// NOTE: taskFrame assigned on task change and OnUnitIdle to workaround idle spam.
 	//       Proper fix: do not issue any commands OnUnitIdle, delay them until next frame?
 	int taskFrame;
@@ -123,9 +159,6 @@ private:
 	springai::Weapon* weapon;  // main weapon
 	springai::Weapon* shield;
 
-	bool isDisarmed;
-	int disarmFrame;
-
 	bool isWeaponReady;
 	int ammoFrame;
 
@@ -0,0 +1,84 @@
+/*
+ * EnemyStructures.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "unit/EnemyStructures.h"
+#include "unit/EnemyUnit.h"
+#include "unit/CircuitDef.h"
+#include "util/utils.h"
+
+namespace circuit {
+
+using namespace springai;
+
+#define STRUCT_CELL_SIZE	512
+
+CEnemyStructures::CEnemyStructures(float width, float height)
+		: grid(STRUCT_CELL_SIZE)
+{
+	grid.Init(width, height);
+}
+
+CEnemyStructures::~CEnemyStructures()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CEnemyStructures::AddEnemy(CEnemyUnit* enemy)
+{
+	CCircuitDef* edef = enemy->GetCircuitDef();
+	if ((edef == nullptr) || edef->IsMobile()) {
+		RemoveEnemy(enemy);
+		return;
+	}
+
+	const AIFloat3& pos = enemy->GetPos();
+	auto it = structures.find(enemy->GetId());
+	if (it == structures.end()) {
+		it = structures.emplace(enemy->GetId(), SStructure {enemy}).first;
+		grid.Insert(&it->second, pos);
+	} else if (it->second.pos != pos) {
+		grid.Move(&it->second, it->second.pos, pos);
+	}
+
+	SStructure& s = it->second;
+	s.pos = pos;
+	s.category = edef->GetCategory();
+	s.power = edef->GetPower();
+	s.isBuilder = edef->IsEnemyRoleAny(CCircuitDef::RoleMask::BUILDER);
+	s.isSiege = edef->IsAttrSiege();
+}
+
+void CEnemyStructures::RemoveEnemy(CEnemyUnit* enemy)
+{
+	auto it = structures.find(enemy->GetId());
+	if (it == structures.end()) {
+		return;
+	}
+	grid.Erase(&it->second, it->second.pos);
+	structures.erase(it);
+}
+
+void CEnemyStructures::ForEachInRadius(const AIFloat3& pos, float radius, const StructFunc& func) const
+{
+	grid.ForEachInRadius(pos, radius, [&func](const SStructure* s) {
+		return func(*s);
+	});
+}
+
+void CEnemyStructures::FindNearest(const AIFloat3& pos, unsigned k, const StructFunc& predicate,
+								   std::vector<const SStructure*>& outStructs) const
+{
+	if (structures.empty()) {
+		outStructs.clear();
+		return;
+	}
+	grid.FindNearest(pos, k, [&predicate](const SStructure* s) {
+		return predicate(*s);
+	}, outStructs);
+}
+
+} // namespace circuit
@@ -0,0 +1,60 @@
+/*
+ * EnemyStructures.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_UNIT_ENEMYSTRUCTURES_H_
+#define SRC_CIRCUIT_UNIT_ENEMYSTRUCTURES_H_
+
+#include "unit/CoreUnit.h"
+#include "util/UniformGrid.h"
+
+#include "AIFloat3.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace circuit {
+
+class CEnemyUnit;
+
+/*
+ * Uniform grid over known enemy static structures, keyed by position at last LOS contact.
+ * Per-def data used by target selection is copied into entry on insertion.
+ * Radar/LOS status is volatile and must be checked by the caller.
+ */
+class CEnemyStructures {
+public:
+	struct SStructure {
+		CEnemyUnit* enemy;
+		springai::AIFloat3 pos;
+		int category;
+		float power;
+		bool isBuilder;
+		bool isSiege;
+	};
+	using StructFunc = std::function<bool (const SStructure& s)>;  // return true to stop iteration
+
+	CEnemyStructures(float width, float height);
+	virtual ~CEnemyStructures();
+
+	// Enemy with unknown or mobile def is removed
+	void AddEnemy(CEnemyUnit* enemy);
+	void RemoveEnemy(CEnemyUnit* enemy);
+
+	void ForEachInRadius(const springai::AIFloat3& pos, float radius, const StructFunc& func) const;
+	// Up to k nearest structures that satisfy predicate, ordered by distance
+	void FindNearest(const springai::AIFloat3& pos, unsigned k, const StructFunc& predicate,
+					 std::vector<const SStructure*>& outStructs) const;
+
+private:
+	std::unordered_map<ICoreUnit::Id, SStructure> structures;
+	CUniformGrid<const SStructure*> grid;  // element pointers of unordered_map are stable
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UNIT_ENEMYSTRUCTURES_H_
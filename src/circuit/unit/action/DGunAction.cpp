@@ -8,11 +8,11 @@
 #include "unit/action/DGunAction.h"
 #include "unit/CircuitUnit.h"
 #include "unit/EnemyUnit.h"
+#include "terrain/LineOfFire.h"
 #include "CircuitAI.h"
 #include "util/utils.h"
 
 #include "OOAICallback.h"
-#include "Drawer.h"
 
 namespace circuit {
 
@@ -51,8 +51,7 @@ void CDGunAction::Update(CCircuitAI* circuit)
 
 	int canTargetCat = unit->GetCircuitDef()->GetTargetCategory();
 	bool notDGunAA = !unit->GetCircuitDef()->HasDGunAA();
-	CEnemyUnit* bestTarget = nullptr;
-	float maxThreat = 0.f;
+	std::vector<CLineOfFire::SRay> rays;
 
 	for (Unit* e : enemies) {
 		if (e == nullptr) {
@@ -67,21 +66,26 @@ void CDGunAction::Update(CCircuitAI* circuit)
 		if ((edef == nullptr) || ((edef->GetCategory() & canTargetCat) == 0) || (edef->IsAbleToFly() && notDGunAA)) {
 			continue;
 		}
+		rays.push_back({enemy, false});
+	}
+	if (rays.empty()) {
+		return;
+	}
 
-		AIFloat3 dir = enemy->GetUnit()->GetPos() - pos;
-		float rayRange = dir.LengthNormalize();
-		// NOTE: TraceRay check is mostly to ensure shot won't go into terrain.
-		//       Doesn't properly work with standoff weapons.
-		//       C API also returns rayLen.
-		ICoreUnit::Id hitUID = circuit->GetDrawer()->TraceRay(pos, dir, rayRange, unit->GetUnit(), 0);
-		if (hitUID != enemy->GetId()) {
+	// NOTE: Line of fire check is mostly to ensure shot won't go into terrain.
+	//       Doesn't properly work with standoff weapons.
+	circuit->GetLineOfFire()->TestRays(unit, rays);
+
+	CEnemyUnit* bestTarget = nullptr;
+	float maxThreat = 0.f;
+	for (const CLineOfFire::SRay& ray : rays) {
+		if (!ray.isClear) {
 			continue;
 		}
-
-		const float defThreat = edef->GetPower();
+		const float defThreat = ray.target->GetCircuitDef()->GetPower();
 		if (maxThreat < defThreat) {
 			maxThreat = defThreat;
-			bestTarget = enemy;
+			bestTarget = ray.target;
 		}
 	}
 
@@ -34,10 +34,10 @@ CJumpAction::~CJumpAction()
 void CJumpAction::Update(CCircuitAI* circuit)
 {
 	CCircuitUnit* unit = static_cast<CCircuitUnit*>(ownerList);
-	if (unit->IsJumping()) {
+	const int frame = circuit->GetLastFrame();
+	if (unit->IsJumping(frame)) {
 		return;
 	}
-	const int frame = circuit->GetLastFrame();
 
 	float stepSpeed;
 	int pathMaxIndex = CalcSpeedStep(frame, stepSpeed);
@@ -47,7 +47,7 @@ void CJumpAction::Update(CCircuitAI* circuit)
 	int step = pathIterator;
 
 	TRY_UNIT(circuit, unit,
-		if (unit->IsJumpReady()) {
+		if (unit->IsJumpReady(frame)) {
 			AIFloat3 startPos = unit->GetPos(frame);
 			const float sqRange = SQUARE(unit->GetCircuitDef()->GetJumpRange());
 			for (; (step < pathMaxIndex) && ((*pPath)[step].SqDistance2D(startPos) < sqRange); ++step);
@@ -0,0 +1,41 @@
+/*
+ * Stagger.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "util/Stagger.h"
+#include "util/utils.h"
+
+namespace circuit {
+
+CStagger::CStagger(unsigned rate, unsigned maxCycle, int64_t budgetUs)
+		: rate(std::max(rate, 1u))
+		, maxCycle(std::max(maxCycle, 1u))
+		, budget(budgetUs * 1000)
+		, iterator(0)
+		, tick(0)
+		, cycleStart(0)
+		, owed(0)
+		, avgCost(0.f)
+		, lastCycle(0)
+		, worstCycle(0)
+		, overruns(0)
+{
+}
+
+CStagger::~CStagger()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CStagger::StartCycle()
+{
+	iterator = 0;
+	lastCycle = tick - cycleStart;
+	worstCycle = std::max(worstCycle, lastCycle);
+	cycleStart = tick;
+}
+
+} // namespace circuit
@@ -0,0 +1,64 @@
+/*
+ * Stagger.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_STAGGER_H_
+#define SRC_CIRCUIT_UTIL_STAGGER_H_
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace circuit {
+
+/*
+ * Time-budgeted round-robin over a vector of items, one Update call per tick.
+ * Nominal pace is size / rate + 1 items per tick, unprocessed quota is carried over
+ * and absorbed by later ticks within the budget. Full pass is forced to finish
+ * in maxCycle ticks regardless of the budget, that bounds starvation of any item.
+ */
+class CStagger {
+public:
+	using clock = std::chrono::steady_clock;
+
+	CStagger(unsigned rate, unsigned maxCycle, int64_t budgetUs);
+	virtual ~CStagger();
+
+	// process(item) returns false if item is dead, it is swapped with the last one and dropped
+	template<typename T, typename F>
+	void Update(std::vector<T>& items, F process);
+
+	void SetBudget(int64_t budgetUs) { budget = budgetUs * 1000; }
+
+	// metrics
+	unsigned GetLastCycle() const { return lastCycle; }  // ticks of the last full pass
+	unsigned GetWorstCycle() const { return worstCycle; }  // ticks of the longest full pass
+	unsigned GetOverruns() const { return overruns; }  // ticks that exceeded the budget to meet maxCycle
+	unsigned GetBacklog() const { return owed; }  // items behind the nominal pace
+	float GetAvgCost() const { return avgCost / 1000.f; }  // average cost of one item, us
+
+private:
+	void StartCycle();
+
+	unsigned rate;
+	unsigned maxCycle;
+	int64_t budget;  // ns
+	unsigned iterator;
+	unsigned tick;
+	unsigned cycleStart;
+	unsigned owed;  // nominal updates not done yet
+	float avgCost;  // ns
+
+	unsigned lastCycle;
+	unsigned worstCycle;
+	unsigned overruns;
+};
+
+} // namespace circuit
+
+#include "util/Stagger.hpp"
+
+#endif // SRC_CIRCUIT_UTIL_STAGGER_H_
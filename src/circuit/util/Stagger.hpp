@@ -0,0 +1,72 @@
+/*
+ * Stagger.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_STAGGER_H_
+#	error "Don't include this file directly, include Stagger.h instead"
+#endif
+
+#include "util/Stagger.h"
+
+#include <algorithm>
+
+namespace circuit {
+
+template<typename T, typename F>
+void CStagger::Update(std::vector<T>& items, F process)
+{
+	++tick;
+	if (iterator >= items.size()) {
+		StartCycle();
+	}
+
+	const unsigned size = items.size();
+	owed = std::min(owed + size / rate + 1, size);
+	// minimum to finish the pass in maxCycle ticks
+	const unsigned ticksLeft = std::max<int>(int(cycleStart + maxCycle) - int(tick), 1);
+	unsigned required = (size - iterator + ticksLeft - 1) / ticksLeft;
+
+	const clock::time_point t0 = clock::now();
+	int64_t elapsed = 0;
+	unsigned count = 0;  // never visit item twice per tick
+	while (((owed > 0) || (required > 0)) && (count < size)) {
+		if ((required == 0) && (elapsed + int64_t(avgCost) > budget)) {
+			break;
+		}
+		if (iterator >= items.size()) {
+			if (items.empty()) {
+				break;
+			}
+			StartCycle();
+			required = 0;
+		}
+
+		T item = items[iterator];
+		const clock::time_point t1 = clock::now();
+		if (!process(item)) {
+			items[iterator] = items.back();
+			items.pop_back();
+			continue;
+		}
+		const clock::time_point t2 = clock::now();
+		avgCost += (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() - avgCost) * 0.1f;
+		elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t0).count();
+
+		++iterator;
+		++count;
+		if (owed > 0) {
+			--owed;
+		}
+		if (required > 0) {
+			--required;
+		}
+	}
+	if (elapsed > budget) {
+		++overruns;
+	}
+}
+
+} // namespace circuit
@@ -0,0 +1,59 @@
+/*
+ * UniformGrid.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_UNIFORMGRID_H_
+#define SRC_CIRCUIT_UTIL_UNIFORMGRID_H_
+
+#include "AIFloat3.h"
+
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Uniform 2D grid of items keyed by position, cells keep a copy of item's position.
+ * Item must be equality comparable, position of Erase/Move is the one it was inserted with.
+ */
+template <typename T>
+class CUniformGrid {
+public:
+	struct SItem {
+		T item;
+		springai::AIFloat3 pos;
+	};
+
+	CUniformGrid(int cellSize);
+
+	void Init(float width, float height);  // removes all items
+	void Insert(const T& item, const springai::AIFloat3& pos);
+	void Erase(const T& item, const springai::AIFloat3& pos);
+	void Move(const T& item, const springai::AIFloat3& oldPos, const springai::AIFloat3& newPos);
+
+	// func(const T& item) returns true to stop iteration
+	template <typename F>
+	void ForEachInRadius(const springai::AIFloat3& pos, float radius, F func) const;
+	// Nearest item within radius that satisfies predicate(const T& item), nullptr if none
+	template <typename P>
+	const SItem* FindNear(const springai::AIFloat3& pos, float radius, P predicate) const;
+	// Up to k nearest items that satisfy predicate(const T& item), ordered by distance
+	template <typename P>
+	void FindNearest(const springai::AIFloat3& pos, unsigned k, P predicate, std::vector<T>& outItems) const;
+
+private:
+	int GetCellIndex(const springai::AIFloat3& pos) const;
+
+	int cellSize;
+	int columns;
+	int rows;
+	std::vector<std::vector<SItem>> cells;
+};
+
+} // namespace circuit
+
+#include "util/UniformGrid.hpp"
+
+#endif // SRC_CIRCUIT_UTIL_UNIFORMGRID_H_
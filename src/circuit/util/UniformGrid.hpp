@@ -0,0 +1,182 @@
+/*
+ * UniformGrid.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_UNIFORMGRID_H_
+#	error "Don't include this file directly, include UniformGrid.h instead"
+#endif
+
+#include "util/UniformGrid.h"
+#include "util/utils.h"
+
+#include <algorithm>
+
+namespace circuit {
+
+template <typename T>
+CUniformGrid<T>::CUniformGrid(int cellSize)
+		: cellSize(cellSize)
+		, columns(1)
+		, rows(1)
+{
+	cells.resize(1);
+}
+
+template <typename T>
+void CUniformGrid<T>::Init(float width, float height)
+{
+	columns = std::max(int(width + cellSize - 1) / cellSize, 1);
+	rows = std::max(int(height + cellSize - 1) / cellSize, 1);
+	cells.clear();
+	cells.resize(columns * rows);
+}
+
+template <typename T>
+void CUniformGrid<T>::Insert(const T& item, const springai::AIFloat3& pos)
+{
+	cells[GetCellIndex(pos)].push_back(SItem {item, pos});
+}
+
+template <typename T>
+void CUniformGrid<T>::Erase(const T& item, const springai::AIFloat3& pos)
+{
+	std::vector<SItem>& items = cells[GetCellIndex(pos)];
+	auto it = std::find_if(items.begin(), items.end(), [&item](const SItem& i) {
+		return i.item == item;
+	});
+	if (it != items.end()) {
+		*it = items.back();
+		items.pop_back();
+	}
+}
+
+template <typename T>
+void CUniformGrid<T>::Move(const T& item, const springai::AIFloat3& oldPos, const springai::AIFloat3& newPos)
+{
+	const int cell = GetCellIndex(oldPos);
+	if (cell != GetCellIndex(newPos)) {
+		Erase(item, oldPos);
+		Insert(item, newPos);
+		return;
+	}
+	for (SItem& i : cells[cell]) {
+		if (i.item == item) {
+			i.pos = newPos;
+			break;
+		}
+	}
+}
+
+template <typename T>
+template <typename F>
+void CUniformGrid<T>::ForEachInRadius(const springai::AIFloat3& pos, float radius, F func) const
+{
+	const float sqRadius = SQUARE(radius);
+	const int x1 = utils::clamp(int((pos.x - radius) / cellSize), 0, columns - 1);
+	const int x2 = utils::clamp(int((pos.x + radius) / cellSize), 0, columns - 1);
+	const int z1 = utils::clamp(int((pos.z - radius) / cellSize), 0, rows - 1);
+	const int z2 = utils::clamp(int((pos.z + radius) / cellSize), 0, rows - 1);
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			for (const SItem& i : cells[z * columns + x]) {
+				if ((pos.SqDistance2D(i.pos) <= sqRadius) && func(i.item)) {
+					return;
+				}
+			}
+		}
+	}
+}
+
+template <typename T>
+template <typename P>
+const typename CUniformGrid<T>::SItem* CUniformGrid<T>::FindNear(const springai::AIFloat3& pos, float radius, P predicate) const
+{
+	const SItem* result = nullptr;
+	float minSqDist = SQUARE(radius);
+	const int x1 = utils::clamp(int((pos.x - radius) / cellSize), 0, columns - 1);
+	const int x2 = utils::clamp(int((pos.x + radius) / cellSize), 0, columns - 1);
+	const int z1 = utils::clamp(int((pos.z - radius) / cellSize), 0, rows - 1);
+	const int z2 = utils::clamp(int((pos.z + radius) / cellSize), 0, rows - 1);
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			for (const SItem& i : cells[z * columns + x]) {
+				const float sqDist = pos.SqDistance2D(i.pos);
+				if ((sqDist < minSqDist) && predicate(i.item)) {
+					result = &i;
+					minSqDist = sqDist;
+				}
+			}
+		}
+	}
+	return result;
+}
+
+template <typename T>
+template <typename P>
+void CUniformGrid<T>::FindNearest(const springai::AIFloat3& pos, unsigned k, P predicate, std::vector<T>& outItems) const
+{
+	outItems.clear();
+	if (k == 0) {
+		return;
+	}
+
+	const int cx = utils::clamp(int(pos.x / cellSize), 0, columns - 1);
+	const int cz = utils::clamp(int(pos.z / cellSize), 0, rows - 1);
+	const int maxRing = std::max(columns, rows);
+	std::vector<std::pair<float, const SItem*>> found;
+	auto checkCell = [this, &pos, &predicate, &found](int x, int z) {
+		if ((x < 0) || (x >= columns) || (z < 0) || (z >= rows)) {
+			return;
+		}
+		for (const SItem& i : cells[z * columns + x]) {
+			if (predicate(i.item)) {
+				found.push_back(std::make_pair(pos.SqDistance2D(i.pos), &i));
+			}
+		}
+	};
+	auto isSettled = [this, &found, k](int ring) {
+		// cells of the next ring are at least ring * cellSize away
+		if (found.size() < k) {
+			return false;
+		}
+		std::nth_element(found.begin(), found.begin() + k - 1, found.end());
+		return found[k - 1].first <= SQUARE(ring * cellSize);
+	};
+
+	for (int ring = 0; ring <= maxRing; ++ring) {
+		if (ring == 0) {
+			checkCell(cx, cz);
+		} else {
+			for (int x = cx - ring; x <= cx + ring; ++x) {
+				checkCell(x, cz - ring);
+				checkCell(x, cz + ring);
+			}
+			for (int z = cz - ring + 1; z <= cz + ring - 1; ++z) {
+				checkCell(cx - ring, z);
+				checkCell(cx + ring, z);
+			}
+		}
+		if (isSettled(ring)) {
+			break;
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	const unsigned size = std::min<unsigned>(k, found.size());
+	for (unsigned i = 0; i < size; ++i) {
+		outItems.push_back(found[i].second->item);
+	}
+}
+
+template <typename T>
+int CUniformGrid<T>::GetCellIndex(const springai::AIFloat3& pos) const
+{
+	const int x = utils::clamp(int(pos.x / cellSize), 0, columns - 1);
+	const int z = utils::clamp(int(pos.z / cellSize), 0, rows - 1);
+	return z * columns + x;
+}
+
+} // namespace circuit
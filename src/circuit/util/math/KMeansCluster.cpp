@@ -8,6 +8,10 @@
 #include "util/math/KMeansCluster.h"
 #include "util/utils.h"
 
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
 namespace circuit {
 
 using namespace springai;
@@ -15,6 +19,7 @@ using namespace springai;
 CKMeansCluster::CKMeansCluster(const springai::AIFloat3& initPos)
 {
 	means.push_back(initPos);
+	counts.push_back(0);
 }
 
 CKMeansCluster::~CKMeansCluster()
@@ -22,77 +27,213 @@ CKMeansCluster::~CKMeansCluster()
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
 }
 
+void CKMeansCluster::SetPoint(int id, const AIFloat3& pos)
+{
+	auto it = pointIdx.find(id);
+	if (it == pointIdx.end()) {
+		pointIdx[id] = points.size();
+		points.push_back({id, pos, -1, std::numeric_limits<float>::max(), 0.f});
+		return;
+	}
+
+	SPoint& point = points[it->second];
+	if (point.pos == pos) {
+		return;
+	}
+	if (point.mean >= 0) {
+		// point moved by delta: own mean is at most delta further, others at most delta closer
+		const float delta = sqrtf(point.pos.SqDistance2D(pos));
+		point.upper += delta;
+		point.lower -= delta;
+	}
+	point.pos = pos;
+}
+
+void CKMeansCluster::RemovePoint(int id)
+{
+	auto it = pointIdx.find(id);
+	if (it == pointIdx.end()) {
+		return;
+	}
+
+	const unsigned idx = it->second;
+	SPoint& point = points[idx];
+	if (point.mean >= 0) {
+		--counts[point.mean];
+	}
+	pointIdx.erase(it);
+	if (idx != points.size() - 1) {
+		point = points.back();
+		pointIdx[point.id] = idx;
+	}
+	points.pop_back();
+}
+
 /*
  * 2d only, ignores y component.
  * @see KAIK/AttackHandler::KMeansIteration for general reference
  */
-void CKMeansCluster::Iteration(const std::vector<AIFloat3>& unitPositions, int newK)
+void CKMeansCluster::Iteration(int newK)
 {
-	assert(newK > 0/* && means.size() > 0*/);
-	int numUnits = unitPositions.size();
-	// change the number of means according to newK
-	int oldK = means.size();
-	means.resize(newK);
-	// add a new means, just use one of the positions
-	AIFloat3 newMeansPosition = unitPositions[0];
-//	newMeansPosition.y = ai->cb->GetElevation(newMeansPosition.x, newMeansPosition.z) + K_MEANS_ELEVATION;
+	assert(newK > 0);
+	if (points.empty()) {
+		return;
+	}
+	SetK(newK);
+	const int k = means.size();
+
+	halfGaps.assign(k, std::numeric_limits<float>::max());
+	for (int i = 0; i < k; ++i) {
+		for (int j = i + 1; j < k; ++j) {
+			const float halfGap = sqrtf(means[i].SqDistance2D(means[j])) * 0.5f;
+			halfGaps[i] = std::min(halfGaps[i], halfGap);
+			halfGaps[j] = std::min(halfGaps[j], halfGap);
+		}
+	}
 
-	for (int i = oldK; i < newK; i++) {
-		means[i] = newMeansPosition;
+	// assign points to means, only points with overlapping bounds are compared against all means;
+	// strict bounds leave ties to AssignPoint, so the closest mean with the lowest index wins as in plain step
+	for (SPoint& point : points) {
+		if (point.mean < 0) {
+			AssignPoint(point);
+			continue;
+		}
+		const float bound = std::max(halfGaps[point.mean], point.lower);
+		if (point.upper < bound) {
+			continue;
+		}
+		point.upper = sqrtf(point.pos.SqDistance2D(means[point.mean]));
+		if (point.upper < bound) {
+			continue;
+		}
+		AssignPoint(point);
 	}
 
-	// check all positions and assign them to means, complexity n*k for one iteration
-	std::vector<int> unitsClosestMeanID(numUnits, -1);
-	std::vector<int> numUnitsAssignedToMean(newK, 0);
+	// empty mean jumps to the worst placed point, then means move to the centroids of assigned points;
+	// sums are collected anew, incremental ones drift off single point clusters
+	sums.assign(k, ZeroVector);
+	for (const SPoint& point : points) {
+		sums[point.mean] += point.pos;
+	}
+	shifts.assign(k, 0.f);
+	seeds.clear();
+	newMeans = means;
+	for (int i = 0; i < k; ++i) {
+		if (counts[i] > 0) {
+			newMeans[i] = sums[i] / counts[i];
+		} else {
+			const int seedIdx = FindSeed();
+			if (seedIdx >= 0) {
+				newMeans[i] = points[seedIdx].pos;
+			}
+		}
+	}
+	float maxShift = 0.f;
+	for (int i = 0; i < k; ++i) {
+		shifts[i] = sqrtf(means[i].SqDistance2D(newMeans[i]));
+		maxShift = std::max(maxShift, shifts[i]);
+		means[i] = newMeans[i];
+	}
+	for (SPoint& point : points) {
+		if (point.mean >= 0) {
+			point.upper += shifts[point.mean];
+			point.lower -= maxShift;
+		}
+	}
+}
 
-	for (int i = 0; i < numUnits; i++) {
-		AIFloat3 unitPos = unitPositions[i];
-		float closestDistance = std::numeric_limits<float>::max();
-		int closestIndex = -1;
+int CKMeansCluster::GetMeanIndex(int id) const
+{
+	auto it = pointIdx.find(id);
+	return (it != pointIdx.end()) ? points[it->second].mean : -1;
+}
 
-		for (int m = 0; m < newK; m++) {
-			AIFloat3 mean = means[m];
-			float distance = unitPos.SqDistance2D(mean);
+void CKMeansCluster::AssignPoint(SPoint& point)
+{
+	int closestIndex = -1;
+	float closestSqDist = std::numeric_limits<float>::max();
+	float secondSqDist = std::numeric_limits<float>::max();
+	for (unsigned i = 0; i < means.size(); ++i) {
+		const float sqDist = point.pos.SqDistance2D(means[i]);
+		if (sqDist < closestSqDist) {
+			secondSqDist = closestSqDist;
+			closestSqDist = sqDist;
+			closestIndex = i;
+		} else if (sqDist < secondSqDist) {
+			secondSqDist = sqDist;
+		}
+	}
 
-			if (distance < closestDistance) {
-				closestDistance = distance;
-				closestIndex = m;
-			}
+	if (closestIndex != point.mean) {
+		if (point.mean >= 0) {
+			--counts[point.mean];
 		}
+		++counts[closestIndex];
+		point.mean = closestIndex;
+	}
+	point.upper = sqrtf(closestSqDist);
+	point.lower = (secondSqDist < std::numeric_limits<float>::max()) ? sqrtf(secondSqDist) : secondSqDist;
+}
 
-		// position i is closest to the mean at closestIndex
-		unitsClosestMeanID[i] = closestIndex;
-		numUnitsAssignedToMean[closestIndex]++;
+void CKMeansCluster::SetK(int newK)
+{
+	const int oldK = means.size();
+	if (newK == oldK) {
+		return;
 	}
 
-	// change the means according to which positions are assigned to them
-	// use meanAverage for indexes with 0 pos'es assigned
-	// make a new means list
-//	std::vector<AIFloat3> newMeans(newK, ZeroVector);
-	std::vector<AIFloat3>& newMeans = means;
-	std::fill(newMeans.begin(), newMeans.end(), ZeroVector);
+	if (newK < oldK) {
+		for (SPoint& point : points) {
+			if (point.mean >= newK) {
+				point.mean = -1;
+			}
+		}
+	}
+	means.resize(newK);
+	counts.resize(newK, 0);
+
+	// new means are placed farthest-first from already placed means
+	if (newK > oldK) {
+		placedSqDists.assign(points.size(), std::numeric_limits<float>::max());
+		for (int i = 0; i < newK; ++i) {
+			if (i >= oldK) {
+				const int seedIdx = std::max_element(placedSqDists.begin(), placedSqDists.end()) - placedSqDists.begin();
+				means[i] = points[seedIdx].pos;
+			}
+			for (unsigned j = 0; j < points.size(); ++j) {
+				placedSqDists[j] = std::min(placedSqDists[j], points[j].pos.SqDistance2D(means[i]));
+			}
+		}
+	}
 
-	// TODO: Return unitsClosestMeanID at this point or make some Visitor to calc other attributes of the group
-	for (int i = 0; i < numUnits; i++) {
-		int meanIndex = unitsClosestMeanID[i];
-		 // don't divide by 0
-		float num = std::max(1, numUnitsAssignedToMean[meanIndex]);
-		newMeans[meanIndex] += unitPositions[i] / num;
+	// any mean could have appeared closer than the second one
+	for (SPoint& point : points) {
+		point.lower = 0.f;
 	}
+}
 
-	// do a check and see if there are any empty means and set the height
-	for (int i = 0; i < newK; i++) {
-		// if a newmean is unchanged, set it to the new means pos instead of (0, 0, 0)
-		if (newMeans[i] == ZeroVector) {
-			newMeans[i] = newMeansPosition;
+/*
+ * Assigned point farthest from its mean that is not a seed yet, -1 if all points sit on means
+ */
+int CKMeansCluster::FindSeed()
+{
+	int seedIdx = -1;
+	float maxSqDist = 0.f;
+	for (unsigned i = 0; i < points.size(); ++i) {
+		const SPoint& point = points[i];
+		if (point.mean < 0) {
+			continue;
 		}
-		else {
-			// get the proper elevation for the y-coord
-//			newMeans[i].y = ai->cb->GetElevation(newMeans[i].x, newMeans[i].z) + K_MEANS_ELEVATION;
+		const float sqDist = point.pos.SqDistance2D(means[point.mean]);
+		if ((sqDist > maxSqDist) && (std::find(seeds.begin(), seeds.end(), i) == seeds.end())) {
+			maxSqDist = sqDist;
+			seedIdx = i;
 		}
 	}
-
-//	return newMeans;
+	if (seedIdx >= 0) {
+		seeds.push_back(seedIdx);
+	}
+	return seedIdx;
 }
 
 } // namespace circuit
@@ -8,24 +8,57 @@
 #ifndef SRC_CIRCUIT_UTIL_MATH_KMEANSCLUSTER_H_
 #define SRC_CIRCUIT_UTIL_MATH_KMEANSCLUSTER_H_
 
-#include <vector>
+#include "AIFloat3.h"
 
-namespace springai {
-	class AIFloat3;
-}
+#include <unordered_map>
+#include <vector>
 
 namespace circuit {
 
+/*
+ * Incremental 2D k-means, ignores y component.
+ * Points are added, moved and removed by id between iterations, means warm-start from previous run.
+ * Assignment uses Hamerly bounds: upper bound to own mean, lower bound to the second closest,
+ * only points whose bounds overlap are compared against all means.
+ */
 class CKMeansCluster {
 public:
 	CKMeansCluster(const springai::AIFloat3& initPos);
 	virtual ~CKMeansCluster();
 
-	void Iteration(const std::vector<springai::AIFloat3>& unitPositions, int newK);
+	void SetPoint(int id, const springai::AIFloat3& pos);  // add or move
+	void RemovePoint(int id);
+
+	// One Lloyd step, newK > 0
+	void Iteration(int newK);
 	const std::vector<springai::AIFloat3>& GetMeans() const { return means; }
+	const std::vector<int>& GetCounts() const { return counts; }
+	int GetMeanIndex(int id) const;  // -1 for unknown or not yet assigned point
 
 private:
+	struct SPoint {
+		int id;
+		springai::AIFloat3 pos;
+		int mean;  // -1 if not assigned
+		float upper;  // >= distance to own mean
+		float lower;  // <= distance to any other mean
+	};
+	void AssignPoint(SPoint& point);
+	void SetK(int newK);
+	int FindSeed();
+
 	std::vector<springai::AIFloat3> means;
+	std::vector<int> counts;
+	std::vector<SPoint> points;
+	std::unordered_map<int, unsigned> pointIdx;  // id: index in points
+
+	// scratch
+	std::vector<springai::AIFloat3> sums;  // sum of positions of assigned points
+	std::vector<float> halfGaps;  // half distance to the closest other mean
+	std::vector<float> shifts;  // movement of means during the last step
+	std::vector<unsigned> seeds;  // points already used to place empty means
+	std::vector<springai::AIFloat3> newMeans;  // means after the step
+	std::vector<float> placedSqDists;  // distance to the closest placed mean, for new means
 };
 
 } // namespace circuit
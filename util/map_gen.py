@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Synthetic map and scenario generator for offline scaling runs.
+
+Emits into output directory:
+  height.raw   - float32 LE, mapx * mapz, heights per SQUARE_SIZE cell (Map::GetHeightMap layout)
+  slope.raw    - float32 LE, (mapx / 2) * (mapz / 2), 1 - normal.y (Map::GetSlopeMap layout)
+  scenario.json - map dimensions, metal spots, start boxes and scripted enemy waves
+
+Same seed and size always produce same scenario.
+Usage: map_gen.py -s 16x16 -e 2000 -r 42 -o out/
+"""
+
+from array import array
+import argparse
+import json
+import math
+import os
+import random
+import sys
+
+SQUARE_SIZE = 8  # elmos per height-map cell
+MAP_UNIT = 64  # height-map cells per map size unit
+SLOPE_SIZE = 2  # height-map cells per slope-map cell
+
+
+class ValueNoise:
+	def __init__(self, rng, cells):
+		self.cells = cells
+		self.grid = [rng.random() for _ in range((cells + 1) * (cells + 1))]
+
+	def sample(self, u, v):
+		x = u * self.cells
+		z = v * self.cells
+		x0 = min(int(x), self.cells - 1)
+		z0 = min(int(z), self.cells - 1)
+		fx = x - x0
+		fz = z - z0
+		fx = fx * fx * (3.0 - 2.0 * fx)
+		fz = fz * fz * (3.0 - 2.0 * fz)
+		row = self.cells + 1
+		a = self.grid[z0 * row + x0]
+		b = self.grid[z0 * row + x0 + 1]
+		c = self.grid[(z0 + 1) * row + x0]
+		d = self.grid[(z0 + 1) * row + x0 + 1]
+		return (a + (b - a) * fx) + ((c + (d - c) * fx) - (a + (b - a) * fx)) * fz
+
+
+def gen_heights(rng, mapx, mapz, args):
+	octaves = [ValueNoise(rng, 4 << i) for i in range(args.octaves)]
+	weights = [0.5 ** i for i in range(args.octaves)]
+	norm = sum(weights)
+	heights = array('f', bytes(4 * mapx * mapz))
+	for z in range(mapz):
+		v = z / mapz
+		for x in range(mapx):
+			u = x / mapx
+			h = sum(w * o.sample(u, v) for o, w in zip(octaves, weights)) / norm
+			heights[z * mapx + x] = args.min_height + (args.max_height - args.min_height) * h
+	return heights
+
+
+def gen_slopes(heights, mapx, mapz):
+	smx = mapx // SLOPE_SIZE
+	smz = mapz // SLOPE_SIZE
+	slopes = array('f', bytes(4 * smx * smz))
+	for sz in range(smz):
+		z = sz * SLOPE_SIZE
+		z2 = min(z + SLOPE_SIZE, mapz - 1)
+		for sx in range(smx):
+			x = sx * SLOPE_SIZE
+			x2 = min(x + SLOPE_SIZE, mapx - 1)
+			h = heights[z * mapx + x]
+			dx = (heights[z * mapx + x2] - h) / (SLOPE_SIZE * SQUARE_SIZE)
+			dz = (heights[z2 * mapx + x] - h) / (SLOPE_SIZE * SQUARE_SIZE)
+			slopes[sz * smx + sx] = 1.0 - 1.0 / math.sqrt(1.0 + dx * dx + dz * dz)
+	return slopes
+
+
+def height_at(heights, mapx, mapz, x, z):
+	ix = min(max(int(x / SQUARE_SIZE), 0), mapx - 1)
+	iz = min(max(int(z / SQUARE_SIZE), 0), mapz - 1)
+	return heights[iz * mapx + ix]
+
+
+def gen_metal(rng, heights, slopes, mapx, mapz, args):
+	width = mapx * SQUARE_SIZE
+	height = mapz * SQUARE_SIZE
+	smx = mapx // SLOPE_SIZE
+	# Same density rule as CMetalManager::ParseMetalSpots: 8x8 ~ 80 spots, 24x24 ~ 240 spots
+	units = (mapx // MAP_UNIT) * (mapz // MAP_UNIT)
+	count = args.mexes or max(int((240.0 - 80.0) / (24 ** 2 - 8 ** 2) * (units - 8 ** 2) + 80.0), 8)
+	minSqDist = (args.mex_spacing * SQUARE_SIZE) ** 2
+	spots = []
+	attempts = count * 50
+	while (len(spots) < count) and (attempts > 0):
+		attempts -= 1
+		cx = rng.uniform(0.05, 0.95) * width
+		cz = rng.uniform(0.05, 0.95) * height
+		# spots come in small clusters like most real maps
+		for _ in range(rng.randint(1, 3)):
+			x = min(max(cx + rng.uniform(-96.0, 96.0), 0.0), width - 1.0)
+			z = min(max(cz + rng.uniform(-96.0, 96.0), 0.0), height - 1.0)
+			si = int(z / (SLOPE_SIZE * SQUARE_SIZE)) * smx + int(x / (SLOPE_SIZE * SQUARE_SIZE))
+			if slopes[si] > args.max_mex_slope:
+				continue
+			if any((s['x'] - x) ** 2 + (s['z'] - z) ** 2 < minSqDist for s in spots):
+				continue
+			spots.append({'x': round(x, 1), 'y': round(height_at(heights, mapx, mapz, x, z), 1),
+						  'z': round(z, 1), 'metal': round(rng.uniform(1.5, 3.0), 2)})
+			if len(spots) >= count:
+				break
+	return spots
+
+
+def gen_starts(mapx, mapz, teams):
+	width = mapx * SQUARE_SIZE
+	height = mapz * SQUARE_SIZE
+	boxes = []
+	for i in range(teams):
+		a = 2.0 * math.pi * i / teams + math.pi * 0.25
+		cx = width * (0.5 + 0.38 * math.cos(a))
+		cz = height * (0.5 + 0.38 * math.sin(a))
+		hw = width * 0.08
+		hh = height * 0.08
+		boxes.append({'team': i, 'left': round(cx - hw), 'top': round(cz - hh),
+					  'right': round(cx + hw), 'bottom': round(cz + hh),
+					  'x': round(cx, 1), 'z': round(cz, 1)})
+	return boxes
+
+
+def gen_enemies(rng, heights, mapx, mapz, spots, starts, args):
+	"""
+	Scripted enemy population: static defences and mexes around spots,
+	mobile groups that appear in waves and move towards AI start.
+	"""
+	width = mapx * SQUARE_SIZE
+	height = mapz * SQUARE_SIZE
+	home = starts[0]
+	enemyStarts = starts[1:] or starts
+	units = []
+	uid = 1
+
+	def place(kind, x, z, frame, target=None):
+		nonlocal uid
+		x = min(max(x, 0.0), width - 1.0)
+		z = min(max(z, 0.0), height - 1.0)
+		u = {'id': uid, 'kind': kind, 'frame': frame, 'x': round(x, 1),
+			 'y': round(height_at(heights, mapx, mapz, x, z), 1), 'z': round(z, 1)}
+		if target is not None:
+			u['target'] = target
+		units.append(u)
+		uid += 1
+
+	staticCount = int(args.enemies * args.static_ratio)
+	for i in range(staticCount):
+		if spots and (rng.random() < 0.5):
+			s = rng.choice(spots)
+			place('mex' if rng.random() < 0.5 else 'defence',
+				  s['x'] + rng.uniform(-64.0, 64.0), s['z'] + rng.uniform(-64.0, 64.0), 0)
+		else:
+			b = rng.choice(enemyStarts)
+			place(rng.choice(('factory', 'energy', 'defence', 'artillery')),
+				  rng.uniform(b['left'], b['right']), rng.uniform(b['top'], b['bottom']), 0)
+
+	mobileCount = args.enemies - staticCount
+	waves = max(args.waves, 1)
+	for w in range(waves):
+		frame = (w + 1) * args.wave_interval
+		perWave = mobileCount // waves + (1 if w < mobileCount % waves else 0)
+		while perWave > 0:
+			b = rng.choice(enemyStarts)
+			cx = rng.uniform(b['left'], b['right'])
+			cz = rng.uniform(b['top'], b['bottom'])
+			group = min(perWave, rng.randint(4, 24))
+			kind = rng.choice(('raider', 'assault', 'skirmisher', 'anti_air', 'air'))
+			for _ in range(group):
+				place(kind, cx + rng.gauss(0.0, 80.0), cz + rng.gauss(0.0, 80.0), frame,
+					  {'x': home['x'], 'z': home['z']})
+			perWave -= group
+	return units
+
+
+def parse_size(value):
+	try:
+		x, _, z = value.lower().partition('x')
+		x, z = int(x), int(z or x)
+	except ValueError:
+		raise argparse.ArgumentTypeError("size must be WxH in map units, e.g. 16x16")
+	if (x <= 0) or (z <= 0) or (x % 2) or (z % 2):
+		raise argparse.ArgumentTypeError("map units must be positive and even")
+	return x, z
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Synthetic map and scenario generator")
+	parser.add_argument('-s', '--size', type=parse_size, default=(12, 12), help="map size in units (512 elmos), WxH")
+	parser.add_argument('-r', '--seed', type=int, default=0)
+	parser.add_argument('-o', '--out', default='scenario')
+	parser.add_argument('-t', '--teams', type=int, default=2)
+	parser.add_argument('-e', '--enemies', type=int, default=500, help="total scripted enemy units")
+	parser.add_argument('--static-ratio', type=float, default=0.3)
+	parser.add_argument('--waves', type=int, default=10)
+	parser.add_argument('--wave-interval', type=int, default=30 * 60, help="frames between waves")
+	parser.add_argument('--mexes', type=int, default=0, help="0 = derive from map size")
+	parser.add_argument('--mex-spacing', type=int, default=12, help="min distance between spots, in squares")
+	parser.add_argument('--max-mex-slope', type=float, default=0.08)
+	parser.add_argument('--octaves', type=int, default=5)
+	parser.add_argument('--min-height', type=float, default=-50.0)
+	parser.add_argument('--max-height', type=float, default=400.0)
+	args = parser.parse_args()
+
+	rng = random.Random(args.seed)
+	mapx = args.size[0] * MAP_UNIT
+	mapz = args.size[1] * MAP_UNIT
+
+	heights = gen_heights(rng, mapx, mapz, args)
+	slopes = gen_slopes(heights, mapx, mapz)
+	spots = gen_metal(rng, heights, slopes, mapx, mapz, args)
+	starts = gen_starts(mapx, mapz, max(args.teams, 1))
+	enemies = gen_enemies(rng, heights, mapx, mapz, spots, starts, args)
+
+	os.makedirs(args.out, exist_ok=True)
+	if sys.byteorder != 'little':
+		heights.byteswap()
+		slopes.byteswap()
+	with open(os.path.join(args.out, 'height.raw'), 'wb') as f:
+		heights.tofile(f)
+	with open(os.path.join(args.out, 'slope.raw'), 'wb') as f:
+		slopes.tofile(f)
+
+	scenario = {
+		'seed': args.seed,
+		'squareSize': SQUARE_SIZE,
+		'heightMap': {'file': 'height.raw', 'width': mapx, 'height': mapz},
+		'slopeMap': {'file': 'slope.raw', 'width': mapx // SLOPE_SIZE, 'height': mapz // SLOPE_SIZE},
+		'metalSpots': spots,
+		'startBoxes': starts,
+		'enemies': enemies,
+	}
+	with open(os.path.join(args.out, 'scenario.json'), 'w') as f:
+		json.dump(scenario, f, indent='\t')
+
+	print("{0}x{1} squares, {2} spots, {3} enemies -> {4}".format(
+		mapx, mapz, len(spots), len(enemies), args.out))
+
+
+if __name__ == "__main__":
+	main()